@@ -0,0 +1,138 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+
+#include <cstdio>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/AddressFilter.h>
+#include <frog/BloomAddressFilter.h>
+#include <frog/CuckooAddressFilter.h>
+#include <frog/XorAddressFilter.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::AddressFilter;
+using frog::net::BloomAddressFilter;
+using frog::net::CuckooAddressFilter;
+using frog::net::XorAddressFilter;
+
+//--------------------------------------------------------------
+// Queries a filter one address at a time and in batches, and prints
+// the false positive rate next to the rates of queries.
+static void measure(const char* name, const AddressFilter& filter,
+        const std::vector<InetAddressValue>& queries, size_t absentFrom)
+{
+    size_t count = queries.size();
+    size_t positives = 0;
+    Stopwatch watch;
+    for(size_t i = 0; i < count; ++i)
+    {
+        positives += filter.mayContain(queries[i]);
+    }
+    double single = watch.elapsed();
+
+    std::vector<uint8_t> result(count);
+    watch.restart();
+    size_t batchPositives = filter.mayContainBatch(&queries[0], count, &result[0]);
+    double batch = watch.elapsed();
+
+    size_t falsePositives = 0;
+    for(size_t i = absentFrom; i < count; ++i)
+    {
+        falsePositives += result[i];
+    }
+    std::printf("%-8s %6.2f bits/address  FPR %7.4f%%  %6.1f Mq/s single  %6.1f Mq/s batch%s\n",
+            name, 8.0 * filter.getMemoryUsage() / filter.getCount(),
+            100.0 * falsePositives / (count - absentFrom),
+            count / single / 1e6, count / batch / 1e6,
+            (positives == batchPositives) ? "" : "  MISMATCH");
+}
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 4000000);
+    BenchRandom rnd;
+
+    // The filters hold count addresses, too many for the caches, and
+    // are queried with as many addresses: half added, half not.
+    std::vector<InetAddressValue> added;
+    added.reserve(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+#ifdef HAVE_IPV6_SUPPORT
+        if((i & 3) == 0)
+        {
+            InetAddress base("2001:db8::");
+            added.push_back((base + static_cast<int64_t>(rnd.next() & 0xffffffffffULL)).getValue());
+            continue;
+        }
+#endif
+        added.push_back((InetAddress("10.0.0.0") + (rnd.next32() & 0xffffff)).getValue());
+    }
+    std::vector<InetAddressValue> queries;
+    queries.reserve(count);
+    for(size_t i = 0; i < count / 2; ++i)
+    {
+        queries.push_back(added[rnd.next32() % count]);
+    }
+    for(size_t i = count / 2; i < count; ++i)
+    {
+#ifdef HAVE_IPV6_SUPPORT
+        InetAddress base((i & 3) ? "198.18.0.0" : "2001:db9::");
+#else
+        InetAddress base("198.18.0.0");
+#endif
+        queries.push_back((base + static_cast<int64_t>(rnd.next32() & 0x1ffff)).getValue());
+    }
+
+    uint32_t bits[] = { 8, 12, 16 };
+    for(size_t b = 0; b < sizeof(bits) / sizeof(bits[0]); ++b)
+    {
+        BloomAddressFilter bloom(count, bits[b]);
+        for(size_t i = 0; i < count; ++i)
+        {
+            bloom.add(added[i]);
+        }
+        char name[16];
+        std::snprintf(name, sizeof(name), "bloom%u", bits[b]);
+        measure(name, bloom, queries, count / 2);
+    }
+
+    CuckooAddressFilter cuckoo(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        cuckoo.add(added[i]);
+    }
+    measure("cuckoo", cuckoo, queries, count / 2);
+
+    XorAddressFilter xor8;
+    Stopwatch watch;
+    xor8.build(&added[0], added.size());
+    watch.report("XorAddressFilter::build()", count);
+    measure("xor8", xor8, queries, count / 2);
+    return 0;
+}
@@ -0,0 +1,145 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#include <pthread.h>
+#include <cstdio>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/AddressPool.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::AddressPool;
+
+//--------------------------------------------------------------
+// One producer thread: interns a slice of the stream.
+struct Producer
+{
+    AddressPool* pool;
+    const InetAddressValue* begin;
+    const InetAddressValue* end;
+    uint32_t* ids;
+};
+
+//--------------------------------------------------------------
+static void* produce(void* arg)
+{
+    Producer* producer = static_cast<Producer*>(arg);
+    uint32_t* id = producer->ids;
+    for(const InetAddressValue* p = producer->begin; p != producer->end; ++p, ++id)
+    {
+        producer->pool->tryIntern(*p, *id);
+    }
+    return NULL;
+}
+
+//--------------------------------------------------------------
+// Interns the stream with the given number of threads.
+static void internAll(AddressPool& pool, const std::vector<InetAddressValue>& stream,
+        std::vector<uint32_t>& ids, size_t threadCount)
+{
+    std::vector<Producer> producers(threadCount);
+    std::vector<pthread_t> threads(threadCount);
+    size_t slice = stream.size() / threadCount;
+    for(size_t t = 0; t < threadCount; ++t)
+    {
+        size_t first = t * slice;
+        size_t last = (t + 1 == threadCount) ? stream.size() : first + slice;
+        producers[t].pool = &pool;
+        producers[t].begin = &stream[0] + first;
+        producers[t].end = &stream[0] + last;
+        producers[t].ids = &ids[0] + first;
+        ::pthread_create(&threads[t], NULL, produce, &producers[t]);
+    }
+    for(size_t t = 0; t < threadCount; ++t)
+    {
+        ::pthread_join(threads[t], NULL);
+    }
+}
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 4000000);
+    const size_t distinct = 300000;
+    BenchRandom rnd;
+
+    // A connection log: few distinct addresses, one IPv6 address for
+    // every three IPv4 addresses when IPv6 is supported, and a skew
+    // towards the first ones.
+    std::vector<InetAddressValue> addresses;
+    addresses.reserve(distinct);
+    for(size_t i = 0; i < distinct; ++i)
+    {
+#ifdef HAVE_IPV6_SUPPORT
+        InetAddress base((i & 3) ? "100.64.0.0" : "2001:db8::");
+#else
+        InetAddress base("100.64.0.0");
+#endif
+        addresses.push_back((base + static_cast<int64_t>(rnd.next32() & 0x3fffff)).getValue());
+    }
+    std::vector<InetAddressValue> stream;
+    stream.reserve(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        uint32_t r = rnd.next32();
+        stream.push_back(addresses[(r & 1) ? (r >> 1) % 1000 : (r >> 1) % distinct]);
+    }
+
+    std::vector<uint32_t> ids(count);
+    size_t threadCounts[] = { 1, 2, 4, 8 };
+    size_t size = 0;
+    for(size_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); ++i)
+    {
+        AddressPool pool(distinct);
+        char name[64];
+        std::snprintf(name, sizeof(name), "AddressPool::tryIntern(), %lu threads",
+                static_cast<unsigned long>(threadCounts[i]));
+        Stopwatch watch;
+        internAll(pool, stream, ids, threadCounts[i]);
+        watch.report(name, count);
+        size = pool.getSize();
+    }
+
+    AddressPool pool(distinct);
+    internAll(pool, stream, ids, 1);
+    uint32_t found = 0;
+    Stopwatch watch;
+    for(size_t i = 0; i < count; ++i)
+    {
+        uint32_t id;
+        found += pool.find(stream[i], id) ? id : 0;
+    }
+    watch.report("AddressPool::find()", count);
+
+    double copies = static_cast<double>(count) * sizeof(InetAddress);
+    double interned = (static_cast<double>(count) * sizeof(uint32_t)) + pool.getMemoryUsage();
+    std::printf("%lu addresses, %lu distinct\n", static_cast<unsigned long>(count),
+            static_cast<unsigned long>(size));
+    std::printf("InetAddress copies: %.1f MB, ids and pool: %.1f MB (%.1fx smaller)\n",
+            copies / 1e6, interned / 1e6, copies / interned);
+    std::printf("checksum %u\n", found);
+    return 0;
+}
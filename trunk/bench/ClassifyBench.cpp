@@ -0,0 +1,107 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 1000000);
+    std::vector<InetAddressValue> values(count);
+    BenchRandom rnd;
+
+    // Half IPv4, half IPv6; a few leading bytes are forced to the
+    // interesting prefixes so that every branch gets taken.
+    const uint8_t firsts[] = { 10, 127, 169, 172, 192, 224, 239, 0xfe, 0xff, 0x20 };
+    for(size_t i = 0; i < count; ++i)
+    {
+        InetAddressValue& value = values[i];
+        ::memset(&value, 0, sizeof(value));
+        uint64_t bits = rnd.next();
+        if(i & 1)
+        {
+            ::memcpy(value.address + InetAddressValue::IPV4_OFFSET, &bits, 4);
+            value.address[InetAddressValue::IPV4_OFFSET] = firsts[bits % 7];
+            value.family = static_cast<frog::net::AddressFamily::TYPE>(AF_INET);
+        }
+        else
+        {
+            ::memcpy(value.address, &bits, 8);
+            bits = rnd.next();
+            ::memcpy(value.address + 8, &bits, 8);
+            value.address[0] = firsts[7 + bits % 3];
+            value.family = static_cast<frog::net::AddressFamily::TYPE>(AF_INET6);
+        }
+    }
+
+    std::vector<InetAddress> addresses;
+    addresses.reserve(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        addresses.push_back(InetAddress(values[i]));
+    }
+
+    size_t rounds = 20;
+    uint64_t sum = 0;
+    Stopwatch watch;
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            const InetAddress& addr = addresses[i];
+            sum += addr.isLoopbackAddress() + addr.isMulticastAddress() + addr.isLinkLocalAddress() +
+                addr.isSiteLocalAddress() + addr.isMulticastGlobal() + addr.isAnyLocalAddress();
+        }
+    }
+    watch.report("six predicates", rounds * count);
+
+    watch.restart();
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            sum += values[i].classify();
+        }
+    }
+    watch.report("classify()", rounds * count);
+
+    std::vector<uint32_t> out(count);
+    watch.restart();
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        InetAddressValue::classifyBatch(&values[0], count, &out[0]);
+        sum += out[r];
+    }
+    watch.report("classifyBatch()", rounds * count);
+
+    return (sum == 42) ? 1 : 0;
+}
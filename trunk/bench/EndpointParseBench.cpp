@@ -0,0 +1,246 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/IPEndpoint.h>
+#include <frog/IllegalArgumentException.h>
+
+#include <Stopwatch.h>
+
+using frog::net::AddressFamily;
+using frog::net::InetAddress;
+using frog::net::IPEndpoint;
+
+//--------------------------------------------------------------
+// The way endpoints were parsed before IPEndpoint::tryParse():
+// split the string, build an InetAddress, which throws on bad
+// input, then an IPEndpoint.
+static bool splitParse(const std::string& text, in_port_t defaultPort, IPEndpoint& out)
+{
+    std::string host = text;
+    std::string port;
+    bool hasPort = false;
+    if(!text.empty() && (text[0] == '['))
+    {
+        std::string::size_type close = text.find(']');
+        if(close == std::string::npos)
+        {
+            return false;
+        }
+        host = text.substr(1, close - 1);
+        if(close + 1 < text.size())
+        {
+            if(text[close + 1] != ':')
+            {
+                return false;
+            }
+            port = text.substr(close + 2);
+            hasPort = true;
+        }
+    }
+    else
+    {
+        std::string::size_type colon = text.find(':');
+        if((colon != std::string::npos) && (text.find(':', colon + 1) == std::string::npos))
+        {
+            host = text.substr(0, colon);
+            port = text.substr(colon + 1);
+            hasPort = true;
+        }
+    }
+
+    long portNo = defaultPort;
+    if(hasPort)
+    {
+        char* end;
+        portNo = std::strtol(port.c_str(), &end, 10);
+        if(port.empty() || (*end != '\0') || (portNo < 0) || (portNo > 65535))
+        {
+            return false;
+        }
+    }
+
+    try
+    {
+        InetAddress addr(host);
+        out = IPEndpoint(addr, static_cast<in_port_t>(portNo));
+        return true;
+    }
+    catch(const frog::sys::IllegalArgumentException&)
+    {
+        return false;
+    }
+}
+
+//--------------------------------------------------------------
+// Builds a mix of endpoints as found in configurations and proxy
+// headers: mostly IPv4 with a port, some bracketed IPv6, some bare
+// addresses and about 5% garbage.
+static std::string makeEndpoint(BenchRandom& rnd)
+{
+    static const char* garbage[] = { "unknown", "-", "10.1.2.3:", "300.1.2.3:80",
+        "[fe80::1::2]:80", "localhost:8080", "1.2.3.4:70000", "[::1" };
+    char buf[64];
+    uint32_t r = rnd.next32();
+    uint32_t kind = r % 100U;
+    uint32_t a = rnd.next32();
+    uint32_t b = rnd.next32();
+
+    if(kind < 5U)
+    {
+        return garbage[r % (sizeof(garbage) / sizeof(garbage[0]))];
+    }
+    else if(kind < 70U)
+    {
+        std::sprintf(buf, "%u.%u.%u.%u:%u", a >> 24, (a >> 16) & 0xffU, (a >> 8) & 0xffU, a & 0xffU,
+                b & 0xffffU);
+    }
+    else if(kind < 80U)
+    {
+        std::sprintf(buf, "%u.%u.%u.%u", a >> 24, (a >> 16) & 0xffU, (a >> 8) & 0xffU, a & 0xffU);
+    }
+    else
+    {
+        std::sprintf(buf, "[2001:db8:%x:%x::%x]:%u", a >> 16, a & 0xffffU, b >> 16, b & 0xffffU);
+    }
+    return buf;
+}
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 2000000);
+    BenchRandom rnd;
+    std::vector<std::string> input;
+    input.reserve(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        input.push_back(makeEndpoint(rnd));
+    }
+
+    IPEndpoint endpoint;
+    size_t valid = 0;
+    Stopwatch watch;
+    for(size_t i = 0; i < input.size(); ++i)
+    {
+        if(splitParse(input[i], 80, endpoint))
+        {
+            valid += endpoint.port;
+        }
+    }
+    watch.report("split, InetAddress and IPEndpoint", count);
+
+    size_t valid2 = 0;
+    watch.restart();
+    for(size_t i = 0; i < input.size(); ++i)
+    {
+        if(IPEndpoint::tryParse(input[i].data(), input[i].size(), endpoint, 80))
+        {
+            valid2 += endpoint.port;
+        }
+    }
+    watch.report("IPEndpoint::tryParse()", count);
+
+    if(valid != valid2)
+    {
+        std::printf("mismatch: split %lu, tryParse %lu\n",
+                static_cast<unsigned long>(valid), static_cast<unsigned long>(valid2));
+        return 1;
+    }
+
+    // X-Forwarded-For style lists of one to four endpoints.
+    std::vector<std::string> lists;
+    size_t items = 0;
+    for(size_t i = 0; i < count / 2; ++i)
+    {
+        std::string list = input[i];
+        for(uint32_t more = rnd.next32() % 4U; more > 0; --more)
+        {
+            list += ", ";
+            list += input[rnd.next32() % count];
+        }
+        lists.push_back(list);
+    }
+
+    valid = 0;
+    watch.restart();
+    for(size_t i = 0; i < lists.size(); ++i)
+    {
+        std::vector<IPEndpoint> endpoints;
+        std::string::size_type begin = 0;
+        while(true)
+        {
+            std::string::size_type comma = lists[i].find(',', begin);
+            std::string item = lists[i].substr(begin, (comma == std::string::npos) ? std::string::npos
+                    : comma - begin);
+            std::string::size_type first = item.find_first_not_of(" \t");
+            std::string::size_type last = item.find_last_not_of(" \t");
+            item = (first == std::string::npos) ? std::string() : item.substr(first, last - first + 1);
+            if(splitParse(item, 80, endpoint))
+            {
+                endpoints.push_back(endpoint);
+            }
+            else
+            {
+                endpoints.push_back(IPEndpoint());
+            }
+            if(comma == std::string::npos)
+            {
+                break;
+            }
+            begin = comma + 1;
+        }
+        items += endpoints.size();
+        for(size_t k = 0; k < endpoints.size(); ++k)
+        {
+            valid += endpoints[k].port;
+        }
+    }
+    watch.report("split list, per endpoint", items);
+
+    IPEndpoint endpoints[8];
+    size_t items2 = 0;
+    valid2 = 0;
+    watch.restart();
+    for(size_t i = 0; i < lists.size(); ++i)
+    {
+        size_t n = IPEndpoint::tryParseList(lists[i].data(), lists[i].size(), endpoints, 8, 80);
+        items2 += n;
+        for(size_t k = 0; k < n; ++k)
+        {
+            valid2 += endpoints[k].port;
+        }
+    }
+    watch.report("IPEndpoint::tryParseList(), per endpoint", items2);
+
+    if((valid != valid2) || (items != items2))
+    {
+        std::printf("mismatch: split %lu in %lu, tryParseList %lu in %lu\n",
+                static_cast<unsigned long>(valid), static_cast<unsigned long>(items),
+                static_cast<unsigned long>(valid2), static_cast<unsigned long>(items2));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,207 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::InetAddressHash;
+using frog::net::InetAddressCanonicalHash;
+using frog::net::InetAddressCanonicalEqual;
+
+//--------------------------------------------------------------
+// The equality of earlier releases, as a reference point: one memcmp
+// of the address, then the family and the scope id.
+struct MemcmpEqual
+{
+    bool operator()(const InetAddress& a, const InetAddress& b) const
+    {
+        return (::memcmp(a.getValue().address, b.getValue().address, 16) == 0) &&
+            (a.getAddressFamily() == b.getAddressFamily()) && (a.getValue().scope == b.getValue().scope);
+    }
+};
+
+//--------------------------------------------------------------
+struct WordEqual
+{
+    bool operator()(const InetAddress& a, const InetAddress& b) const
+    {
+        return a == b;
+    }
+};
+
+//--------------------------------------------------------------
+// A linear probing hash set of addresses, as found in flow and
+// connection tables: every lookup runs the equality at least once.
+template <typename H, typename E>
+    class AddressSet
+    {
+      public:
+          explicit AddressSet(size_t capacity) : mask_(1), size_(0)
+          {
+              while(mask_ < 2 * capacity)
+              {
+                  mask_ <<= 1;
+              }
+              slots_.resize(mask_);
+              used_.resize(mask_, 0);
+              mask_ -= 1;
+          }
+
+          // Returns true if the address was not in the set.
+          bool insert(const InetAddress& address)
+          {
+              size_t i = hash_(address) & mask_;
+              while(used_[i])
+              {
+                  if(equal_(slots_[i], address))
+                  {
+                      return false;
+                  }
+                  i = (i + 1) & mask_;
+              }
+              slots_[i] = address;
+              used_[i] = 1;
+              ++size_;
+              return true;
+          }
+
+          size_t size() const
+          {
+              return size_;
+          }
+      private:
+          H hash_;
+          E equal_;
+          std::vector<InetAddress> slots_;
+          std::vector<uint8_t> used_;
+          size_t mask_;
+          size_t size_;
+    };
+
+//--------------------------------------------------------------
+template <typename H, typename E>
+    static size_t run(const char* name, const std::vector<InetAddress>& peers,
+            const std::vector<uint32_t>& stream)
+    {
+        AddressSet<H, E> set(peers.size());
+        Stopwatch watch;
+        for(size_t i = 0; i < stream.size(); ++i)
+        {
+            set.insert(peers[stream[i]]);
+        }
+        watch.report(name, stream.size());
+        return set.size();
+    }
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 10000000);
+    const size_t distinct = 4000;
+    BenchRandom rnd;
+
+    // Peers of a dual-stack server: IPv6 clients, and IPv4 clients seen
+    // both as themselves and as IPv4-mapped addresses. Without IPv6
+    // support there are only the IPv4 clients.
+    std::vector<InetAddress> peers;
+    for(size_t i = 0; i < distinct; ++i)
+    {
+        uint32_t r = rnd.next32();
+#ifdef HAVE_IPV6_SUPPORT
+        if((i & 3) == 0)
+        {
+            peers.push_back(InetAddress("2001:db8::") + static_cast<int64_t>(r));
+        }
+        else
+        {
+            InetAddress ipv4 = InetAddress("100.64.0.0") + static_cast<int64_t>(r & 0x3fffff);
+            peers.push_back(ipv4);
+            peers.push_back(InetAddress("::ffff:" + ipv4.toString()));
+        }
+#else
+        peers.push_back(InetAddress("100.64.0.0") + static_cast<int64_t>(r & 0x3fffff));
+#endif
+    }
+    // The peers and the table stay in the caches, so that the time goes
+    // to hashing and comparing rather than to memory.
+    std::vector<uint32_t> stream(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        stream[i] = static_cast<uint32_t>(rnd.next32() % peers.size());
+    }
+
+    run<InetAddressHash, MemcmpEqual>("memcmp operator== (old)", peers, stream);
+    size_t plain = run<InetAddressHash, WordEqual>("word operator==", peers, stream);
+    size_t folded = run<InetAddressCanonicalHash, InetAddressCanonicalEqual>("canonical hash and equality",
+            peers, stream);
+
+    // Equality alone, on a copy of the same address as for a hit in a
+    // table, and on another address as for a collision.
+    std::vector<InetAddress> same(peers);
+    MemcmpEqual memcmpEqual;
+    WordEqual wordEqual;
+    size_t equal = 0;
+    Stopwatch compare;
+    for(size_t i = 1; i < stream.size(); ++i)
+    {
+        equal += memcmpEqual(peers[stream[i]], same[stream[i]]);
+    }
+    compare.report("memcmp operator==, equal (old)", stream.size());
+    compare.restart();
+    for(size_t i = 1; i < stream.size(); ++i)
+    {
+        equal += wordEqual(peers[stream[i]], same[stream[i]]);
+    }
+    compare.report("word operator==, equal", stream.size());
+    compare.restart();
+    for(size_t i = 1; i < stream.size(); ++i)
+    {
+        equal += memcmpEqual(peers[stream[i - 1]], same[stream[i]]);
+    }
+    compare.report("memcmp operator==, unequal (old)", stream.size());
+    compare.restart();
+    for(size_t i = 1; i < stream.size(); ++i)
+    {
+        equal += wordEqual(peers[stream[i - 1]], same[stream[i]]);
+    }
+    compare.report("word operator==, unequal", stream.size());
+
+    std::vector<InetAddress> copies(1024);
+    Stopwatch watch;
+    for(size_t i = 0; i < stream.size(); ++i)
+    {
+        copies[i & 1023] = peers[stream[i]];
+    }
+    watch.report("InetAddress::operator=", stream.size());
+
+    std::printf("%lu keys, %lu after folding IPv4-mapped addresses\n",
+            static_cast<unsigned long>(plain), static_cast<unsigned long>(folded));
+    return (copies[0] == peers[equal & 1]) ? 1 : 0;
+}
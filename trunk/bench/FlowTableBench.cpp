@@ -0,0 +1,195 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <cstdio>
+#include <map>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/IPEndpoint.h>
+#include <frog/FlowKey.h>
+#include <frog/FlowTable.h>
+
+#include <Stopwatch.h>
+
+using frog::net::AddressFamily;
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::IPEndpoint;
+using frog::net::FlowKey4;
+using frog::net::FlowTable;
+
+//--------------------------------------------------------------
+// A flow keyed by IPEndpoint objects, as a reference point.
+struct EndpointFlow
+{
+    IPEndpoint source;
+    IPEndpoint destination;
+    uint8_t protocol;
+
+    bool operator<(const EndpointFlow& other) const
+    {
+        if(source != other.source)
+        {
+            return source < other.source;
+        }
+        if(destination != other.destination)
+        {
+            return destination < other.destination;
+        }
+        return protocol < other.protocol;
+    }
+};
+
+//--------------------------------------------------------------
+// Client flows to a thousand servers on a few ports.
+static FlowKey4 makeFlow(BenchRandom& rnd)
+{
+    static const uint16_t ports[] = { 80, 443, 53, 8080 };
+    uint32_t client = rnd.next32();
+    uint32_t r = rnd.next32();
+    FlowKey4 key;
+    key.source[0] = static_cast<uint8_t>(client >> 24);
+    key.source[1] = static_cast<uint8_t>(client >> 16);
+    key.source[2] = static_cast<uint8_t>(client >> 8);
+    key.source[3] = static_cast<uint8_t>(client);
+    key.destination[0] = 203;
+    key.destination[1] = 0;
+    key.destination[2] = static_cast<uint8_t>((r % 1000) >> 8);
+    key.destination[3] = static_cast<uint8_t>(r % 1000);
+    uint16_t port = static_cast<uint16_t>(1024 + (r >> 16) % 64000);
+    key.sourcePort[0] = static_cast<uint8_t>(port >> 8);
+    key.sourcePort[1] = static_cast<uint8_t>(port);
+    key.destinationPort[0] = static_cast<uint8_t>(ports[(r >> 10) & 3] >> 8);
+    key.destinationPort[1] = static_cast<uint8_t>(ports[(r >> 10) & 3]);
+    key.protocol = ((r >> 12) & 7) ? IPPROTO_TCP : IPPROTO_UDP;
+    return key;
+}
+
+//--------------------------------------------------------------
+// Inserts are timed in blocks, to show the slowest block. That is
+// where a table that rehashes at once would pause; the presized table
+// shows what page faults alone cost.
+static const size_t BLOCK = 1024;
+
+static double insertAll(FlowTable<FlowKey4, uint32_t>& table, const std::vector<FlowKey4>& flows)
+{
+    double slowest = 0;
+    for(size_t base = 0; base < flows.size(); base += BLOCK)
+    {
+        Stopwatch block;
+        size_t end = (base + BLOCK < flows.size()) ? (base + BLOCK) : flows.size();
+        for(size_t i = base; i < end; ++i)
+        {
+            table.insert(flows[i], static_cast<uint32_t>(i));
+        }
+        double secs = block.elapsed();
+        slowest = (secs > slowest) ? secs : slowest;
+    }
+    return slowest;
+}
+
+//--------------------------------------------------------------
+static EndpointFlow toEndpoints(const FlowKey4& key)
+{
+    EndpointFlow flow = { key.getSource(), key.getDestination(), key.protocol };
+    return flow;
+}
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 10000000);
+    BenchRandom rnd;
+    std::vector<FlowKey4> flows(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        flows[i] = makeFlow(rnd);
+    }
+    // Lookups see both directions of random flows.
+    std::vector<FlowKey4> probes(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        const FlowKey4& key = flows[rnd.next32() % count];
+        probes[i] = (i & 1) ? key.reverse() : key;
+    }
+
+    FlowTable<FlowKey4, uint32_t> table;
+    Stopwatch watch;
+    double slowest = insertAll(table, flows);
+    watch.report("FlowTable::insert()", count);
+    std::printf("%lu flows, %.1f bytes per flow, slowest block of %lu inserts %.0f us\n",
+            static_cast<unsigned long>(table.getSize()),
+            static_cast<double>(table.getMemoryUsage()) / static_cast<double>(table.getSize()),
+            static_cast<unsigned long>(BLOCK), slowest * 1e6);
+
+    size_t found = 0;
+    watch.restart();
+    for(size_t i = 0; i < count; ++i)
+    {
+        found += (table.find(probes[i]) != NULL);
+    }
+    watch.report("FlowTable::find(), both directions", count);
+
+    std::vector<uint32_t*> result(count);
+    watch.restart();
+    size_t found2 = table.findMany(&probes[0], count, &result[0]);
+    watch.report("FlowTable::findMany()", count);
+
+    {
+        FlowTable<FlowKey4, uint32_t> sized(count);
+        watch.restart();
+        slowest = insertAll(sized, flows);
+        watch.report("FlowTable::insert(), presized", count);
+        std::printf("slowest block of %lu inserts %.0f us\n", static_cast<unsigned long>(BLOCK), slowest * 1e6);
+    }
+
+    // std::map of IPEndpoint keys on a tenth of the flows, to keep its
+    // memory in bounds.
+    size_t mapped = count / 10;
+    std::map<EndpointFlow, uint32_t> reference;
+    watch.restart();
+    for(size_t i = 0; i < mapped; ++i)
+    {
+        reference.insert(std::make_pair(toEndpoints(flows[i]), static_cast<uint32_t>(i)));
+    }
+    watch.report("std::map<IPEndpoint...>::insert()", mapped);
+
+    size_t found3 = 0;
+    watch.restart();
+    for(size_t i = 0; i < mapped; ++i)
+    {
+        found3 += reference.count(toEndpoints(flows[rnd.next32() % mapped]));
+    }
+    watch.report("std::map<IPEndpoint...>::find()", mapped);
+    // A red-black tree node holds three pointers and a color besides
+    // the key and the value.
+    std::printf("std::map: %lu bytes per flow\n",
+            static_cast<unsigned long>(sizeof(std::pair<const EndpointFlow, uint32_t>) + 4 * sizeof(void*)));
+
+    if((found != count) || (found2 != count) || (found3 != mapped))
+    {
+        std::printf("mismatch: %lu, %lu, %lu\n", static_cast<unsigned long>(found),
+                static_cast<unsigned long>(found2), static_cast<unsigned long>(found3));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/IPEndpoint.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::IPEndpoint;
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 2000000);
+    std::vector<InetAddress> input;
+    BenchRandom rnd;
+    char buf[IPEndpoint::MAX_TEXT_SIZE];
+
+    input.reserve(1024);
+    for(size_t i = 0; i < 1024; ++i)
+    {
+        uint32_t a = rnd.next32();
+        uint32_t b = rnd.next32();
+#ifdef HAVE_IPV6_SUPPORT
+        if(i % 4 == 3)
+        {
+            std::sprintf(buf, "2001:db8:%x:%x::%x:%x", a >> 16, a & 0xffffU, b >> 16, b & 0xffffU);
+        }
+        else
+#endif
+        {
+            std::sprintf(buf, "%u.%u.%u.%u", a >> 24, (a >> 16) & 0xffU, (a >> 8) & 0xffU, a & 0xffU);
+        }
+        input.push_back(InetAddress(buf));
+    }
+
+    size_t total = 0;
+    Stopwatch watch;
+    for(size_t i = 0; i < count; ++i)
+    {
+        total += input[i & 1023].getHostAddress().size();
+    }
+    watch.report("InetAddress::getHostAddress()", count);
+
+    size_t total2 = 0;
+    watch.restart();
+    for(size_t i = 0; i < count; ++i)
+    {
+        total2 += input[i & 1023].format(buf, sizeof(buf));
+    }
+    watch.report("InetAddress::format()", count);
+
+    size_t total3 = 0;
+    watch.restart();
+    for(size_t i = 0; i < count; ++i)
+    {
+        IPEndpoint endpoint(input[i & 1023], static_cast<in_port_t>(i));
+        total3 += endpoint.toString().size();
+    }
+    watch.report("IPEndpoint::toString()", count);
+
+    size_t total4 = 0;
+    watch.restart();
+    for(size_t i = 0; i < count; ++i)
+    {
+        IPEndpoint endpoint(input[i & 1023], static_cast<in_port_t>(i));
+        total4 += endpoint.format(buf, sizeof(buf));
+    }
+    watch.report("IPEndpoint::format()", count);
+
+    return ((total == total2) && (total3 == total4)) ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#include <arpa/inet.h>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/IPEndpoint.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::IPEndpoint;
+
+//--------------------------------------------------------------
+// Byte-at-a-time FNV-1a, as a reference point.
+static uint64_t fnv1a(const InetAddressValue& value)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for(size_t i = 0; i < sizeof(value); ++i)
+    {
+        h = (h ^ p[i]) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+//--------------------------------------------------------------
+// Prints how many 32-bit hash codes collide and how evenly the low bits
+// fill a power-of-two bucket array as large as the input.
+static void reportCollisions(const char* name, const std::vector<InetAddress>& input)
+{
+    std::vector<uint32_t> codes(input.size());
+    std::vector<uint32_t> buckets(input.size(), 0);
+    size_t mask = 1;
+    while(mask < input.size())
+    {
+        mask <<= 1;
+    }
+    buckets.resize(mask, 0);
+    mask -= 1;
+
+    for(size_t i = 0; i < input.size(); ++i)
+    {
+        codes[i] = static_cast<uint32_t>(input[i].hashCode());
+        ++buckets[static_cast<size_t>(input[i].getValue().hash()) & mask];
+    }
+
+    std::sort(codes.begin(), codes.end());
+    size_t collisions = codes.end() - std::unique(codes.begin(), codes.end());
+    double n = static_cast<double>(input.size());
+    double expected = (n * n) / (2.0 * 4294967296.0);
+
+    size_t empty = 0, longest = 0;
+    for(size_t i = 0; i < buckets.size(); ++i)
+    {
+        empty += (buckets[i] == 0);
+        longest = std::max<size_t>(longest, buckets[i]);
+    }
+
+    std::printf("%-28s hashCode() collisions %6lu (ideal ~%.0f), empty buckets %.1f%%, longest chain %lu\n",
+            name, static_cast<unsigned long>(collisions), expected,
+            (100.0 * empty) / buckets.size(), static_cast<unsigned long>(longest));
+}
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 1000000);
+    std::vector<InetAddress> sequential4, random4, sequential6;
+    BenchRandom rnd;
+    struct in_addr in4;
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        in4.s_addr = htonl(0x0a000000U + static_cast<uint32_t>(i));
+        sequential4.push_back(InetAddress(in4));
+        in4.s_addr = rnd.next32();
+        random4.push_back(InetAddress(in4));
+#ifdef HAVE_IPV6_SUPPORT
+        struct in6_addr in6;
+        ::memset(&in6, 0, sizeof(in6));
+        in6.s6_addr[0] = 0x20;
+        in6.s6_addr[1] = 0x01;
+        in6.s6_addr[2] = 0x0d;
+        in6.s6_addr[3] = 0xb8;
+        in6.s6_addr[15] = static_cast<uint8_t>(i);
+        in6.s6_addr[14] = static_cast<uint8_t>(i >> 8);
+        in6.s6_addr[13] = static_cast<uint8_t>(i >> 16);
+        sequential6.push_back(InetAddress(in6));
+#endif
+    }
+
+    reportCollisions("sequential IPv4 (10/8)", sequential4);
+    reportCollisions("random IPv4", random4);
+#ifdef HAVE_IPV6_SUPPORT
+    reportCollisions("sequential IPv6 (2001:db8::)", sequential6);
+#endif
+
+    size_t rounds = 20;
+    uint64_t sum = 0;
+    Stopwatch watch;
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            sum += random4[i].getValue().hash();
+        }
+    }
+    watch.report("InetAddressValue::hash()", rounds * count);
+
+    watch.restart();
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            sum += fnv1a(random4[i].getValue());
+        }
+    }
+    watch.report("FNV-1a byte loop", rounds * count);
+
+    watch.restart();
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            IPEndpoint endpoint(random4[i], static_cast<in_port_t>(i));
+            sum += endpoint.hash();
+        }
+    }
+    watch.report("IPEndpoint::hash()", rounds * count);
+
+    return (sum == 42) ? 1 : 0;
+}
@@ -0,0 +1,156 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/IPEndpoint.h>
+#include <frog/NetworkInterface.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::IPEndpoint;
+using frog::net::NetworkInterface;
+
+//--------------------------------------------------------------
+// Every heap allocation made by the benchmark goes through here.
+static uint64_t allocations = 0;
+
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+    ++allocations;
+    void* p = std::malloc(size ? size : 1);
+    if(!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) throw()
+{
+    std::free(p);
+}
+
+//--------------------------------------------------------------
+static void reportAllocations(const char* name, uint64_t allocs, uint64_t ops)
+{
+    std::printf("%-40s %12.2f allocs/op\n", name,
+            static_cast<double>(allocs) / static_cast<double>(ops));
+}
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 100000);
+    size_t sum = 0;
+    uint64_t before;
+
+    std::printf("sizeof(InetAddress) %lu, sizeof(IPEndpoint) %lu, sizeof(NetworkInterface) %lu\n",
+            static_cast<unsigned long>(sizeof(InetAddress)),
+            static_cast<unsigned long>(sizeof(IPEndpoint)),
+            static_cast<unsigned long>(sizeof(NetworkInterface)));
+
+    Stopwatch watch;
+    before = allocations;
+    for(size_t i = 0; i < count / 10; ++i)
+    {
+        sum += NetworkInterface::getNetworkInterfaces().size();
+    }
+    watch.report("getNetworkInterfaces", count / 10);
+    reportAllocations("getNetworkInterfaces", allocations - before, count / 10);
+
+    const std::vector<NetworkInterface> interfaces = NetworkInterface::getNetworkInterfaces();
+
+    // Walking the addresses of every interface, the way
+    // InetAddress::getLocalHost() does.
+    watch.restart();
+    before = allocations;
+    for(size_t i = 0; i < count; ++i)
+    {
+        for(size_t k = 0; k < interfaces.size(); ++k)
+        {
+            // What the by-value getInterfaceAddresses() of earlier
+            // releases did on every call.
+            NetworkInterface::InterfaceAddrList addrList = interfaces[k].getInterfaceAddresses();
+            sum += addrList.size();
+        }
+    }
+    watch.report("walk addresses, list copied (old)", count);
+    reportAllocations("walk addresses, list copied (old)", allocations - before, count);
+    watch.restart();
+    before = allocations;
+    for(size_t i = 0; i < count; ++i)
+    {
+        for(size_t k = 0; k < interfaces.size(); ++k)
+        {
+            const NetworkInterface::InterfaceAddrList& addrList = interfaces[k].getInterfaceAddresses();
+            sum += addrList.size();
+        }
+    }
+    watch.report("walk addresses, by reference", count);
+    reportAllocations("walk addresses, by reference", allocations - before, count);
+
+    // Passing interfaces and endpoints around in containers.
+    watch.restart();
+    before = allocations;
+    for(size_t i = 0; i < count / 10; ++i)
+    {
+        std::vector<NetworkInterface> grown;
+        for(size_t k = 0; k < 16; ++k)
+        {
+            grown.push_back(interfaces[k % interfaces.size()]);
+        }
+        sum += grown.size();
+    }
+    watch.report("vector<NetworkInterface>, 16 pushes", count / 10);
+    reportAllocations("vector<NetworkInterface>, 16 pushes", allocations - before, count / 10);
+
+    std::vector<IPEndpoint> endpoints;
+    for(size_t k = 0; k < interfaces.size(); ++k)
+    {
+        const NetworkInterface::InterfaceAddrList& addrList = interfaces[k].getInterfaceAddresses();
+        for(size_t j = 0; j < addrList.size(); ++j)
+        {
+            InetAddress addr = addrList[j].unicast;
+            endpoints.push_back(IPEndpoint(addr, static_cast<in_port_t>(1024 + j)));
+        }
+    }
+    std::vector<IPEndpoint> copies(endpoints.size());
+    watch.restart();
+    before = allocations;
+    for(size_t i = 0; i < count; ++i)
+    {
+        for(size_t k = 0; k < endpoints.size(); ++k)
+        {
+            copies[k] = endpoints[k];
+            sum += copies[k].port;
+        }
+    }
+    watch.report("copy local IPEndpoints", count);
+    reportAllocations("copy local IPEndpoints", allocations - before, count);
+
+    std::printf("checksum %lu\n", static_cast<unsigned long>(sum));
+    return 0;
+}
@@ -0,0 +1,141 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <vector>
+
+#include <frog/Ipv4Set.h>
+
+#include <Stopwatch.h>
+
+using frog::net::Ipv4Set;
+
+//--------------------------------------------------------------
+// Per-minute sets of sources: most from a busy population of a few
+// million addresses, the rest from anywhere.
+int main(int argc, char* argv[])
+{
+    size_t perMinute = benchIterations(argc, argv, 300000);
+    const size_t minutes = 60;
+    BenchRandom rnd;
+
+    std::vector<Ipv4Set> sets(minutes);
+    std::vector<std::vector<uint32_t> > arrays(minutes);
+    size_t total = 0;
+    for(size_t m = 0; m < minutes; ++m)
+    {
+        for(size_t i = 0; i < perMinute; ++i)
+        {
+            uint32_t address = ((i % 10) < 7) ? (0x0a000000U | (rnd.next32() & 0x3fffff)) : rnd.next32();
+            sets[m].add(address);
+            arrays[m].push_back(address);
+        }
+        sets[m].optimize();
+        std::sort(arrays[m].begin(), arrays[m].end());
+        arrays[m].erase(std::unique(arrays[m].begin(), arrays[m].end()), arrays[m].end());
+        total += arrays[m].size();
+    }
+
+    size_t memory = 0, serialized = 0;
+    for(size_t m = 0; m < minutes; ++m)
+    {
+        memory += sets[m].getMemoryUsage();
+        serialized += sets[m].getSerializedSize();
+    }
+    std::printf("%-40s %10.2f bytes/address\n", "Ipv4Set memory", static_cast<double>(memory) / total);
+    std::printf("%-40s %10.2f bytes/address\n", "Ipv4Set serialized", static_cast<double>(serialized) / total);
+    std::printf("%-40s %10.2f bytes/address\n", "sorted array", 4.0);
+
+    Stopwatch watch;
+    std::vector<const Ipv4Set*> pointers;
+    for(size_t m = 0; m < minutes; ++m)
+    {
+        pointers.push_back(&sets[m]);
+    }
+    Ipv4Set hour = Ipv4Set::unionOf(&pointers[0], pointers.size());
+    watch.report("Ipv4Set::unionOf 60 sets", total);
+
+    watch.restart();
+    Ipv4Set chained;
+    for(size_t m = 0; m < minutes; ++m)
+    {
+        chained = chained.setUnion(sets[m]);
+    }
+    watch.report("Ipv4Set::setUnion chain", total);
+
+    watch.restart();
+    std::vector<uint32_t> merged, next;
+    for(size_t m = 0; m < minutes; ++m)
+    {
+        next.clear();
+        std::set_union(merged.begin(), merged.end(), arrays[m].begin(), arrays[m].end(), std::back_inserter(next));
+        merged.swap(next);
+    }
+    watch.report("std::set_union chain", total);
+
+    if((hour != chained) || (hour.getCardinality() != merged.size()))
+    {
+        std::printf("unions differ\n");
+        return 1;
+    }
+
+    size_t pairs = 0;
+    uint64_t common = 0;
+    watch.restart();
+    for(size_t m = 1; m < minutes; ++m, ++pairs)
+    {
+        common += sets[m].intersectionCardinality(sets[m - 1]);
+    }
+    watch.report("Ipv4Set::intersectionCardinality", pairs * perMinute);
+
+    uint64_t expected = 0;
+    watch.restart();
+    for(size_t m = 1; m < minutes; ++m)
+    {
+        next.clear();
+        std::set_intersection(arrays[m].begin(), arrays[m].end(), arrays[m - 1].begin(), arrays[m - 1].end(),
+                std::back_inserter(next));
+        expected += next.size();
+    }
+    watch.report("std::set_intersection", pairs * perMinute);
+
+    watch.restart();
+    uint64_t built = 0;
+    for(size_t m = 1; m < minutes; ++m)
+    {
+        built += sets[m].setIntersection(sets[m - 1]).getCardinality();
+    }
+    watch.report("Ipv4Set::setIntersection", pairs * perMinute);
+
+    if((common != expected) || (built != expected))
+    {
+        std::printf("intersections differ\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> bytes;
+    watch.restart();
+    hour.serialize(bytes);
+    Ipv4Set copy = Ipv4Set::deserialize(bytes);
+    watch.report("serialize and deserialize", hour.getCardinality());
+    return (copy == hour) ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/InetAddressLoader.h>
+#include <frog/Exception.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::InetAddressLoader;
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 2000000);
+    std::ostringstream name;
+    name << "/tmp/LoaderBench." << ::getpid() << ".txt";
+    std::string path = name.str();
+    BenchRandom rnd;
+
+    // Three IPv4 addresses for each IPv6 address, and a bad line now
+    // and then.
+    FILE* file = ::fopen(path.c_str(), "w");
+    for(size_t i = 0; i < count; ++i)
+    {
+        uint64_t bits = rnd.next();
+        if(i % 10000 == 9999)
+        {
+            ::fputs("not an address\n", file);
+        }
+        else if(i & 3)
+        {
+            ::fprintf(file, "%u.%u.%u.%u\n", static_cast<unsigned>(bits >> 56), static_cast<unsigned>((bits >> 48) & 0xFF),
+                    static_cast<unsigned>((bits >> 40) & 0xFF), static_cast<unsigned>((bits >> 32) & 0xFF));
+        }
+        else
+        {
+            ::fprintf(file, "2001:db8:%x:%x::%x\n", static_cast<unsigned>(bits >> 48),
+                    static_cast<unsigned>((bits >> 32) & 0xFFFF), static_cast<unsigned>(bits & 0xFFFF));
+        }
+    }
+    ::fclose(file);
+
+    size_t bad = 0;
+    std::vector<InetAddress> addresses;
+    Stopwatch watch;
+    std::ifstream in(path.c_str());
+    std::string line;
+    while(std::getline(in, line))
+    {
+        try
+        {
+            addresses.push_back(InetAddress(line));
+        }
+        catch(frog::sys::Exception&)
+        {
+            ++bad;
+        }
+    }
+    watch.report("InetAddress(std::string) loop", count);
+
+    long online = ::sysconf(_SC_NPROCESSORS_ONLN);
+    for(size_t threads = 1; threads <= static_cast<size_t>(online); threads *= 2)
+    {
+        InetAddressLoader loader(threads);
+        watch.restart();
+        loader.load(path);
+        char label[64];
+        ::snprintf(label, sizeof(label), "InetAddressLoader, %lu threads", static_cast<unsigned long>(threads));
+        watch.report(label, count);
+        bad += loader.getBadLines().size();
+    }
+
+    ::unlink(path.c_str());
+    return (bad == 0) ? 1 : 0;
+}
@@ -0,0 +1,240 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <fcntl.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/NetworkInterface.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::NetworkInterface;
+
+//--------------------------------------------------------------
+// What NetworkInterface::findAll() of earlier releases built.
+struct OldInterface
+{
+    std::string name;
+    uint32_t index;
+    NetworkInterface::InterfaceAddrList addressList;
+};
+
+class OldNameEqual
+{
+  public:
+      OldNameEqual(const std::string name) : name_(name) { }
+      bool operator()(const OldInterface intface)
+      {
+          return (name_ == intface.name);
+      }
+  private:
+      std::string name_;
+};
+
+//--------------------------------------------------------------
+// The enumeration of earlier releases, as a reference point:
+// ::getifaddrs(), an if_nametoindex() call and three InetAddress
+// allocations for every address, and a linear search of the
+// interfaces found so far.
+static size_t oldFindAll(std::vector<OldInterface>& interfaces)
+{
+    struct ifaddrs* list;
+    if(::getifaddrs(&list) == -1)
+    {
+        return 0;
+    }
+
+    for(struct ifaddrs* entry = list; entry; entry = entry->ifa_next)
+    {
+        if(!entry->ifa_addr || ((entry->ifa_flags & IFF_UP) == 0)
+#ifdef HAVE_IPV6_SUPPORT
+                || ((entry->ifa_addr->sa_family != AF_INET) && (entry->ifa_addr->sa_family != AF_INET6)))
+#else
+                || (entry->ifa_addr->sa_family != AF_INET))
+#endif
+        {
+            continue;
+        }
+
+        uint32_t index = ::if_nametoindex(entry->ifa_name);
+        InetAddress* addr_p = NULL;
+        InetAddress* netmask_p = NULL;
+        InetAddress* broadcast_p = NULL;
+
+        if(entry->ifa_addr->sa_family == AF_INET)
+        {
+            addr_p = new InetAddress(reinterpret_cast<struct sockaddr_in*>(entry->ifa_addr)->sin_addr);
+            if(entry->ifa_netmask)
+                netmask_p = new InetAddress(reinterpret_cast<struct sockaddr_in*>(entry->ifa_netmask)->sin_addr);
+            if(entry->ifa_broadaddr)
+                broadcast_p = new InetAddress(reinterpret_cast<struct sockaddr_in*>(entry->ifa_broadaddr)->sin_addr);
+        }
+#ifdef HAVE_IPV6_SUPPORT
+        else
+        {
+            addr_p = new InetAddress(reinterpret_cast<struct sockaddr_in6*>(entry->ifa_addr)->sin6_addr, index);
+            if(entry->ifa_netmask)
+                netmask_p = new InetAddress(reinterpret_cast<struct sockaddr_in6*>(entry->ifa_netmask)->sin6_addr);
+            if(entry->ifa_broadaddr)
+                broadcast_p = new InetAddress(reinterpret_cast<struct sockaddr_in6*>(entry->ifa_broadaddr)->sin6_addr);
+        }
+#endif
+
+        NetworkInterface::InterfaceAddress addrs;
+        addrs.unicast = *addr_p;
+        if(netmask_p)
+            addrs.netmask = *netmask_p;
+        if(broadcast_p)
+            addrs.broadcast = *broadcast_p;
+
+        std::vector<OldInterface>::iterator iter = std::find_if(interfaces.begin(),
+                interfaces.end(), OldNameEqual(std::string(entry->ifa_name)));
+        if(iter == interfaces.end())
+        {
+            OldInterface intface;
+            intface.name = std::string(entry->ifa_name);
+            intface.index = index;
+            intface.addressList.push_back(addrs);
+            interfaces.push_back(intface);
+        }
+        else
+        {
+            iter->addressList.push_back(addrs);
+        }
+
+        delete addr_p;
+        delete netmask_p;
+        delete broadcast_p;
+    }
+
+    ::freeifaddrs(list);
+    return interfaces.size();
+}
+
+//--------------------------------------------------------------
+// Moves to a network namespace of our own and fills it with
+// @arg count interfaces of type @arg kind, each with an IPv4 and an
+// IPv6 address. Needs root and ip(8); if the interfaces cannot be
+// created, stays in the namespace of the host and returns false.
+static bool makeInterfaces(size_t count, const char* kind)
+{
+    if(::geteuid() != 0)
+    {
+        return false;
+    }
+
+    int host = ::open("/proc/self/ns/net", O_RDONLY);
+    if(host == -1)
+    {
+        return false;
+    }
+    if(::unshare(CLONE_NEWNET) == -1)
+    {
+        ::close(host);
+        return false;
+    }
+
+    // ip(8) stops at the first command that fails.
+    void (*handler)(int) = ::signal(SIGPIPE, SIG_IGN);
+    FILE* ip = ::popen("ip -batch - >/dev/null 2>&1", "w");
+    bool created = false;
+
+    if(ip)
+    {
+        std::fprintf(ip, "link set lo up\n");
+        for(size_t i = 1; i <= count; ++i)
+        {
+            std::fprintf(ip, "link add frog%lu type %s\n", static_cast<unsigned long>(i), kind);
+            std::fprintf(ip, "link set frog%lu up\n", static_cast<unsigned long>(i));
+            std::fprintf(ip, "addr add 10.%lu.%lu.1/24 dev frog%lu\n", static_cast<unsigned long>(i >> 8),
+                    static_cast<unsigned long>(i & 0xff), static_cast<unsigned long>(i));
+            std::fprintf(ip, "addr add fd00:%lx::1/64 dev frog%lu nodad\n", static_cast<unsigned long>(i),
+                    static_cast<unsigned long>(i));
+        }
+        created = (::pclose(ip) == 0);
+    }
+    ::signal(SIGPIPE, handler);
+
+    if(!created)
+    {
+        ::setns(host, CLONE_NEWNET);
+    }
+    ::close(host);
+    return created;
+}
+
+//--------------------------------------------------------------
+// NetlinkBench [interfaces [link type]]. The link type defaults to
+// "dummy"; "bridge" works where the dummy module is missing.
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 2000);
+    const char* kind = (argc > 2) ? argv[2] : "dummy";
+
+    if(!makeInterfaces(count, kind))
+    {
+        std::printf("could not create %lu %s interfaces (needs root, ip(8) and that link type),"
+                " measuring the interfaces of this host\n", static_cast<unsigned long>(count), kind);
+    }
+
+    size_t rounds = 10;
+    size_t sum = 0;
+
+    Stopwatch watch;
+    for(size_t i = 0; i < rounds; ++i)
+    {
+        std::vector<OldInterface> interfaces;
+        sum += oldFindAll(interfaces);
+    }
+    watch.report("getifaddrs and find_if (old)", rounds);
+    watch.restart();
+    for(size_t i = 0; i < rounds; ++i)
+    {
+        sum += NetworkInterface::getNetworkInterfaces().size();
+    }
+    watch.report("getNetworkInterfaces", rounds);
+
+    std::vector<OldInterface> oldInterfaces;
+    oldFindAll(oldInterfaces);
+    std::vector<NetworkInterface> interfaces = NetworkInterface::getNetworkInterfaces();
+    size_t addresses = 0;
+    for(size_t i = 0; i < interfaces.size(); ++i)
+    {
+        addresses += interfaces[i].getInterfaceAddresses().size();
+    }
+    std::printf("%lu interfaces (%lu before), %lu addresses\n",
+            static_cast<unsigned long>(interfaces.size()),
+            static_cast<unsigned long>(oldInterfaces.size()),
+            static_cast<unsigned long>(addresses));
+
+    std::printf("checksum %lu\n", static_cast<unsigned long>(sum));
+    return 0;
+}
@@ -0,0 +1,162 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/IllegalArgumentException.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+
+//--------------------------------------------------------------
+// Builds a log-like mix of client addresses: mostly IPv4, some IPv6
+// and about 5% garbage.
+static void makeInput(std::vector<std::string>& input, size_t count)
+{
+    static const char* garbage[] = { "unknown", "-", "10.1.2", "300.1.2.3",
+        "fe80::1::2", "localhost", "1.2.3.4.5", "::g" };
+    BenchRandom rnd;
+    char buf[64];
+
+    input.reserve(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        uint32_t r = rnd.next32();
+        uint32_t kind = r % 100U;
+        if(kind < 5U)
+        {
+            input.push_back(garbage[r % (sizeof(garbage) / sizeof(garbage[0]))]);
+            continue;
+        }
+
+        uint32_t a = rnd.next32();
+        if(kind < 75U)
+        {
+            std::sprintf(buf, "%u.%u.%u.%u", a >> 24, (a >> 16) & 0xffU, (a >> 8) & 0xffU, a & 0xffU);
+        }
+        else
+        {
+            uint32_t b = rnd.next32();
+            std::sprintf(buf, "2001:db8:%x:%x::%x:%x", a >> 16, a & 0xffffU, b >> 16, b & 0xffffU);
+        }
+        input.push_back(buf);
+    }
+}
+
+//--------------------------------------------------------------
+// Compares a tryParse() loop with tryParseBatch() on the given texts.
+static bool benchBatch(const std::vector<std::string>& input, const char* loopName, const char* batchName)
+{
+    size_t count = input.size();
+    std::vector<const char*> texts(count);
+    std::vector<size_t> lengths(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        texts[i] = input[i].data();
+        lengths[i] = input[i].size();
+    }
+    std::vector<InetAddressValue> values(count);
+
+    size_t valid = 0;
+    Stopwatch watch;
+    for(size_t i = 0; i < count; ++i)
+    {
+        valid += InetAddress::tryParse(texts[i], lengths[i], values[i]);
+    }
+    watch.report(loopName, count);
+
+    watch.restart();
+    size_t valid2 = InetAddress::tryParseBatch(&texts[0], &lengths[0], count, &values[0]);
+    watch.report(batchName, count);
+
+    if(valid != valid2)
+    {
+        std::printf("mismatch: tryParse %lu, tryParseBatch %lu\n",
+                static_cast<unsigned long>(valid), static_cast<unsigned long>(valid2));
+        return false;
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 2000000);
+    std::vector<std::string> input;
+    makeInput(input, count);
+
+    size_t valid = 0;
+    Stopwatch watch;
+    for(size_t i = 0; i < input.size(); ++i)
+    {
+        try
+        {
+            InetAddress addr(input[i]);
+            valid += addr.isIPv4Compatible() ? 1 : 2;
+        }
+        catch(const frog::sys::IllegalArgumentException&)
+        {
+        }
+    }
+    watch.report("InetAddress(const std::string&)", count);
+
+    size_t valid2 = 0;
+    watch.restart();
+    for(size_t i = 0; i < input.size(); ++i)
+    {
+        InetAddress addr;
+        if(InetAddress::tryParse(input[i].data(), input[i].size(), addr))
+        {
+            valid2 += addr.isIPv4Compatible() ? 1 : 2;
+        }
+    }
+    watch.report("InetAddress::tryParse()", count);
+
+    if(valid != valid2)
+    {
+        std::printf("mismatch: constructor %lu, tryParse %lu\n",
+                static_cast<unsigned long>(valid), static_cast<unsigned long>(valid2));
+        return 1;
+    }
+
+    std::vector<std::string> quads;
+    quads.reserve(count);
+    BenchRandom rnd;
+    char buf[16];
+    for(size_t i = 0; i < count; ++i)
+    {
+        uint32_t a = rnd.next32();
+        std::sprintf(buf, "%u.%u.%u.%u", a >> 24, (a >> 16) & 0xffU, (a >> 8) & 0xffU, a & 0xffU);
+        quads.push_back(buf);
+    }
+    if(!benchBatch(input, "tryParse() into InetAddressValue, mixed", "tryParseBatch(), mixed") ||
+            !benchBatch(quads, "tryParse() into InetAddressValue, IPv4", "tryParseBatch(), IPv4"))
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/Subnet.h>
+#include <frog/PrefixTable.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::Subnet;
+using frog::net::PrefixTable;
+
+//--------------------------------------------------------------
+// Makes an IPv4 InetAddressValue.
+static InetAddressValue makeValue4(uint32_t addr)
+{
+    struct in_addr in;
+    in.s_addr = htonl(addr);
+    return InetAddress(in).getValue();
+}
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 1000000);
+    BenchRandom rnd;
+
+    // Prefix lengths roughly follow a BGP table: mostly /24, then /16
+    // to /23, and a few longer ones.
+    std::vector<PrefixTable<uint32_t>::Route> routes;
+    routes.reserve(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        uint32_t r = rnd.next32() % 100;
+        uint32_t prefixLength = (r < 60) ? 24 : (r < 95) ? 16 + r % 8 : 25 + r % 8;
+        InetAddress network(makeValue4(rnd.next32()));
+        routes.push_back(PrefixTable<uint32_t>::Route(Subnet(network, prefixLength),
+                    static_cast<uint32_t>(i)));
+    }
+
+    Stopwatch watch;
+    PrefixTable<uint32_t> table(routes);
+    watch.report("build (per prefix)", count);
+
+    size_t probes = 1 << 22;
+    std::vector<InetAddressValue> input(probes);
+    for(size_t i = 0; i < probes; ++i)
+    {
+        input[i] = makeValue4(rnd.next32());
+    }
+
+    size_t rounds = 10;
+    uint64_t sum = 0;
+    watch.restart();
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        for(size_t i = 0; i < probes; ++i)
+        {
+            const uint32_t* value = table.lookup(input[i]);
+            sum += (value != NULL) ? *value : 0;
+        }
+    }
+    watch.report("IPv4 lookup()", rounds * probes);
+
+    std::vector<const uint32_t*> result(probes);
+    watch.restart();
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        sum += table.lookupMany(&input[0], probes, &result[0]);
+    }
+    watch.report("IPv4 lookupMany()", rounds * probes);
+
+    // The std::map approach this table replaces: one map per prefix
+    // length, probed from the longest length down.
+    std::vector<std::map<uint32_t, uint32_t> > maps(33);
+    for(size_t i = 0; i < routes.size(); ++i)
+    {
+        InetAddressValue network = routes[i].first.getNetwork().getValue();
+        uint32_t key;
+        ::memcpy(&key, network.address + InetAddressValue::IPV4_OFFSET, sizeof(key));
+        maps[routes[i].first.getPrefixLength()][ntohl(key)] = routes[i].second;
+    }
+    size_t mapProbes = probes / 16;
+    watch.restart();
+    for(size_t i = 0; i < mapProbes; ++i)
+    {
+        uint32_t key;
+        ::memcpy(&key, input[i].address + InetAddressValue::IPV4_OFFSET, sizeof(key));
+        key = ntohl(key);
+        for(int length = 32; length >= 0; --length)
+        {
+            uint32_t mask = (length == 0) ? 0 : (0xffffffffU << (32 - length));
+            std::map<uint32_t, uint32_t>::const_iterator it = maps[length].find(key & mask);
+            if(it != maps[length].end())
+            {
+                sum += it->second;
+                break;
+            }
+        }
+    }
+    watch.report("std::map per prefix length", mapProbes);
+
+#ifdef HAVE_IPV6_SUPPORT
+    std::vector<PrefixTable<uint32_t>::Route> routes6;
+    std::vector<InetAddressValue> input6(probes);
+    for(size_t i = 0; i < count / 4; ++i)
+    {
+        InetAddressValue value;
+        ::memset(&value, 0, sizeof(value));
+        value.family = static_cast<frog::net::AddressFamily::TYPE>(AF_INET6);
+        value.address[0] = 0x20;
+        value.address[1] = 0x01;
+        uint64_t bits = rnd.next();
+        ::memcpy(value.address + 2, &bits, 6);
+        uint32_t prefixLength = 32 + rnd.next32() % 17;
+        routes6.push_back(PrefixTable<uint32_t>::Route(Subnet(InetAddress(value), prefixLength),
+                    static_cast<uint32_t>(i)));
+    }
+    for(size_t i = 0; i < probes; ++i)
+    {
+        input6[i] = routes6[i % routes6.size()].first.getNetwork().getValue();
+        input6[i].address[15] = static_cast<uint8_t>(i);
+    }
+
+    PrefixTable<uint32_t> table6(routes6);
+    watch.restart();
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        for(size_t i = 0; i < probes; ++i)
+        {
+            const uint32_t* value = table6.lookup(input6[i]);
+            sum += (value != NULL) ? *value : 0;
+        }
+    }
+    watch.report("IPv6 lookup()", rounds * probes);
+#endif
+
+    return (sum == 42) ? 1 : 0;
+}
@@ -0,0 +1,116 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/RangeDatabase.h>
+#include <frog/RangeDatabaseWriter.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::RangeDatabase;
+using frog::net::RangeDatabaseWriter;
+
+//--------------------------------------------------------------
+static InetAddress toAddress(uint32_t key)
+{
+    InetAddressValue value;
+    ::memset(&value, 0, sizeof(value));
+    value.family = static_cast<frog::net::AddressFamily::TYPE>(AF_INET);
+    for(size_t i = 0; i < 4; ++i)
+    {
+        value.address[InetAddressValue::IPV4_OFFSET + i] = static_cast<uint8_t>(key >> (24 - 8 * i));
+    }
+    return InetAddress(value);
+}
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 1000000);
+    std::ostringstream name;
+    name << "/tmp/RangeDatabaseBench." << ::getpid() << ".db";
+    std::string path = name.str();
+    BenchRandom rnd;
+
+    // count ranges spread over the IPv4 space, about a thousand
+    // distinct records, like an AS number table.
+    std::vector<std::string> fields;
+    fields.push_back("asn");
+    fields.push_back("region");
+    RangeDatabaseWriter writer(fields);
+    uint32_t step = static_cast<uint32_t>(0xFFFFFFFFU / count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        uint32_t first = static_cast<uint32_t>(i) * step;
+        uint32_t last = first + static_cast<uint32_t>(rnd.next32() % step);
+        std::ostringstream asn;
+        asn << (64512 + rnd.next32() % 1000);
+        fields[0] = asn.str();
+        fields[1] = (i & 1) ? "eu" : "us";
+        writer.add(toAddress(first), toAddress(last), fields);
+    }
+    Stopwatch watch;
+    writer.write(path);
+    watch.report("write", count);
+
+    RangeDatabase database;
+    size_t opens = 100;
+    watch.restart();
+    for(size_t i = 0; i < opens; ++i)
+    {
+        database.open(path);
+    }
+    watch.report("open (per range)", opens * count);
+
+    std::vector<InetAddressValue> values(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        values[i] = toAddress(rnd.next32()).getValue();
+    }
+    size_t rounds = 10;
+    uint64_t found = 0;
+    RangeDatabase::Record record;
+    watch.restart();
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            found += database.lookup(values[i], record);
+        }
+    }
+    watch.report("lookup", rounds * count);
+    std::printf("found %lu of %lu\n", static_cast<unsigned long>(found),
+            static_cast<unsigned long>(rounds * count));
+
+    ::unlink(path.c_str());
+    return 0;
+}
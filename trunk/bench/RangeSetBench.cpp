@@ -0,0 +1,130 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+
+#include <arpa/inet.h>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/Subnet.h>
+#include <frog/InetAddressRangeSet.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::InetAddressRangeSet;
+using frog::net::Subnet;
+
+//--------------------------------------------------------------
+static InetAddress makeAddress4(uint32_t addr)
+{
+    struct in_addr in;
+    in.s_addr = htonl(addr);
+    return InetAddress(in);
+}
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 1000000);
+    BenchRandom rnd;
+
+    // Overlapping subnets from /16 to /32, as found in block lists.
+    std::vector<Subnet> subnets;
+    subnets.reserve(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        uint32_t prefixLength = 16 + rnd.next32() % 17;
+        subnets.push_back(Subnet(makeAddress4(rnd.next32()), prefixLength));
+    }
+
+    Stopwatch watch;
+    InetAddressRangeSet set;
+    for(size_t i = 0; i < count; ++i)
+    {
+        set.add(subnets[i]);
+    }
+    set.compact();
+    std::printf("%lu ranges\n", static_cast<unsigned long>(set.getRangeCount()));
+    watch.report("build (per entry)", count);
+
+    watch.restart();
+    std::vector<Subnet> cidrs = set.toCidrs();
+    watch.report("toCidrs (per subnet)", cidrs.size());
+
+    size_t probes = 1 << 22;
+    std::vector<InetAddressValue> input(probes);
+    for(size_t i = 0; i < probes; ++i)
+    {
+        input[i] = makeAddress4(rnd.next32()).getValue();
+    }
+
+    size_t rounds = 5;
+    size_t found = 0;
+    watch.restart();
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        for(size_t i = 0; i < probes; ++i)
+        {
+            found += set.contains(input[i]);
+        }
+    }
+    watch.report("contains() Eytzinger", rounds * probes);
+
+    // The same search over the sorted ranges with std::upper_bound.
+    InetAddressRangeSet::RangeList ranges = set.getRanges();
+    std::vector<uint32_t> firsts(ranges.size()), lasts(ranges.size());
+    for(size_t i = 0; i < ranges.size(); ++i)
+    {
+        firsts[i] = ntohl(*reinterpret_cast<const uint32_t*>(ranges[i].first.getValue().address + 12));
+        lasts[i] = ntohl(*reinterpret_cast<const uint32_t*>(ranges[i].second.getValue().address + 12));
+    }
+    watch.restart();
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        for(size_t i = 0; i < probes; ++i)
+        {
+            uint32_t key = ntohl(*reinterpret_cast<const uint32_t*>(input[i].address + 12));
+            size_t at = std::upper_bound(firsts.begin(), firsts.end(), key) - firsts.begin();
+            found += (at > 0) && (key <= lasts[at - 1]);
+        }
+    }
+    watch.report("std::upper_bound", rounds * probes);
+
+    InetAddressRangeSet other;
+    for(size_t i = 0; i < count / 2; ++i)
+    {
+        other.add(Subnet(makeAddress4(rnd.next32()), 16 + rnd.next32() % 17));
+    }
+    other.getRangeCount();
+    watch.restart();
+    found += set.setIntersection(other).getRangeCount();
+    found += set.setDifference(other).getRangeCount();
+    found += set.setUnion(other).getRangeCount();
+    watch.report("intersection+difference+union (per range)",
+            set.getRangeCount() + other.getRangeCount());
+
+    std::printf("%lu\n", static_cast<unsigned long>(found));
+    return 0;
+}
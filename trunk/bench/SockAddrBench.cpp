@@ -0,0 +1,168 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/IPEndpoint.h>
+#include <frog/IPEndpointView.h>
+
+#include <Stopwatch.h>
+
+using frog::net::AddressFamily;
+using frog::net::InetAddress;
+using frog::net::IPEndpoint;
+using frog::net::IPEndpointView;
+
+//--------------------------------------------------------------
+// The conversion of earlier releases, as a reference point:
+// getPrimitive() then filling the socket address by hand.
+static socklen_t oldToSockAddr(const IPEndpoint& ep, struct sockaddr_storage& storage)
+{
+    if(ep.getAddressFamily() == AddressFamily::InterNetwork)
+    {
+        struct in_addr raw;
+        ep.address.getPrimitive(raw);
+        struct sockaddr_in* in = reinterpret_cast<struct sockaddr_in*>(&storage);
+        ::memset(in, 0, sizeof(struct sockaddr_in));
+        in->sin_family = AF_INET;
+        in->sin_port = htons(ep.port);
+        in->sin_addr = raw;
+        return sizeof(struct sockaddr_in);
+    }
+#ifdef HAVE_IPV6_SUPPORT
+    struct in6_addr raw;
+    ep.address.getPrimitive(raw);
+    struct sockaddr_in6* in6 = reinterpret_cast<struct sockaddr_in6*>(&storage);
+    ::memset(in6, 0, sizeof(struct sockaddr_in6));
+    in6->sin6_family = AF_INET6;
+    in6->sin6_port = htons(ep.port);
+    in6->sin6_addr = raw;
+    in6->sin6_scope_id = ep.address.getValue().scope;
+    return sizeof(struct sockaddr_in6);
+#else
+    return 0;
+#endif
+}
+
+//--------------------------------------------------------------
+// And back: a new InetAddress and IPEndpoint for every datagram.
+static void oldFromSockAddr(const struct sockaddr_storage& storage, IPEndpoint& ep)
+{
+    if(storage.ss_family == AF_INET)
+    {
+        const struct sockaddr_in* in = reinterpret_cast<const struct sockaddr_in*>(&storage);
+        InetAddress addr(in->sin_addr);
+        ep = IPEndpoint(addr, ntohs(in->sin_port));
+    }
+#ifdef HAVE_IPV6_SUPPORT
+    else
+    {
+        const struct sockaddr_in6* in6 = reinterpret_cast<const struct sockaddr_in6*>(&storage);
+        InetAddress addr(in6->sin6_addr, in6->sin6_scope_id);
+        ep = IPEndpoint(addr, ntohs(in6->sin6_port));
+    }
+#endif
+}
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 10000000);
+    const size_t distinct = 4096;
+    BenchRandom rnd;
+
+    // The peers of a dual-stack UDP server, one in four over IPv6 when
+    // IPv6 is supported.
+    std::vector<IPEndpoint> peers(distinct);
+    std::vector<struct sockaddr_storage> received(distinct);
+    std::vector<socklen_t> lengths(distinct);
+    for(size_t i = 0; i < distinct; ++i)
+    {
+        uint32_t r = rnd.next32();
+#ifdef HAVE_IPV6_SUPPORT
+        InetAddress addr = ((i & 3) == 0) ? InetAddress("2001:db8::") + static_cast<int64_t>(r)
+            : InetAddress("100.64.0.0") + static_cast<int64_t>(r & 0x3fffff);
+#else
+        InetAddress addr = InetAddress("100.64.0.0") + static_cast<int64_t>(r & 0x3fffff);
+#endif
+        peers[i] = IPEndpoint(addr, static_cast<in_port_t>(1024 + (r >> 20)));
+        peers[i].toSockAddr(received[i], lengths[i]);
+    }
+
+    struct sockaddr_storage storage;
+    socklen_t length = 0;
+    size_t sum = 0;
+
+    Stopwatch watch;
+    for(size_t i = 0; i < count; ++i)
+    {
+        sum += oldToSockAddr(peers[i & (distinct - 1)], storage);
+    }
+    watch.report("getPrimitive and fill (old)", count);
+    watch.restart();
+    for(size_t i = 0; i < count; ++i)
+    {
+        peers[i & (distinct - 1)].toSockAddr(storage, length);
+        sum += length;
+    }
+    watch.report("IPEndpoint::toSockAddr", count);
+
+    IPEndpoint ep;
+    watch.restart();
+    for(size_t i = 0; i < count; ++i)
+    {
+        oldFromSockAddr(received[i & (distinct - 1)], ep);
+        sum += ep.port;
+    }
+    watch.report("new InetAddress and IPEndpoint (old)", count);
+    watch.restart();
+    for(size_t i = 0; i < count; ++i)
+    {
+        size_t k = i & (distinct - 1);
+        ep.fromSockAddr(reinterpret_cast<const struct sockaddr*>(&received[k]), lengths[k]);
+        sum += ep.port;
+    }
+    watch.report("IPEndpoint::fromSockAddr", count);
+
+    // Matching a datagram against a known peer, as a connection table does.
+    watch.restart();
+    for(size_t i = 0; i < count; ++i)
+    {
+        size_t k = i & (distinct - 1);
+        ep.fromSockAddr(reinterpret_cast<const struct sockaddr*>(&received[k]), lengths[k]);
+        sum += (ep == peers[k]) + ep.hash();
+    }
+    watch.report("fromSockAddr, hash and compare", count);
+    watch.restart();
+    for(size_t i = 0; i < count; ++i)
+    {
+        size_t k = i & (distinct - 1);
+        IPEndpointView view(received[k], lengths[k]);
+        sum += (view == peers[k]) + view.hash();
+    }
+    watch.report("IPEndpointView, hash and compare", count);
+
+    std::printf("checksum %lu\n", static_cast<unsigned long>(sum));
+    return 0;
+}
@@ -0,0 +1,170 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+
+#include <arpa/inet.h>
+#include <algorithm>
+#include <iterator>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/InetAddressSort.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+
+//--------------------------------------------------------------
+// A sort key with the memcmp order of InetAddressValue::sortKey().
+struct SortKey
+{
+    uint8_t bytes[InetAddressValue::SORT_KEY_SIZE];
+
+    bool operator<(const SortKey& other) const
+    {
+        return (::memcmp(bytes, other.bytes, sizeof(bytes)) < 0);
+    }
+};
+
+//--------------------------------------------------------------
+// The ordering a caller would write without compare(): byte-wise
+// comparison of the address followed by family and scope.
+static bool lessBytewise(const InetAddressValue& a, const InetAddressValue& b)
+{
+    if(a.family != b.family)
+    {
+        return (a.family < b.family);
+    }
+    int result = ::memcmp(a.address, b.address, sizeof(a.address));
+    return (result < 0) || ((result == 0) && (a.scope < b.scope));
+}
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 10000000);
+    std::vector<InetAddressValue> input(count);
+    BenchRandom rnd;
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        InetAddressValue& value = input[i];
+        ::memset(&value, 0, sizeof(value));
+#ifdef HAVE_IPV6_SUPPORT
+        if((i & 3) == 0)
+        {
+            uint64_t high = rnd.next(), low = rnd.next();
+            ::memcpy(value.address, &high, 8);
+            ::memcpy(value.address + 8, &low, 8);
+            value.family = static_cast<frog::net::AddressFamily::TYPE>(AF_INET6);
+            continue;
+        }
+#endif
+        uint32_t addr = rnd.next32();
+        ::memcpy(value.address + InetAddressValue::IPV4_OFFSET, &addr, sizeof(addr));
+        value.family = static_cast<frog::net::AddressFamily::TYPE>(AF_INET);
+    }
+
+    std::vector<InetAddressValue> work(input);
+    Stopwatch watch;
+    std::sort(work.begin(), work.end());
+    watch.report("std::sort InetAddressValue", count);
+
+    work = input;
+    watch.restart();
+    std::sort(work.begin(), work.end(), lessBytewise);
+    watch.report("std::sort memcmp comparator", count);
+
+    std::vector<SortKey> keys(count);
+    watch.restart();
+    for(size_t i = 0; i < count; ++i)
+    {
+        input[i].sortKey(keys[i].bytes);
+    }
+    std::sort(keys.begin(), keys.end());
+    watch.report("std::sort of sortKey()", count);
+
+    std::vector<InetAddressValue> radix(input);
+    watch.restart();
+    frog::net::sortAddresses(radix, 1);
+    watch.report("sortAddresses 1 thread", count);
+
+    radix = input;
+    watch.restart();
+    frog::net::sortAddresses(radix);
+    watch.report("sortAddresses all threads", count);
+
+    // Intersections of the sorted set with a set of the same size and
+    // with one a thousand times smaller.
+    std::vector<InetAddressValue> a(radix);
+    a.resize(frog::net::uniqueAddresses(&a[0], a.size()));
+    std::vector<InetAddressValue> out(a.size());
+    for(size_t ratio = 1; ratio <= 1000; ratio *= 1000)
+    {
+        std::vector<InetAddressValue> b;
+        for(size_t i = 0; i < a.size(); i += 2 * ratio)
+        {
+            b.push_back(a[i]);
+            b.push_back(a[i]);
+            ++b.back().address[15];
+        }
+        std::sort(b.begin(), b.end());
+        b.erase(std::unique(b.begin(), b.end()), b.end());
+
+        std::vector<InetAddressValue> expected;
+        watch.restart();
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        watch.report(ratio == 1 ? "std::set_intersection 1:1" : "std::set_intersection 1000:1", a.size());
+
+        watch.restart();
+        size_t n = frog::net::intersectAddresses(&a[0], a.size(), &b[0], b.size(), &out[0]);
+        watch.report(ratio == 1 ? "intersectAddresses 1:1" : "intersectAddresses 1000:1", a.size());
+        if((n != expected.size()) || !std::equal(expected.begin(), expected.end(), out.begin()))
+        {
+            std::printf("intersection differs\n");
+            return 1;
+        }
+    }
+
+    std::vector<InetAddress> addresses;
+    addresses.reserve(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        addresses.push_back(InetAddress(input[i]));
+    }
+    watch.restart();
+    std::sort(addresses.begin(), addresses.end());
+    watch.report("std::sort InetAddress", count);
+
+    for(size_t i = 1; i < count; ++i)
+    {
+        if(work[i] < work[i - 1] || addresses[i].getValue() < addresses[i - 1].getValue()
+                || radix[i] != work[i])
+        {
+            std::printf("not sorted at %lu\n", static_cast<unsigned long>(i));
+            return 1;
+        }
+    }
+    return 0;
+}
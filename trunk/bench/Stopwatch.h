@@ -0,0 +1,118 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_BENCH_STOPWATCH_H
+#define FROG_BENCH_STOPWATCH_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <sys/time.h>
+#include <cstdio>
+#include <cstdlib>
+
+#include <frog/stdint.h>
+
+/**
+ * Measures the wall clock time spent in a section of a benchmark.
+ */
+class Stopwatch
+{
+  public:
+      /**
+       * Starts the stopwatch.
+       */
+      Stopwatch() { restart(); }
+
+      /**
+       * Resets the stopwatch to zero.
+       */
+      void restart()
+      {
+          ::gettimeofday(&start_, NULL);
+      }
+
+      /**
+       * Returns the number of seconds elapsed since the last restart.
+       */
+      double elapsed() const
+      {
+          struct timeval now;
+          ::gettimeofday(&now, NULL);
+          return (now.tv_sec - start_.tv_sec) + ((now.tv_usec - start_.tv_usec) / 1e6);
+      }
+
+      /**
+       * Prints one line of benchmark results. @arg ops is the number of
+       * operations performed since the stopwatch was restarted.
+       */
+      void report(const char* name, uint64_t ops) const
+      {
+          double secs = elapsed();
+          std::printf("%-40s %12.2f ns/op %14.0f ops/s\n", name,
+                  (secs * 1e9) / static_cast<double>(ops),
+                  static_cast<double>(ops) / secs);
+      }
+  private:
+      struct timeval start_;
+};
+
+/**
+ * A small, fast pseudo-random generator (xorshift64*) so that every
+ * benchmark run sees the same input.
+ */
+class BenchRandom
+{
+  public:
+      explicit BenchRandom(uint64_t seed = 0x9E3779B97F4A7C15ULL) : state_(seed) { }
+
+      uint64_t next()
+      {
+          state_ ^= state_ >> 12;
+          state_ ^= state_ << 25;
+          state_ ^= state_ >> 27;
+          return state_ * 0x2545F4914F6CDD1DULL;
+      }
+
+      uint32_t next32()
+      {
+          return static_cast<uint32_t>(next() >> 32);
+      }
+  private:
+      uint64_t state_;
+};
+
+/**
+ * Returns the number of iterations a benchmark should run. This can be
+ * overridden with the first command line argument.
+ */
+inline size_t benchIterations(int argc, char* argv[], size_t defaultCount)
+{
+    if(argc > 1)
+    {
+        return static_cast<size_t>(std::strtoul(argv[1], NULL, 10));
+    }
+    return defaultCount;
+}
+
+#endif // FROG_BENCH_STOPWATCH_H
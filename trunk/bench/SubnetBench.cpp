@@ -0,0 +1,150 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+
+#include <arpa/inet.h>
+#include <cstdio>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/Subnet.h>
+
+#include <Stopwatch.h>
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::Subnet;
+
+//--------------------------------------------------------------
+// The hand written check that Subnet replaces: mask the unicast and
+// the peer address with the netmask and compare the bytes.
+static bool sameNetwork(const InetAddress& addr, const InetAddress& unicast,
+        const InetAddress& netmask)
+{
+    const InetAddressValue& a = addr.getValue();
+    const InetAddressValue& u = unicast.getValue();
+    const InetAddressValue& m = netmask.getValue();
+    if(a.family != u.family)
+    {
+        return false;
+    }
+    for(size_t i = 0; i < sizeof(a.address); ++i)
+    {
+        if((a.address[i] & m.address[i]) != (u.address[i] & m.address[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    size_t count = benchIterations(argc, argv, 1000000);
+    std::vector<InetAddress> input;
+    std::vector<InetAddressValue> values;
+    BenchRandom rnd;
+
+    input.reserve(count);
+    values.reserve(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        struct in_addr in;
+        // One address in four is in 10/8.
+        in.s_addr = rnd.next32();
+        if((i & 3) == 0)
+        {
+            in.s_addr = htonl(0x0a000000U | (ntohl(in.s_addr) & 0x00ffffffU));
+        }
+        input.push_back(InetAddress(in));
+        values.push_back(input.back().getValue());
+    }
+
+    Subnet subnet("10.0.0.0/8");
+    InetAddress unicast("10.0.0.1");
+    InetAddress netmask("255.0.0.0");
+    size_t rounds = 20;
+    size_t found = 0;
+
+    Stopwatch watch;
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            found += sameNetwork(input[i], unicast, netmask);
+        }
+    }
+    watch.report("byte-wise netmask compare", rounds * count);
+
+    watch.restart();
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            found += subnet.contains(values[i]);
+        }
+    }
+    watch.report("Subnet::contains()", rounds * count);
+
+    std::vector<uint8_t> result(count);
+    watch.restart();
+    for(size_t r = 0; r < rounds; ++r)
+    {
+        found += subnet.containsMany(&values[0], count, &result[0]);
+    }
+    watch.report("Subnet::containsMany()", rounds * count);
+
+    // Walking a /12: formatting and parsing every address against the
+    // iterators.
+    Subnet walk("172.16.0.0/12");
+    size_t walked = 0;
+    uint32_t first = 0xac100000U;
+    watch.restart();
+    for(uint32_t i = 0; i < (1U << 20); ++i)
+    {
+        struct in_addr in;
+        in.s_addr = htonl(first + i);
+        InetAddress addr(InetAddress(in).getHostAddress());
+        walked += addr.getValue().address[15];
+    }
+    watch.report("format and parse each address", 1U << 20);
+
+    watch.restart();
+    Subnet::iterator end = walk.end();
+    for(Subnet::iterator it = walk.begin(); it != end; ++it)
+    {
+        walked += it->getValue().address[15];
+    }
+    watch.report("Subnet::iterator", 1U << 20);
+
+    watch.restart();
+    Subnet::Range shuffled = walk.permutation(1);
+    for(Subnet::iterator it = shuffled.begin(); it != end; ++it)
+    {
+        walked += it->getValue().address[15];
+    }
+    watch.report("Subnet::permutation()", 1U << 20);
+
+    std::printf("%lu matches, %lu walked\n", static_cast<unsigned long>(found / 3),
+            static_cast<unsigned long>(walked));
+    return 0;
+}
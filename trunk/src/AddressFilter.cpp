@@ -0,0 +1,204 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <frog/AddressFilter.h>
+
+namespace frog
+{
+    namespace net
+    {
+        const char AddressFilter::MAGIC[8] = { 'F', 'R', 'O', 'G', 'A', 'M', 'F', '\0' };
+        const uint32_t AddressFilter::FORMAT_VERSION;
+        const uint32_t AddressFilter::BYTE_ORDER_MARK;
+        const uint32_t AddressFilter::KIND_BLOOM;
+        const uint32_t AddressFilter::KIND_CUCKOO;
+        const uint32_t AddressFilter::KIND_XOR;
+
+        //--------------------------------------------------------------
+        static void writeAll(int fd, const char* p, size_t n, const std::string& path)
+            throw(sys::IOException)
+        {
+            while(n > 0)
+            {
+                ssize_t written = ::write(fd, p, n);
+                if(written < 0)
+                {
+                    if(errno == EINTR)
+                    {
+                        continue;
+                    }
+                    throw sys::IOException(path + ": " + ::strerror(errno));
+                }
+                p += written;
+                n -= static_cast<size_t>(written);
+            }
+        }
+
+        //--------------------------------------------------------------
+        AddressFilter::AddressFilter(uint32_t kind) throw() :
+          kind_(kind), count_(0), words_(NULL), wordCount_(0)
+        {
+            ::memset(params_, 0, sizeof(params_));
+        }
+
+        //--------------------------------------------------------------
+        AddressFilter::~AddressFilter() throw()
+        {
+        }
+
+        //--------------------------------------------------------------
+        void AddressFilter::allocate(size_t wordCount) throw()
+        {
+            file_.close();
+            storage_.assign(wordCount, 0);
+            words_ = storage_.empty() ? NULL : &storage_[0];
+            wordCount_ = wordCount;
+        }
+
+        //--------------------------------------------------------------
+        uint64_t* AddressFilter::getMutableWords() throw(sys::RuntimeException)
+        {
+            if(file_.isOpen())
+            {
+                throw sys::RuntimeException("Filter is mapped from a file and cannot be changed.");
+            }
+            return storage_.empty() ? NULL : &storage_[0];
+        }
+
+        //--------------------------------------------------------------
+        void AddressFilter::write(const std::string& path) const throw(sys::IOException)
+        {
+            Header header;
+            ::memset(&header, 0, sizeof(header));
+            ::memcpy(header.magic, MAGIC, sizeof(header.magic));
+            header.version = FORMAT_VERSION;
+            header.byteOrder = BYTE_ORDER_MARK;
+            header.headerSize = sizeof(header);
+            header.kind = kind_;
+            header.count = count_;
+            ::memcpy(header.params, params_, sizeof(header.params));
+            header.wordCount = wordCount_;
+
+            std::string temporary = path + ".tmp";
+            int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if(fd < 0)
+            {
+                throw sys::IOException(temporary + ": " + ::strerror(errno));
+            }
+            try
+            {
+                writeAll(fd, reinterpret_cast<const char*>(&header), sizeof(header), temporary);
+                writeAll(fd, reinterpret_cast<const char*>(words_), wordCount_ * sizeof(uint64_t), temporary);
+                if(::fsync(fd) < 0)
+                {
+                    throw sys::IOException(temporary + ": " + ::strerror(errno));
+                }
+            }
+            catch(sys::IOException&)
+            {
+                ::close(fd);
+                ::unlink(temporary.c_str());
+                throw;
+            }
+            if(::close(fd) < 0)
+            {
+                int error = errno;
+                ::unlink(temporary.c_str());
+                throw sys::IOException(temporary + ": " + ::strerror(error));
+            }
+            if(::rename(temporary.c_str(), path.c_str()) < 0)
+            {
+                int error = errno;
+                ::unlink(temporary.c_str());
+                throw sys::IOException(path + ": " + ::strerror(error));
+            }
+        }
+
+        //--------------------------------------------------------------
+        void AddressFilter::open(const std::string& path) throw(sys::IOException)
+        {
+            allocate(0);
+            count_ = 0;
+            ::memset(params_, 0, sizeof(params_));
+            file_.open(path);
+            try
+            {
+                attach(path);
+            }
+            catch(sys::IOException&)
+            {
+                allocate(0);
+                count_ = 0;
+                ::memset(params_, 0, sizeof(params_));
+                throw;
+            }
+        }
+
+        //--------------------------------------------------------------
+        void AddressFilter::attach(const std::string& path) throw(sys::IOException)
+        {
+            Header header;
+            if(file_.size() < sizeof(header))
+            {
+                throw sys::IOException(path + ": not an address filter");
+            }
+            ::memcpy(&header, file_.data(), sizeof(header));
+            if(::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+            {
+                throw sys::IOException(path + ": not an address filter");
+            }
+            if(header.byteOrder != BYTE_ORDER_MARK)
+            {
+                throw sys::IOException(path + ": address filter has the wrong byte order");
+            }
+            if(header.version != FORMAT_VERSION)
+            {
+                throw sys::IOException(path + ": unsupported address filter version");
+            }
+            if(header.kind != kind_)
+            {
+                throw sys::IOException(path + ": address filter is of another kind");
+            }
+
+            uint64_t dataSize = file_.size() - sizeof(header);
+            if((header.headerSize != sizeof(header)) || (dataSize % sizeof(uint64_t) != 0) ||
+                    (header.wordCount != dataSize / sizeof(uint64_t)))
+            {
+                throw sys::IOException(path + ": address filter is damaged");
+            }
+            count_ = header.count;
+            ::memcpy(params_, header.params, sizeof(params_));
+            words_ = reinterpret_cast<const uint64_t*>(file_.data() + sizeof(header));
+            wordCount_ = static_cast<size_t>(header.wordCount);
+            if(!checkParams())
+            {
+                throw sys::IOException(path + ": address filter is damaged");
+            }
+        }
+    } // net ns
+} // frog ns
@@ -0,0 +1,221 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <cstring>
+
+#include <frog/AddressPool.h>
+
+namespace frog
+{
+    namespace net
+    {
+        const size_t AddressPool::MAX_CAPACITY;
+        const uint32_t AddressPool::SLOT_BUSY;
+        const uint32_t AddressPool::SLOT_DROPPED;
+
+        //--------------------------------------------------------------
+        // Loads a slot so that the address stored before the slot was
+        // published is visible.
+        static inline uint64_t loadAcquire(const uint64_t* slot) throw()
+        {
+#ifdef __ATOMIC_ACQUIRE
+            return __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+#else
+            uint64_t word = *static_cast<const volatile uint64_t*>(slot);
+            __sync_synchronize();
+            return word;
+#endif
+        }
+
+        //--------------------------------------------------------------
+        // Publishes a slot after the address it names was stored.
+        static inline void storeRelease(uint64_t* slot, uint64_t word) throw()
+        {
+#ifdef __ATOMIC_RELEASE
+            __atomic_store_n(slot, word, __ATOMIC_RELEASE);
+#else
+            __sync_synchronize();
+            *static_cast<volatile uint64_t*>(slot) = word;
+#endif
+        }
+
+        //--------------------------------------------------------------
+        // Reads the id counter while other threads may add to it, so that
+        // the slots claimed before the ids were taken are visible.
+        static inline uint32_t loadCount(const volatile uint32_t* count) throw()
+        {
+#ifdef __ATOMIC_ACQUIRE
+            return __atomic_load_n(count, __ATOMIC_ACQUIRE);
+#else
+            uint32_t value = *count;
+            __sync_synchronize();
+            return value;
+#endif
+        }
+
+        //--------------------------------------------------------------
+        AddressPool::AddressPool(size_t capacity) throw(sys::IllegalArgumentException) : count_(0)
+        {
+            if((capacity == 0) || (capacity > MAX_CAPACITY))
+            {
+                throw sys::IllegalArgumentException("Capacity is out of range.");
+            }
+
+            size_t slotCount = 16;
+            while(slotCount < capacity * 2)
+            {
+                slotCount *= 2;
+            }
+            slots_.assign(slotCount, 0);
+            values_.resize(capacity);
+        }
+
+        //--------------------------------------------------------------
+        uint64_t AddressPool::waitForSlot(size_t index) const throw()
+        {
+            uint64_t slot;
+            while(static_cast<uint32_t>(slot = loadAcquire(&slots_[index])) == SLOT_BUSY)
+            {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+                __builtin_ia32_pause();
+#endif
+            }
+            return slot;
+        }
+
+        //--------------------------------------------------------------
+        bool AddressPool::tryIntern(const InetAddressValue& value, uint32_t& id) throw()
+        {
+            uint64_t hash = value.hash();
+            uint64_t tag = tagOf(hash);
+            size_t mask = slots_.size() - 1;
+            size_t index = static_cast<size_t>(hash) & mask;
+            uint64_t* slots = &slots_[0];
+
+            for(size_t probes = 0; probes <= mask; ++probes, index = (index + 1) & mask)
+            {
+                uint64_t slot = loadAcquire(&slots[index]);
+                if(slot == 0)
+                {
+                    if(loadCount(&count_) >= values_.size())
+                    {
+                        // The last id may have gone to a thread that has
+                        // just claimed this slot for the same address.
+                        // The slot was claimed before the id was taken,
+                        // so if it is still empty the address is not here.
+                        slot = loadAcquire(&slots[index]);
+                        if(slot == 0)
+                        {
+                            return false;
+                        }
+                    }
+                    else
+                    {
+                        slot = __sync_val_compare_and_swap(&slots[index], 0, tag | SLOT_BUSY);
+                    }
+                    if(slot == 0)
+                    {
+                        // The slot is ours: take an id, store the address
+                        // and publish the id.
+                        uint32_t next = __sync_fetch_and_add(&count_, 1U);
+                        if(next >= values_.size())
+                        {
+                            storeRelease(&slots[index], tag | SLOT_DROPPED);
+                            return false;
+                        }
+                        values_[next] = value;
+                        storeRelease(&slots[index], tag | (next + 1U));
+                        id = next;
+                        return true;
+                    }
+                    // Another thread claimed the slot first; look at
+                    // what it holds.
+                }
+
+                if((slot & 0xffffffff00000000ULL) != tag)
+                {
+                    continue;
+                }
+                if(static_cast<uint32_t>(slot) == SLOT_BUSY)
+                {
+                    slot = waitForSlot(index);
+                }
+                uint32_t state = static_cast<uint32_t>(slot);
+                if((state != SLOT_DROPPED) && (values_[state - 1U] == value))
+                {
+                    id = state - 1U;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //--------------------------------------------------------------
+        uint32_t AddressPool::intern(const InetAddressValue& value) throw(sys::OverflowException)
+        {
+            uint32_t id;
+            if(!tryIntern(value, id))
+            {
+                throw sys::OverflowException("Address pool is full.");
+            }
+            return id;
+        }
+
+        //--------------------------------------------------------------
+        bool AddressPool::find(const InetAddressValue& value, uint32_t& id) const throw()
+        {
+            uint64_t hash = value.hash();
+            uint64_t tag = tagOf(hash);
+            size_t mask = slots_.size() - 1;
+            size_t index = static_cast<size_t>(hash) & mask;
+
+            for(size_t probes = 0; probes <= mask; ++probes, index = (index + 1) & mask)
+            {
+                uint64_t slot = loadAcquire(&slots_[index]);
+                if(slot == 0)
+                {
+                    return false;
+                }
+                if((slot & 0xffffffff00000000ULL) != tag)
+                {
+                    continue;
+                }
+                if(static_cast<uint32_t>(slot) == SLOT_BUSY)
+                {
+                    slot = waitForSlot(index);
+                }
+                uint32_t state = static_cast<uint32_t>(slot);
+                if((state != SLOT_DROPPED) && (values_[state - 1U] == value))
+                {
+                    id = state - 1U;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //--------------------------------------------------------------
+        size_t AddressPool::getSize() const throw()
+        {
+            size_t count = loadCount(&count_);
+            return (count < values_.size()) ? count : values_.size();
+        }
+    } // net ns
+} // frog ns
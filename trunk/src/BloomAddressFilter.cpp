@@ -0,0 +1,143 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <frog/BloomAddressFilter.h>
+
+namespace frog
+{
+    namespace net
+    {
+        const size_t BloomAddressFilter::BLOCK_WORDS;
+
+        //--------------------------------------------------------------
+        // Odd multipliers that pick one bit in each 32-bit lane of a
+        // block.
+        static const uint32_t bloomSalts[8] = {
+            0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+            0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U };
+
+        //--------------------------------------------------------------
+        // Addresses tested ahead in mayContainBatch().
+        static const size_t BLOOM_BATCH = 16U;
+
+        //--------------------------------------------------------------
+        BloomAddressFilter::BloomAddressFilter(uint64_t expectedCount, uint32_t bitsPerAddress)
+            throw(sys::IllegalArgumentException) : AddressFilter(KIND_BLOOM)
+        {
+            if((bitsPerAddress == 0) || (bitsPerAddress > 64U))
+            {
+                throw sys::IllegalArgumentException("Bits per address is out of range.");
+            }
+            uint64_t blockCount = (expectedCount * bitsPerAddress + 255U) / 256U;
+            if(blockCount == 0)
+            {
+                blockCount = 1;
+            }
+            if((expectedCount > (1ULL << 40)) || (blockCount >= (1ULL << 32)))
+            {
+                throw sys::IllegalArgumentException("Filter is too large.");
+            }
+            params_[0] = blockCount;
+            allocate(static_cast<size_t>(blockCount * BLOCK_WORDS));
+        }
+
+        //--------------------------------------------------------------
+        void BloomAddressFilter::maskOf(uint64_t hash, uint64_t mask[BLOCK_WORDS]) throw()
+        {
+            uint32_t key = static_cast<uint32_t>(hash);
+            for(size_t i = 0; i < BLOCK_WORDS; ++i)
+            {
+                uint32_t low = (key * bloomSalts[2 * i]) >> 27;
+                uint32_t high = (key * bloomSalts[2 * i + 1]) >> 27;
+                mask[i] = (1ULL << low) | (1ULL << (high + 32U));
+            }
+        }
+
+        //--------------------------------------------------------------
+        void BloomAddressFilter::add(const InetAddressValue& value) throw(sys::RuntimeException)
+        {
+            uint64_t* words = getMutableWords();
+            uint64_t hash = value.hash();
+            uint64_t mask[BLOCK_WORDS];
+            maskOf(hash, mask);
+            uint64_t* block = words + blockOf(hash);
+            for(size_t i = 0; i < BLOCK_WORDS; ++i)
+            {
+                block[i] |= mask[i];
+            }
+            ++count_;
+        }
+
+        //--------------------------------------------------------------
+        bool BloomAddressFilter::mayContain(const InetAddressValue& value) const throw()
+        {
+            uint64_t hash = value.hash();
+            uint64_t mask[BLOCK_WORDS];
+            maskOf(hash, mask);
+            const uint64_t* block = words_ + blockOf(hash);
+            uint64_t missing = 0;
+            for(size_t i = 0; i < BLOCK_WORDS; ++i)
+            {
+                missing |= mask[i] & ~block[i];
+            }
+            return (missing == 0);
+        }
+
+        //--------------------------------------------------------------
+        size_t BloomAddressFilter::mayContainBatch(const InetAddressValue* values, size_t count,
+                uint8_t* result) const throw()
+        {
+            size_t found = 0;
+            uint64_t hashes[BLOOM_BATCH];
+            for(size_t start = 0; start < count; start += BLOOM_BATCH)
+            {
+                size_t n = (count - start < BLOOM_BATCH) ? count - start : BLOOM_BATCH;
+                for(size_t i = 0; i < n; ++i)
+                {
+                    hashes[i] = values[start + i].hash();
+#ifdef __GNUC__
+                    __builtin_prefetch(words_ + blockOf(hashes[i]));
+#endif
+                }
+                for(size_t i = 0; i < n; ++i)
+                {
+                    uint64_t mask[BLOCK_WORDS];
+                    maskOf(hashes[i], mask);
+                    const uint64_t* block = words_ + blockOf(hashes[i]);
+                    uint64_t missing = 0;
+                    for(size_t j = 0; j < BLOCK_WORDS; ++j)
+                    {
+                        missing |= mask[j] & ~block[j];
+                    }
+                    result[start + i] = static_cast<uint8_t>(missing == 0);
+                    found += (missing == 0);
+                }
+            }
+            return found;
+        }
+
+        //--------------------------------------------------------------
+        bool BloomAddressFilter::checkParams() const throw()
+        {
+            return (params_[0] != 0) && (params_[0] < (1ULL << 32)) &&
+                (wordCount_ == params_[0] * BLOCK_WORDS);
+        }
+    } // net ns
+} // frog ns
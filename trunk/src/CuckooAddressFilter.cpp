@@ -0,0 +1,227 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <frog/CuckooAddressFilter.h>
+
+namespace frog
+{
+    namespace net
+    {
+        //--------------------------------------------------------------
+        // Moves tried before add() gives up on placing a fingerprint.
+        static const uint32_t CUCKOO_MAX_KICKS = 500U;
+
+        //--------------------------------------------------------------
+        // Addresses tested ahead in mayContainBatch().
+        static const size_t CUCKOO_BATCH = 16U;
+
+        //--------------------------------------------------------------
+        // Flag of params_[1] telling a fingerprint is kept there.
+        static const uint64_t CUCKOO_VICTIM = 1ULL << 63;
+
+        //--------------------------------------------------------------
+        CuckooAddressFilter::CuckooAddressFilter(uint64_t capacity) throw(sys::IllegalArgumentException)
+            : AddressFilter(KIND_CUCKOO)
+        {
+            if(capacity > (1ULL << 33))
+            {
+                throw sys::IllegalArgumentException("Filter is too large.");
+            }
+            // Buckets are filled to 95% at most.
+            uint64_t bucketCount = (capacity * 100U + 379U) / 380U;
+            if(bucketCount < 2)
+            {
+                bucketCount = 2;
+            }
+            params_[0] = bucketCount;
+            allocate(static_cast<size_t>(bucketCount));
+        }
+
+        //--------------------------------------------------------------
+        bool CuckooAddressFilter::store(uint64_t& bucket, uint64_t fingerprint) throw()
+        {
+            for(uint32_t shift = 0; shift < 64U; shift += 16U)
+            {
+                if(((bucket >> shift) & 0xffffU) == 0)
+                {
+                    bucket |= fingerprint << shift;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //--------------------------------------------------------------
+        bool CuckooAddressFilter::erase(uint64_t& bucket, uint64_t fingerprint) throw()
+        {
+            for(uint32_t shift = 0; shift < 64U; shift += 16U)
+            {
+                if(((bucket >> shift) & 0xffffU) == fingerprint)
+                {
+                    bucket &= ~(0xffffULL << shift);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //--------------------------------------------------------------
+        void CuckooAddressFilter::place(uint64_t* words, uint64_t bucket, uint64_t fingerprint) throw()
+        {
+            for(uint32_t kick = 0; kick < CUCKOO_MAX_KICKS; ++kick)
+            {
+                if(store(words[bucket], fingerprint))
+                {
+                    return;
+                }
+                uint32_t shift = static_cast<uint32_t>(((count_ + kick) * 0x9E3779B97F4A7C15ULL) >> 62) * 16U;
+                uint64_t evicted = (words[bucket] >> shift) & 0xffffU;
+                words[bucket] ^= (evicted ^ fingerprint) << shift;
+                fingerprint = evicted;
+                bucket = alternateOf(bucket, fingerprint);
+            }
+            params_[1] = CUCKOO_VICTIM | (bucket << 16) | fingerprint;
+        }
+
+        //--------------------------------------------------------------
+        bool CuckooAddressFilter::add(const InetAddressValue& value) throw(sys::RuntimeException)
+        {
+            uint64_t* words = getMutableWords();
+            if(params_[1] != 0)
+            {
+                return false;
+            }
+            uint64_t hash = value.hash();
+            uint64_t fingerprint = fingerprintOf(hash);
+            uint64_t first = bucketOf(hash);
+            if(!store(words[first], fingerprint))
+            {
+                place(words, alternateOf(first, fingerprint), fingerprint);
+            }
+            ++count_;
+            return true;
+        }
+
+        //--------------------------------------------------------------
+        bool CuckooAddressFilter::remove(const InetAddressValue& value) throw(sys::RuntimeException)
+        {
+            uint64_t* words = getMutableWords();
+            uint64_t hash = value.hash();
+            uint64_t fingerprint = fingerprintOf(hash);
+            uint64_t first = bucketOf(hash);
+            uint64_t second = alternateOf(first, fingerprint);
+            uint64_t victim = params_[1];
+            if(erase(words[first], fingerprint) || erase(words[second], fingerprint))
+            {
+                if(victim != 0)
+                {
+                    // There is room again for the fingerprint left over.
+                    params_[1] = 0;
+                    place(words, (victim >> 16) & 0xffffffffU, victim & 0xffffU);
+                }
+            }
+            else if((victim != 0) && ((victim & 0xffffU) == fingerprint) &&
+                    ((((victim >> 16) & 0xffffffffU) == first) || (((victim >> 16) & 0xffffffffU) == second)))
+            {
+                params_[1] = 0;
+            }
+            else
+            {
+                return false;
+            }
+            --count_;
+            return true;
+        }
+
+        //--------------------------------------------------------------
+        bool CuckooAddressFilter::mayContain(const InetAddressValue& value) const throw()
+        {
+            uint64_t hash = value.hash();
+            uint64_t fingerprint = fingerprintOf(hash);
+            uint64_t first = bucketOf(hash);
+            uint64_t second = alternateOf(first, fingerprint);
+            if(holds(words_[first], fingerprint) || holds(words_[second], fingerprint))
+            {
+                return true;
+            }
+            uint64_t victim = params_[1];
+            return (victim != 0) && ((victim & 0xffffU) == fingerprint) &&
+                ((((victim >> 16) & 0xffffffffU) == first) || (((victim >> 16) & 0xffffffffU) == second));
+        }
+
+        //--------------------------------------------------------------
+        size_t CuckooAddressFilter::mayContainBatch(const InetAddressValue* values, size_t count,
+                uint8_t* result) const throw()
+        {
+            if(params_[1] != 0)
+            {
+                // Rare: the filter is full. Take the slow path.
+                size_t found = 0;
+                for(size_t i = 0; i < count; ++i)
+                {
+                    result[i] = static_cast<uint8_t>(mayContain(values[i]));
+                    found += result[i];
+                }
+                return found;
+            }
+
+            size_t found = 0;
+            uint64_t fingerprints[CUCKOO_BATCH];
+            uint64_t firsts[CUCKOO_BATCH];
+            uint64_t seconds[CUCKOO_BATCH];
+            for(size_t start = 0; start < count; start += CUCKOO_BATCH)
+            {
+                size_t n = (count - start < CUCKOO_BATCH) ? count - start : CUCKOO_BATCH;
+                for(size_t i = 0; i < n; ++i)
+                {
+                    uint64_t hash = values[start + i].hash();
+                    fingerprints[i] = fingerprintOf(hash);
+                    firsts[i] = bucketOf(hash);
+                    seconds[i] = alternateOf(firsts[i], fingerprints[i]);
+#ifdef __GNUC__
+                    __builtin_prefetch(words_ + firsts[i]);
+                    __builtin_prefetch(words_ + seconds[i]);
+#endif
+                }
+                for(size_t i = 0; i < n; ++i)
+                {
+                    bool hit = holds(words_[firsts[i]], fingerprints[i]) |
+                        holds(words_[seconds[i]], fingerprints[i]);
+                    result[start + i] = static_cast<uint8_t>(hit);
+                    found += hit;
+                }
+            }
+            return found;
+        }
+
+        //--------------------------------------------------------------
+        bool CuckooAddressFilter::checkParams() const throw()
+        {
+            uint64_t bucketCount = params_[0];
+            if((bucketCount < 2) || (bucketCount >= (1ULL << 32)) || (wordCount_ != bucketCount))
+            {
+                return false;
+            }
+            uint64_t victim = params_[1];
+            return (victim == 0) ||
+                (((victim & CUCKOO_VICTIM) != 0) && (((victim >> 16) & 0xffffffffU) < bucketCount));
+        }
+    } // net ns
+} // frog ns
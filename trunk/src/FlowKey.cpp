@@ -0,0 +1,154 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <cstring>
+
+#include <frog/FlowKey.h>
+
+namespace frog
+{
+    namespace net
+    {
+        //--------------------------------------------------------------
+        // Writes a port in network byte order.
+        static void storePort(uint8_t* p, in_port_t port) throw()
+        {
+            p[0] = static_cast<uint8_t>(port >> 8);
+            p[1] = static_cast<uint8_t>(port);
+        }
+
+        //--------------------------------------------------------------
+        // Reads a port in network byte order.
+        static in_port_t loadPort(const uint8_t* p) throw()
+        {
+            return static_cast<in_port_t>((p[0] << 8) | p[1]);
+        }
+
+        //--------------------------------------------------------------
+        // Builds an endpoint from raw address bytes and a port.
+        static IPEndpoint makeEndpoint(const uint8_t* address, size_t size, const uint8_t* port) throw()
+        {
+            InetAddressValue value;
+            ::memset(&value, 0, sizeof(InetAddressValue));
+            ::memcpy(value.address + sizeof(value.address) - size, address, size);
+#ifdef HAVE_IPV6_SUPPORT
+            value.family = (size == sizeof(value.address)) ? AddressFamily::InterNetworkV6
+                : AddressFamily::InterNetwork;
+#else
+            value.family = AddressFamily::InterNetwork;
+#endif
+            InetAddress addr(value);
+            return IPEndpoint(addr, loadPort(port));
+        }
+
+#ifdef HAVE_IPV6_SUPPORT
+        //--------------------------------------------------------------
+        // Writes the address of an endpoint as 16 bytes, mapping an IPv4
+        // address to IPv6.
+        static void storeAddress6(uint8_t* p, const InetAddressValue& value) throw()
+        {
+            if(value.family == AddressFamily::InterNetworkV6)
+            {
+                ::memcpy(p, value.address, sizeof(value.address));
+            }
+            else
+            {
+                ::memset(p, 0, InetAddressValue::IPV4_OFFSET);
+                p[10] = 0xff;
+                p[11] = 0xff;
+                ::memcpy(p + InetAddressValue::IPV4_OFFSET, value.address + InetAddressValue::IPV4_OFFSET, 4);
+            }
+        }
+#endif
+
+        //--------------------------------------------------------------
+        bool FlowKey4::make(const IPEndpoint& src, const IPEndpoint& dst, uint8_t proto,
+                FlowKey4& out) throw()
+        {
+            const InetAddressValue& from = src.address.getValue();
+            const InetAddressValue& to = dst.address.getValue();
+            if((from.family != AddressFamily::InterNetwork) || (to.family != AddressFamily::InterNetwork))
+            {
+                return false;
+            }
+
+            ::memcpy(out.source, from.address + InetAddressValue::IPV4_OFFSET, sizeof(out.source));
+            ::memcpy(out.destination, to.address + InetAddressValue::IPV4_OFFSET, sizeof(out.destination));
+            storePort(out.sourcePort, src.port);
+            storePort(out.destinationPort, dst.port);
+            out.protocol = proto;
+            return true;
+        }
+
+        //--------------------------------------------------------------
+        IPEndpoint FlowKey4::getSource() const throw()
+        {
+            return makeEndpoint(source, sizeof(source), sourcePort);
+        }
+
+        //--------------------------------------------------------------
+        IPEndpoint FlowKey4::getDestination() const throw()
+        {
+            return makeEndpoint(destination, sizeof(destination), destinationPort);
+        }
+
+        //--------------------------------------------------------------
+        bool FlowKey6::make(const IPEndpoint& src, const IPEndpoint& dst, uint8_t proto,
+                FlowKey6& out) throw()
+        {
+#ifdef HAVE_IPV6_SUPPORT
+            const InetAddressValue& from = src.address.getValue();
+            const InetAddressValue& to = dst.address.getValue();
+            if(((from.family != AddressFamily::InterNetwork) && (from.family != AddressFamily::InterNetworkV6)) ||
+                    ((to.family != AddressFamily::InterNetwork) && (to.family != AddressFamily::InterNetworkV6)))
+            {
+                return false;
+            }
+
+            storeAddress6(out.source, from);
+            storeAddress6(out.destination, to);
+            storePort(out.sourcePort, src.port);
+            storePort(out.destinationPort, dst.port);
+            out.protocol = proto;
+            return true;
+#else
+            // Without IPv6 support there are no IPv6 flows; IPv4 flows
+            // use FlowKey4.
+            (void)src;
+            (void)dst;
+            (void)proto;
+            (void)out;
+            return false;
+#endif
+        }
+
+        //--------------------------------------------------------------
+        IPEndpoint FlowKey6::getSource() const throw()
+        {
+            return makeEndpoint(source, sizeof(source), sourcePort);
+        }
+
+        //--------------------------------------------------------------
+        IPEndpoint FlowKey6::getDestination() const throw()
+        {
+            return makeEndpoint(destination, sizeof(destination), destinationPort);
+        }
+    } // net ns
+} // frog ns
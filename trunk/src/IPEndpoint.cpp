@@ -20,7 +20,7 @@
 
 
 #include <arpa/inet.h>
-#include <sstream>
+#include <cstring>
 
 #include <frog/IPEndpoint.h>
 
@@ -29,29 +29,51 @@ namespace frog
     namespace net
     {
         //--------------------------------------------------------------
-        IPEndpoint::IPEndpoint(InetAddress& ipAddress, in_port_t portNo) throw() :
-          address(ipAddress), port(portNo)
+        // Parses a decimal port number of one to five digits.
+        static bool parsePort(const char* p, const char* end, in_port_t& port) throw()
         {
-            setAddressFamily(ipAddress.addressFamily);
+            if((p == end) || (end - p > 5))
+            {
+                return false;
+            }
+
+            uint32_t value = 0;
+            for(; p != end; ++p)
+            {
+                uint32_t digit = static_cast<uint8_t>(*p - '0');
+                if(digit > 9U)
+                {
+                    return false;
+                }
+                value = (value * 10U) + digit;
+            }
+
+            if(value > 0xFFFFU)
+            {
+                return false;
+            }
+            port = static_cast<in_port_t>(value);
+            return true;
         }
 
         //--------------------------------------------------------------
-        IPEndpoint& IPEndpoint::operator=(const IPEndpoint& ep) throw()
+        IPEndpoint::IPEndpoint() throw() :
+          address(), port(0)
         {
-            if(this != &ep)
-            {
-                address = ep.address;
-                port = ep.port;
-                setAddressFamily(ep.address.addressFamily);
-            }
-            return *this;
+        }
+
+        //--------------------------------------------------------------
+        IPEndpoint::IPEndpoint(InetAddress& ipAddress, in_port_t portNo) throw() :
+          address(ipAddress), port(portNo)
+        {
+            setAddressFamily(ipAddress.getAddressFamily());
         }
 
         //--------------------------------------------------------------
         bool IPEndpoint::operator==(const IPEndpoint& ep) const throw()
         {
             return ((address == ep.address) && (port == ep.port)
-                    && (addressFamily == ep.addressFamily));
+                    && (getAddressFamily() == ep.getAddressFamily()));
         }
 
         //--------------------------------------------------------------
@@ -59,28 +81,270 @@ namespace frog
         {
 
             return ((address != ep.address) || (port != ep.port)
-                    || (addressFamily != ep.addressFamily));
+                    || (getAddressFamily() != ep.getAddressFamily()));
         }
 
         //--------------------------------------------------------------
-        std::string IPEndpoint::toString() const throw()
+        bool IPEndpoint::toSockAddr(struct sockaddr_storage& storage, socklen_t& length) const throw()
+        {
+            const InetAddressValue& value = address.getValue();
+
+            if(value.family == AddressFamily::InterNetwork)
+            {
+                struct sockaddr_in* in = reinterpret_cast<struct sockaddr_in*>(&storage);
+                ::memset(in, 0, sizeof(struct sockaddr_in));
+                in->sin_family = AF_INET;
+                in->sin_port = htons(port);
+                ::memcpy(&in->sin_addr, value.address + InetAddressValue::IPV4_OFFSET, sizeof(in->sin_addr));
+                length = sizeof(struct sockaddr_in);
+                return true;
+            }
+#ifdef HAVE_IPV6_SUPPORT
+            else if(value.family == AddressFamily::InterNetworkV6)
+            {
+                struct sockaddr_in6* in6 = reinterpret_cast<struct sockaddr_in6*>(&storage);
+                ::memset(in6, 0, sizeof(struct sockaddr_in6));
+                in6->sin6_family = AF_INET6;
+                in6->sin6_port = htons(port);
+                ::memcpy(&in6->sin6_addr, value.address, sizeof(in6->sin6_addr));
+                in6->sin6_scope_id = value.scope;
+                length = sizeof(struct sockaddr_in6);
+                return true;
+            }
+#endif
+            return false;
+        }
+
+        //--------------------------------------------------------------
+        bool IPEndpoint::fromSockAddr(const struct sockaddr* addr, socklen_t length) throw()
+        {
+            if((addr == NULL) || (length < static_cast<socklen_t>(sizeof(sa_family_t))))
+            {
+                return false;
+            }
+
+            InetAddressValue& value = address.value_;
+
+            if(addr->sa_family == AF_INET)
+            {
+                if(length < static_cast<socklen_t>(sizeof(struct sockaddr_in)))
+                {
+                    return false;
+                }
+
+                const struct sockaddr_in* in = reinterpret_cast<const struct sockaddr_in*>(addr);
+                ::memset(&value, 0, sizeof(InetAddressValue));
+                ::memcpy(value.address + InetAddressValue::IPV4_OFFSET, &in->sin_addr, sizeof(in->sin_addr));
+                value.family = AddressFamily::InterNetwork;
+                address.ipv4Compatible_ = true;
+                port = ntohs(in->sin_port);
+            }
+#ifdef HAVE_IPV6_SUPPORT
+            else if(addr->sa_family == AF_INET6)
+            {
+                if(length < static_cast<socklen_t>(sizeof(struct sockaddr_in6)))
+                {
+                    return false;
+                }
+
+                const struct sockaddr_in6* in6 = reinterpret_cast<const struct sockaddr_in6*>(addr);
+                ::memcpy(value.address, &in6->sin6_addr, sizeof(in6->sin6_addr));
+                value.scope = in6->sin6_scope_id;
+                value.family = AddressFamily::InterNetworkV6;
+                value.reserved = 0;
+                address.ipv4Compatible_ = value.isIPv4Compatible();
+                port = ntohs(in6->sin6_port);
+            }
+#endif
+            else
+            {
+                return false;
+            }
+
+            setAddressFamily(value.family);
+            return true;
+        }
+
+        //--------------------------------------------------------------
+        bool IPEndpoint::tryParse(const char* p, size_t n, IPEndpoint& out, in_port_t defaultPort) throw()
+        {
+            if((p == NULL) || (n == 0))
+            {
+                return false;
+            }
+
+            const char* end = p + n;
+            const char* host = p;
+            const char* hostEnd = end;
+            in_port_t portNo = defaultPort;
+            bool bracketed = (*p == '[');
+
+            if(bracketed)
+            {
+                // [ipv6-address%scope-id] with an optional :port.
+                hostEnd = static_cast<const char*>(::memchr(p, ']', n));
+                if(hostEnd == NULL)
+                {
+                    return false;
+                }
+                ++host;
+                if((hostEnd + 1 != end) &&
+                        ((hostEnd[1] != ':') || !parsePort(hostEnd + 2, end, portNo)))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                // A single colon separates an IPv4 address from its port;
+                // more than one is a bare IPv6 address.
+                const char* colon = static_cast<const char*>(::memchr(p, ':', n));
+                if((colon != NULL) && (::memchr(colon + 1, ':', end - colon - 1) == NULL))
+                {
+                    if(!parsePort(colon + 1, end, portNo))
+                    {
+                        return false;
+                    }
+                    hostEnd = colon;
+                }
+            }
+
+            InetAddressValue value;
+#ifdef HAVE_IPV6_SUPPORT
+            if(!InetAddress::tryParse(host, hostEnd - host, value) ||
+                    (bracketed && (value.family != AddressFamily::InterNetworkV6)))
+            {
+                return false;
+            }
+#else
+            // Only an IPv6 address can be bracketed.
+            if(bracketed || !InetAddress::tryParse(host, hostEnd - host, value))
+            {
+                return false;
+            }
+#endif
+
+            out.address.value_ = value;
+            out.address.ipv4Compatible_ = value.isIPv4Compatible();
+            out.port = portNo;
+            out.setAddressFamily(value.family);
+            return true;
+        }
+
+        //--------------------------------------------------------------
+        size_t IPEndpoint::tryParseList(const char* p, size_t n, IPEndpoint* out, size_t capacity,
+                in_port_t defaultPort) throw()
+        {
+            if((p == NULL) || (n == 0))
+            {
+                return 0;
+            }
+
+            const char* end = p + n;
+            size_t count = 0;
+            while(count < capacity)
+            {
+                const char* comma = static_cast<const char*>(::memchr(p, ',', end - p));
+                const char* itemEnd = (comma != NULL) ? comma : end;
+
+                const char* first = p;
+                while((first != itemEnd) && ((*first == ' ') || (*first == '\t')))
+                {
+                    ++first;
+                }
+                const char* last = itemEnd;
+                while((last != first) && ((last[-1] == ' ') || (last[-1] == '\t')))
+                {
+                    --last;
+                }
+
+                if(!tryParse(first, last - first, out[count], defaultPort))
+                {
+                    out[count] = IPEndpoint();
+                }
+                ++count;
+
+                if(comma == NULL)
+                {
+                    break;
+                }
+                p = comma + 1;
+            }
+            return count;
+        }
+
+        //--------------------------------------------------------------
+        size_t IPEndpoint::format(char* buf, size_t cap) const throw()
         {
-            std::ostringstream portStr;
-            portStr << port;
-            std::string ipEndpointStr = "";
+            char text[MAX_TEXT_SIZE];
+            char* out = (cap >= MAX_TEXT_SIZE) ? buf : text;
+            char* end = out;
 
-            if(addressFamily == AddressFamily::InterNetwork)
+            if(getAddressFamily() == AddressFamily::InterNetwork)
             {
-                ipEndpointStr = address.toString() + ":" + portStr.str();
+                end += address.format(end, InetAddress::MAX_TEXT_SIZE);
             }
 #ifdef HAVE_IPV6_SUPPORT
-            else if(addressFamily == AddressFamily::InterNetworkV6)
+            else if(getAddressFamily() == AddressFamily::InterNetworkV6)
             {
-                ipEndpointStr = "[" + address.toString() + "]:" + portStr.str();
+                *end++ = '[';
+                end += address.format(end, InetAddress::MAX_TEXT_SIZE);
+                *end++ = ']';
             }
 #endif
+            else
+            {
+                if(cap > 0)
+                {
+                    buf[0] = '\0';
+                }
+                return 0;
+            }
+
+            // The port has at most five digits.
+            char digits[5];
+            char* p = digits + sizeof(digits);
+            uint32_t value = port;
+            do
+            {
+                *--p = static_cast<char>('0' + (value % 10U));
+                value /= 10U;
+            } while(value != 0);
 
-            return ipEndpointStr;
+            *end++ = ':';
+            ::memcpy(end, p, digits + sizeof(digits) - p);
+            end += digits + sizeof(digits) - p;
+
+            size_t length = end - out;
+            if(length >= cap)
+            {
+                if(cap > 0)
+                {
+                    buf[0] = '\0';
+                }
+                return 0;
+            }
+
+            if(out != buf)
+            {
+                ::memcpy(buf, out, length);
+            }
+            buf[length] = '\0';
+            return length;
+        }
+
+        //--------------------------------------------------------------
+        int32_t IPEndpoint::hashCode() const throw()
+        {
+            uint64_t h = hash();
+            return static_cast<int32_t>(h ^ (h >> 32));
+        }
+
+        //--------------------------------------------------------------
+        std::string IPEndpoint::toString() const throw()
+        {
+            char text[MAX_TEXT_SIZE];
+            return std::string(text, format(text, sizeof(text)));
         }
     } // net ns
 } // frog ns
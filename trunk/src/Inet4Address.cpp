@@ -0,0 +1,85 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <frog/Inet4Address.h>
+
+namespace frog
+{
+    namespace net
+    {
+        const uint32_t Inet4Address::BITS;
+        const size_t Inet4Address::MAX_TEXT_SIZE;
+
+        //--------------------------------------------------------------
+        Inet4Address::Inet4Address(const InetAddressValue& value) throw(sys::IllegalArgumentException)
+            : word_(0)
+        {
+            if(!fromValue(value, *this))
+            {
+                throw sys::IllegalArgumentException("Not an IPv4 address.");
+            }
+        }
+
+        //--------------------------------------------------------------
+        Inet4Address::Inet4Address(const InetAddress& address) throw(sys::IllegalArgumentException)
+            : word_(0)
+        {
+            if(!fromValue(address.getValue(), *this))
+            {
+                throw sys::IllegalArgumentException("Not an IPv4 address.");
+            }
+        }
+
+        //--------------------------------------------------------------
+        Inet4Address::Inet4Address(const std::string& text) throw(sys::IllegalArgumentException)
+            : word_(0)
+        {
+            if(!tryParse(text.data(), text.size(), *this))
+            {
+                throw sys::IllegalArgumentException("Not an IPv4 address: " + text);
+            }
+        }
+
+        //--------------------------------------------------------------
+        bool Inet4Address::tryParse(const char* p, size_t n, Inet4Address& out) throw()
+        {
+            InetAddressValue value;
+            if(!InetAddress::tryParse(p, n, value))
+            {
+                return false;
+            }
+            return fromValue(value, out);
+        }
+
+        //--------------------------------------------------------------
+        size_t Inet4Address::format(char* buf, size_t cap) const throw()
+        {
+            return toInetAddress().format(buf, cap);
+        }
+
+        //--------------------------------------------------------------
+        std::string Inet4Address::toString() const throw()
+        {
+            char buf[MAX_TEXT_SIZE];
+            size_t n = format(buf, sizeof(buf));
+            return std::string(buf, n);
+        }
+    } // net ns
+} // frog ns
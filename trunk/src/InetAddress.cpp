@@ -20,37 +20,648 @@
 
 
 #include <arpa/inet.h>
+#include <net/if.h>
 #include <cerrno>
+#include <cstring>
 #include <vector>
 
 #include <frog/InetAddress.h>
+#include <frog/Inet4Address.h>
+#include <frog/Inet6Address.h>
 #include <frog/NetworkInterface.h>
 
+#if defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9))) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define FROG_PARSE_SSE41
+#include <immintrin.h>
+#endif
+
 namespace frog
 {
     namespace net
     {
         //--------------------------------------------------------------
-        InetAddress::InetAddress() throw() :
-          addressFamily(addressFamily_), ipv4Compatible(ipv4Compatible_),
-          ipv4Compatible_(true), index_(0), addressFamily_(AddressFamily::Unspecified)
+        // Value of every hexadecimal digit, 0xff for anything else. We
+        // use our own table so the parser does not depend on the locale.
+        static const uint8_t hexDigitTable[256] =
+        {
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+        };
+
+        //--------------------------------------------------------------
+        // Text of every IPv4 octet: up to three digits followed by the
+        // number of digits.
+        static const char octetTable[256][4] =
+        {
+            { '0', 0, 0, 1 }, { '1', 0, 0, 1 }, { '2', 0, 0, 1 }, { '3', 0, 0, 1 },
+            { '4', 0, 0, 1 }, { '5', 0, 0, 1 }, { '6', 0, 0, 1 }, { '7', 0, 0, 1 },
+            { '8', 0, 0, 1 }, { '9', 0, 0, 1 }, { '1', '0', 0, 2 }, { '1', '1', 0, 2 },
+            { '1', '2', 0, 2 }, { '1', '3', 0, 2 }, { '1', '4', 0, 2 }, { '1', '5', 0, 2 },
+            { '1', '6', 0, 2 }, { '1', '7', 0, 2 }, { '1', '8', 0, 2 }, { '1', '9', 0, 2 },
+            { '2', '0', 0, 2 }, { '2', '1', 0, 2 }, { '2', '2', 0, 2 }, { '2', '3', 0, 2 },
+            { '2', '4', 0, 2 }, { '2', '5', 0, 2 }, { '2', '6', 0, 2 }, { '2', '7', 0, 2 },
+            { '2', '8', 0, 2 }, { '2', '9', 0, 2 }, { '3', '0', 0, 2 }, { '3', '1', 0, 2 },
+            { '3', '2', 0, 2 }, { '3', '3', 0, 2 }, { '3', '4', 0, 2 }, { '3', '5', 0, 2 },
+            { '3', '6', 0, 2 }, { '3', '7', 0, 2 }, { '3', '8', 0, 2 }, { '3', '9', 0, 2 },
+            { '4', '0', 0, 2 }, { '4', '1', 0, 2 }, { '4', '2', 0, 2 }, { '4', '3', 0, 2 },
+            { '4', '4', 0, 2 }, { '4', '5', 0, 2 }, { '4', '6', 0, 2 }, { '4', '7', 0, 2 },
+            { '4', '8', 0, 2 }, { '4', '9', 0, 2 }, { '5', '0', 0, 2 }, { '5', '1', 0, 2 },
+            { '5', '2', 0, 2 }, { '5', '3', 0, 2 }, { '5', '4', 0, 2 }, { '5', '5', 0, 2 },
+            { '5', '6', 0, 2 }, { '5', '7', 0, 2 }, { '5', '8', 0, 2 }, { '5', '9', 0, 2 },
+            { '6', '0', 0, 2 }, { '6', '1', 0, 2 }, { '6', '2', 0, 2 }, { '6', '3', 0, 2 },
+            { '6', '4', 0, 2 }, { '6', '5', 0, 2 }, { '6', '6', 0, 2 }, { '6', '7', 0, 2 },
+            { '6', '8', 0, 2 }, { '6', '9', 0, 2 }, { '7', '0', 0, 2 }, { '7', '1', 0, 2 },
+            { '7', '2', 0, 2 }, { '7', '3', 0, 2 }, { '7', '4', 0, 2 }, { '7', '5', 0, 2 },
+            { '7', '6', 0, 2 }, { '7', '7', 0, 2 }, { '7', '8', 0, 2 }, { '7', '9', 0, 2 },
+            { '8', '0', 0, 2 }, { '8', '1', 0, 2 }, { '8', '2', 0, 2 }, { '8', '3', 0, 2 },
+            { '8', '4', 0, 2 }, { '8', '5', 0, 2 }, { '8', '6', 0, 2 }, { '8', '7', 0, 2 },
+            { '8', '8', 0, 2 }, { '8', '9', 0, 2 }, { '9', '0', 0, 2 }, { '9', '1', 0, 2 },
+            { '9', '2', 0, 2 }, { '9', '3', 0, 2 }, { '9', '4', 0, 2 }, { '9', '5', 0, 2 },
+            { '9', '6', 0, 2 }, { '9', '7', 0, 2 }, { '9', '8', 0, 2 }, { '9', '9', 0, 2 },
+            { '1', '0', '0', 3 }, { '1', '0', '1', 3 }, { '1', '0', '2', 3 }, { '1', '0', '3', 3 },
+            { '1', '0', '4', 3 }, { '1', '0', '5', 3 }, { '1', '0', '6', 3 }, { '1', '0', '7', 3 },
+            { '1', '0', '8', 3 }, { '1', '0', '9', 3 }, { '1', '1', '0', 3 }, { '1', '1', '1', 3 },
+            { '1', '1', '2', 3 }, { '1', '1', '3', 3 }, { '1', '1', '4', 3 }, { '1', '1', '5', 3 },
+            { '1', '1', '6', 3 }, { '1', '1', '7', 3 }, { '1', '1', '8', 3 }, { '1', '1', '9', 3 },
+            { '1', '2', '0', 3 }, { '1', '2', '1', 3 }, { '1', '2', '2', 3 }, { '1', '2', '3', 3 },
+            { '1', '2', '4', 3 }, { '1', '2', '5', 3 }, { '1', '2', '6', 3 }, { '1', '2', '7', 3 },
+            { '1', '2', '8', 3 }, { '1', '2', '9', 3 }, { '1', '3', '0', 3 }, { '1', '3', '1', 3 },
+            { '1', '3', '2', 3 }, { '1', '3', '3', 3 }, { '1', '3', '4', 3 }, { '1', '3', '5', 3 },
+            { '1', '3', '6', 3 }, { '1', '3', '7', 3 }, { '1', '3', '8', 3 }, { '1', '3', '9', 3 },
+            { '1', '4', '0', 3 }, { '1', '4', '1', 3 }, { '1', '4', '2', 3 }, { '1', '4', '3', 3 },
+            { '1', '4', '4', 3 }, { '1', '4', '5', 3 }, { '1', '4', '6', 3 }, { '1', '4', '7', 3 },
+            { '1', '4', '8', 3 }, { '1', '4', '9', 3 }, { '1', '5', '0', 3 }, { '1', '5', '1', 3 },
+            { '1', '5', '2', 3 }, { '1', '5', '3', 3 }, { '1', '5', '4', 3 }, { '1', '5', '5', 3 },
+            { '1', '5', '6', 3 }, { '1', '5', '7', 3 }, { '1', '5', '8', 3 }, { '1', '5', '9', 3 },
+            { '1', '6', '0', 3 }, { '1', '6', '1', 3 }, { '1', '6', '2', 3 }, { '1', '6', '3', 3 },
+            { '1', '6', '4', 3 }, { '1', '6', '5', 3 }, { '1', '6', '6', 3 }, { '1', '6', '7', 3 },
+            { '1', '6', '8', 3 }, { '1', '6', '9', 3 }, { '1', '7', '0', 3 }, { '1', '7', '1', 3 },
+            { '1', '7', '2', 3 }, { '1', '7', '3', 3 }, { '1', '7', '4', 3 }, { '1', '7', '5', 3 },
+            { '1', '7', '6', 3 }, { '1', '7', '7', 3 }, { '1', '7', '8', 3 }, { '1', '7', '9', 3 },
+            { '1', '8', '0', 3 }, { '1', '8', '1', 3 }, { '1', '8', '2', 3 }, { '1', '8', '3', 3 },
+            { '1', '8', '4', 3 }, { '1', '8', '5', 3 }, { '1', '8', '6', 3 }, { '1', '8', '7', 3 },
+            { '1', '8', '8', 3 }, { '1', '8', '9', 3 }, { '1', '9', '0', 3 }, { '1', '9', '1', 3 },
+            { '1', '9', '2', 3 }, { '1', '9', '3', 3 }, { '1', '9', '4', 3 }, { '1', '9', '5', 3 },
+            { '1', '9', '6', 3 }, { '1', '9', '7', 3 }, { '1', '9', '8', 3 }, { '1', '9', '9', 3 },
+            { '2', '0', '0', 3 }, { '2', '0', '1', 3 }, { '2', '0', '2', 3 }, { '2', '0', '3', 3 },
+            { '2', '0', '4', 3 }, { '2', '0', '5', 3 }, { '2', '0', '6', 3 }, { '2', '0', '7', 3 },
+            { '2', '0', '8', 3 }, { '2', '0', '9', 3 }, { '2', '1', '0', 3 }, { '2', '1', '1', 3 },
+            { '2', '1', '2', 3 }, { '2', '1', '3', 3 }, { '2', '1', '4', 3 }, { '2', '1', '5', 3 },
+            { '2', '1', '6', 3 }, { '2', '1', '7', 3 }, { '2', '1', '8', 3 }, { '2', '1', '9', 3 },
+            { '2', '2', '0', 3 }, { '2', '2', '1', 3 }, { '2', '2', '2', 3 }, { '2', '2', '3', 3 },
+            { '2', '2', '4', 3 }, { '2', '2', '5', 3 }, { '2', '2', '6', 3 }, { '2', '2', '7', 3 },
+            { '2', '2', '8', 3 }, { '2', '2', '9', 3 }, { '2', '3', '0', 3 }, { '2', '3', '1', 3 },
+            { '2', '3', '2', 3 }, { '2', '3', '3', 3 }, { '2', '3', '4', 3 }, { '2', '3', '5', 3 },
+            { '2', '3', '6', 3 }, { '2', '3', '7', 3 }, { '2', '3', '8', 3 }, { '2', '3', '9', 3 },
+            { '2', '4', '0', 3 }, { '2', '4', '1', 3 }, { '2', '4', '2', 3 }, { '2', '4', '3', 3 },
+            { '2', '4', '4', 3 }, { '2', '4', '5', 3 }, { '2', '4', '6', 3 }, { '2', '4', '7', 3 },
+            { '2', '4', '8', 3 }, { '2', '4', '9', 3 }, { '2', '5', '0', 3 }, { '2', '5', '1', 3 },
+            { '2', '5', '2', 3 }, { '2', '5', '3', 3 }, { '2', '5', '4', 3 }, { '2', '5', '5', 3 }
+        };
+
+        //--------------------------------------------------------------
+        // Every number from 00 to 99 as two digits.
+        static const char decimalPairTable[] =
+            "00010203040506070809"
+            "10111213141516171819"
+            "20212223242526272829"
+            "30313233343536373839"
+            "40414243444546474849"
+            "50515253545556575859"
+            "60616263646566676869"
+            "70717273747576777879"
+            "80818283848586878889"
+            "90919293949596979899";
+
+        //--------------------------------------------------------------
+        static const char hexCharTable[] = "0123456789abcdef";
+
+        //--------------------------------------------------------------
+        // Writes a dotted-quad IPv4 address. Needs room for 15 characters.
+        static char* formatIPv4Text(const uint8_t* addr, char* out) throw()
+        {
+            for(int i = 0; i < 4; ++i)
+            {
+                const char* octet = octetTable[addr[i]];
+                out[0] = octet[0];
+                out[1] = octet[1];
+                out[2] = octet[2];
+                out += octet[3];
+                *out++ = '.';
+            }
+            return out - 1;
+        }
+
+#ifdef HAVE_IPV6_SUPPORT
+        //--------------------------------------------------------------
+        // Writes an unsigned number in decimal. Needs room for 10 characters.
+        static char* formatDecimalText(uint32_t value, char* out) throw()
+        {
+            char digits[10];
+            char* p = digits + sizeof(digits);
+            while(value >= 100U)
+            {
+                const char* pair = decimalPairTable + ((value % 100U) * 2U);
+                value /= 100U;
+                *--p = pair[1];
+                *--p = pair[0];
+            }
+            if(value >= 10U)
+            {
+                const char* pair = decimalPairTable + (value * 2U);
+                *--p = pair[1];
+                *--p = pair[0];
+            }
+            else
+            {
+                *--p = static_cast<char>('0' + value);
+            }
+
+            size_t length = digits + sizeof(digits) - p;
+            ::memcpy(out, p, length);
+            return out + length;
+        }
+
+        //--------------------------------------------------------------
+        // Writes an IPv6 address as recommended by RFC 5952: lower case
+        // hex digits without leading zeros, and the longest run of two
+        // or more zero groups (the first one on a tie) replaced by "::".
+        // Like inet_ntop(), IPv4-compatible and IPv4-mapped addresses end
+        // in dotted-quad notation. Needs room for 45 characters.
+        static char* formatIPv6Text(const uint8_t* addr, char* out) throw()
+        {
+            uint32_t words[8];
+            int bestBase = -1, bestLength = 0;
+            int base = -1;
+
+            for(int i = 0; i < 8; ++i)
+            {
+                words[i] = (static_cast<uint32_t>(addr[2 * i]) << 8) | addr[(2 * i) + 1];
+                if(words[i] == 0)
+                {
+                    if(base < 0)
+                    {
+                        base = i;
+                    }
+                    if(i - base + 1 > bestLength)
+                    {
+                        bestBase = base;
+                        bestLength = i - base + 1;
+                    }
+                }
+                else
+                {
+                    base = -1;
+                }
+            }
+
+            if(bestLength < 2)
+            {
+                bestBase = -1;
+            }
+
+            for(int i = 0; i < 8; ++i)
+            {
+                if(i == bestBase)
+                {
+                    *out++ = ':';
+                    i += bestLength - 1;
+                    if(i == 7)
+                    {
+                        *out++ = ':';
+                    }
+                    continue;
+                }
+
+                if(i != 0)
+                {
+                    *out++ = ':';
+                }
+
+                if((i == 6) && (bestBase == 0) &&
+                        ((bestLength == 6) || ((bestLength == 5) && (words[5] == 0xffffU))))
+                {
+                    return formatIPv4Text(addr + 12, out);
+                }
+
+                uint32_t word = words[i];
+                if(word >= 0x1000U)
+                {
+                    *out++ = hexCharTable[word >> 12];
+                }
+                if(word >= 0x100U)
+                {
+                    *out++ = hexCharTable[(word >> 8) & 0x0fU];
+                }
+                if(word >= 0x10U)
+                {
+                    *out++ = hexCharTable[(word >> 4) & 0x0fU];
+                }
+                *out++ = hexCharTable[word & 0x0fU];
+            }
+
+            return out;
+        }
+#endif
+
+        //--------------------------------------------------------------
+        // Parses a dotted-quad IPv4 address in [p, end) into four bytes
+        // in network byte order. Like inet_pton(), each part must be a
+        // decimal number from 0 to 255 without leading zeros.
+        static bool parseIPv4Text(const char* p, const char* end, uint8_t* dst) throw()
+        {
+            for(int octet = 0; octet < 4; ++octet)
+            {
+                if(octet > 0)
+                {
+                    if((p == end) || (*p != '.'))
+                    {
+                        return false;
+                    }
+                    ++p;
+                }
+
+                const char* start = p;
+                uint32_t value = 0;
+                while((p != end) && (p - start < 3) &&
+                        (static_cast<uint8_t>(*p - '0') <= 9U))
+                {
+                    value = (value * 10U) + static_cast<uint32_t>(*p - '0');
+                    ++p;
+                }
+
+                if((p == start) || (value > 255U) ||
+                        ((*start == '0') && (p - start > 1)))
+                {
+                    return false;
+                }
+                dst[octet] = static_cast<uint8_t>(value);
+            }
+
+            return (p == end);
+        }
+
+#ifdef HAVE_IPV6_SUPPORT
+        //--------------------------------------------------------------
+        // Parses the scope id found after the '%' of an IPv6 address. A
+        // numeric scope id is taken as the interface index, anything
+        // else is looked up as an interface name.
+        static bool parseScopeId(const char* p, const char* end, uint32_t& index) throw()
+        {
+            if(p == end)
+            {
+                return false;
+            }
+
+            uint64_t value = 0;
+            const char* q = p;
+            while((q != end) && (static_cast<uint8_t>(*q - '0') <= 9U))
+            {
+                value = (value * 10U) + static_cast<uint64_t>(*q - '0');
+                if(value > 0xFFFFFFFFU)
+                {
+                    return false;
+                }
+                ++q;
+            }
+
+            if(q == end)
+            {
+                index = static_cast<uint32_t>(value);
+                return true;
+            }
+
+            char name[IF_NAMESIZE];
+            if(end - p >= IF_NAMESIZE)
+            {
+                return false;
+            }
+            ::memcpy(name, p, end - p);
+            name[end - p] = '\0';
+            if(::memchr(name, '\0', end - p) != NULL)
+            {
+                return false;
+            }
+
+            index = ::if_nametoindex(name);
+            return (index != 0);
+        }
+
+        //--------------------------------------------------------------
+        // Parses an IPv6 address (without its scope id) in [p, end) into
+        // sixteen bytes in network byte order. This follows the same
+        // grammar as inet_pton(AF_INET6, ...).
+        static bool parseIPv6Text(const char* p, const char* end, uint8_t* dst) throw()
+        {
+            uint8_t words[16];
+            int length = 0;
+            int gap = -1; // Where the "::" was found, if any
+
+            if((p != end) && (*p == ':'))
+            {
+                ++p;
+                if((p == end) || (*p != ':'))
+                {
+                    return false;
+                }
+            }
+
+            while(p != end)
+            {
+                if(*p == ':')
+                {
+                    // The only way to see a colon here is as the second
+                    // half of a "::".
+                    if(gap >= 0)
+                    {
+                        return false;
+                    }
+                    gap = length;
+                    ++p;
+                    continue;
+                }
+
+                const char* start = p;
+                uint32_t value = 0;
+                uint8_t digit;
+                while((p != end) && (p - start < 4) &&
+                        ((digit = hexDigitTable[static_cast<uint8_t>(*p)]) != 0xff))
+                {
+                    value = (value << 4) | digit;
+                    ++p;
+                }
+
+                if((p != end) && (*p == '.'))
+                {
+                    // Embedded IPv4 address which must be the last part.
+                    if((length > 12) || !parseIPv4Text(start, end, words + length))
+                    {
+                        return false;
+                    }
+                    length += 4;
+                    p = end;
+                    break;
+                }
+
+                if((p == start) || (length > 14))
+                {
+                    return false;
+                }
+                words[length++] = static_cast<uint8_t>(value >> 8);
+                words[length++] = static_cast<uint8_t>(value);
+
+                if(p != end)
+                {
+                    if(*p != ':')
+                    {
+                        return false;
+                    }
+                    ++p;
+                    if(p == end)
+                    {
+                        // A trailing single colon.
+                        return false;
+                    }
+                }
+            }
+
+            if(gap >= 0)
+            {
+                if(length == 16)
+                {
+                    return false;
+                }
+                int tail = length - gap;
+                ::memset(dst, 0, 16);
+                ::memcpy(dst, words, gap);
+                ::memcpy(dst + 16 - tail, words + gap, tail);
+            }
+            else
+            {
+                if(length != 16)
+                {
+                    return false;
+                }
+                ::memcpy(dst, words, 16);
+            }
+
+            return true;
+        }
+#endif
+
+#ifdef FROG_PARSE_SSE41
+        //--------------------------------------------------------------
+        // A dotted quad is 7 to 15 characters long, so it fits in one
+        // vector. Its shape is given by the lengths of its four octets,
+        // each 1 to 3 digits: 81 shapes. For each shape, ipv4Shapes holds
+        // the shuffle that moves the digits of octet k to bytes 4k to
+        // 4k+2 (hundreds, tens, units, missing digits being zero) and the
+        // positions of the first digits of the octets that have more than
+        // one digit, which must not be zeros.
+        struct IPv4Shape
+        {
+            uint8_t shuffle[16];
+            uint32_t leading;
+        };
+
+        static IPv4Shape ipv4Shapes[81];
+
+        static void buildIPv4Shapes() throw()
+        {
+            for(uint32_t shape = 0; shape < 81; ++shape)
+            {
+                uint32_t lengths[4] = { shape / 27 + 1, (shape / 9) % 3 + 1, (shape / 3) % 3 + 1, shape % 3 + 1 };
+                uint32_t start = 0;
+                ::memset(ipv4Shapes[shape].shuffle, 0x80, 16);
+                ipv4Shapes[shape].leading = 0;
+                for(uint32_t k = 0; k < 4; ++k)
+                {
+                    for(uint32_t j = 3 - lengths[k]; j < 3; ++j)
+                    {
+                        ipv4Shapes[shape].shuffle[4 * k + j] = static_cast<uint8_t>(start + j - (3 - lengths[k]));
+                    }
+                    if(lengths[k] > 1)
+                    {
+                        ipv4Shapes[shape].leading |= 1U << start;
+                    }
+                    start += lengths[k] + 1;
+                }
+            }
+        }
+
+        //--------------------------------------------------------------
+        // Parses a dotted quad with SSE4.1. Returns false for anything
+        // that is not one, leaving the final word to the scalar parser.
+        __attribute__((target("sse4.1")))
+        static inline bool parseIPv4SSE41(const char* p, size_t n, uint8_t* dst) throw()
+        {
+            if((n < 7) || (n > 15))
+            {
+                return false;
+            }
+
+            // Reading 16 bytes is safe unless they cross into the next
+            // page; the bytes past the text are masked off.
+            __m128i text;
+            if((reinterpret_cast<uintptr_t>(p) & 4095U) <= 4096U - 16U)
+            {
+                text = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            }
+            else
+            {
+                char buf[16];
+                ::memset(buf, 0, sizeof(buf));
+                ::memcpy(buf, p, n);
+                text = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+            }
+
+            uint32_t inText = (1U << n) - 1U;
+            __m128i digits = _mm_sub_epi8(text, _mm_set1_epi8('0'));
+            uint32_t isDigit = static_cast<uint32_t>(_mm_movemask_epi8(
+                        _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits)));
+            uint32_t isDot = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(text, _mm_set1_epi8('.')))) & inText;
+            if(((isDigit & inText) | isDot) != inText)
+            {
+                return false;
+            }
+
+            // Exactly three dots: clearing the lowest two leaves one bit.
+            uint32_t dot0 = __builtin_ctz(isDot | 0x10000U);
+            isDot &= isDot - 1U;
+            uint32_t dot1 = __builtin_ctz(isDot | 0x10000U);
+            isDot &= isDot - 1U;
+            uint32_t dot2 = __builtin_ctz(isDot | 0x10000U);
+            if((isDot == 0) || ((isDot & (isDot - 1U)) != 0))
+            {
+                return false;
+            }
+            uint32_t length0 = dot0 - 1U;
+            uint32_t length1 = dot1 - dot0 - 2U;
+            uint32_t length2 = dot2 - dot1 - 2U;
+            uint32_t length3 = static_cast<uint32_t>(n) - dot2 - 2U;
+            // Each length less one must be 0, 1 or 2; a length of zero
+            // wraps around and fails the test too.
+            if((length0 > 2U) | (length1 > 2U) | (length2 > 2U) | (length3 > 2U))
+            {
+                return false;
+            }
+
+            const IPv4Shape& shape = ipv4Shapes[length0 * 27U + length1 * 9U + length2 * 3U + length3];
+            uint32_t isZero = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(text, _mm_set1_epi8('0'))));
+            if((isZero & shape.leading) != 0)
+            {
+                return false;
+            }
+
+            __m128i placed = _mm_shuffle_epi8(digits, _mm_loadu_si128(reinterpret_cast<const __m128i*>(shape.shuffle)));
+            __m128i pairs = _mm_maddubs_epi16(placed, _mm_set_epi8(0, 1, 10, 100, 0, 1, 10, 100,
+                        0, 1, 10, 100, 0, 1, 10, 100));
+            __m128i octets = _mm_madd_epi16(pairs, _mm_set1_epi16(1));
+            if(_mm_movemask_epi8(_mm_cmpgt_epi32(octets, _mm_set1_epi32(255))) != 0)
+            {
+                return false;
+            }
+
+            uint32_t packed = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_shuffle_epi8(octets,
+                            _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 12, 8, 4, 0))));
+            ::memcpy(dst, &packed, 4);
+            return true;
+        }
+#endif
+
+        //--------------------------------------------------------------
+        // Scalar version of tryParseBatch(), also the reference for the
+        // vector version.
+        static size_t parseBatchScalar(const char* const* texts, const size_t* lengths, size_t count,
+                InetAddressValue* out) throw()
+        {
+            size_t valid = 0;
+            for(size_t i = 0; i < count; ++i)
+            {
+                if(InetAddress::tryParse(texts[i], lengths[i], out[i]))
+                {
+                    ++valid;
+                }
+                else
+                {
+                    ::memset(&out[i], 0, sizeof(InetAddressValue));
+                    out[i].family = AddressFamily::Unspecified;
+                }
+            }
+            return valid;
+        }
+
+#ifdef FROG_PARSE_SSE41
+        //--------------------------------------------------------------
+        // SSE4.1 version of tryParseBatch(): dotted quads take the vector
+        // path and everything else goes through the scalar parser.
+        __attribute__((target("sse4.1")))
+        static size_t parseBatchSSE41(const char* const* texts, const size_t* lengths, size_t count,
+                InetAddressValue* out) throw()
+        {
+            size_t valid = 0;
+            for(size_t i = 0; i < count; ++i)
+            {
+                uint8_t addr[4];
+                if(parseIPv4SSE41(texts[i], lengths[i], addr))
+                {
+                    ::memset(&out[i], 0, sizeof(InetAddressValue));
+                    ::memcpy(out[i].address + InetAddressValue::IPV4_OFFSET, addr, 4);
+                    out[i].family = AddressFamily::InterNetwork;
+                    ++valid;
+                }
+                else
+                {
+                    valid += parseBatchScalar(texts + i, lengths + i, 1, out + i);
+                }
+            }
+            return valid;
+        }
+#endif
+
+        //--------------------------------------------------------------
+        typedef size_t (*ParseBatchFunction)(const char* const*, const size_t*, size_t, InetAddressValue*);
+
+        //--------------------------------------------------------------
+        // Picks the vector version if the processor supports it.
+        static ParseBatchFunction chooseBatchParser() throw()
         {
-            memset(address_, 0, sizeof(uint8_t) * MAX_ADDR_SIZE);
+#ifdef FROG_PARSE_SSE41
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("sse4.1"))
+            {
+                buildIPv4Shapes();
+                return parseBatchSSE41;
+            }
+#endif
+            return parseBatchScalar;
         }
 
         //--------------------------------------------------------------
-        InetAddress::InetAddress(const InetAddress& addr) throw() :
-          addressFamily(addressFamily_), ipv4Compatible(ipv4Compatible_)
+        InetAddress::InetAddress() throw() :
+          ipv4Compatible_(true)
         {
-            ::memcpy(address_, addr.address_, sizeof(uint8_t) * MAX_ADDR_SIZE);
-            addressFamily_ = addr.addressFamily_;
-            ipv4Compatible_ = addr.ipv4Compatible_;
-            index_ = addr.index_;
+            ::memset(&value_, 0, sizeof(InetAddressValue));
+            value_.family = AddressFamily::Unspecified;
         }
 
         //--------------------------------------------------------------
-        InetAddress::InetAddress(const std::string& ipAddress, uint32_t index) throw(sys::IllegalArgumentException) :
-          addressFamily(addressFamily_), ipv4Compatible(ipv4Compatible_)
+        InetAddress::InetAddress(const std::string& ipAddress, uint32_t index) throw(sys::IllegalArgumentException)
         {
             // We know that it is not an IPv4 address if it contains
             // a semicolon.
@@ -80,7 +691,7 @@ namespace frog
                 }
 
                 this->initIPv4(inaddr);
-                addressFamily_ = AddressFamily::InterNetwork;
+                value_.family = AddressFamily::InterNetwork;
                 ipv4Compatible_ = true;
             }
             else
@@ -102,46 +713,127 @@ namespace frog
                 }
 
                 this->initIPv6(in6addr, index);
-                addressFamily_ = AddressFamily::InterNetworkV6;
+                value_.family = AddressFamily::InterNetworkV6;
                 ipv4Compatible_ = IN6_IS_ADDR_V4COMPAT(&in6addr);
 #else
+                (void)index;
                 throw sys::IllegalArgumentException("IP address is not valid.");
 #endif
             }
         }
 
         //--------------------------------------------------------------
-        InetAddress::InetAddress(const struct in_addr& ipAddress) throw(sys::ArgumentOutOfBoundsException) :
-          addressFamily(addressFamily_), ipv4Compatible(ipv4Compatible_)
+        InetAddress::InetAddress(const struct in_addr& ipAddress) throw(sys::ArgumentOutOfBoundsException)
         {
             this->initIPv4(ipAddress);
-            addressFamily_ = AddressFamily::InterNetwork;
+            value_.family = AddressFamily::InterNetwork;
             ipv4Compatible_ = true;
         }
 
         //--------------------------------------------------------------
 #ifdef HAVE_IPV6_SUPPORT
-        InetAddress::InetAddress(const struct in6_addr& ipAddress, uint32_t index) throw(sys::ArgumentOutOfBoundsException) :
-          addressFamily(addressFamily_), ipv4Compatible(ipv4Compatible_)
+        InetAddress::InetAddress(const struct in6_addr& ipAddress, uint32_t index) throw(sys::ArgumentOutOfBoundsException)
         {
             this->initIPv6(ipAddress, index);
-            addressFamily_ = AddressFamily::InterNetworkV6;
+            value_.family = AddressFamily::InterNetworkV6;
             ipv4Compatible_ = IN6_IS_ADDR_V4COMPAT(&ipAddress);
         }
 #endif
 
+        //--------------------------------------------------------------
+        InetAddress::InetAddress(const InetAddressValue& value) throw() :
+          ipv4Compatible_(value.isIPv4Compatible()), value_(value)
+        {
+        }
+
+        //--------------------------------------------------------------
+        bool InetAddress::tryParse(const char* p, size_t n, InetAddressValue& out) throw()
+        {
+            if((p == NULL) || (n == 0))
+            {
+                return false;
+            }
+
+            const char* end = p + n;
+
+            // The first character that is not a decimal digit tells us
+            // which family we are looking at: IPv4 if it is a dot.
+            const char* q = p;
+            while((q != end) && (q - p < 4) && (static_cast<uint8_t>(*q - '0') <= 9U))
+            {
+                ++q;
+            }
+
+            if((q != end) && (*q == '.'))
+            {
+                uint8_t addr[INADDRSZ];
+                if(!parseIPv4Text(p, end, addr))
+                {
+                    return false;
+                }
+
+                ::memset(&out, 0, sizeof(InetAddressValue));
+                ::memcpy(out.address + IPV4_OFFSET, addr, sizeof(uint8_t) * INADDRSZ);
+                out.family = AddressFamily::InterNetwork;
+                return true;
+            }
+
+#ifdef HAVE_IPV6_SUPPORT
+            const char* zone = static_cast<const char*>(::memchr(p, '%', n));
+            uint32_t index = 0;
+            if((zone != NULL) && !parseScopeId(zone + 1, end, index))
+            {
+                return false;
+            }
+
+            struct in6_addr in6addr;
+            if(!parseIPv6Text(p, (zone != NULL) ? zone : end, in6addr.s6_addr))
+            {
+                return false;
+            }
+
+            ::memcpy(out.address, in6addr.s6_addr, sizeof(uint8_t) * INADDRSZ6);
+            out.scope = index;
+            out.reserved = 0;
+            out.family = AddressFamily::InterNetworkV6;
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        //--------------------------------------------------------------
+        bool InetAddress::tryParse(const char* p, size_t n, InetAddress& out) throw()
+        {
+            InetAddressValue value;
+            if(!tryParse(p, n, value))
+            {
+                return false;
+            }
+            out.value_ = value;
+            out.ipv4Compatible_ = value.isIPv4Compatible();
+            return true;
+        }
+
+        //--------------------------------------------------------------
+        size_t InetAddress::tryParseBatch(const char* const* texts, const size_t* lengths, size_t count,
+                InetAddressValue* out) throw()
+        {
+            static const ParseBatchFunction parser = chooseBatchParser();
+            return parser(texts, lengths, count, out);
+        }
+
         //--------------------------------------------------------------
         InetAddress InetAddress::getLocalHost() throw(UnknownHostException)
         {
             std::vector<NetworkInterface>::iterator intfaceIter;
             std::vector<NetworkInterface> netInterfaces	= NetworkInterface::getNetworkInterfaces();
-            NetworkInterface::InterfaceAddrList addrList;
-            NetworkInterface::InterfaceAddrListIterator addrListIter;
+            NetworkInterface::InterfaceAddrListConstIterator addrListIter;
 
             for(intfaceIter = netInterfaces.begin(); intfaceIter != netInterfaces.end();
                     ++intfaceIter)
             {
-                addrList = intfaceIter->getInterfaceAddresses();
+                const NetworkInterface::InterfaceAddrList& addrList = intfaceIter->getInterfaceAddresses();
                 for(addrListIter = addrList.begin(); addrListIter != addrList.end();
                         ++addrListIter)
                 {
@@ -159,240 +851,153 @@ namespace frog
         }
 
         //--------------------------------------------------------------
-        bool InetAddress::isAnyLocalAddress() throw()
+        void InetAddress::getPrimitive(struct in_addr& rawIPAddress) const
         {
-            if(this->addressFamily == AddressFamily::InterNetwork)
-            {
-                return((address_[IPV4_OFFSET + 0] == 0x00) && (address_[IPV4_OFFSET + 1] == 0x00) &&
-                        (address_[IPV4_OFFSET + 2] == 0x00) && (address_[IPV4_OFFSET + 3] == 0x00));
-            }
-#ifdef HAVE_IPV6_SUPPORT
-            else if(this->addressFamily == AddressFamily::InterNetworkV6)
-            {
-                uint8_t test = 0x00;
-                for(int i= 0; i < MAX_ADDR_SIZE; ++i)
-                {
-                    test |= address_[i];
-                }
-                return (test == 0x00);
-            }
-#endif
-
-            return false;
+            ::memset(&rawIPAddress, 0, sizeof(struct in_addr));
+            ::memcpy(&rawIPAddress.s_addr, value_.address + IPV4_OFFSET, sizeof(uint8_t) * INADDRSZ);
         }
 
         //--------------------------------------------------------------
-        bool InetAddress::isLoopbackAddress() throw()
-        {
-            if(this->addressFamily == AddressFamily::InterNetwork)
-            {
-                return (address_[IPV4_OFFSET + 0] == 127U);
-            }
 #ifdef HAVE_IPV6_SUPPORT
-            else if(this->addressFamily == AddressFamily::InterNetworkV6)
-            {
-                uint8_t test = 0x00;
-                for(int i= 0; i < 15; ++i)
-                {
-                    test |= address_[i];
-                }
-                return ((test == 0x00) && (address_[15] == 0x01U));
-            }
+        void InetAddress::getPrimitive(struct in6_addr& rawIPAddress) const
+        {
+            ::memset(&rawIPAddress, 0, sizeof(struct in6_addr));
+            ::memcpy(&rawIPAddress.s6_addr, value_.address, sizeof(uint8_t) * INADDRSZ6);
+        }
 #endif
 
-            return false;
+        //--------------------------------------------------------------
+        InetAddress& InetAddress::operator++() throw()
+        {
+            return (*this += 1);
         }
 
         //--------------------------------------------------------------
-        bool InetAddress::isMulticastAddress() throw()
+        InetAddress InetAddress::operator++(int) throw()
         {
-            if(this->addressFamily == AddressFamily::InterNetwork)
-            {
-                return ((address_[IPV4_OFFSET + 0] & 0xf0) == 224U);
-            }
-#ifdef HAVE_IPV6_SUPPORT
-            else if(this->addressFamily == AddressFamily::InterNetworkV6)
-            {
-                return ((address_[0] & 0xffU) == 0xffU);
-            }
-#endif
-            return false;
+            InetAddress previous(*this);
+            *this += 1;
+            return previous;
         }
 
         //--------------------------------------------------------------
-        bool InetAddress::isLinkLocalAddress() throw()
+        InetAddress& InetAddress::operator--() throw()
         {
-            if(this->addressFamily == AddressFamily::InterNetwork)
-            {
-                return (((address_[IPV4_OFFSET + 0] & 0xffU) == 169U) &&
-                        ((address_[IPV4_OFFSET + 1] & 0xffU) == 254U));
-            }
-#ifdef HAVE_IPV6_SUPPORT
-            else if(this->addressFamily == AddressFamily::InterNetworkV6)
-            {
-                return (((address_[0] & 0xffU) == 0xfeU) &&
-                        ((address_[1] & 0xc0U) == 0x80U));
-            }
-#endif
-            return false;
+            return (*this -= 1);
         }
 
         //--------------------------------------------------------------
-        bool InetAddress::isSiteLocalAddress() throw()
+        InetAddress InetAddress::operator--(int) throw()
         {
-            if(this->addressFamily == AddressFamily::InterNetwork)
-            {
-                return ((address_[IPV4_OFFSET + 0] & 0xffU) == 10U) ||
-                    (((address_[IPV4_OFFSET + 0] & 0xffU) == 172U) &&
-                     ((address_[IPV4_OFFSET + 1] & 0xffU) == 16U)) ||
-                    (((address_[IPV4_OFFSET + 0] & 0xffU) == 192U) &&
-                     ((address_[IPV4_OFFSET + 1] & 0xffU) == 168U));
-            }
-#ifdef HAVE_IPV6_SUPPORT
-            else if(this->addressFamily == AddressFamily::InterNetworkV6)
-            {
-                return (((address_[0] & 0xffU) == 0xfeU) &&
-                        ((address_[1] & 0xc0U) == 0xc0U));
-            }
-#endif
-            return false;
+            InetAddress previous(*this);
+            *this -= 1;
+            return previous;
         }
 
         //--------------------------------------------------------------
-        bool InetAddress::isMulticastGlobal() throw()
+        InetAddress& InetAddress::operator+=(int64_t offset) throw()
         {
-            if(this->addressFamily == AddressFamily::InterNetwork)
+            Inet4Address addr4;
+            Inet6Address addr6;
+            if(Inet4Address::fromValue(value_, addr4))
             {
-                return (((address_[IPV4_OFFSET + 0] & 0xffU) >= 224U) &&
-                        ((address_[IPV4_OFFSET + 0] & 0xffU) <= 238U)) &&
-                    !(((address_[IPV4_OFFSET + 0] & 0xffU) == 224U) && 
-                            ((address_[IPV4_OFFSET + 1] & 0xffU) == 0) &&
-                            ((address_[IPV4_OFFSET + 2] & 0xffU) == 0));
+                value_ = advance(addr4, offset).toValue();
             }
-#ifdef HAVE_IPV6_SUPPORT
-            else if(this->addressFamily == AddressFamily::InterNetworkV6)
+            else if(Inet6Address::fromValue(value_, addr6))
             {
-                return (((address_[0] & 0xffU) == 0xffU) &&
-                        ((address_[1] & 0x0fU) == 0x0eU));
+                value_ = advance(addr6, offset).toValue();
+                ipv4Compatible_ = value_.isIPv4Compatible();
             }
-#endif
-            return false;
+            return *this;
         }
 
         //--------------------------------------------------------------
-        bool InetAddress::isMulticastNodeLocal() throw()
+        InetAddress& InetAddress::operator-=(int64_t offset) throw()
         {
-            if(this->addressFamily == AddressFamily::InterNetwork)
+            Inet4Address addr4;
+            Inet6Address addr6;
+            if(Inet4Address::fromValue(value_, addr4))
             {
-                // unless ttl == 0
-                return false;
+                value_ = retreat(addr4, offset).toValue();
             }
-#ifdef HAVE_IPV6_SUPPORT
-            else if(this->addressFamily == AddressFamily::InterNetworkV6)
+            else if(Inet6Address::fromValue(value_, addr6))
             {
-                return (((address_[0] & 0xffU) == 0xffU) &&
-                        ((address_[1] & 0x0fU) == 0x01U));
+                value_ = retreat(addr6, offset).toValue();
+                ipv4Compatible_ = value_.isIPv4Compatible();
             }
-#endif
-            return false;
+            return *this;
         }
 
         //--------------------------------------------------------------
-        bool InetAddress::isMulticastLinkLocal() throw()
+        int64_t InetAddress::distance(const InetAddress& to) const throw(sys::IllegalArgumentException)
         {
-            if(this->addressFamily == AddressFamily::InterNetwork)
+            if(value_.family != to.value_.family)
             {
-                return ((address_[IPV4_OFFSET + 0] & 0xffU) == 224U) &&
-                    ((address_[IPV4_OFFSET + 1] & 0xffU) == 0) &&
-                    ((address_[IPV4_OFFSET + 2] & 0xffU) == 0);
+                throw sys::IllegalArgumentException("Address families differ.");
             }
-#ifdef HAVE_IPV6_SUPPORT
-            else if(this->addressFamily == AddressFamily::InterNetworkV6)
+
+            int64_t result = 0;
+            bool fits;
+            Inet4Address from4, to4;
+            Inet6Address from6, to6;
+            if(Inet4Address::fromValue(value_, from4) && Inet4Address::fromValue(to.value_, to4))
             {
-                return (((address_[0] & 0xffU) == 0xffU) &&
-                        ((address_[1] & 0x0fU) == 0x02U));
+                fits = net::distance(from4, to4, result);
             }
-#endif
-            return false;
-        }
-
-        //--------------------------------------------------------------
-        bool InetAddress::isMulticastSiteLocal() throw()
-        {
-            if(this->addressFamily == AddressFamily::InterNetwork)
+            else if(Inet6Address::fromValue(value_, from6) && Inet6Address::fromValue(to.value_, to6))
             {
-                return ((address_[IPV4_OFFSET + 0] & 0xffU) == 239U) &&
-                    ((address_[IPV4_OFFSET + 1] & 0xffU) == 255U);
+                fits = net::distance(from6, to6, result);
             }
-#ifdef HAVE_IPV6_SUPPORT
-            else if(this->addressFamily == AddressFamily::InterNetworkV6)
+            else
             {
-                return (((address_[0] & 0xffU) == 0xffU) &&
-                        ((address_[1] & 0x0fU) == 0x05U));
+                throw sys::IllegalArgumentException("Address family is not supported.");
             }
-#endif
-            return false;
+
+            if(!fits)
+            {
+                throw sys::ArgumentOutOfBoundsException("Distance is out of range.");
+            }
+            return result;
         }
 
         //--------------------------------------------------------------
-        bool InetAddress::isMulticastOrgLocal() throw()
+        InetAddress InetAddress::mask(uint32_t prefixLength) const throw(sys::IllegalArgumentException)
         {
-            if(this->addressFamily == AddressFamily::InterNetwork)
+            Inet4Address addr4;
+            Inet6Address addr6;
+            if(Inet4Address::fromValue(value_, addr4))
             {
-                return (((address_[IPV4_OFFSET + 0] & 0xffU) == 239U) &&
-                        ((address_[IPV4_OFFSET + 1] & 0xffU) >= 192U) &&
-                        ((address_[IPV4_OFFSET + 1] & 0xffU) <= 195U));
+                if(prefixLength > Inet4Address::BITS)
+                {
+                    throw sys::IllegalArgumentException("Prefix length is out of range.");
+                }
+                return networkAddress(addr4, prefixLength).toInetAddress();
             }
-#ifdef HAVE_IPV6_SUPPORT
-            else if(this->addressFamily == AddressFamily::InterNetworkV6)
+            if(Inet6Address::fromValue(value_, addr6))
             {
-                return (((address_[0] & 0xffU) == 0xffU) &&
-                        ((address_[1] & 0x0fU) == 0x08U));
+                if(prefixLength > Inet6Address::BITS)
+                {
+                    throw sys::IllegalArgumentException("Prefix length is out of range.");
+                }
+                return networkAddress(addr6, prefixLength).toInetAddress();
             }
-#endif
-            return false;
+            throw sys::IllegalArgumentException("Address family is not supported.");
         }
 
         //--------------------------------------------------------------
-        void InetAddress::getPrimitive(struct in_addr& rawIPAddress) const
+        InetAddress InetAddress::mask(const InetAddress& netmask) const throw(sys::IllegalArgumentException)
         {
-            ::memset(&rawIPAddress, 0, sizeof(struct in_addr));
-            ::memcpy(&rawIPAddress.s_addr, address_ + IPV4_OFFSET, sizeof(uint8_t) * INADDRSZ);
-        }
-
-        //--------------------------------------------------------------
-#ifdef HAVE_IPV6_SUPPORT
-        void InetAddress::getPrimitive(struct in6_addr& rawIPAddress) const
-        {
-            ::memset(&rawIPAddress, 0, sizeof(struct in6_addr));
-            ::memcpy(&rawIPAddress.s6_addr, address_, sizeof(uint8_t) * INADDRSZ6);
-        }
-#endif
-
-        //--------------------------------------------------------------
-        bool InetAddress::operator==(const InetAddress& addr) const throw()
-        {
-            return((!::memcmp(address_, addr.address_, sizeof(uint8_t) * MAX_ADDR_SIZE))
-                    && (addressFamily == addr.addressFamily) && index_ == addr.index_);
-        }
+            if((value_.family != netmask.value_.family) || (value_.family == AddressFamily::Unspecified))
+            {
+                throw sys::IllegalArgumentException("Address families differ.");
+            }
 
-        //--------------------------------------------------------------
-        bool InetAddress::operator!=(const InetAddress& addr) const throw()
-        {
-            return((::memcmp(address_, addr.address_, sizeof(uint8_t) * MAX_ADDR_SIZE))
-                    || (addressFamily != addr.addressFamily) || (index_ != addr.index_));
-        }
-        //--------------------------------------------------------------
-        InetAddress& InetAddress::operator=(const InetAddress& addr) throw()
-        {
-            if(this != &addr)
+            InetAddressValue result = value_;
+            for(size_t i = 0; i < sizeof(result.address); ++i)
             {
-                ::memcpy(address_, addr.address_, sizeof(uint8_t) * MAX_ADDR_SIZE);
-                addressFamily_ = addr.addressFamily_;
-                ipv4Compatible_ = addr.ipv4Compatible_;
-                index_ = addr.index_;
+                result.address[i] &= netmask.value_.address[i];
             }
-            return *this;
+            return InetAddress(result);
         }
 
         //--------------------------------------------------------------
@@ -408,10 +1013,10 @@ namespace frog
             ::memcpy(addr, &ipAddress.s_addr, sizeof(ipAddress.s_addr));
 
 
-            ::memset(address_, 0, sizeof(uint8_t) * MAX_ADDR_SIZE);
-            ::memcpy(address_ + IPV4_OFFSET, &ipAddress.s_addr, sizeof(ipAddress.s_addr));
+            ::memset(&value_, 0, sizeof(InetAddressValue));
+            ::memcpy(value_.address + IPV4_OFFSET, &ipAddress.s_addr, sizeof(ipAddress.s_addr));
 
-            index_ = 0;
+            value_.scope = 0;
         }
 
         //--------------------------------------------------------------
@@ -429,68 +1034,66 @@ namespace frog
             }
 
 
-            ::memset(address_, 0, sizeof(uint8_t) * MAX_ADDR_SIZE);
-            ::memcpy(address_, &ipAddress.s6_addr, sizeof(ipAddress.s6_addr));
+            ::memset(&value_, 0, sizeof(InetAddressValue));
+            ::memcpy(value_.address, &ipAddress.s6_addr, sizeof(ipAddress.s6_addr));
 
-            index_ = index;
+            value_.scope = index;
         }
 #endif
 
         //--------------------------------------------------------------
-        std::string InetAddress::getHostAddress() const throw()
+        size_t InetAddress::format(char* buf, size_t cap) const throw()
         {
-            std::string ipText = "";
-            if(this->addressFamily == AddressFamily::InterNetwork)
-            {
-                char dst[INET_ADDRSTRLEN];
-                struct in_addr inaddr;
-
-                ::memset(dst, 0, sizeof(char) * INET_ADDRSTRLEN);
-                ::memset(&inaddr, 0, sizeof(struct in_addr));
+            char text[MAX_TEXT_SIZE];
+            char* out = (cap >= MAX_TEXT_SIZE) ? buf : text;
+            char* end = out;
 
-                ::memcpy(&inaddr.s_addr, address_ + IPV4_OFFSET, sizeof(uint8_t) * INADDRSZ);
-#ifdef HAVE_INET_NTOP
-                if((::inet_ntop(AF_INET, &inaddr,
-                                dst, sizeof(char) * INET_ADDRSTRLEN) != NULL) && (dst != NULL))
-                {
-                    ipText = std::string(dst);
-                }
-#else
-                ipText = std::string(inet_ntoa(inaddr));
-#endif
+            if(getAddressFamily() == AddressFamily::InterNetwork)
+            {
+                end = formatIPv4Text(value_.address + IPV4_OFFSET, out);
             }
 #ifdef HAVE_IPV6_SUPPORT
-            else if(this->addressFamily == AddressFamily::InterNetworkV6)
+            else if(getAddressFamily() == AddressFamily::InterNetworkV6)
             {
-                char dst[INET6_ADDRSTRLEN];
-                struct in6_addr in6addr;
-
-                ::memset(dst, 0, sizeof(char) * INET6_ADDRSTRLEN);
-                ::memset(&in6addr, 0, sizeof(struct in6_addr));
-
-                ::memcpy(&in6addr.s6_addr, address_, sizeof(uint8_t) * INADDRSZ6);
-
-#ifdef HAVE_INET_NTOP
-                if((::inet_ntop(AF_INET6, &in6addr,
-                                dst, sizeof(char) * INET6_ADDRSTRLEN) != NULL) && (dst != NULL))
+                end = formatIPv6Text(value_.address, out);
+                if(value_.scope != 0)
                 {
-                    std::string indexSuffix = "";
-                    if(index_ != 0)
-                    {
-                        char indexTxt[3];
-                        ::memset(indexTxt, 0, 3);
-                        ::sprintf(indexTxt, "%d", index_);
-                        indexSuffix = std::string("%") + std::string(indexTxt);
-                    }
-                    ipText = std::string(dst) + indexSuffix;
+                    *end++ = '%';
+                    end = formatDecimalText(value_.scope, end);
                 }
-#else
-#error	enabling IPv6 support without a working inet_ntop(); configure without IPv6 support
-#endif
             }
 #endif
 
-            return ipText;
+            size_t length = end - out;
+            if(length >= cap)
+            {
+                if(cap > 0)
+                {
+                    buf[0] = '\0';
+                }
+                return 0;
+            }
+
+            if(out != buf)
+            {
+                ::memcpy(buf, out, length);
+            }
+            buf[length] = '\0';
+            return length;
+        }
+
+        //--------------------------------------------------------------
+        std::string InetAddress::getHostAddress() const throw()
+        {
+            char text[MAX_TEXT_SIZE];
+            return std::string(text, format(text, sizeof(text)));
+        }
+
+        //--------------------------------------------------------------
+        int32_t InetAddress::hashCode() const throw()
+        {
+            uint64_t h = value_.hash();
+            return static_cast<int32_t>(h ^ (h >> 32));
         }
 
         //--------------------------------------------------------------
@@ -0,0 +1,266 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#include <sys/stat.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <cstring>
+
+#include <frog/InetAddressLoader.h>
+#include <frog/InetAddress.h>
+#include <frog/MappedFile.h>
+
+namespace frog
+{
+    namespace net
+    {
+        //--------------------------------------------------------------
+        // The part of the text handled by one thread.
+        struct LoaderChunk
+        {
+            const char* begin;
+            const char* end;
+            size_t lines;
+            size_t firstLine;
+            InetAddressValue* out;
+            size_t count;
+            std::vector<size_t> badLines;
+            bool failed; // Set when badLines could not grow.
+        };
+
+        //--------------------------------------------------------------
+        // Each chunk but the last ends with a newline, so its lines are
+        // its newlines.
+        static void* countLines(void* arg)
+        {
+            LoaderChunk* chunk = static_cast<LoaderChunk*>(arg);
+            const char* p = chunk->begin;
+            size_t lines = 0;
+            while(p != chunk->end)
+            {
+                const char* eol = static_cast<const char*>(::memchr(p, '\n', chunk->end - p));
+                ++lines;
+                if(eol == NULL)
+                {
+                    break;
+                }
+                p = eol + 1;
+            }
+            chunk->lines = lines;
+            return NULL;
+        }
+
+        //--------------------------------------------------------------
+        static inline bool isBlank(char c) throw()
+        {
+            return (c == ' ') || (c == '\t') || (c == '\r');
+        }
+
+        static void* parseLines(void* arg)
+        {
+            LoaderChunk* chunk = static_cast<LoaderChunk*>(arg);
+            const char* p = chunk->begin;
+            size_t line = chunk->firstLine;
+            size_t count = 0;
+            while(p != chunk->end)
+            {
+                const char* eol = static_cast<const char*>(::memchr(p, '\n', chunk->end - p));
+                const char* last = (eol != NULL) ? eol : chunk->end;
+                while((p != last) && isBlank(*p))
+                {
+                    ++p;
+                }
+                while((last != p) && isBlank(last[-1]))
+                {
+                    --last;
+                }
+                if((p != last) && (*p != '#'))
+                {
+                    if(InetAddress::tryParse(p, last - p, chunk->out[count]))
+                    {
+                        ++count;
+                    }
+                    else
+                    {
+                        // An exception must not leave a thread function.
+                        try
+                        {
+                            chunk->badLines.push_back(line);
+                        }
+                        catch(const std::bad_alloc&)
+                        {
+                            chunk->failed = true;
+                            return NULL;
+                        }
+                    }
+                }
+                ++line;
+                if(eol == NULL)
+                {
+                    break;
+                }
+                p = eol + 1;
+            }
+            chunk->count = count;
+            return NULL;
+        }
+
+        //--------------------------------------------------------------
+        // Runs a function on every chunk, one thread per chunk. The first
+        // chunk runs on the calling thread, and so does any chunk whose
+        // thread cannot be created.
+        static void runChunks(std::vector<LoaderChunk>& chunks, void* (*function)(void*))
+        {
+            std::vector<pthread_t> threads(chunks.size());
+            std::vector<bool> started(chunks.size(), false);
+            for(size_t i = 1; i < chunks.size(); ++i)
+            {
+                started[i] = (::pthread_create(&threads[i], NULL, function, &chunks[i]) == 0);
+            }
+            function(&chunks[0]);
+            for(size_t i = 1; i < chunks.size(); ++i)
+            {
+                if(started[i])
+                {
+                    ::pthread_join(threads[i], NULL);
+                }
+                else
+                {
+                    function(&chunks[i]);
+                }
+            }
+        }
+
+        //--------------------------------------------------------------
+        InetAddressLoader::InetAddressLoader(size_t threads) throw() : threads_(threads)
+        {
+            if(threads_ == 0)
+            {
+                long online = ::sysconf(_SC_NPROCESSORS_ONLN);
+                threads_ = (online > 0) ? static_cast<size_t>(online) : 1U;
+            }
+        }
+
+        //--------------------------------------------------------------
+        void InetAddressLoader::load(const std::string& path) throw(sys::IOException, std::bad_alloc)
+        {
+            // An empty file cannot be mapped, but it is a valid list of
+            // no addresses. Other stat() errors are left to MappedFile.
+            struct stat info;
+            if((::stat(path.c_str(), &info) == 0) && S_ISREG(info.st_mode) && (info.st_size == 0))
+            {
+                load("", 0);
+                return;
+            }
+
+            sys::MappedFile file(path);
+            load(reinterpret_cast<const char*>(file.data()), file.size());
+        }
+
+        //--------------------------------------------------------------
+        void InetAddressLoader::load(const char* text, size_t size) throw(std::bad_alloc)
+        {
+            try
+            {
+                loadChunks(text, size);
+            }
+            catch(const std::bad_alloc&)
+            {
+                values_.clear();
+                badLines_.clear();
+                throw;
+            }
+        }
+
+        //--------------------------------------------------------------
+        void InetAddressLoader::loadChunks(const char* text, size_t size)
+        {
+            // Small texts are not worth a thread per chunk.
+            const size_t MIN_CHUNK_SIZE = 64U * 1024U;
+            size_t threads = threads_;
+            if(size / MIN_CHUNK_SIZE < threads)
+            {
+                threads = (size / MIN_CHUNK_SIZE > 0) ? size / MIN_CHUNK_SIZE : 1U;
+            }
+
+            // Cuts the text after the first newline past each even split.
+            std::vector<LoaderChunk> chunks(threads);
+            const char* end = text + size;
+            const char* begin = text;
+            for(size_t i = 0; i < threads; ++i)
+            {
+                const char* cut = end;
+                if(i + 1 < threads)
+                {
+                    cut = text + (size / threads) * (i + 1);
+                    cut = (cut < begin) ? begin : cut;
+                    const char* eol = static_cast<const char*>(::memchr(cut, '\n', end - cut));
+                    cut = (eol != NULL) ? eol + 1 : end;
+                }
+                chunks[i].begin = begin;
+                chunks[i].end = cut;
+                chunks[i].lines = 0;
+                chunks[i].count = 0;
+                chunks[i].failed = false;
+                begin = cut;
+            }
+
+            runChunks(chunks, countLines);
+
+            size_t lines = 0;
+            for(size_t i = 0; i < threads; ++i)
+            {
+                chunks[i].firstLine = lines + 1;
+                lines += chunks[i].lines;
+            }
+            values_.resize(lines);
+            badLines_.clear();
+            for(size_t i = 0, offset = 0; i < threads; ++i)
+            {
+                chunks[i].out = values_.empty() ? NULL : &values_[0] + offset;
+                offset += chunks[i].lines;
+            }
+
+            runChunks(chunks, parseLines);
+            for(size_t i = 0; i < threads; ++i)
+            {
+                if(chunks[i].failed)
+                {
+                    throw std::bad_alloc();
+                }
+            }
+
+            // Closes the gaps left by bad, empty and comment lines.
+            size_t count = 0;
+            for(size_t i = 0; i < threads; ++i)
+            {
+                if((chunks[i].count > 0) && (chunks[i].out != &values_[count]))
+                {
+                    ::memmove(&values_[count], chunks[i].out, chunks[i].count * sizeof(InetAddressValue));
+                }
+                count += chunks[i].count;
+                badLines_.insert(badLines_.end(), chunks[i].badLines.begin(), chunks[i].badLines.end());
+            }
+            values_.resize(count);
+        }
+
+    } // net ns
+} // frog ns
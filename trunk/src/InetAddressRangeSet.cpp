@@ -0,0 +1,671 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#include <algorithm>
+#include <cstring>
+
+#include <frog/InetAddressRangeSet.h>
+
+namespace frog
+{
+    namespace net
+    {
+        //--------------------------------------------------------------
+        // Operations on the numbers the ranges are made of, for both
+        // uint32_t (IPv4) and Word128 (IPv6).
+        static inline bool lessKey(uint32_t a, uint32_t b) throw()
+        {
+            return (a < b);
+        }
+
+        static inline bool lessKey(const Word128& a, const Word128& b) throw()
+        {
+            return (a.high < b.high) || ((a.high == b.high) && (a.low < b.low));
+        }
+
+        static inline bool isMaxKey(uint32_t a) throw()
+        {
+            return (a == 0xffffffffU);
+        }
+
+        static inline bool isMaxKey(const Word128& a) throw()
+        {
+            return ((a.high & a.low) == ~static_cast<uint64_t>(0));
+        }
+
+        static inline uint32_t nextKey(uint32_t a) throw()
+        {
+            return a + 1;
+        }
+
+        static inline Word128 nextKey(Word128 a) throw()
+        {
+            a.low += 1;
+            a.high += (a.low == 0);
+            return a;
+        }
+
+        static inline uint32_t previousKey(uint32_t a) throw()
+        {
+            return a - 1;
+        }
+
+        static inline Word128 previousKey(Word128 a) throw()
+        {
+            a.high -= (a.low == 0);
+            a.low -= 1;
+            return a;
+        }
+
+        // Number of trailing zero bits; the width of the key when it is 0.
+        static inline uint32_t trailingZeros(uint32_t a) throw()
+        {
+            uint32_t count = 0;
+            if(a == 0)
+            {
+                return 32;
+            }
+            while(!(a & 1U))
+            {
+                a >>= 1;
+                ++count;
+            }
+            return count;
+        }
+
+        static inline uint32_t trailingZeros(const Word128& a) throw()
+        {
+            uint64_t word = (a.low != 0) ? a.low : a.high;
+            uint32_t count = (a.low != 0) ? 0 : 64;
+            if(word == 0)
+            {
+                return 128;
+            }
+            while(!(word & 1U))
+            {
+                word >>= 1;
+                ++count;
+            }
+            return count;
+        }
+
+        // Sets the low @arg bits bits of a key.
+        static inline uint32_t fillLowBits(uint32_t a, uint32_t bits) throw()
+        {
+            return (bits >= 32) ? 0xffffffffU : (a | ((1U << bits) - 1U));
+        }
+
+        static inline Word128 fillLowBits(Word128 a, uint32_t bits) throw()
+        {
+            const uint64_t ones = ~static_cast<uint64_t>(0);
+            if(bits >= 64)
+            {
+                a.low = ones;
+                a.high |= (bits >= 128) ? ones : ((static_cast<uint64_t>(1) << (bits - 64)) - 1);
+            }
+            else
+            {
+                a.low |= (static_cast<uint64_t>(1) << bits) - 1;
+            }
+            return a;
+        }
+
+        static inline uint32_t keyBits(uint32_t) throw()
+        {
+            return 32;
+        }
+
+        static inline uint32_t keyBits(const Word128&) throw()
+        {
+            return 128;
+        }
+
+        //--------------------------------------------------------------
+        // Conversions between InetAddressValue and keys.
+        static inline uint32_t toKey4(const InetAddressValue& value) throw()
+        {
+            const uint8_t* p = value.address + InetAddressValue::IPV4_OFFSET;
+            return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+                (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+        }
+
+        static inline Word128 toKey6(const InetAddressValue& value) throw()
+        {
+            Word128 key;
+            key.high = value.high();
+            key.low = value.low();
+            return key;
+        }
+
+        static InetAddress toAddress(uint32_t key) throw()
+        {
+            InetAddressValue value;
+            ::memset(&value, 0, sizeof(value));
+            value.family = AddressFamily::InterNetwork;
+            for(size_t i = 0; i < 4; ++i)
+            {
+                value.address[InetAddressValue::IPV4_OFFSET + i] = static_cast<uint8_t>(key >> (24 - 8 * i));
+            }
+            return InetAddress(value);
+        }
+
+#ifdef HAVE_IPV6_SUPPORT
+        static InetAddress toAddress(const Word128& key) throw()
+        {
+            InetAddressValue value;
+            ::memset(&value, 0, sizeof(value));
+            value.family = AddressFamily::InterNetworkV6;
+            for(size_t i = 0; i < 8; ++i)
+            {
+                value.address[i] = static_cast<uint8_t>(key.high >> (56 - 8 * i));
+                value.address[i + 8] = static_cast<uint8_t>(key.low >> (56 - 8 * i));
+            }
+            return InetAddress(value);
+        }
+#endif
+
+        //--------------------------------------------------------------
+        template <typename K>
+            static bool lessFirst(const InetAddressRangeSet::Range<K>& a,
+                    const InetAddressRangeSet::Range<K>& b) throw()
+            {
+                return lessKey(a.first, b.first);
+            }
+
+        //--------------------------------------------------------------
+        // Sorts ranges and merges the ones that overlap or touch.
+        template <typename K>
+            static void mergeRanges(std::vector<InetAddressRangeSet::Range<K> >& ranges)
+            {
+                if(ranges.empty())
+                {
+                    return;
+                }
+                std::sort(ranges.begin(), ranges.end(), lessFirst<K>);
+
+                size_t out = 0;
+                for(size_t i = 1; i < ranges.size(); ++i)
+                {
+                    InetAddressRangeSet::Range<K>& current = ranges[out];
+                    if(isMaxKey(current.last) || !lessKey(nextKey(current.last), ranges[i].first))
+                    {
+                        if(lessKey(current.last, ranges[i].last))
+                        {
+                            current.last = ranges[i].last;
+                        }
+                    }
+                    else
+                    {
+                        ranges[++out] = ranges[i];
+                    }
+                }
+                ranges.resize(out + 1);
+            }
+
+        //--------------------------------------------------------------
+        // Intersects two merged lists.
+        template <typename K>
+            static void intersectRanges(const std::vector<InetAddressRangeSet::Range<K> >& a,
+                    const std::vector<InetAddressRangeSet::Range<K> >& b,
+                    std::vector<InetAddressRangeSet::Range<K> >& out)
+            {
+                size_t i = 0, j = 0;
+                while((i < a.size()) && (j < b.size()))
+                {
+                    InetAddressRangeSet::Range<K> range;
+                    range.first = lessKey(a[i].first, b[j].first) ? b[j].first : a[i].first;
+                    range.last = lessKey(a[i].last, b[j].last) ? a[i].last : b[j].last;
+                    if(!lessKey(range.last, range.first))
+                    {
+                        out.push_back(range);
+                    }
+                    if(lessKey(a[i].last, b[j].last))
+                    {
+                        ++i;
+                    }
+                    else
+                    {
+                        ++j;
+                    }
+                }
+            }
+
+        //--------------------------------------------------------------
+        // Removes the ranges of merged list b from merged list a.
+        template <typename K>
+            static void subtractRanges(const std::vector<InetAddressRangeSet::Range<K> >& a,
+                    const std::vector<InetAddressRangeSet::Range<K> >& b,
+                    std::vector<InetAddressRangeSet::Range<K> >& out)
+            {
+                size_t j = 0;
+                for(size_t i = 0; i < a.size(); ++i)
+                {
+                    K current = a[i].first;
+                    bool done = false;
+                    while((j < b.size()) && lessKey(b[j].last, current))
+                    {
+                        ++j;
+                    }
+                    for(size_t k = j; !done && (k < b.size()) && !lessKey(a[i].last, b[k].first); ++k)
+                    {
+                        if(lessKey(current, b[k].first))
+                        {
+                            InetAddressRangeSet::Range<K> range;
+                            range.first = current;
+                            range.last = previousKey(b[k].first);
+                            out.push_back(range);
+                        }
+                        if(!lessKey(b[k].last, a[i].last))
+                        {
+                            done = true;
+                        }
+                        else
+                        {
+                            current = nextKey(b[k].last);
+                        }
+                    }
+                    if(!done)
+                    {
+                        InetAddressRangeSet::Range<K> range;
+                        range.first = current;
+                        range.last = a[i].last;
+                        out.push_back(range);
+                    }
+                }
+            }
+
+        //--------------------------------------------------------------
+        // Splits merged ranges into the fewest aligned blocks: at each
+        // step, take the largest block that starts at the current
+        // address and does not go past the end of the range.
+        template <typename K>
+            static void appendCidrs(const std::vector<InetAddressRangeSet::Range<K> >& ranges,
+                    std::vector<Subnet>& out)
+            {
+                for(size_t i = 0; i < ranges.size(); ++i)
+                {
+                    K current = ranges[i].first;
+                    for(;;)
+                    {
+                        uint32_t bits = trailingZeros(current);
+                        K last = fillLowBits(current, bits);
+                        while(lessKey(ranges[i].last, last))
+                        {
+                            last = fillLowBits(current, --bits);
+                        }
+                        out.push_back(Subnet(toAddress(current), keyBits(current) - bits));
+                        if(!lessKey(last, ranges[i].last))
+                        {
+                            break;
+                        }
+                        current = nextKey(last);
+                    }
+                }
+            }
+
+        //--------------------------------------------------------------
+        // Copies sorted ranges into Eytzinger order: index[k] has its
+        // children at index[2k] and index[2k + 1].
+        template <typename K>
+            static size_t fillIndex(const std::vector<InetAddressRangeSet::Range<K> >& ranges,
+                    std::vector<InetAddressRangeSet::Range<K> >& index, size_t i, size_t k)
+            {
+                if(k < index.size())
+                {
+                    i = fillIndex(ranges, index, i, 2 * k);
+                    index[k] = ranges[i++];
+                    i = fillIndex(ranges, index, i, 2 * k + 1);
+                }
+                return i;
+            }
+
+        //--------------------------------------------------------------
+        // Finds the first range that ends at or after @arg key and tests
+        // whether it starts at or before it. The descent has no data
+        // dependent branches; the position of the answer is recovered
+        // from the path taken, which is encoded in the bits of k.
+        template <typename K>
+            static inline bool searchIndex(const std::vector<InetAddressRangeSet::Range<K> >& index,
+                    const K& key) throw()
+            {
+                const InetAddressRangeSet::Range<K>* base = &index[0];
+                size_t n = index.size();
+                size_t k = 1;
+                while(k < n)
+                {
+#ifdef __GNUC__
+                    __builtin_prefetch(base + k * (64 / sizeof(base[0])));
+#endif
+                    k = 2 * k + lessKey(base[k].last, key);
+                }
+#ifdef __GNUC__
+                k >>= __builtin_ffsl(static_cast<long>(~k));
+#else
+                while(k & 1)
+                {
+                    k >>= 1;
+                }
+                k >>= 1;
+#endif
+                return (k != 0) && !lessKey(key, base[k].first);
+            }
+
+        //--------------------------------------------------------------
+        // Tests the ranges one by one, for a set that is not compacted.
+        template <typename K>
+            static bool scanRanges(const std::vector<InetAddressRangeSet::Range<K> >& ranges,
+                    const K& key) throw()
+            {
+                for(size_t i = 0; i < ranges.size(); ++i)
+                {
+                    if(!lessKey(key, ranges[i].first) && !lessKey(ranges[i].last, key))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+        //--------------------------------------------------------------
+        InetAddressRangeSet::InetAddressRangeSet() throw() : dirty_(true)
+        {
+        }
+
+        //--------------------------------------------------------------
+        InetAddressRangeSet::InetAddressRangeSet(const InetAddressRangeSet& set) : Object()
+        {
+            set.compact();
+            ranges4_ = set.ranges4_;
+            ranges6_ = set.ranges6_;
+            index4_ = set.index4_;
+            index6_ = set.index6_;
+            dirty_ = false;
+        }
+
+        //--------------------------------------------------------------
+        InetAddressRangeSet& InetAddressRangeSet::operator=(const InetAddressRangeSet& set)
+        {
+            if(this != &set)
+            {
+                set.compact();
+                ranges4_ = set.ranges4_;
+                ranges6_ = set.ranges6_;
+                index4_ = set.index4_;
+                index6_ = set.index6_;
+                dirty_ = false;
+            }
+            return *this;
+        }
+
+        //--------------------------------------------------------------
+        bool InetAddressRangeSet::operator==(const InetAddressRangeSet& set) const
+        {
+            compact();
+            set.compact();
+            if((ranges4_.size() != set.ranges4_.size()) || (ranges6_.size() != set.ranges6_.size()))
+            {
+                return false;
+            }
+            for(size_t i = 0; i < ranges4_.size(); ++i)
+            {
+                if((ranges4_[i].first != set.ranges4_[i].first) || (ranges4_[i].last != set.ranges4_[i].last))
+                {
+                    return false;
+                }
+            }
+            for(size_t i = 0; i < ranges6_.size(); ++i)
+            {
+                if(lessKey(ranges6_[i].first, set.ranges6_[i].first) ||
+                        lessKey(set.ranges6_[i].first, ranges6_[i].first) ||
+                        lessKey(ranges6_[i].last, set.ranges6_[i].last) ||
+                        lessKey(set.ranges6_[i].last, ranges6_[i].last))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        //--------------------------------------------------------------
+        bool InetAddressRangeSet::operator!=(const InetAddressRangeSet& set) const
+        {
+            return !(*this == set);
+        }
+
+        //--------------------------------------------------------------
+        void InetAddressRangeSet::add(const Subnet& subnet) throw(sys::IllegalArgumentException)
+        {
+            InetAddressValue network = subnet.getNetwork().getValue();
+            uint32_t hostBits = 0;
+            if(network.family == AddressFamily::InterNetwork)
+            {
+                hostBits = 32 - subnet.getPrefixLength();
+                Range<uint32_t> range;
+                range.first = toKey4(network);
+                range.last = fillLowBits(range.first, hostBits);
+                ranges4_.push_back(range);
+            }
+#ifdef HAVE_IPV6_SUPPORT
+            else if(network.family == AddressFamily::InterNetworkV6)
+            {
+                hostBits = 128 - subnet.getPrefixLength();
+                Range<Word128> range;
+                range.first = toKey6(network);
+                range.last = fillLowBits(range.first, hostBits);
+                ranges6_.push_back(range);
+            }
+#endif
+            else
+            {
+                throw sys::IllegalArgumentException("Subnet is empty.");
+            }
+            dirty_ = true;
+        }
+
+        //--------------------------------------------------------------
+        void InetAddressRangeSet::add(const InetAddress& first, const InetAddress& last)
+            throw(sys::IllegalArgumentException)
+        {
+            const InetAddressValue& a = first.getValue();
+            const InetAddressValue& b = last.getValue();
+            if(a.family != b.family)
+            {
+                throw sys::IllegalArgumentException("Addresses are of different families.");
+            }
+
+            if(a.family == AddressFamily::InterNetwork)
+            {
+                Range<uint32_t> range;
+                range.first = toKey4(a);
+                range.last = toKey4(b);
+                if(lessKey(range.last, range.first))
+                {
+                    throw sys::IllegalArgumentException("Range is empty.");
+                }
+                ranges4_.push_back(range);
+            }
+#ifdef HAVE_IPV6_SUPPORT
+            else if(a.family == AddressFamily::InterNetworkV6)
+            {
+                Range<Word128> range;
+                range.first = toKey6(a);
+                range.last = toKey6(b);
+                if(lessKey(range.last, range.first))
+                {
+                    throw sys::IllegalArgumentException("Range is empty.");
+                }
+                ranges6_.push_back(range);
+            }
+#endif
+            else
+            {
+                throw sys::IllegalArgumentException("Address family is not supported.");
+            }
+            dirty_ = true;
+        }
+
+        //--------------------------------------------------------------
+        void InetAddressRangeSet::add(const InetAddress& addr) throw(sys::IllegalArgumentException)
+        {
+            add(addr, addr);
+        }
+
+        //--------------------------------------------------------------
+        bool InetAddressRangeSet::contains(const InetAddressValue& addr) const throw()
+        {
+            if(addr.family == AddressFamily::InterNetwork)
+            {
+                return dirty_ ? scanRanges(ranges4_, toKey4(addr)) : searchIndex(index4_, toKey4(addr));
+            }
+#ifdef HAVE_IPV6_SUPPORT
+            if(addr.family == AddressFamily::InterNetworkV6)
+            {
+                return dirty_ ? scanRanges(ranges6_, toKey6(addr)) : searchIndex(index6_, toKey6(addr));
+            }
+#endif
+            return false;
+        }
+
+        //--------------------------------------------------------------
+        InetAddressRangeSet InetAddressRangeSet::setUnion(const InetAddressRangeSet& set) const
+        {
+            compact();
+            set.compact();
+            InetAddressRangeSet result(*this);
+            result.ranges4_.insert(result.ranges4_.end(), set.ranges4_.begin(), set.ranges4_.end());
+            result.ranges6_.insert(result.ranges6_.end(), set.ranges6_.begin(), set.ranges6_.end());
+            result.dirty_ = true;
+            result.compact();
+            return result;
+        }
+
+        //--------------------------------------------------------------
+        InetAddressRangeSet InetAddressRangeSet::setIntersection(const InetAddressRangeSet& set) const
+        {
+            compact();
+            set.compact();
+            InetAddressRangeSet result;
+            intersectRanges(ranges4_, set.ranges4_, result.ranges4_);
+            intersectRanges(ranges6_, set.ranges6_, result.ranges6_);
+            result.buildIndex();
+            return result;
+        }
+
+        //--------------------------------------------------------------
+        InetAddressRangeSet InetAddressRangeSet::setDifference(const InetAddressRangeSet& set) const
+        {
+            compact();
+            set.compact();
+            InetAddressRangeSet result;
+            subtractRanges(ranges4_, set.ranges4_, result.ranges4_);
+            subtractRanges(ranges6_, set.ranges6_, result.ranges6_);
+            result.buildIndex();
+            return result;
+        }
+
+        //--------------------------------------------------------------
+        std::vector<Subnet> InetAddressRangeSet::toCidrs() const
+        {
+            compact();
+            std::vector<Subnet> cidrs;
+            appendCidrs(ranges4_, cidrs);
+#ifdef HAVE_IPV6_SUPPORT
+            appendCidrs(ranges6_, cidrs);
+#endif
+            return cidrs;
+        }
+
+        //--------------------------------------------------------------
+        InetAddressRangeSet::RangeList InetAddressRangeSet::getRanges() const
+        {
+            compact();
+            RangeList list;
+            for(size_t i = 0; i < ranges4_.size(); ++i)
+            {
+                list.push_back(std::make_pair(toAddress(ranges4_[i].first), toAddress(ranges4_[i].last)));
+            }
+#ifdef HAVE_IPV6_SUPPORT
+            for(size_t i = 0; i < ranges6_.size(); ++i)
+            {
+                list.push_back(std::make_pair(toAddress(ranges6_[i].first), toAddress(ranges6_[i].last)));
+            }
+#endif
+            return list;
+        }
+
+        //--------------------------------------------------------------
+        size_t InetAddressRangeSet::getRangeCount() const
+        {
+            compact();
+            return ranges4_.size() + ranges6_.size();
+        }
+
+        //--------------------------------------------------------------
+        bool InetAddressRangeSet::isEmpty() const throw()
+        {
+            return ranges4_.empty() && ranges6_.empty();
+        }
+
+        //--------------------------------------------------------------
+        std::string InetAddressRangeSet::toString() const throw()
+        {
+            RangeList list = getRanges();
+            std::string text("{");
+            for(size_t i = 0; i < list.size(); ++i)
+            {
+                if(i > 0)
+                {
+                    text += ", ";
+                }
+                text += list[i].first.toString();
+                if(list[i].first != list[i].second)
+                {
+                    text += "-";
+                    text += list[i].second.toString();
+                }
+            }
+            text += "}";
+            return text;
+        }
+
+        //--------------------------------------------------------------
+        void InetAddressRangeSet::compact() const
+        {
+            if(dirty_)
+            {
+                mergeRanges(ranges4_);
+                mergeRanges(ranges6_);
+                buildIndex();
+            }
+        }
+
+        //--------------------------------------------------------------
+        void InetAddressRangeSet::buildIndex() const
+        {
+            index4_.resize(ranges4_.size() + 1);
+            fillIndex(ranges4_, index4_, 0, 1);
+            index6_.resize(ranges6_.size() + 1);
+            fillIndex(ranges6_, index6_, 0, 1);
+            dirty_ = false;
+        }
+
+    } // net ns
+} // frog ns
@@ -0,0 +1,450 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <pthread.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <frog/InetAddressSort.h>
+
+namespace frog
+{
+    namespace net
+    {
+        //--------------------------------------------------------------
+        // The digits of the sort key, least significant first: the four
+        // bytes of the scope id, the sixteen bytes of the address and the
+        // two bytes of the family.
+        static const size_t SORT_DIGITS = 22U;
+
+        //--------------------------------------------------------------
+        // Below this many addresses per thread, threads cost more than
+        // they save.
+        static const size_t SORT_MIN_PER_THREAD = 64U * 1024U;
+
+        //--------------------------------------------------------------
+        // Below this many addresses, a comparison sort is faster.
+        static const size_t SORT_MIN_RADIX = 256U;
+
+        //--------------------------------------------------------------
+        // Above this many digits that vary, a range is split on its most
+        // significant digit instead of sorted from the least.
+        static const size_t SORT_MAX_LSD_PASSES = 4U;
+
+        //--------------------------------------------------------------
+        // A slice of the array, sorted by one thread in every pass.
+        struct SortChunk
+        {
+            const size_t* offsets; // Byte of each digit in a value
+            const InetAddressValue* from;
+            InetAddressValue* to;
+            size_t begin;
+            size_t end;
+            size_t first; // Digits to count
+            size_t last;
+            size_t digit;
+            std::vector<size_t> counts; // SORT_DIGITS * 256, then 256
+        };
+
+        //--------------------------------------------------------------
+        // Returns the offset in an InetAddressValue of each digit.
+        static void digitOffsets(size_t* offsets) throw()
+        {
+            uint32_t probe = 1;
+            bool little = (*reinterpret_cast<const uint8_t*>(&probe) == 1);
+            size_t scope = offsetof(InetAddressValue, scope);
+            size_t family = offsetof(InetAddressValue, family);
+            for(size_t k = 0; k < 4; ++k)
+            {
+                offsets[k] = scope + (little ? k : 3 - k);
+            }
+            for(size_t k = 0; k < 16; ++k)
+            {
+                offsets[4 + k] = offsetof(InetAddressValue, address) + 15 - k;
+            }
+            for(size_t k = 0; k < 2; ++k)
+            {
+                offsets[20 + k] = family + (little ? k : 1 - k);
+            }
+        }
+
+        //--------------------------------------------------------------
+        // Counts the bytes of the digits from first to last in the slice.
+        static void* countAllDigits(void* arg)
+        {
+            SortChunk* chunk = static_cast<SortChunk*>(arg);
+            size_t offsets[SORT_DIGITS];
+            std::copy(chunk->offsets, chunk->offsets + SORT_DIGITS, offsets);
+            size_t* counts = &chunk->counts[0];
+            const InetAddressValue* from = chunk->from;
+            size_t first = chunk->first, last = chunk->last;
+            for(size_t i = chunk->begin; i < chunk->end; ++i)
+            {
+                const uint8_t* p = reinterpret_cast<const uint8_t*>(from + i);
+                for(size_t d = first; d < last; ++d)
+                {
+                    ++counts[d * 256U + p[offsets[d]]];
+                }
+            }
+            return NULL;
+        }
+
+        //--------------------------------------------------------------
+        // Counts the bytes of the current digit in the slice.
+        static void* countDigit(void* arg)
+        {
+            SortChunk* chunk = static_cast<SortChunk*>(arg);
+            size_t* counts = &chunk->counts[SORT_DIGITS * 256U];
+            std::fill(counts, counts + 256, 0);
+            size_t offset = chunk->offsets[chunk->digit];
+            for(size_t i = chunk->begin; i < chunk->end; ++i)
+            {
+                ++counts[reinterpret_cast<const uint8_t*>(chunk->from + i)[offset]];
+            }
+            return NULL;
+        }
+
+        //--------------------------------------------------------------
+        // Moves the slice to the positions computed from the counts.
+        static void* scatterDigit(void* arg)
+        {
+            SortChunk* chunk = static_cast<SortChunk*>(arg);
+            size_t* positions = &chunk->counts[SORT_DIGITS * 256U];
+            size_t offset = chunk->offsets[chunk->digit];
+            const InetAddressValue* from = chunk->from;
+            InetAddressValue* to = chunk->to;
+            for(size_t i = chunk->begin; i < chunk->end; ++i)
+            {
+                to[positions[reinterpret_cast<const uint8_t*>(from + i)[offset]]++] = from[i];
+            }
+            return NULL;
+        }
+
+        //--------------------------------------------------------------
+        // Runs a function on every chunk, one thread per chunk. The first
+        // chunk runs on the calling thread, and so does any chunk whose
+        // thread cannot be created.
+        static void runChunks(std::vector<SortChunk>& chunks, void* (*function)(void*)) throw()
+        {
+            std::vector<pthread_t> threads(chunks.size());
+            std::vector<bool> started(chunks.size(), false);
+            for(size_t i = 1; i < chunks.size(); ++i)
+            {
+                started[i] = (::pthread_create(&threads[i], NULL, function, &chunks[i]) == 0);
+            }
+            function(&chunks[0]);
+            for(size_t i = 1; i < chunks.size(); ++i)
+            {
+                if(started[i])
+                {
+                    ::pthread_join(threads[i], NULL);
+                }
+                else
+                {
+                    function(&chunks[i]);
+                }
+            }
+        }
+
+        //--------------------------------------------------------------
+        // Moves every chunk from one array to the other in the order of
+        // one digit.
+        static void scatterPass(std::vector<SortChunk>& chunks, const InetAddressValue* from,
+                InetAddressValue* to, size_t digit) throw()
+        {
+            size_t threads = chunks.size();
+            for(size_t t = 0; t < threads; ++t)
+            {
+                chunks[t].from = from;
+                chunks[t].to = to;
+                chunks[t].digit = digit;
+            }
+            if(threads > 1)
+            {
+                runChunks(chunks, countDigit);
+            }
+            else
+            {
+                std::copy(&chunks[0].counts[digit * 256U], &chunks[0].counts[digit * 256U] + 256,
+                        &chunks[0].counts[SORT_DIGITS * 256U]);
+            }
+
+            // Each thread writes its share of every byte value after the
+            // shares of the threads before it.
+            size_t position = 0;
+            for(size_t b = 0; b < 256U; ++b)
+            {
+                for(size_t t = 0; t < threads; ++t)
+                {
+                    size_t& slot = chunks[t].counts[SORT_DIGITS * 256U + b];
+                    size_t n = slot;
+                    slot = position;
+                    position += n;
+                }
+            }
+            runChunks(chunks, scatterDigit);
+        }
+
+        //--------------------------------------------------------------
+        // Sorts values on the digits below last, using temp as the second
+        // array. The result is left in values.
+        static void sortRange(InetAddressValue* values, InetAddressValue* temp, size_t count,
+                size_t threads, const size_t* offsets, size_t last) throw()
+        {
+            if(count < SORT_MIN_RADIX)
+            {
+                std::stable_sort(values, values + count);
+                return;
+            }
+            if(count / SORT_MIN_PER_THREAD < threads)
+            {
+                threads = (count / SORT_MIN_PER_THREAD > 0) ? count / SORT_MIN_PER_THREAD : 1U;
+            }
+            std::vector<SortChunk> chunks(threads);
+            for(size_t t = 0; t < threads; ++t)
+            {
+                chunks[t].offsets = offsets;
+                chunks[t].from = values;
+                chunks[t].begin = (count / threads) * t;
+                chunks[t].end = (t + 1 == threads) ? count : (count / threads) * (t + 1);
+                chunks[t].first = 0;
+                chunks[t].last = last;
+                chunks[t].counts.assign((SORT_DIGITS + 1) * 256U, 0);
+            }
+            runChunks(chunks, countAllDigits);
+
+            // A digit that is the same in every address leaves the order
+            // as it is, so only the others are sorted on.
+            size_t digits[SORT_DIGITS];
+            size_t varying = 0;
+            for(size_t d = 0; d < last; ++d)
+            {
+                bool constant = false;
+                for(size_t b = 0; (b < 256U) && !constant; ++b)
+                {
+                    size_t total = 0;
+                    for(size_t t = 0; t < threads; ++t)
+                    {
+                        total += chunks[t].counts[d * 256U + b];
+                    }
+                    constant = (total == count);
+                }
+                if(!constant)
+                {
+                    digits[varying++] = d;
+                }
+            }
+
+            if(varying <= SORT_MAX_LSD_PASSES)
+            {
+                InetAddressValue* from = values;
+                InetAddressValue* to = temp;
+                for(size_t i = 0; i < varying; ++i)
+                {
+                    scatterPass(chunks, from, to, digits[i]);
+                    std::swap(from, to);
+                }
+                if(from != values)
+                {
+                    std::copy(from, from + count, values);
+                }
+                return;
+            }
+
+            // Too many passes: split on the most significant digit that
+            // varies and sort each part on the digits below it. The parts
+            // soon fit in the cache, and most of their bytes are the same.
+            size_t digit = digits[varying - 1];
+            size_t bounds[257];
+            bounds[0] = 0;
+            for(size_t b = 0; b < 256U; ++b)
+            {
+                size_t total = 0;
+                for(size_t t = 0; t < threads; ++t)
+                {
+                    total += chunks[t].counts[digit * 256U + b];
+                }
+                bounds[b + 1] = bounds[b] + total;
+            }
+            scatterPass(chunks, values, temp, digit);
+            chunks.clear();
+            for(size_t b = 0; b < 256U; ++b)
+            {
+                size_t begin = bounds[b], n = bounds[b + 1] - bounds[b];
+                if(n > 0)
+                {
+                    sortRange(temp + begin, values + begin, n, threads, offsets, digit);
+                    std::copy(temp + begin, temp + begin + n, values + begin);
+                }
+            }
+        }
+
+        //--------------------------------------------------------------
+        void sortAddresses(InetAddressValue* values, size_t count, size_t threads) throw()
+        {
+            if(count < SORT_MIN_RADIX)
+            {
+                std::stable_sort(values, values + count);
+                return;
+            }
+            if(threads == 0)
+            {
+                long online = ::sysconf(_SC_NPROCESSORS_ONLN);
+                threads = (online > 0) ? static_cast<size_t>(online) : 1U;
+            }
+
+            size_t offsets[SORT_DIGITS];
+            digitOffsets(offsets);
+            std::vector<InetAddressValue> buffer(count);
+            sortRange(values, &buffer[0], count, threads, offsets, SORT_DIGITS);
+        }
+
+        //--------------------------------------------------------------
+        // Returns the first position at or after begin whose address is
+        // not less than key: an exponential search followed by a binary
+        // search without branches.
+        static size_t gallop(const InetAddressValue* values, size_t begin, size_t end,
+                const InetAddressValue& key) throw()
+        {
+            if((begin == end) || !(values[begin] < key))
+            {
+                return begin;
+            }
+            size_t low = begin;
+            size_t step = 1;
+            size_t high = begin + 1;
+            while((high < end) && (values[high] < key))
+            {
+                low = high;
+                step <<= 1;
+                high = (end - low > step) ? low + step : end;
+            }
+
+            // values[low] < key, and the answer is in (low, high].
+            const InetAddressValue* first = values + low + 1;
+            size_t length = high - low - 1;
+            while(length > 1)
+            {
+                size_t half = length / 2;
+                first = (first[half] < key) ? first + half : first;
+                length -= half;
+            }
+            if((length == 1) && (*first < key))
+            {
+                ++first;
+            }
+            return static_cast<size_t>(first - values);
+        }
+
+        //--------------------------------------------------------------
+        size_t uniqueAddresses(InetAddressValue* values, size_t count) throw()
+        {
+            if(count == 0)
+            {
+                return 0;
+            }
+            size_t kept = 1;
+            for(size_t i = 1; i < count; ++i)
+            {
+                if(values[i] != values[kept - 1])
+                {
+                    values[kept++] = values[i];
+                }
+            }
+            return kept;
+        }
+
+        //--------------------------------------------------------------
+        size_t mergeAddresses(const InetAddressValue* a, size_t countA,
+                const InetAddressValue* b, size_t countB, InetAddressValue* out) throw()
+        {
+            size_t i = 0, j = 0, n = 0;
+            while((i < countA) && (j < countB))
+            {
+                int order = a[i].compare(b[j]);
+                out[n++] = (order <= 0) ? a[i] : b[j];
+                i += (order <= 0);
+                j += (order >= 0);
+            }
+            for(; i < countA; ++i)
+            {
+                out[n++] = a[i];
+            }
+            for(; j < countB; ++j)
+            {
+                out[n++] = b[j];
+            }
+            return n;
+        }
+
+        //--------------------------------------------------------------
+        size_t intersectAddresses(const InetAddressValue* a, size_t countA,
+                const InetAddressValue* b, size_t countB, InetAddressValue* out) throw()
+        {
+            // Walks the smaller array and gallops through the larger one.
+            const InetAddressValue* small = a;
+            const InetAddressValue* large = b;
+            size_t smallCount = countA, largeCount = countB;
+            if(countB < countA)
+            {
+                std::swap(small, large);
+                std::swap(smallCount, largeCount);
+            }
+
+            size_t j = 0, n = 0;
+            for(size_t i = 0; i < smallCount; ++i)
+            {
+                j = gallop(large, j, largeCount, small[i]);
+                if(j == largeCount)
+                {
+                    break;
+                }
+                if(large[j] == small[i])
+                {
+                    out[n++] = small[i];
+                    ++j;
+                }
+            }
+            return n;
+        }
+
+        //--------------------------------------------------------------
+        size_t differenceAddresses(const InetAddressValue* a, size_t countA,
+                const InetAddressValue* b, size_t countB, InetAddressValue* out) throw()
+        {
+            size_t j = 0, n = 0;
+            for(size_t i = 0; i < countA; ++i)
+            {
+                j = gallop(b, j, countB, a[i]);
+                if((j < countB) && (b[j] == a[i]))
+                {
+                    ++j;
+                }
+                else
+                {
+                    out[n++] = a[i];
+                }
+            }
+            return n;
+        }
+    } // net ns
+} // frog ns
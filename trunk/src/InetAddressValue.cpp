@@ -0,0 +1,215 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#include <frog/InetAddressValue.h>
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#define FROG_CLASSIFY_SSE2
+#include <emmintrin.h>
+#if (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9))
+#define FROG_CLASSIFY_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace frog
+{
+    namespace net
+    {
+        const size_t InetAddressValue::IPV4_OFFSET;
+        const size_t InetAddressValue::SORT_KEY_SIZE;
+        const uint32_t InetAddressValue::CLASS_IPV4;
+        const uint32_t InetAddressValue::CLASS_IPV6;
+        const uint32_t InetAddressValue::CLASS_IPV4_COMPATIBLE;
+        const uint32_t InetAddressValue::CLASS_ANY_LOCAL;
+        const uint32_t InetAddressValue::CLASS_LOOPBACK;
+        const uint32_t InetAddressValue::CLASS_LINK_LOCAL;
+        const uint32_t InetAddressValue::CLASS_SITE_LOCAL;
+        const uint32_t InetAddressValue::CLASS_MULTICAST;
+        const uint32_t InetAddressValue::CLASS_MULTICAST_GLOBAL;
+        const uint32_t InetAddressValue::CLASS_MULTICAST_NODE_LOCAL;
+        const uint32_t InetAddressValue::CLASS_MULTICAST_LINK_LOCAL;
+        const uint32_t InetAddressValue::CLASS_MULTICAST_SITE_LOCAL;
+        const uint32_t InetAddressValue::CLASS_MULTICAST_ORG_LOCAL;
+
+        //--------------------------------------------------------------
+        // Portable version of classifyBatch().
+        static void classifyScalar(const InetAddressValue* values, size_t count, uint32_t* out) throw()
+        {
+            for(size_t i = 0; i < count; ++i)
+            {
+                out[i] = values[i].classify();
+            }
+        }
+
+#ifdef FROG_CLASSIFY_SSE2
+        //--------------------------------------------------------------
+        // The vector versions work on 32-bit lanes, one address per lane.
+        // The four words of an address (w0 holds bytes 0-3, w3 holds bytes
+        // 12-15, which is the IPv4 address) are read in the little-endian
+        // order of x86, so a mask of 0xff selects the first byte of a word.
+        // Each test yields an all-ones or all-zeros lane that selects its
+        // flag. The macro is shared by the SSE2 and the AVX2 versions,
+        // which differ only in the width of the vectors.
+#define FROG_CLASSIFY_LANES(T, SET1, CMPEQ, AND, OR, ANDNOT, SRLI, w0, w1, w2, w3, fam, result) \
+        do { \
+            const T zero = SET1(0); \
+            T v4 = CMPEQ(fam, SET1(AF_INET)); \
+            T v6 = CMPEQ(fam, SET1(AF_INET6)); \
+            \
+            T b0 = AND(w3, SET1(0xff)); \
+            T b01 = AND(w3, SET1(0xffff)); \
+            T linkScope4 = CMPEQ(AND(w3, SET1(0xffffff)), SET1(224)); \
+            T is239 = CMPEQ(b0, SET1(239)); \
+            T multicast4 = CMPEQ(AND(w3, SET1(0xf0)), SET1(0xe0)); \
+            T flags4 = OR(SET1(InetAddressValue::CLASS_IPV4 | InetAddressValue::CLASS_IPV4_COMPATIBLE), \
+                    AND(CMPEQ(w3, zero), SET1(InetAddressValue::CLASS_ANY_LOCAL))); \
+            flags4 = OR(flags4, AND(CMPEQ(b0, SET1(127)), SET1(InetAddressValue::CLASS_LOOPBACK))); \
+            flags4 = OR(flags4, AND(CMPEQ(b01, SET1(169 | (254 << 8))), SET1(InetAddressValue::CLASS_LINK_LOCAL))); \
+            flags4 = OR(flags4, AND(OR(CMPEQ(b0, SET1(10)), OR(CMPEQ(b01, SET1(172 | (16 << 8))), \
+                                CMPEQ(b01, SET1(192 | (168 << 8))))), SET1(InetAddressValue::CLASS_SITE_LOCAL))); \
+            flags4 = OR(flags4, AND(multicast4, SET1(InetAddressValue::CLASS_MULTICAST))); \
+            flags4 = OR(flags4, AND(ANDNOT(OR(is239, linkScope4), multicast4), \
+                        SET1(InetAddressValue::CLASS_MULTICAST_GLOBAL))); \
+            flags4 = OR(flags4, AND(linkScope4, SET1(InetAddressValue::CLASS_MULTICAST_LINK_LOCAL))); \
+            flags4 = OR(flags4, AND(CMPEQ(b01, SET1(239 | (255 << 8))), \
+                        SET1(InetAddressValue::CLASS_MULTICAST_SITE_LOCAL))); \
+            flags4 = OR(flags4, AND(CMPEQ(AND(w3, SET1(0xfcff)), SET1(239 | (192 << 8))), \
+                        SET1(InetAddressValue::CLASS_MULTICAST_ORG_LOCAL))); \
+            \
+            T zero012 = CMPEQ(OR(OR(w0, w1), w2), zero); \
+            T tailZero = CMPEQ(w3, zero); \
+            T tailOne = CMPEQ(w3, SET1(0x01000000)); \
+            T multicast6 = CMPEQ(AND(w0, SET1(0xff)), SET1(0xff)); \
+            T scope6 = AND(SRLI(w0, 8), SET1(0x0f)); \
+            T flags6 = SET1(InetAddressValue::CLASS_IPV6); \
+            flags6 = OR(flags6, AND(ANDNOT(OR(tailZero, tailOne), zero012), \
+                        SET1(InetAddressValue::CLASS_IPV4_COMPATIBLE))); \
+            flags6 = OR(flags6, AND(AND(zero012, tailZero), SET1(InetAddressValue::CLASS_ANY_LOCAL))); \
+            flags6 = OR(flags6, AND(AND(zero012, tailOne), SET1(InetAddressValue::CLASS_LOOPBACK))); \
+            flags6 = OR(flags6, AND(CMPEQ(AND(w0, SET1(0xc0ff)), SET1(0xfe | (0x80 << 8))), \
+                        SET1(InetAddressValue::CLASS_LINK_LOCAL))); \
+            flags6 = OR(flags6, AND(CMPEQ(AND(w0, SET1(0xc0ff)), SET1(0xfe | (0xc0 << 8))), \
+                        SET1(InetAddressValue::CLASS_SITE_LOCAL))); \
+            T scopeFlags = AND(CMPEQ(scope6, SET1(0x1)), SET1(InetAddressValue::CLASS_MULTICAST_NODE_LOCAL)); \
+            scopeFlags = OR(scopeFlags, AND(CMPEQ(scope6, SET1(0x2)), SET1(InetAddressValue::CLASS_MULTICAST_LINK_LOCAL))); \
+            scopeFlags = OR(scopeFlags, AND(CMPEQ(scope6, SET1(0x5)), SET1(InetAddressValue::CLASS_MULTICAST_SITE_LOCAL))); \
+            scopeFlags = OR(scopeFlags, AND(CMPEQ(scope6, SET1(0x8)), SET1(InetAddressValue::CLASS_MULTICAST_ORG_LOCAL))); \
+            scopeFlags = OR(scopeFlags, AND(CMPEQ(scope6, SET1(0xe)), SET1(InetAddressValue::CLASS_MULTICAST_GLOBAL))); \
+            flags6 = OR(flags6, AND(multicast6, OR(scopeFlags, SET1(InetAddressValue::CLASS_MULTICAST)))); \
+            \
+            result = OR(AND(v4, flags4), AND(v6, flags6)); \
+        } while(0)
+
+        //--------------------------------------------------------------
+        // Loads four addresses and turns them into four vectors of words:
+        // w0 holds the first word of every address, and so on.
+        static inline void transpose4(const InetAddressValue* values, __m128i& w0, __m128i& w1,
+                __m128i& w2, __m128i& w3, __m128i& family) throw()
+        {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values[0].address));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values[1].address));
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values[2].address));
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values[3].address));
+            __m128i ab0 = _mm_unpacklo_epi32(a, b);
+            __m128i ab1 = _mm_unpackhi_epi32(a, b);
+            __m128i cd0 = _mm_unpacklo_epi32(c, d);
+            __m128i cd1 = _mm_unpackhi_epi32(c, d);
+            w0 = _mm_unpacklo_epi64(ab0, cd0);
+            w1 = _mm_unpackhi_epi64(ab0, cd0);
+            w2 = _mm_unpacklo_epi64(ab1, cd1);
+            w3 = _mm_unpackhi_epi64(ab1, cd1);
+            family = _mm_set_epi32(values[3].family, values[2].family, values[1].family, values[0].family);
+        }
+
+        //--------------------------------------------------------------
+        // SSE2 version of classifyBatch(), four addresses at a time.
+        static void classifySSE2(const InetAddressValue* values, size_t count, uint32_t* out) throw()
+        {
+            size_t i = 0;
+            for(; i + 4 <= count; i += 4)
+            {
+                __m128i w0, w1, w2, w3, family, result;
+                transpose4(values + i, w0, w1, w2, w3, family);
+                FROG_CLASSIFY_LANES(__m128i, _mm_set1_epi32, _mm_cmpeq_epi32, _mm_and_si128,
+                        _mm_or_si128, _mm_andnot_si128, _mm_srli_epi32, w0, w1, w2, w3, family, result);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), result);
+            }
+            classifyScalar(values + i, count - i, out + i);
+        }
+
+#ifdef FROG_CLASSIFY_AVX2
+        //--------------------------------------------------------------
+        // AVX2 version of classifyBatch(), eight addresses at a time.
+        __attribute__((target("avx2")))
+        static void classifyAVX2(const InetAddressValue* values, size_t count, uint32_t* out) throw()
+        {
+            size_t i = 0;
+            for(; i + 8 <= count; i += 8)
+            {
+                __m128i lo0, lo1, lo2, lo3, loFamily, hi0, hi1, hi2, hi3, hiFamily;
+                transpose4(values + i, lo0, lo1, lo2, lo3, loFamily);
+                transpose4(values + i + 4, hi0, hi1, hi2, hi3, hiFamily);
+                __m256i w0 = _mm256_inserti128_si256(_mm256_castsi128_si256(lo0), hi0, 1);
+                __m256i w1 = _mm256_inserti128_si256(_mm256_castsi128_si256(lo1), hi1, 1);
+                __m256i w2 = _mm256_inserti128_si256(_mm256_castsi128_si256(lo2), hi2, 1);
+                __m256i w3 = _mm256_inserti128_si256(_mm256_castsi128_si256(lo3), hi3, 1);
+                __m256i family = _mm256_inserti128_si256(_mm256_castsi128_si256(loFamily), hiFamily, 1);
+                __m256i result;
+                FROG_CLASSIFY_LANES(__m256i, _mm256_set1_epi32, _mm256_cmpeq_epi32, _mm256_and_si256,
+                        _mm256_or_si256, _mm256_andnot_si256, _mm256_srli_epi32, w0, w1, w2, w3, family, result);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), result);
+            }
+            classifySSE2(values + i, count - i, out + i);
+        }
+#endif
+#endif
+
+        //--------------------------------------------------------------
+        typedef void (*ClassifyFunction)(const InetAddressValue*, size_t, uint32_t*);
+
+        //--------------------------------------------------------------
+        // Picks the widest version the processor supports.
+        static ClassifyFunction chooseClassifier() throw()
+        {
+#ifdef FROG_CLASSIFY_AVX2
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx2"))
+            {
+                return classifyAVX2;
+            }
+#endif
+#ifdef FROG_CLASSIFY_SSE2
+            return classifySSE2;
+#else
+            return classifyScalar;
+#endif
+        }
+
+        //--------------------------------------------------------------
+        void InetAddressValue::classifyBatch(const InetAddressValue* values, size_t count, uint32_t* out) throw()
+        {
+            static const ClassifyFunction classifier = chooseClassifier();
+            classifier(values, count, out);
+        }
+
+    } // net ns
+} // frog ns
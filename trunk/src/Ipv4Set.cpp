@@ -0,0 +1,1563 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <algorithm>
+#include <cstring>
+
+#include <frog/Ipv4Set.h>
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#define FROG_BITMAP_POPCNT
+#if (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9))
+#define FROG_BITMAP_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace frog
+{
+    namespace net
+    {
+        //--------------------------------------------------------------
+        // Container forms and sizes.
+        static const uint8_t CONTAINER_ARRAY = 0;
+        static const uint8_t CONTAINER_BITMAP = 1;
+        static const uint8_t CONTAINER_RUN = 2;
+        static const uint32_t ARRAY_MAX = 4096U;
+        static const size_t BITMAP_WORDS = 1024U;
+
+        //--------------------------------------------------------------
+        // Cookies of the portable format. A set without runs starts with
+        // SERIAL_COOKIE_NO_RUN and the number of containers; a set with
+        // runs starts with SERIAL_COOKIE in 16 bits, the number of
+        // containers less one in 16 bits and a bit per container telling
+        // which hold runs. The offsets of the containers follow their keys
+        // and cardinalities unless there are runs and fewer than
+        // SERIAL_NO_OFFSET_THRESHOLD containers.
+        static const uint32_t SERIAL_COOKIE_NO_RUN = 12346U;
+        static const uint32_t SERIAL_COOKIE = 12347U;
+        static const size_t SERIAL_NO_OFFSET_THRESHOLD = 4U;
+
+        //--------------------------------------------------------------
+        struct Ipv4Set::Container
+        {
+            uint8_t type;                 // CONTAINER_ARRAY, _BITMAP or _RUN
+            uint32_t cardinality;         // 1 to 65536
+            std::vector<uint16_t> values; // Sorted values, or run starts and lengths less one
+            std::vector<uint64_t> bits;   // BITMAP_WORDS words for a bitmap
+
+            Container() : type(CONTAINER_ARRAY), cardinality(0) { }
+        };
+
+        typedef Ipv4Set::Container Container;
+
+        //--------------------------------------------------------------
+        static inline uint32_t popcount64(uint64_t word) throw()
+        {
+#ifdef __GNUC__
+            return static_cast<uint32_t>(__builtin_popcountll(word));
+#else
+            word -= (word >> 1) & 0x5555555555555555ULL;
+            word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+            word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+            return static_cast<uint32_t>((word * 0x0101010101010101ULL) >> 56);
+#endif
+        }
+
+        //--------------------------------------------------------------
+        // Operations on two bitmaps. A function of type BitmapFunction
+        // combines a and b into out, unless out is NULL, and returns the
+        // number of bits set in the result, unless count is false.
+        enum BitmapOperation { BITMAP_OR, BITMAP_AND, BITMAP_ANDNOT };
+
+        typedef uint32_t (*BitmapFunction)(const uint64_t* a, const uint64_t* b, uint64_t* out,
+                BitmapOperation operation, bool count);
+
+        //--------------------------------------------------------------
+        static inline uint64_t combine(uint64_t a, uint64_t b, BitmapOperation operation) throw()
+        {
+            return (operation == BITMAP_OR) ? (a | b) : ((operation == BITMAP_AND) ? (a & b) : (a & ~b));
+        }
+
+        //--------------------------------------------------------------
+        // The loop of the scalar versions, compiled for each target.
+#ifdef __GNUC__
+        __attribute__((always_inline))
+#endif
+        static inline uint32_t bitmapLoop(const uint64_t* a, const uint64_t* b, uint64_t* out,
+                BitmapOperation operation, bool count) throw()
+        {
+            uint32_t total = 0;
+            for(size_t i = 0; i < BITMAP_WORDS; ++i)
+            {
+                uint64_t word = combine(a[i], b[i], operation);
+                if(out != NULL)
+                {
+                    out[i] = word;
+                }
+                if(count)
+                {
+                    total += popcount64(word);
+                }
+            }
+            return total;
+        }
+
+        //--------------------------------------------------------------
+        static uint32_t bitmapScalar(const uint64_t* a, const uint64_t* b, uint64_t* out,
+                BitmapOperation operation, bool count)
+        {
+            return bitmapLoop(a, b, out, operation, count);
+        }
+
+#ifdef FROG_BITMAP_POPCNT
+        //--------------------------------------------------------------
+        // Scalar version with the POPCNT instruction.
+        __attribute__((target("popcnt")))
+        static uint32_t bitmapPopcnt(const uint64_t* a, const uint64_t* b, uint64_t* out,
+                BitmapOperation operation, bool count)
+        {
+            return bitmapLoop(a, b, out, operation, count);
+        }
+#endif
+
+#ifdef FROG_BITMAP_AVX2
+        //--------------------------------------------------------------
+        // AVX2 version, four words at a time. Bits are counted with a
+        // table of the counts of each 4-bit value and summed per word
+        // with a sum of absolute differences.
+        __attribute__((target("avx2")))
+        static uint32_t bitmapAVX2(const uint64_t* a, const uint64_t* b, uint64_t* out,
+                BitmapOperation operation, bool count)
+        {
+            const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+            const __m256i nibble = _mm256_set1_epi8(0x0f);
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i total = zero;
+            for(size_t i = 0; i < BITMAP_WORDS; i += 4)
+            {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+                __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+                __m256i word = (operation == BITMAP_OR) ? _mm256_or_si256(x, y) :
+                    ((operation == BITMAP_AND) ? _mm256_and_si256(x, y) : _mm256_andnot_si256(y, x));
+                if(out != NULL)
+                {
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), word);
+                }
+                if(count)
+                {
+                    __m256i bytes = _mm256_add_epi8(
+                            _mm256_shuffle_epi8(table, _mm256_and_si256(word, nibble)),
+                            _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(word, 4), nibble)));
+                    total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, zero));
+                }
+            }
+            uint64_t lanes[4];
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), total);
+            return static_cast<uint32_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+        }
+#endif
+
+        //--------------------------------------------------------------
+        // Picks the widest version the processor supports.
+        static BitmapFunction chooseBitmapFunction() throw()
+        {
+#ifdef FROG_BITMAP_POPCNT
+            __builtin_cpu_init();
+#ifdef FROG_BITMAP_AVX2
+            if(__builtin_cpu_supports("avx2"))
+            {
+                return bitmapAVX2;
+            }
+#endif
+            if(__builtin_cpu_supports("popcnt"))
+            {
+                return bitmapPopcnt;
+            }
+#endif
+            return bitmapScalar;
+        }
+
+        //--------------------------------------------------------------
+        static uint32_t bitmapOperation(const uint64_t* a, const uint64_t* b, uint64_t* out,
+                BitmapOperation operation, bool count = true) throw()
+        {
+            static const BitmapFunction function = chooseBitmapFunction();
+            return function(a, b, out, operation, count);
+        }
+
+        //--------------------------------------------------------------
+        // Sets the bits first to last of a bitmap.
+        static void setBits(uint64_t* words, uint32_t first, uint32_t last) throw()
+        {
+            size_t firstWord = first >> 6, lastWord = last >> 6;
+            uint64_t firstMask = ~0ULL << (first & 63);
+            uint64_t lastMask = ~0ULL >> (63 - (last & 63));
+            if(firstWord == lastWord)
+            {
+                words[firstWord] |= firstMask & lastMask;
+                return;
+            }
+            words[firstWord] |= firstMask;
+            for(size_t i = firstWord + 1; i < lastWord; ++i)
+            {
+                words[i] = ~0ULL;
+            }
+            words[lastWord] |= lastMask;
+        }
+
+        //--------------------------------------------------------------
+        // Writes the values of a container as a bitmap.
+        static void toBitmap(const Container& c, uint64_t* words) throw()
+        {
+            if(c.type == CONTAINER_BITMAP)
+            {
+                std::copy(c.bits.begin(), c.bits.end(), words);
+                return;
+            }
+            std::fill(words, words + BITMAP_WORDS, 0);
+            if(c.type == CONTAINER_ARRAY)
+            {
+                for(size_t i = 0; i < c.values.size(); ++i)
+                {
+                    words[c.values[i] >> 6] |= 1ULL << (c.values[i] & 63);
+                }
+            }
+            else
+            {
+                for(size_t i = 0; i < c.values.size(); i += 2)
+                {
+                    setBits(words, c.values[i], static_cast<uint32_t>(c.values[i]) + c.values[i + 1]);
+                }
+            }
+        }
+
+        //--------------------------------------------------------------
+        // Writes the values of a container in order and returns their
+        // number.
+        static size_t toValues(const Container& c, uint16_t* out) throw()
+        {
+            if(c.type == CONTAINER_ARRAY)
+            {
+                std::copy(c.values.begin(), c.values.end(), out);
+                return c.values.size();
+            }
+            size_t n = 0;
+            if(c.type == CONTAINER_BITMAP)
+            {
+                for(size_t i = 0; i < BITMAP_WORDS; ++i)
+                {
+                    for(uint64_t word = c.bits[i]; word != 0; word &= word - 1)
+                    {
+#ifdef __GNUC__
+                        uint32_t bit = static_cast<uint32_t>(__builtin_ctzll(word));
+#else
+                        uint32_t bit = popcount64((word & (0 - word)) - 1);
+#endif
+                        out[n++] = static_cast<uint16_t>((i << 6) + bit);
+                    }
+                }
+                return n;
+            }
+            for(size_t i = 0; i < c.values.size(); i += 2)
+            {
+                for(uint32_t v = c.values[i]; v <= static_cast<uint32_t>(c.values[i]) + c.values[i + 1]; ++v)
+                {
+                    out[n++] = static_cast<uint16_t>(v);
+                }
+            }
+            return n;
+        }
+
+        //--------------------------------------------------------------
+        // Converts a container to a bitmap.
+        static void makeBitmap(Container& c)
+        {
+            if(c.type != CONTAINER_BITMAP)
+            {
+                c.bits.resize(BITMAP_WORDS);
+                toBitmap(c, &c.bits[0]);
+                std::vector<uint16_t>().swap(c.values);
+                c.type = CONTAINER_BITMAP;
+            }
+        }
+
+        //--------------------------------------------------------------
+        // Converts a container to an array.
+        static void makeArray(Container& c)
+        {
+            if(c.type != CONTAINER_ARRAY)
+            {
+                std::vector<uint16_t> values(c.cardinality);
+                toValues(c, &values[0]);
+                c.values.swap(values);
+                std::vector<uint64_t>().swap(c.bits);
+                c.type = CONTAINER_ARRAY;
+            }
+        }
+
+        //--------------------------------------------------------------
+        // Returns the number of runs of consecutive values in a container.
+        static size_t countRuns(const Container& c) throw()
+        {
+            if(c.type == CONTAINER_RUN)
+            {
+                return c.values.size() / 2;
+            }
+            size_t runs = 0;
+            if(c.type == CONTAINER_ARRAY)
+            {
+                for(size_t i = 0; i < c.values.size(); ++i)
+                {
+                    runs += (i == 0) || (c.values[i] != c.values[i - 1] + 1);
+                }
+                return runs;
+            }
+            // A run starts at each bit set whose lower neighbour is clear.
+            uint64_t carry = 0;
+            for(size_t i = 0; i < BITMAP_WORDS; ++i)
+            {
+                uint64_t word = c.bits[i];
+                runs += popcount64(word & ~((word << 1) | carry));
+                carry = word >> 63;
+            }
+            return runs;
+        }
+
+        //--------------------------------------------------------------
+        // Converts a container to runs.
+        static void makeRuns(Container& c)
+        {
+            if(c.type == CONTAINER_RUN)
+            {
+                return;
+            }
+            std::vector<uint16_t> values(c.cardinality);
+            toValues(c, &values[0]);
+            std::vector<uint16_t> runs;
+            runs.reserve(2 * countRuns(c));
+            for(size_t i = 0; i < values.size(); )
+            {
+                size_t j = i + 1;
+                while((j < values.size()) && (values[j] == values[j - 1] + 1))
+                {
+                    ++j;
+                }
+                runs.push_back(values[i]);
+                runs.push_back(static_cast<uint16_t>(j - i - 1));
+                i = j;
+            }
+            c.values.swap(runs);
+            std::vector<uint64_t>().swap(c.bits);
+            c.type = CONTAINER_RUN;
+        }
+
+        //--------------------------------------------------------------
+        // Gives a container the form that a set without runs uses for its
+        // cardinality, an array up to ARRAY_MAX values and a bitmap above,
+        // or runs if allowed and smaller than both.
+        static void normalize(Container& c, bool allowRuns)
+        {
+            if(allowRuns)
+            {
+                size_t runBytes = 2 + 4 * countRuns(c);
+                size_t otherBytes = (c.cardinality <= ARRAY_MAX) ? 2 * c.cardinality : BITMAP_WORDS * 8;
+                if(runBytes < otherBytes)
+                {
+                    makeRuns(c);
+                    return;
+                }
+            }
+            if(c.cardinality <= ARRAY_MAX)
+            {
+                makeArray(c);
+            }
+            else
+            {
+                makeBitmap(c);
+            }
+        }
+
+        //--------------------------------------------------------------
+        static bool containerContains(const Container& c, uint16_t value) throw()
+        {
+            if(c.type == CONTAINER_BITMAP)
+            {
+                return ((c.bits[value >> 6] >> (value & 63)) & 1) != 0;
+            }
+            if(c.type == CONTAINER_ARRAY)
+            {
+                return std::binary_search(c.values.begin(), c.values.end(), value);
+            }
+            // The last run that starts at or before the value.
+            size_t low = 0, high = c.values.size() / 2;
+            while(low < high)
+            {
+                size_t middle = (low + high) / 2;
+                if(c.values[2 * middle] <= value)
+                {
+                    low = middle + 1;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+            return (low > 0) &&
+                (value <= static_cast<uint32_t>(c.values[2 * low - 2]) + c.values[2 * low - 1]);
+        }
+
+        //--------------------------------------------------------------
+        // Intersects two sorted arrays, galloping through the larger one
+        // when their sizes are far apart. Writes the result to out, unless
+        // out is NULL, and returns its size.
+        static size_t intersectArrays(const uint16_t* a, size_t countA, const uint16_t* b, size_t countB,
+                uint16_t* out) throw()
+        {
+            if(countA > countB)
+            {
+                std::swap(a, b);
+                std::swap(countA, countB);
+            }
+            size_t n = 0;
+            if(countA * 32 < countB)
+            {
+                const uint16_t* position = b;
+                const uint16_t* end = b + countB;
+                for(size_t i = 0; (i < countA) && (position != end); ++i)
+                {
+                    size_t step = 1;
+                    const uint16_t* low = position;
+                    while((static_cast<size_t>(end - position) > step) && (position[step] < a[i]))
+                    {
+                        low = position + step;
+                        step <<= 1;
+                    }
+                    const uint16_t* high = (static_cast<size_t>(end - position) > step) ? position + step + 1 : end;
+                    position = std::lower_bound(low, high, a[i]);
+                    if((position != end) && (*position == a[i]))
+                    {
+                        if(out != NULL)
+                        {
+                            out[n] = a[i];
+                        }
+                        ++n;
+                        ++position;
+                    }
+                }
+                return n;
+            }
+            size_t i = 0, j = 0;
+            while((i < countA) && (j < countB))
+            {
+                uint16_t x = a[i], y = b[j];
+                if((x == y) && (out != NULL))
+                {
+                    out[n] = x;
+                }
+                n += (x == y);
+                i += (x <= y);
+                j += (y <= x);
+            }
+            return n;
+        }
+
+        //--------------------------------------------------------------
+        // Builds a container from sorted values.
+        static Container* fromValues(const uint16_t* values, size_t count)
+        {
+            Container* c = new Container();
+            c->cardinality = static_cast<uint32_t>(count);
+            if(count <= ARRAY_MAX)
+            {
+                c->values.assign(values, values + count);
+            }
+            else
+            {
+                c->type = CONTAINER_BITMAP;
+                c->bits.assign(BITMAP_WORDS, 0);
+                for(size_t i = 0; i < count; ++i)
+                {
+                    c->bits[values[i] >> 6] |= 1ULL << (values[i] & 63);
+                }
+            }
+            return c;
+        }
+
+        //--------------------------------------------------------------
+        // Builds a container from a bitmap and the number of its bits set.
+        static Container* fromBitmap(const uint64_t* words, uint32_t cardinality, bool allowRuns)
+        {
+            Container* c = new Container();
+            c->type = CONTAINER_BITMAP;
+            c->cardinality = cardinality;
+            c->bits.assign(words, words + BITMAP_WORDS);
+            normalize(*c, allowRuns);
+            return c;
+        }
+
+        //--------------------------------------------------------------
+        static Container* unionContainers(const Container& a, const Container& b)
+        {
+            if((a.type == CONTAINER_ARRAY) && (b.type == CONTAINER_ARRAY))
+            {
+                std::vector<uint16_t> values(a.values.size() + b.values.size());
+                values.resize(std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                            values.begin()) - values.begin());
+                return fromValues(&values[0], values.size());
+            }
+            uint64_t x[BITMAP_WORDS], y[BITMAP_WORDS];
+            toBitmap(a, x);
+            toBitmap(b, y);
+            uint32_t cardinality = bitmapOperation(x, y, x, BITMAP_OR);
+            return fromBitmap(x, cardinality, (a.type == CONTAINER_RUN) || (b.type == CONTAINER_RUN));
+        }
+
+        //--------------------------------------------------------------
+        // Returns the intersection of two containers, or NULL if empty.
+        static Container* intersectContainers(const Container& a, const Container& b)
+        {
+            if((a.type == CONTAINER_ARRAY) || (b.type == CONTAINER_ARRAY))
+            {
+                std::vector<uint16_t> values;
+                if((a.type == CONTAINER_ARRAY) && (b.type == CONTAINER_ARRAY))
+                {
+                    values.resize(std::min(a.values.size(), b.values.size()));
+                    values.resize(intersectArrays(&a.values[0], a.values.size(), &b.values[0], b.values.size(),
+                                &values[0]));
+                }
+                else
+                {
+                    const Container& array = (a.type == CONTAINER_ARRAY) ? a : b;
+                    const Container& other = (a.type == CONTAINER_ARRAY) ? b : a;
+                    values.reserve(array.values.size());
+                    for(size_t i = 0; i < array.values.size(); ++i)
+                    {
+                        if(containerContains(other, array.values[i]))
+                        {
+                            values.push_back(array.values[i]);
+                        }
+                    }
+                }
+                return values.empty() ? NULL : fromValues(&values[0], values.size());
+            }
+            uint64_t x[BITMAP_WORDS], y[BITMAP_WORDS];
+            toBitmap(a, x);
+            toBitmap(b, y);
+            uint32_t cardinality = bitmapOperation(x, y, x, BITMAP_AND);
+            if(cardinality == 0)
+            {
+                return NULL;
+            }
+            return fromBitmap(x, cardinality, (a.type == CONTAINER_RUN) || (b.type == CONTAINER_RUN));
+        }
+
+        //--------------------------------------------------------------
+        // Returns the values of a that are not in b, or NULL if none.
+        static Container* subtractContainers(const Container& a, const Container& b)
+        {
+            if(a.type == CONTAINER_ARRAY)
+            {
+                std::vector<uint16_t> values;
+                values.reserve(a.values.size());
+                for(size_t i = 0; i < a.values.size(); ++i)
+                {
+                    if(!containerContains(b, a.values[i]))
+                    {
+                        values.push_back(a.values[i]);
+                    }
+                }
+                return values.empty() ? NULL : fromValues(&values[0], values.size());
+            }
+            uint64_t x[BITMAP_WORDS], y[BITMAP_WORDS];
+            toBitmap(a, x);
+            toBitmap(b, y);
+            uint32_t cardinality = bitmapOperation(x, y, x, BITMAP_ANDNOT);
+            if(cardinality == 0)
+            {
+                return NULL;
+            }
+            return fromBitmap(x, cardinality, a.type == CONTAINER_RUN);
+        }
+
+        //--------------------------------------------------------------
+        static uint32_t intersectionCount(const Container& a, const Container& b) throw()
+        {
+            if((a.type == CONTAINER_ARRAY) && (b.type == CONTAINER_ARRAY))
+            {
+                return static_cast<uint32_t>(intersectArrays(&a.values[0], a.values.size(),
+                            &b.values[0], b.values.size(), NULL));
+            }
+            if((a.type == CONTAINER_ARRAY) || (b.type == CONTAINER_ARRAY))
+            {
+                const Container& array = (a.type == CONTAINER_ARRAY) ? a : b;
+                const Container& other = (a.type == CONTAINER_ARRAY) ? b : a;
+                uint32_t n = 0;
+                for(size_t i = 0; i < array.values.size(); ++i)
+                {
+                    n += containerContains(other, array.values[i]);
+                }
+                return n;
+            }
+            if((a.type == CONTAINER_BITMAP) && (b.type == CONTAINER_BITMAP))
+            {
+                return bitmapOperation(&a.bits[0], &b.bits[0], NULL, BITMAP_AND);
+            }
+            uint64_t x[BITMAP_WORDS], y[BITMAP_WORDS];
+            toBitmap(a, x);
+            toBitmap(b, y);
+            return bitmapOperation(x, y, NULL, BITMAP_AND);
+        }
+
+        //--------------------------------------------------------------
+        // Tests if two containers hold the same values.
+        static bool equalContainers(const Container& a, const Container& b) throw()
+        {
+            if(a.cardinality != b.cardinality)
+            {
+                return false;
+            }
+            if(a.type == b.type)
+            {
+                return (a.values == b.values) && (a.bits == b.bits);
+            }
+            return intersectionCount(a, b) == a.cardinality;
+        }
+
+        //--------------------------------------------------------------
+        // Calls function(first, last) for each run of consecutive values of
+        // a container.
+        template <typename F>
+            static void forEachRun(const Container& c, F& function)
+            {
+                if(c.type == CONTAINER_RUN)
+                {
+                    for(size_t i = 0; i < c.values.size(); i += 2)
+                    {
+                        function(c.values[i], static_cast<uint32_t>(c.values[i]) + c.values[i + 1]);
+                    }
+                    return;
+                }
+                std::vector<uint16_t> values(c.cardinality);
+                toValues(c, &values[0]);
+                for(size_t i = 0; i < values.size(); )
+                {
+                    size_t j = i + 1;
+                    while((j < values.size()) && (values[j] == values[j - 1] + 1))
+                    {
+                        ++j;
+                    }
+                    function(values[i], values[j - 1]);
+                    i = j;
+                }
+            }
+
+        //--------------------------------------------------------------
+        // Appends the ranges of a container to a string.
+        struct RangeWriter
+        {
+            std::string* text;
+            uint32_t high;
+
+            void operator()(uint32_t first, uint32_t last)
+            {
+                if(text->size() > 1)
+                {
+                    *text += ", ";
+                }
+                *text += Inet4Address(high | first).toString();
+                if(first != last)
+                {
+                    *text += "-";
+                    *text += Inet4Address(high | last).toString();
+                }
+            }
+        };
+
+        //--------------------------------------------------------------
+        // Appends little-endian numbers to a byte vector.
+        static inline void put16(std::vector<uint8_t>& out, uint32_t value)
+        {
+            out.push_back(static_cast<uint8_t>(value));
+            out.push_back(static_cast<uint8_t>(value >> 8));
+        }
+
+        static inline void put32(std::vector<uint8_t>& out, uint32_t value)
+        {
+            put16(out, value & 0xffffU);
+            put16(out, value >> 16);
+        }
+
+        //--------------------------------------------------------------
+        // Reads little-endian numbers.
+        static inline uint32_t get16(const uint8_t* p) throw()
+        {
+            return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8);
+        }
+
+        static inline uint32_t get32(const uint8_t* p) throw()
+        {
+            return get16(p) | (get16(p + 2) << 16);
+        }
+
+        //--------------------------------------------------------------
+        // Returns the size of a container in the portable format.
+        static size_t serializedSize(const Container& c) throw()
+        {
+            if(c.type == CONTAINER_RUN)
+            {
+                return 2 + 2 * c.values.size();
+            }
+            return (c.type == CONTAINER_ARRAY) ? 2 * c.values.size() : BITMAP_WORDS * 8;
+        }
+
+        //--------------------------------------------------------------
+        // Addresses in host byte order.
+        static inline bool toNumber(const InetAddressValue& value, uint32_t& number) throw()
+        {
+            if(value.isIPv4() || value.isIPv4Mapped())
+            {
+                number = static_cast<uint32_t>(value.low());
+                return true;
+            }
+            return false;
+        }
+
+        //--------------------------------------------------------------
+        Ipv4Set::Ipv4Set() throw()
+        {
+        }
+
+        //--------------------------------------------------------------
+        Ipv4Set::Ipv4Set(const Ipv4Set& set) : Object()
+        {
+            *this = set;
+        }
+
+        //--------------------------------------------------------------
+        Ipv4Set::~Ipv4Set() throw()
+        {
+            clear();
+        }
+
+        //--------------------------------------------------------------
+        Ipv4Set& Ipv4Set::operator=(const Ipv4Set& set)
+        {
+            if(this != &set)
+            {
+                clear();
+                keys_ = set.keys_;
+                containers_.reserve(set.containers_.size());
+                for(size_t i = 0; i < set.containers_.size(); ++i)
+                {
+                    containers_.push_back(new Container(*set.containers_[i]));
+                }
+            }
+            return *this;
+        }
+
+        //--------------------------------------------------------------
+        bool Ipv4Set::operator==(const Ipv4Set& set) const throw()
+        {
+            if(keys_ != set.keys_)
+            {
+                return false;
+            }
+            for(size_t i = 0; i < containers_.size(); ++i)
+            {
+                if(!equalContainers(*containers_[i], *set.containers_[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        //--------------------------------------------------------------
+        size_t Ipv4Set::find(uint16_t key) const throw()
+        {
+            return std::lower_bound(keys_.begin(), keys_.end(), key) - keys_.begin();
+        }
+
+        //--------------------------------------------------------------
+        void Ipv4Set::insert(size_t index, uint16_t key, Container* container)
+        {
+            try
+            {
+                keys_.insert(keys_.begin() + index, key);
+                containers_.insert(containers_.begin() + index, container);
+            }
+            catch(...)
+            {
+                if(keys_.size() != containers_.size())
+                {
+                    keys_.erase(keys_.begin() + index);
+                }
+                delete container;
+                throw;
+            }
+        }
+
+        //--------------------------------------------------------------
+        void Ipv4Set::erase(size_t index) throw()
+        {
+            delete containers_[index];
+            keys_.erase(keys_.begin() + index);
+            containers_.erase(containers_.begin() + index);
+        }
+
+        //--------------------------------------------------------------
+        bool Ipv4Set::add(uint32_t address)
+        {
+            uint16_t key = static_cast<uint16_t>(address >> 16);
+            uint16_t value = static_cast<uint16_t>(address);
+            size_t index = find(key);
+            if((index == keys_.size()) || (keys_[index] != key))
+            {
+                Container* c = new Container();
+                c->cardinality = 1;
+                c->values.push_back(value);
+                insert(index, key, c);
+                return true;
+            }
+
+            Container& c = *containers_[index];
+            if(c.type == CONTAINER_RUN)
+            {
+                if(containerContains(c, value))
+                {
+                    return false;
+                }
+                normalize(c, false);
+            }
+            if(c.type == CONTAINER_ARRAY)
+            {
+                std::vector<uint16_t>::iterator position = std::lower_bound(c.values.begin(), c.values.end(), value);
+                if((position != c.values.end()) && (*position == value))
+                {
+                    return false;
+                }
+                if(c.cardinality < ARRAY_MAX)
+                {
+                    c.values.insert(position, value);
+                    ++c.cardinality;
+                    return true;
+                }
+                makeBitmap(c);
+            }
+            uint64_t& word = c.bits[value >> 6];
+            uint64_t bit = 1ULL << (value & 63);
+            if((word & bit) != 0)
+            {
+                return false;
+            }
+            word |= bit;
+            ++c.cardinality;
+            return true;
+        }
+
+        //--------------------------------------------------------------
+        bool Ipv4Set::add(const InetAddress& address) throw(sys::IllegalArgumentException)
+        {
+            uint32_t number;
+            if(!toNumber(address.getValue(), number))
+            {
+                throw sys::IllegalArgumentException("Address is not an IPv4 address.");
+            }
+            return add(number);
+        }
+
+        //--------------------------------------------------------------
+        void Ipv4Set::add(uint32_t first, uint32_t last) throw(sys::IllegalArgumentException)
+        {
+            if(last < first)
+            {
+                throw sys::IllegalArgumentException("Last address comes before the first address.");
+            }
+            for(uint32_t high = first >> 16; high <= (last >> 16); ++high)
+            {
+                uint16_t key = static_cast<uint16_t>(high);
+                uint32_t low = (high == (first >> 16)) ? (first & 0xffffU) : 0;
+                uint32_t top = (high == (last >> 16)) ? (last & 0xffffU) : 0xffffU;
+                size_t index = find(key);
+                if((index == keys_.size()) || (keys_[index] != key))
+                {
+                    Container* c = new Container();
+                    c->type = CONTAINER_RUN;
+                    c->cardinality = top - low + 1;
+                    c->values.push_back(static_cast<uint16_t>(low));
+                    c->values.push_back(static_cast<uint16_t>(top - low));
+                    insert(index, key, c);
+                }
+                else
+                {
+                    Container& c = *containers_[index];
+                    makeBitmap(c);
+                    setBits(&c.bits[0], low, top);
+                    c.cardinality = bitmapOperation(&c.bits[0], &c.bits[0], NULL, BITMAP_AND);
+                    normalize(c, true);
+                }
+            }
+        }
+
+        //--------------------------------------------------------------
+        void Ipv4Set::add(const Subnet& subnet) throw(sys::IllegalArgumentException)
+        {
+            uint32_t first, last;
+            if(!toNumber(subnet.getNetwork().getValue(), first) ||
+                    !toNumber(subnet.getLastAddress().getValue(), last) ||
+                    (subnet.getAddressFamily() != AddressFamily::InterNetwork))
+            {
+                throw sys::IllegalArgumentException("Subnet is not an IPv4 subnet.");
+            }
+            add(first, last);
+        }
+
+        //--------------------------------------------------------------
+        bool Ipv4Set::remove(uint32_t address)
+        {
+            uint16_t key = static_cast<uint16_t>(address >> 16);
+            uint16_t value = static_cast<uint16_t>(address);
+            size_t index = find(key);
+            if((index == keys_.size()) || (keys_[index] != key))
+            {
+                return false;
+            }
+
+            Container& c = *containers_[index];
+            if(!containerContains(c, value))
+            {
+                return false;
+            }
+            if(c.cardinality == 1)
+            {
+                erase(index);
+                return true;
+            }
+            if(c.type == CONTAINER_RUN)
+            {
+                normalize(c, false);
+            }
+            if(c.type == CONTAINER_ARRAY)
+            {
+                c.values.erase(std::lower_bound(c.values.begin(), c.values.end(), value));
+            }
+            else
+            {
+                c.bits[value >> 6] &= ~(1ULL << (value & 63));
+            }
+            if(--c.cardinality == ARRAY_MAX)
+            {
+                makeArray(c);
+            }
+            return true;
+        }
+
+        //--------------------------------------------------------------
+        bool Ipv4Set::remove(const InetAddress& address)
+        {
+            uint32_t number;
+            return toNumber(address.getValue(), number) && remove(number);
+        }
+
+        //--------------------------------------------------------------
+        bool Ipv4Set::contains(uint32_t address) const throw()
+        {
+            uint16_t key = static_cast<uint16_t>(address >> 16);
+            size_t index = find(key);
+            return (index < keys_.size()) && (keys_[index] == key) &&
+                containerContains(*containers_[index], static_cast<uint16_t>(address));
+        }
+
+        //--------------------------------------------------------------
+        bool Ipv4Set::contains(const InetAddressValue& address) const throw()
+        {
+            uint32_t number;
+            return toNumber(address, number) && contains(number);
+        }
+
+        //--------------------------------------------------------------
+        uint64_t Ipv4Set::getCardinality() const throw()
+        {
+            uint64_t total = 0;
+            for(size_t i = 0; i < containers_.size(); ++i)
+            {
+                total += containers_[i]->cardinality;
+            }
+            return total;
+        }
+
+        //--------------------------------------------------------------
+        void Ipv4Set::clear() throw()
+        {
+            for(size_t i = 0; i < containers_.size(); ++i)
+            {
+                delete containers_[i];
+            }
+            containers_.clear();
+            keys_.clear();
+        }
+
+        //--------------------------------------------------------------
+        Ipv4Set Ipv4Set::setUnion(const Ipv4Set& set) const
+        {
+            Ipv4Set result;
+            size_t i = 0, j = 0;
+            while((i < keys_.size()) || (j < set.keys_.size()))
+            {
+                Container* c;
+                uint16_t key;
+                if((j == set.keys_.size()) || ((i < keys_.size()) && (keys_[i] < set.keys_[j])))
+                {
+                    key = keys_[i];
+                    c = new Container(*containers_[i++]);
+                }
+                else if((i == keys_.size()) || (set.keys_[j] < keys_[i]))
+                {
+                    key = set.keys_[j];
+                    c = new Container(*set.containers_[j++]);
+                }
+                else
+                {
+                    key = keys_[i];
+                    c = unionContainers(*containers_[i++], *set.containers_[j++]);
+                }
+                result.insert(result.keys_.size(), key, c);
+            }
+            return result;
+        }
+
+        //--------------------------------------------------------------
+        Ipv4Set Ipv4Set::setIntersection(const Ipv4Set& set) const
+        {
+            Ipv4Set result;
+            size_t i = 0, j = 0;
+            while((i < keys_.size()) && (j < set.keys_.size()))
+            {
+                if(keys_[i] < set.keys_[j])
+                {
+                    ++i;
+                }
+                else if(set.keys_[j] < keys_[i])
+                {
+                    ++j;
+                }
+                else
+                {
+                    Container* c = intersectContainers(*containers_[i], *set.containers_[j]);
+                    if(c != NULL)
+                    {
+                        result.insert(result.keys_.size(), keys_[i], c);
+                    }
+                    ++i;
+                    ++j;
+                }
+            }
+            return result;
+        }
+
+        //--------------------------------------------------------------
+        Ipv4Set Ipv4Set::setDifference(const Ipv4Set& set) const
+        {
+            Ipv4Set result;
+            size_t j = 0;
+            for(size_t i = 0; i < keys_.size(); ++i)
+            {
+                while((j < set.keys_.size()) && (set.keys_[j] < keys_[i]))
+                {
+                    ++j;
+                }
+                Container* c;
+                if((j < set.keys_.size()) && (set.keys_[j] == keys_[i]))
+                {
+                    c = subtractContainers(*containers_[i], *set.containers_[j]);
+                }
+                else
+                {
+                    c = new Container(*containers_[i]);
+                }
+                if(c != NULL)
+                {
+                    result.insert(result.keys_.size(), keys_[i], c);
+                }
+            }
+            return result;
+        }
+
+        //--------------------------------------------------------------
+        uint64_t Ipv4Set::intersectionCardinality(const Ipv4Set& set) const throw()
+        {
+            uint64_t total = 0;
+            size_t i = 0, j = 0;
+            while((i < keys_.size()) && (j < set.keys_.size()))
+            {
+                if(keys_[i] < set.keys_[j])
+                {
+                    ++i;
+                }
+                else if(set.keys_[j] < keys_[i])
+                {
+                    ++j;
+                }
+                else
+                {
+                    total += intersectionCount(*containers_[i++], *set.containers_[j++]);
+                }
+            }
+            return total;
+        }
+
+        //--------------------------------------------------------------
+        Ipv4Set Ipv4Set::unionOf(const Ipv4Set* const* sets, size_t count)
+        {
+            Ipv4Set result;
+            std::vector<size_t> positions(count, 0);
+            std::vector<const Container*> group;
+            std::vector<uint16_t> values;
+            uint64_t words[BITMAP_WORDS];
+            for(;;)
+            {
+                // The smallest key not yet done, and its containers.
+                uint32_t key = 0x10000U;
+                for(size_t s = 0; s < count; ++s)
+                {
+                    if(positions[s] < sets[s]->keys_.size())
+                    {
+                        key = std::min<uint32_t>(key, sets[s]->keys_[positions[s]]);
+                    }
+                }
+                if(key == 0x10000U)
+                {
+                    break;
+                }
+                group.clear();
+                for(size_t s = 0; s < count; ++s)
+                {
+                    if((positions[s] < sets[s]->keys_.size()) && (sets[s]->keys_[positions[s]] == key))
+                    {
+                        group.push_back(sets[s]->containers_[positions[s]++]);
+                    }
+                }
+
+                if(group.size() == 1)
+                {
+                    result.insert(result.keys_.size(), static_cast<uint16_t>(key), new Container(*group[0]));
+                    continue;
+                }
+
+                // Small arrays are merged by sorting their values.
+                size_t arrayValues = 0;
+                bool arrays = true;
+                for(size_t g = 0; g < group.size(); ++g)
+                {
+                    arrays = arrays && (group[g]->type == CONTAINER_ARRAY);
+                    arrayValues += group[g]->cardinality;
+                }
+                if(arrays && (arrayValues <= ARRAY_MAX))
+                {
+                    values.clear();
+                    for(size_t g = 0; g < group.size(); ++g)
+                    {
+                        values.insert(values.end(), group[g]->values.begin(), group[g]->values.end());
+                    }
+                    std::sort(values.begin(), values.end());
+                    values.erase(std::unique(values.begin(), values.end()), values.end());
+                    result.insert(result.keys_.size(), static_cast<uint16_t>(key),
+                            fromValues(&values[0], values.size()));
+                    continue;
+                }
+
+                // Otherwise every container is or'ed into one bitmap,
+                // which is counted once.
+                bool runs = false;
+                std::fill(words, words + BITMAP_WORDS, 0);
+                for(size_t g = 0; g < group.size(); ++g)
+                {
+                    const Container& c = *group[g];
+                    runs = runs || (c.type == CONTAINER_RUN);
+                    if(c.type == CONTAINER_BITMAP)
+                    {
+                        bitmapOperation(words, &c.bits[0], words, BITMAP_OR, false);
+                    }
+                    else if(c.type == CONTAINER_ARRAY)
+                    {
+                        for(size_t i = 0; i < c.values.size(); ++i)
+                        {
+                            words[c.values[i] >> 6] |= 1ULL << (c.values[i] & 63);
+                        }
+                    }
+                    else
+                    {
+                        for(size_t i = 0; i < c.values.size(); i += 2)
+                        {
+                            setBits(words, c.values[i], static_cast<uint32_t>(c.values[i]) + c.values[i + 1]);
+                        }
+                    }
+                }
+                uint32_t cardinality = bitmapOperation(words, words, NULL, BITMAP_AND);
+                result.insert(result.keys_.size(), static_cast<uint16_t>(key),
+                        fromBitmap(words, cardinality, runs));
+            }
+            return result;
+        }
+
+        //--------------------------------------------------------------
+        Ipv4Set Ipv4Set::select(uint32_t classes) const
+        {
+            // Only the any-local address 0.0.0.0 and the link-local
+            // multicast group 224.0.0.0/24 are classified differently from
+            // the rest of their /16; every other /16 is classified as a
+            // whole.
+            Ipv4Set result;
+            std::vector<uint16_t> values;
+            for(size_t i = 0; i < keys_.size(); ++i)
+            {
+                uint32_t high = static_cast<uint32_t>(keys_[i]) << 16;
+                const Container& c = *containers_[i];
+                if((keys_[i] != 0) && (keys_[i] != 0xe000U))
+                {
+                    if((InetAddressValue::classify4(high) & classes) != 0)
+                    {
+                        result.insert(result.keys_.size(), keys_[i], new Container(c));
+                    }
+                    continue;
+                }
+
+                values.resize(c.cardinality);
+                toValues(c, &values[0]);
+                size_t kept = 0;
+                for(size_t v = 0; v < values.size(); ++v)
+                {
+                    if((InetAddressValue::classify4(high | values[v]) & classes) != 0)
+                    {
+                        values[kept++] = values[v];
+                    }
+                }
+                if(kept > 0)
+                {
+                    Container* selected = fromValues(&values[0], kept);
+                    result.insert(result.keys_.size(), keys_[i], selected);
+                    normalize(*selected, c.type == CONTAINER_RUN);
+                }
+            }
+            return result;
+        }
+
+        //--------------------------------------------------------------
+        void Ipv4Set::optimize()
+        {
+            for(size_t i = 0; i < containers_.size(); ++i)
+            {
+                normalize(*containers_[i], true);
+                if(containers_[i]->values.capacity() > containers_[i]->values.size())
+                {
+                    std::vector<uint16_t>(containers_[i]->values).swap(containers_[i]->values);
+                }
+            }
+        }
+
+        //--------------------------------------------------------------
+        size_t Ipv4Set::toArray(uint32_t* out) const throw()
+        {
+            std::vector<uint16_t> values;
+            size_t n = 0;
+            for(size_t i = 0; i < keys_.size(); ++i)
+            {
+                uint32_t high = static_cast<uint32_t>(keys_[i]) << 16;
+                values.resize(containers_[i]->cardinality);
+                toValues(*containers_[i], &values[0]);
+                for(size_t v = 0; v < values.size(); ++v)
+                {
+                    out[n++] = high | values[v];
+                }
+            }
+            return n;
+        }
+
+        //--------------------------------------------------------------
+        std::vector<InetAddress> Ipv4Set::getAddresses() const
+        {
+            std::vector<uint32_t> numbers(static_cast<size_t>(getCardinality()));
+            if(!numbers.empty())
+            {
+                toArray(&numbers[0]);
+            }
+            std::vector<InetAddress> addresses;
+            addresses.reserve(numbers.size());
+            for(size_t i = 0; i < numbers.size(); ++i)
+            {
+                addresses.push_back(Inet4Address(numbers[i]).toInetAddress());
+            }
+            return addresses;
+        }
+
+        //--------------------------------------------------------------
+        size_t Ipv4Set::getMemoryUsage() const throw()
+        {
+            size_t bytes = sizeof(*this) + keys_.capacity() * sizeof(uint16_t) +
+                containers_.capacity() * sizeof(Container*);
+            for(size_t i = 0; i < containers_.size(); ++i)
+            {
+                bytes += sizeof(Container) + containers_[i]->values.capacity() * sizeof(uint16_t) +
+                    containers_[i]->bits.capacity() * sizeof(uint64_t);
+            }
+            return bytes;
+        }
+
+        //--------------------------------------------------------------
+        size_t Ipv4Set::getSerializedSize() const throw()
+        {
+            size_t n = containers_.size();
+            bool runs = false;
+            size_t bytes = 0;
+            for(size_t i = 0; i < n; ++i)
+            {
+                runs = runs || (containers_[i]->type == CONTAINER_RUN);
+                bytes += serializedSize(*containers_[i]);
+            }
+            bytes += runs ? 4 + (n + 7) / 8 : 8;
+            bytes += 4 * n;
+            if(!runs || (n >= SERIAL_NO_OFFSET_THRESHOLD))
+            {
+                bytes += 4 * n;
+            }
+            return bytes;
+        }
+
+        //--------------------------------------------------------------
+        void Ipv4Set::serialize(std::vector<uint8_t>& out) const
+        {
+            size_t n = containers_.size();
+            bool runs = false;
+            for(size_t i = 0; i < n; ++i)
+            {
+                runs = runs || (containers_[i]->type == CONTAINER_RUN);
+            }
+
+            out.clear();
+            out.reserve(getSerializedSize());
+            if(runs)
+            {
+                put16(out, SERIAL_COOKIE);
+                put16(out, static_cast<uint32_t>(n - 1));
+                out.resize(out.size() + (n + 7) / 8, 0);
+                for(size_t i = 0; i < n; ++i)
+                {
+                    if(containers_[i]->type == CONTAINER_RUN)
+                    {
+                        out[4 + i / 8] |= static_cast<uint8_t>(1U << (i % 8));
+                    }
+                }
+            }
+            else
+            {
+                put32(out, SERIAL_COOKIE_NO_RUN);
+                put32(out, static_cast<uint32_t>(n));
+            }
+            for(size_t i = 0; i < n; ++i)
+            {
+                put16(out, keys_[i]);
+                put16(out, containers_[i]->cardinality - 1);
+            }
+            if(!runs || (n >= SERIAL_NO_OFFSET_THRESHOLD))
+            {
+                uint32_t offset = static_cast<uint32_t>(out.size() + 4 * n);
+                for(size_t i = 0; i < n; ++i)
+                {
+                    put32(out, offset);
+                    offset += static_cast<uint32_t>(serializedSize(*containers_[i]));
+                }
+            }
+
+            for(size_t i = 0; i < n; ++i)
+            {
+                const Container& c = *containers_[i];
+                if(c.type == CONTAINER_RUN)
+                {
+                    put16(out, static_cast<uint32_t>(c.values.size() / 2));
+                }
+                if(c.type == CONTAINER_BITMAP)
+                {
+                    for(size_t w = 0; w < BITMAP_WORDS; ++w)
+                    {
+                        put32(out, static_cast<uint32_t>(c.bits[w]));
+                        put32(out, static_cast<uint32_t>(c.bits[w] >> 32));
+                    }
+                }
+                else
+                {
+                    for(size_t v = 0; v < c.values.size(); ++v)
+                    {
+                        put16(out, c.values[v]);
+                    }
+                }
+            }
+        }
+
+        //--------------------------------------------------------------
+        Ipv4Set Ipv4Set::deserialize(const uint8_t* data, size_t size) throw(sys::FormatException)
+        {
+            if(size < 4)
+            {
+                throw sys::FormatException("Serialized set is truncated.");
+            }
+            uint32_t cookie = get32(data);
+            size_t n, position;
+            const uint8_t* runFlags = NULL;
+            if((cookie & 0xffffU) == SERIAL_COOKIE)
+            {
+                n = (cookie >> 16) + 1;
+                runFlags = data + 4;
+                position = 4 + (n + 7) / 8;
+            }
+            else if((cookie == SERIAL_COOKIE_NO_RUN) && (size >= 8))
+            {
+                n = get32(data + 4);
+                position = 8;
+                if(n > 0x10000U)
+                {
+                    throw sys::FormatException("Serialized set has too many containers.");
+                }
+            }
+            else
+            {
+                throw sys::FormatException("Data is not a serialized set.");
+            }
+            size_t headers = position;
+            position += 4 * n;
+            if((runFlags == NULL) || (n >= SERIAL_NO_OFFSET_THRESHOLD))
+            {
+                position += 4 * n;
+            }
+            if(position > size)
+            {
+                throw sys::FormatException("Serialized set is truncated.");
+            }
+
+            Ipv4Set result;
+            result.keys_.reserve(n);
+            result.containers_.reserve(n);
+            for(size_t i = 0; i < n; ++i)
+            {
+                uint32_t key = get16(data + headers + 4 * i);
+                uint32_t cardinality = get16(data + headers + 4 * i + 2) + 1;
+                if((i > 0) && (key <= result.keys_.back()))
+                {
+                    throw sys::FormatException("Serialized set has keys out of order.");
+                }
+
+                Container* c = new Container();
+                result.insert(i, static_cast<uint16_t>(key), c);
+                c->cardinality = cardinality;
+                if((runFlags != NULL) && ((runFlags[i / 8] >> (i % 8)) & 1))
+                {
+                    c->type = CONTAINER_RUN;
+                    if(position + 2 > size)
+                    {
+                        throw sys::FormatException("Serialized set is truncated.");
+                    }
+                    size_t runs = get16(data + position);
+                    position += 2;
+                    if(position + 4 * runs > size)
+                    {
+                        throw sys::FormatException("Serialized set is truncated.");
+                    }
+                    c->values.resize(2 * runs);
+                    uint32_t total = 0, next = 0;
+                    for(size_t r = 0; r < runs; ++r)
+                    {
+                        uint32_t start = get16(data + position + 4 * r);
+                        uint32_t length = get16(data + position + 4 * r + 2);
+                        if(((r > 0) && (start < next)) || (start + length > 0xffffU))
+                        {
+                            throw sys::FormatException("Serialized set has invalid runs.");
+                        }
+                        c->values[2 * r] = static_cast<uint16_t>(start);
+                        c->values[2 * r + 1] = static_cast<uint16_t>(length);
+                        next = start + length + 1;
+                        total += length + 1;
+                    }
+                    position += 4 * runs;
+                    if((runs == 0) || (total != cardinality))
+                    {
+                        throw sys::FormatException("Serialized set has a wrong cardinality.");
+                    }
+                }
+                else if(cardinality <= ARRAY_MAX)
+                {
+                    if(position + 2 * cardinality > size)
+                    {
+                        throw sys::FormatException("Serialized set is truncated.");
+                    }
+                    c->values.resize(cardinality);
+                    for(size_t v = 0; v < cardinality; ++v)
+                    {
+                        c->values[v] = static_cast<uint16_t>(get16(data + position + 2 * v));
+                        if((v > 0) && (c->values[v] <= c->values[v - 1]))
+                        {
+                            throw sys::FormatException("Serialized set has values out of order.");
+                        }
+                    }
+                    position += 2 * cardinality;
+                }
+                else
+                {
+                    if(position + BITMAP_WORDS * 8 > size)
+                    {
+                        throw sys::FormatException("Serialized set is truncated.");
+                    }
+                    c->type = CONTAINER_BITMAP;
+                    c->bits.resize(BITMAP_WORDS);
+                    for(size_t w = 0; w < BITMAP_WORDS; ++w)
+                    {
+                        c->bits[w] = static_cast<uint64_t>(get32(data + position + 8 * w)) |
+                            (static_cast<uint64_t>(get32(data + position + 8 * w + 4)) << 32);
+                    }
+                    position += BITMAP_WORDS * 8;
+                    if(bitmapOperation(&c->bits[0], &c->bits[0], NULL, BITMAP_AND) != cardinality)
+                    {
+                        throw sys::FormatException("Serialized set has a wrong cardinality.");
+                    }
+                }
+            }
+            if(position != size)
+            {
+                throw sys::FormatException("Serialized set has trailing data.");
+            }
+            return result;
+        }
+
+        //--------------------------------------------------------------
+        std::string Ipv4Set::toString() const throw()
+        {
+            std::string text("{");
+            RangeWriter writer;
+            writer.text = &text;
+            for(size_t i = 0; i < keys_.size(); ++i)
+            {
+                writer.high = static_cast<uint32_t>(keys_[i]) << 16;
+                forEachRun(*containers_[i], writer);
+            }
+            text += "}";
+            return text;
+        }
+    } // net ns
+} // frog ns
@@ -0,0 +1,105 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+#include <frog/MappedFile.h>
+
+namespace frog
+{
+    namespace sys
+    {
+        //--------------------------------------------------------------
+        MappedFile::MappedFile() throw() : data_(NULL), size_(0)
+        {
+        }
+
+        //--------------------------------------------------------------
+        MappedFile::MappedFile(const std::string& path) throw(IOException) :
+          data_(NULL), size_(0)
+        {
+            open(path);
+        }
+
+        //--------------------------------------------------------------
+        MappedFile::~MappedFile() throw()
+        {
+            close();
+        }
+
+        //--------------------------------------------------------------
+        void MappedFile::open(const std::string& path) throw(IOException)
+        {
+            close();
+
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if(fd < 0)
+            {
+                throw IOException(path + ": " + ::strerror(errno));
+            }
+
+            struct stat info;
+            if(::fstat(fd, &info) < 0)
+            {
+                int error = errno;
+                ::close(fd);
+                throw IOException(path + ": " + ::strerror(error));
+            }
+
+            size_t size = static_cast<size_t>(info.st_size);
+            if(size == 0)
+            {
+                ::close(fd);
+                throw IOException(path + ": file is empty");
+            }
+
+            void* data = ::mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+            int error = errno;
+            // The mapping stays valid after the descriptor is closed.
+            ::close(fd);
+            if(data == MAP_FAILED)
+            {
+                throw IOException(path + ": " + ::strerror(error));
+            }
+
+            data_ = static_cast<const uint8_t*>(data);
+            size_ = size;
+        }
+
+        //--------------------------------------------------------------
+        void MappedFile::close() throw()
+        {
+            if(data_ != NULL)
+            {
+                ::munmap(const_cast<uint8_t*>(data_), size_);
+                data_ = NULL;
+                size_ = 0;
+            }
+        }
+
+    } // sys ns
+} // frog ns
@@ -39,6 +39,12 @@
 #include <sys/sockio.h>
 #endif
 
+#ifdef HAVE_LINUX_RTNETLINK_H
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <unistd.h>
+#endif
+
 #include <netinet/in.h>
 #include <net/if.h>
 #include <algorithm>
@@ -56,55 +62,390 @@ namespace frog
         class intfacenm_equal
         {
           public:
-              intfacenm_equal(const std::string name)
+              intfacenm_equal(const char* name)
                   : intfacenm_(name) { }
-              bool operator()(const NetworkInterface intface)
+              bool operator()(const NetworkInterface& intface) const
               {
-                  return (intfacenm_ == intface.name);
+                  return (intface.getName() == intfacenm_);
               }
           private:
-              std::string intfacenm_;
+              const char* intfacenm_;
         };
 
-
+#ifdef HAVE_IFADDRS_H
         //--------------------------------------------------------------
-        NetworkInterface NetworkInterface::getByInetAddress(const InetAddress& addr) throw(SocketException)
+        // Fills in the unicast, netmask, and broadcast addresses of one
+        // ::getifaddrs() entry. The addresses are assigned in place, the
+        // heap is not involved.
+        static void readInterfaceAddress(const struct ifaddrs* intfaceAddr,
+                uint32_t interfaceIndex, NetworkInterface::InterfaceAddress& addrs)
         {
-            return NetworkInterface::find(&addr);
+            if(intfaceAddr->ifa_addr->sa_family == AF_INET)
+            {
+                const struct sockaddr_in* sockaddr;
+
+                sockaddr = reinterpret_cast<const struct sockaddr_in*>(intfaceAddr->ifa_addr);
+                addrs.unicast = InetAddress(sockaddr->sin_addr);
+
+                if(intfaceAddr->ifa_netmask)
+                {
+                    sockaddr = reinterpret_cast<const struct sockaddr_in*>(intfaceAddr->ifa_netmask);
+                    addrs.netmask = InetAddress(sockaddr->sin_addr);
+                }
+
+                if(intfaceAddr->ifa_broadaddr)
+                {
+                    sockaddr = reinterpret_cast<const struct sockaddr_in*>(intfaceAddr->ifa_broadaddr);
+                    addrs.broadcast = InetAddress(sockaddr->sin_addr);
+                }
+            }
+#ifdef HAVE_IPV6_SUPPORT
+            else if(intfaceAddr->ifa_addr->sa_family == AF_INET6)
+            {
+                const struct sockaddr_in6* sockaddr6;
+
+                sockaddr6 = reinterpret_cast<const struct sockaddr_in6*>(intfaceAddr->ifa_addr);
+                addrs.unicast = InetAddress(sockaddr6->sin6_addr, interfaceIndex);
+
+                if(intfaceAddr->ifa_netmask)
+                {
+                    sockaddr6 = reinterpret_cast<const struct sockaddr_in6*>(intfaceAddr->ifa_netmask);
+                    addrs.netmask = InetAddress(sockaddr6->sin6_addr);
+                }
+
+                if(intfaceAddr->ifa_broadaddr)
+                {
+                    sockaddr6 = reinterpret_cast<const struct sockaddr_in6*>(intfaceAddr->ifa_broadaddr);
+                    addrs.broadcast = InetAddress(sockaddr6->sin6_addr);
+                }
+            }
+#else
+            (void)interfaceIndex;
+#endif
         }
 
         //--------------------------------------------------------------
-        NetworkInterface NetworkInterface::getByName(const std::string& intfaceName) throw(SocketException)
+        // Tells whether a ::getifaddrs() entry is an IP address of an
+        // interface that is up.
+        static bool isUsableEntry(const struct ifaddrs* intfaceAddr)
         {
-            return NetworkInterface::find(NULL, intfaceName);
+            if(!intfaceAddr->ifa_addr) // Ignore if we do not have an IP address
+                return false;
+
+            if((intfaceAddr->ifa_addr->sa_family != AF_INET)
+#ifdef HAVE_IPV6_SUPPORT
+                    && (intfaceAddr->ifa_addr->sa_family != AF_INET6)
+#endif
+              )
+                return false;
+
+            return ((intfaceAddr->ifa_flags & IFF_UP) != 0); // Ignore if interface is not up
         }
+#endif
 
+#ifdef HAVE_LINUX_RTNETLINK_H
         //--------------------------------------------------------------
-        NetworkInterface::~NetworkInterface() throw()
+        // A network interface that is up, as found by the RTM_GETLINK dump.
+        struct NetlinkLink
         {
-        }
+            static const uint32_t NO_POSITION = 0xffffffffU;
+
+            uint32_t index;     // Interface index
+            uint32_t position;  // Position in the result, or NO_POSITION
+            char name[IFNAMSIZ];
+        };
+
+        //--------------------------------------------------------------
+        // Maps interface indexes to positions in a list of NetlinkLink%s.
+        // The table is open addressed with linear probing and at most
+        // half full. Interface indexes are mostly consecutive, and the
+        // multiplicative hash spreads consecutive indexes over distinct
+        // slots.
+        class LinkIndex
+        {
+          public:
+              static const uint32_t NOT_FOUND = 0xffffffffU;
+
+              explicit LinkIndex(size_t count) : mask_(capacityFor(count) - 1)
+              {
+                  Slot empty = { 0, NOT_FOUND };
+                  slots_.assign(mask_ + 1, empty);
+              }
+
+              void insert(uint32_t index, uint32_t position)
+              {
+                  size_t i = slotOf(index);
+                  while((slots_[i].index != 0) && (slots_[i].index != index))
+                  {
+                      i = (i + 1) & mask_;
+                  }
+                  slots_[i].index = index;
+                  slots_[i].position = position;
+              }
+
+              uint32_t find(uint32_t index) const
+              {
+                  // Index 0 is never assigned to an interface, it marks
+                  // the empty slots.
+                  if(index == 0)
+                      return NOT_FOUND;
+
+                  for(size_t i = slotOf(index); slots_[i].index != 0; i = (i + 1) & mask_)
+                  {
+                      if(slots_[i].index == index)
+                          return slots_[i].position;
+                  }
+                  return NOT_FOUND;
+              }
+          private:
+              struct Slot
+              {
+                  uint32_t index;
+                  uint32_t position;
+              };
+
+              static size_t capacityFor(size_t count)
+              {
+                  size_t capacity = 16;
+                  while(capacity < 2 * count)
+                  {
+                      capacity <<= 1;
+                  }
+                  return capacity;
+              }
+
+              size_t slotOf(uint32_t index) const
+              {
+                  return (index * 0x9E3779B1U) & mask_;
+              }
+
+              size_t mask_;
+              std::vector<Slot> slots_;
+        };
 
         //--------------------------------------------------------------
-        NetworkInterface::NetworkInterface(const NetworkInterface& netInterface) throw() :
-          name(name_), displayName(displayName_)
+        // A NETLINK_ROUTE socket, and the messages of one dump at a time.
+        // The messages are handed out in place in the receive buffer.
+        class NetlinkDump
         {
-            name_ = netInterface.name_;
-            displayName_ = netInterface.displayName_;
-            addressList_ = netInterface.addressList_;
-            intfaceIndex_ = netInterface.intfaceIndex_;
+          public:
+              NetlinkDump() : sequence_(0), buffer_(BUFFER_SIZE), message_(NULL),
+                  remaining_(0), done_(true)
+              {
+                  fd_ = ::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+              }
+
+              ~NetlinkDump()
+              {
+                  if(fd_ != -1)
+                      ::close(fd_);
+              }
+
+              bool isOpen() const
+              {
+                  return (fd_ != -1);
+              }
+
+              // Asks the kernel for all the objects of type @arg type, such
+              // as RTM_GETLINK or RTM_GETADDR, of all address families.
+              void request(uint16_t type) throw(SocketException)
+              {
+                  struct
+                  {
+                      struct nlmsghdr header;
+                      struct rtgenmsg message;
+                  } request;
+                  struct sockaddr_nl kernel;
+
+                  ::memset(&request, 0, sizeof(request));
+                  request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtgenmsg));
+                  request.header.nlmsg_type = type;
+                  request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+                  request.header.nlmsg_seq = ++sequence_;
+                  request.message.rtgen_family = AF_UNSPEC;
+
+                  ::memset(&kernel, 0, sizeof(kernel));
+                  kernel.nl_family = AF_NETLINK;
+
+                  if(::sendto(fd_, &request, request.header.nlmsg_len, 0,
+                              reinterpret_cast<struct sockaddr*>(&kernel), sizeof(kernel)) == -1)
+                  {
+                      throw SocketException(::strerror(errno));
+                  }
+
+                  remaining_ = 0;
+                  done_ = false;
+              }
+
+              // Gives the next message of the dump, or returns false at
+              // its end.
+              bool next(struct nlmsghdr*& message) throw(SocketException)
+              {
+                  while(!done_)
+                  {
+                      if(!NLMSG_OK(message_, remaining_))
+                      {
+                          receive();
+                          continue;
+                      }
+
+                      struct nlmsghdr* current = message_;
+                      message_ = NLMSG_NEXT(message_, remaining_);
+
+                      if(current->nlmsg_seq != sequence_)
+                          continue;
+
+                      if(current->nlmsg_type == NLMSG_DONE)
+                      {
+                          done_ = true;
+                      }
+                      else if(current->nlmsg_type == NLMSG_ERROR)
+                      {
+                          const struct nlmsgerr* error = static_cast<const struct nlmsgerr*>(NLMSG_DATA(current));
+                          done_ = true;
+                          throw SocketException(::strerror(-error->error));
+                      }
+                      else
+                      {
+                          message = current;
+                          return true;
+                      }
+                  }
+                  return false;
+              }
+          private:
+              // Large enough for the biggest datagram of a dump, 32 KiB
+              // on current kernels.
+              static const size_t BUFFER_SIZE = 65536U;
+
+              void receive() throw(SocketException)
+              {
+                  ssize_t length;
+
+                  do
+                  {
+                      length = ::recv(fd_, &buffer_[0], buffer_.size(), MSG_TRUNC);
+                  } while((length == -1) && (errno == EINTR));
+
+                  if(length == -1)
+                  {
+                      throw SocketException(::strerror(errno));
+                  }
+                  if(static_cast<size_t>(length) > buffer_.size())
+                  {
+                      throw SocketException("netlink message larger than the receive buffer");
+                  }
+
+                  message_ = reinterpret_cast<struct nlmsghdr*>(&buffer_[0]);
+                  remaining_ = static_cast<int>(length);
+              }
+
+              int fd_;
+              uint32_t sequence_;
+              std::vector<char> buffer_;
+              struct nlmsghdr* message_;
+              int remaining_;
+              bool done_;
+        };
+
+        //--------------------------------------------------------------
+        // Makes an InetAddress out of the raw address of a netlink
+        // attribute. IPv6 addresses get the scope id @arg index.
+        static InetAddress makeAddress(uint8_t family, const void* raw, uint32_t index = 0)
+        {
+#ifdef HAVE_IPV6_SUPPORT
+            if(family == AF_INET6)
+            {
+                struct in6_addr in6addr;
+                ::memcpy(&in6addr, raw, sizeof(in6addr));
+                return InetAddress(in6addr, index);
+            }
+#else
+            (void)family;
+            (void)index;
+#endif
+            struct in_addr inaddr;
+            ::memcpy(&inaddr, raw, sizeof(inaddr));
+            return InetAddress(inaddr);
         }
 
         //--------------------------------------------------------------
-        NetworkInterface& NetworkInterface::operator=(const NetworkInterface& netInterface) throw()
+        // Fills in the unicast, netmask, and broadcast addresses of one
+        // RTM_NEWADDR message the way ::getifaddrs() does: the local
+        // address is the unicast address, and when there is both a local
+        // and a peer address and no broadcast address, the peer goes into
+        // the broadcast slot.
+        static bool readNetlinkAddress(struct nlmsghdr* message,
+                NetworkInterface::InterfaceAddress& addrs)
         {
-            if(this != &netInterface)
+            struct ifaddrmsg* info = static_cast<struct ifaddrmsg*>(NLMSG_DATA(message));
+            size_t size = (info->ifa_family == AF_INET) ? 4U : 16U;
+            const void* address = NULL;
+            const void* local = NULL;
+            const void* broadcast = NULL;
+
+            int length = IFA_PAYLOAD(message);
+            for(struct rtattr* attr = IFA_RTA(info); RTA_OK(attr, length); attr = RTA_NEXT(attr, length))
+            {
+                if(RTA_PAYLOAD(attr) < size)
+                    continue;
+
+                switch(attr->rta_type)
+                {
+                  case IFA_ADDRESS:
+                      address = RTA_DATA(attr);
+                      break;
+                  case IFA_LOCAL:
+                      local = RTA_DATA(attr);
+                      break;
+                  case IFA_BROADCAST:
+                      broadcast = RTA_DATA(attr);
+                      break;
+                  default:
+                      break;
+                }
+            }
+
+            if(local)
             {
-                name_ = netInterface.name_;
-                displayName_ = netInterface.displayName_;
-                addressList_ = netInterface.addressList_;
-                intfaceIndex_ = netInterface.intfaceIndex_;
+                if(!broadcast)
+                    broadcast = address;
+                address = local;
             }
-            return *this;
+            if(!address)
+                return false;
+
+            uint8_t netmask[16];
+            size_t prefix = std::min(static_cast<size_t>(info->ifa_prefixlen), size * 8);
+            ::memset(netmask, 0, sizeof(netmask));
+            ::memset(netmask, 0xff, prefix / 8);
+            if(prefix % 8)
+                netmask[prefix / 8] = static_cast<uint8_t>(0xff00 >> (prefix % 8));
+
+            addrs.unicast = makeAddress(info->ifa_family, address, info->ifa_index);
+            addrs.netmask = makeAddress(info->ifa_family, netmask);
+            if(broadcast)
+                addrs.broadcast = makeAddress(info->ifa_family, broadcast);
+            return true;
+        }
+#endif
+
+
+        //--------------------------------------------------------------
+        NetworkInterface NetworkInterface::getByInetAddress(const InetAddress& addr) throw(SocketException)
+        {
+            return NetworkInterface::find(&addr);
+        }
+
+        //--------------------------------------------------------------
+        NetworkInterface NetworkInterface::getByName(const std::string& intfaceName) throw(SocketException)
+        {
+            return NetworkInterface::find(NULL, intfaceName);
+        }
+
+        //--------------------------------------------------------------
+        NetworkInterface::~NetworkInterface() throw()
+        {
         }
 
         //--------------------------------------------------------------
@@ -130,7 +471,7 @@ namespace frog
         }
 
         //--------------------------------------------------------------
-        NetworkInterface::InterfaceAddrList NetworkInterface::getInterfaceAddresses() const
+        const NetworkInterface::InterfaceAddrList& NetworkInterface::getInterfaceAddresses() const throw()
         {
             return addressList_;
         }
@@ -140,132 +481,51 @@ namespace frog
         {
 #ifdef HAVE_IFADDRS_H
             NetworkInterface netInterface;
-            struct ifaddrs* intfaceAddr;
+            struct ifaddrs* intfaceList;
+            uint32_t interfaceIndex = 0;
 
-            if(::getifaddrs(&intfaceAddr) == -1)
+            if(::getifaddrs(&intfaceList) == -1)
             {
                 throw SocketException(::strerror(errno));
             }
 
-            InetAddress* addr_p      = NULL;
-            InetAddress* netmask_p   = NULL;
-            InetAddress* broadcast_p = NULL;
-            uint32_t interfaceIndex = 0;
-
-            while(intfaceAddr)
+            for(struct ifaddrs* intfaceAddr = intfaceList; intfaceAddr; intfaceAddr = intfaceAddr->ifa_next)
             {
-                if((intfaceAddr->ifa_addr->sa_family != AF_INET) 
-#ifdef HAVE_IPV6_SUPPORT
-                        && (intfaceAddr->ifa_addr->sa_family != AF_INET6)
-#endif
-                        || ((intfaceAddr->ifa_flags & IFF_UP) == 0) // Ignore if interface is not up
-                        || (!(intfaceAddr->ifa_addr))) // Ignore if we do not have an IP address
-                {
-                    intfaceAddr = intfaceAddr->ifa_next;
+                if(!isUsableEntry(intfaceAddr))
                     continue;
-                }
 
                 interfaceIndex = if_nametoindex(intfaceAddr->ifa_name);
 
-                if(intfaceAddr->ifa_addr->sa_family == AF_INET)
-                {
-                    struct sockaddr_in* sockaddr;
-
-                    sockaddr = reinterpret_cast<struct sockaddr_in*>(intfaceAddr->ifa_addr);
-                    addr_p = new InetAddress(sockaddr->sin_addr);
-
-                    if(intfaceAddr->ifa_netmask)
-                    {
-                        sockaddr = reinterpret_cast<struct sockaddr_in*>(intfaceAddr->ifa_netmask);
-                        netmask_p = new InetAddress(sockaddr->sin_addr);
-                    }
-
-                    if(intfaceAddr->ifa_broadaddr)
-                    {
-                        sockaddr = reinterpret_cast<struct sockaddr_in*>(intfaceAddr->ifa_broadaddr);
-                        broadcast_p = new InetAddress(sockaddr->sin_addr);
-                    }
-                }
-#ifdef HAVE_IPV6_SUPPORT
-                else if(intfaceAddr->ifa_addr->sa_family == AF_INET6)
-                {
-                    struct sockaddr_in6* sockaddr6;
-
-                    sockaddr6 = reinterpret_cast<struct sockaddr_in6*>(intfaceAddr->ifa_addr);
-                    addr_p = new InetAddress(sockaddr6->sin6_addr, interfaceIndex);
-
-                    if(intfaceAddr->ifa_netmask)
-                    {
-                        sockaddr6 = reinterpret_cast<struct sockaddr_in6*>(intfaceAddr->ifa_netmask);
-                        netmask_p = new InetAddress(sockaddr6->sin6_addr);
-                    }
-
-                    if(intfaceAddr->ifa_broadaddr)
-                    {
-                        sockaddr6 = reinterpret_cast<struct sockaddr_in6*>(intfaceAddr->ifa_broadaddr);
-                        broadcast_p = new InetAddress(sockaddr6->sin6_addr);
-                    }
-                }
-#endif
+                NetworkInterface::InterfaceAddress addrs;
+                readInterfaceAddress(intfaceAddr, interfaceIndex, addrs);
 
                 bool addrMatch = false;
                 bool nameMatch = false;
 
                 if(addr)
-                    addrMatch = (*addr_p == *addr);
+                    addrMatch = (addrs.unicast == *addr);
                 if(name.length() > 0)
-                    nameMatch = (name == std::string(intfaceAddr->ifa_name));
+                    nameMatch = (name == intfaceAddr->ifa_name);
 
                 if(addrMatch || nameMatch)
                 {
-                    netInterface.name_ = std::string(intfaceAddr->ifa_name);
-                    netInterface.displayName_ = std::string(intfaceAddr->ifa_name);
-
-                    NetworkInterface::InterfaceAddress addrs;
-                    memset(&addrs, 0, sizeof(NetworkInterface::InterfaceAddress));
-
-                    addrs.unicast = *addr_p;
-
-                    if(netmask_p) 
-                        addrs.netmask = *netmask_p;
-                    if(broadcast_p)
-                        addrs.broadcast = *broadcast_p;
-
+                    netInterface.name_ = intfaceAddr->ifa_name;
+                    netInterface.displayName_ = netInterface.name_;
                     netInterface.intfaceIndex_ = interfaceIndex;
 
                     netInterface.addressList_.push_back(addrs);
                 }
-
-                if(addr_p)
-                {
-                    delete addr_p;
-                    addr_p = NULL;
-                }
-
-                if(netmask_p)
-                {
-                    delete netmask_p;
-                    netmask_p = NULL;
-                }
-
-                if(broadcast_p)
-                {
-                    delete broadcast_p;
-                    broadcast_p = NULL;
-                }
-
-                intfaceAddr = intfaceAddr->ifa_next;
             }
 
-            ::freeifaddrs(intfaceAddr);
+            ::freeifaddrs(intfaceList);
 
             return netInterface;
 #else
             // No ::getifaddrs()
             int sockfd;
             int len, lastLen, flags;
-            char* buf = frog::nullptr;
-            char* ptr = frog::nullptr;
+            char* buf = nullptr;
+            char* ptr = nullptr;
             struct ifconf ifc;
             struct ifreq* ifr;
             struct ifreq ifrcopy;
@@ -291,7 +551,7 @@ namespace frog
                     if(errno != EINVAL || lastLen != 0)
                     {
                         delete[] buf;
-                        buf = frog::nullptr;
+                        buf = nullptr;
                         throw SocketException(::strerror(errno));
                     }
                 }
@@ -303,7 +563,7 @@ namespace frog
                 }
                 len  += 10 * sizeof(struct ifreq); // Increment
                 delete[] buf;
-                buf = frog::nullptr;
+                buf = nullptr;
             }
 
             InetAddress* addr_p = NULL;
@@ -417,7 +677,7 @@ namespace frog
                 }
             }
             delete[] buf;
-            buf = frog::nullptr;
+            buf = nullptr;
 
             return netInterface;
 #endif
@@ -426,136 +686,58 @@ namespace frog
         //--------------------------------------------------------------
         std::vector<NetworkInterface> NetworkInterface::findAll() throw(SocketException)
         {
+#ifdef HAVE_LINUX_RTNETLINK_H
+            std::vector<NetworkInterface> netlinkInterfaces;
+
+            if(NetworkInterface::findAllNetlink(netlinkInterfaces))
+            {
+                return netlinkInterfaces;
+            }
+#endif
 #ifdef HAVE_IFADDRS_H
             std::vector<NetworkInterface> netInterfaces;
             std::vector<NetworkInterface>::iterator intfaceIter;
-            struct ifaddrs* intfaceAddr;
+            struct ifaddrs* intfaceList;
 
-            if(::getifaddrs(&intfaceAddr) == -1)
+            if(::getifaddrs(&intfaceList) == -1)
             {
                 throw SocketException(::strerror(errno));
             }
 
-            InetAddress* addr_p      = NULL;
-            InetAddress* netmask_p   = NULL;
-            InetAddress* broadcast_p = NULL;
-            uint32_t interfaceIndex = 0;
-
-            while(intfaceAddr)
+            for(struct ifaddrs* intfaceAddr = intfaceList; intfaceAddr; intfaceAddr = intfaceAddr->ifa_next)
             {
-                if((intfaceAddr->ifa_addr->sa_family != AF_INET) 
-#ifdef HAVE_IPV6_SUPPORT
-                        && (intfaceAddr->ifa_addr->sa_family != AF_INET6)
-#endif
-                        || ((intfaceAddr->ifa_flags & IFF_UP) == 0) // Ignore if interface is not up
-                        || (!(intfaceAddr->ifa_addr))) // Ignore if we do not have an IP address
-                {
-                    intfaceAddr = intfaceAddr->ifa_next;
+                if(!isUsableEntry(intfaceAddr))
                     continue;
-                }
-
-                interfaceIndex = if_nametoindex(intfaceAddr->ifa_name);
-
-                if(intfaceAddr->ifa_addr->sa_family == AF_INET)
-                {
-                    struct sockaddr_in* sockaddr;
-
-                    sockaddr = reinterpret_cast<struct sockaddr_in*>(intfaceAddr->ifa_addr);
-                    addr_p = new InetAddress(sockaddr->sin_addr);
-
-                    if(intfaceAddr->ifa_netmask)
-                    {
-                        sockaddr = reinterpret_cast<struct sockaddr_in*>(intfaceAddr->ifa_netmask);
-                        netmask_p = new InetAddress(sockaddr->sin_addr);
-                    }
-
-                    if(intfaceAddr->ifa_broadaddr)
-                    {
-                        sockaddr = reinterpret_cast<struct sockaddr_in*>(intfaceAddr->ifa_broadaddr);
-                        broadcast_p = new InetAddress(sockaddr->sin_addr);
-                    }
-                }
-#ifdef HAVE_IPV6_SUPPORT
-                else if(intfaceAddr->ifa_addr->sa_family == AF_INET6)
-                {
-                    struct sockaddr_in6* sockaddr6;
-
-                    sockaddr6 = reinterpret_cast<struct sockaddr_in6*>(intfaceAddr->ifa_addr);
-                    addr_p = new InetAddress(sockaddr6->sin6_addr, interfaceIndex);
-
-                    if(intfaceAddr->ifa_netmask)
-                    {
-                        sockaddr6 = reinterpret_cast<struct sockaddr_in6*>(intfaceAddr->ifa_netmask);
-                        netmask_p = new InetAddress(sockaddr6->sin6_addr);
-                    }
-
-                    if(intfaceAddr->ifa_broadaddr)
-                    {
-                        sockaddr6 = reinterpret_cast<struct sockaddr_in6*>(intfaceAddr->ifa_broadaddr);
-                        broadcast_p = new InetAddress(sockaddr6->sin6_addr);
-                    }
-                }
-#endif
-                NetworkInterface netInterface;
-                NetworkInterface::InterfaceAddress addrs;
 
-                memset(&addrs, 0, sizeof(NetworkInterface::InterfaceAddress));
-
-                addrs.unicast = *addr_p;
-
-                if(netmask_p) 
-                    addrs.netmask = *netmask_p;
-                if(broadcast_p)
-                    addrs.broadcast = *broadcast_p;
-
-                intfaceIter = std::find_if(netInterfaces.begin(), 
-                        netInterfaces.end(), intfacenm_equal(std::string(intfaceAddr->ifa_name)));
+                intfaceIter = std::find_if(netInterfaces.begin(),
+                        netInterfaces.end(), intfacenm_equal(intfaceAddr->ifa_name));
 
                 if(intfaceIter == netInterfaces.end())
                 {
-                    netInterface.name_ = std::string(intfaceAddr->ifa_name);
-                    netInterface.displayName_ = std::string(intfaceAddr->ifa_name);
-
-                    netInterface.intfaceIndex_ = interfaceIndex;
-
-                    netInterface.addressList_.push_back(addrs);
-                    netInterfaces.push_back(netInterface);
-                }
-                else
-                {
-                    intfaceIter->addressList_.push_back(addrs);
-                }
-
-                if(addr_p)
-                {
-                    delete addr_p;
-                    addr_p = NULL;
-                }
-
-                if(netmask_p)
-                {
-                    delete netmask_p;
-                    netmask_p = NULL;
-                }
-
-                if(broadcast_p)
-                {
-                    delete broadcast_p;
-                    broadcast_p = NULL;
+                    // Build the interface inside the vector rather than
+                    // copying a local one, and its address list, into it.
+                    netInterfaces.push_back(NetworkInterface());
+                    intfaceIter = netInterfaces.end() - 1;
+
+                    intfaceIter->name_ = intfaceAddr->ifa_name;
+                    intfaceIter->displayName_ = intfaceIter->name_;
+                    intfaceIter->intfaceIndex_ = if_nametoindex(intfaceAddr->ifa_name);
                 }
 
-                intfaceAddr = intfaceAddr->ifa_next;
+                intfaceIter->addressList_.push_back(NetworkInterface::InterfaceAddress());
+                readInterfaceAddress(intfaceAddr, intfaceIter->intfaceIndex_,
+                        intfaceIter->addressList_.back());
             }
 
-            ::freeifaddrs(intfaceAddr);
+            ::freeifaddrs(intfaceList);
 
             return netInterfaces;
 #else
             // No ::getifaddrs()
             int sockfd;
             int len, lastLen, flags;
-            char* buf = frog::nullptr;
-            char* ptr = frog::nullptr;
+            char* buf = nullptr;
+            char* ptr = nullptr;
             struct ifconf ifc;
             struct ifreq* ifr;
             struct ifreq ifrcopy;
@@ -583,7 +765,7 @@ namespace frog
                     if(errno != EINVAL || lastLen != 0)
                     {
                         delete[] buf;
-                        buf = frog::nullptr;
+                        buf = nullptr;
                         throw SocketException(::strerror(errno));
                     }
                 }
@@ -595,7 +777,7 @@ namespace frog
                 }
                 len  += 10 * sizeof(struct ifreq); // Increment
                 delete[] buf;
-                buf = frog::nullptr;
+                buf = nullptr;
             }
 
             InetAddress* addr_p = NULL;
@@ -674,7 +856,7 @@ namespace frog
                 if(broadcast_p)
                     addrs.broadcast = *broadcast_p;
                 intfaceIter = std::find_if(netInterfaces.begin(), 
-                        netInterfaces.end(), intfacenm_equal(std::string(ifr->ifr_name)));
+                        netInterfaces.end(), intfacenm_equal(ifr->ifr_name));
 
                 if(intfaceIter == netInterfaces.end())
                 {
@@ -710,19 +892,110 @@ namespace frog
                 }
             }
             delete[] buf;
-            buf = frog::nullptr;
+            buf = nullptr;
 
             return netInterfaces;
 #endif
         }
 
+#ifdef HAVE_LINUX_RTNETLINK_H
+        //--------------------------------------------------------------
+        bool NetworkInterface::findAllNetlink(std::vector<NetworkInterface>& netInterfaces) throw(SocketException)
+        {
+            NetlinkDump dump;
+            std::vector<NetlinkLink> links;
+            struct nlmsghdr* message;
+
+            if(!dump.isOpen())
+            {
+                return false;
+            }
+
+            dump.request(RTM_GETLINK);
+            while(dump.next(message))
+            {
+                if(message->nlmsg_type != RTM_NEWLINK)
+                    continue;
+
+                struct ifinfomsg* info = static_cast<struct ifinfomsg*>(NLMSG_DATA(message));
+                if((info->ifi_flags & IFF_UP) == 0) // Ignore if interface is not up
+                    continue;
+
+                NetlinkLink link;
+                link.index = static_cast<uint32_t>(info->ifi_index);
+                link.position = NetlinkLink::NO_POSITION;
+                link.name[0] = '\0';
+
+                int length = IFLA_PAYLOAD(message);
+                for(struct rtattr* attr = IFLA_RTA(info); RTA_OK(attr, length); attr = RTA_NEXT(attr, length))
+                {
+                    if(attr->rta_type == IFLA_IFNAME)
+                    {
+                        size_t size = std::min(static_cast<size_t>(RTA_PAYLOAD(attr)), sizeof(link.name) - 1);
+                        ::memcpy(link.name, RTA_DATA(attr), size);
+                        link.name[size] = '\0';
+                    }
+                }
+
+                links.push_back(link);
+            }
+
+            LinkIndex linkIndex(links.size());
+            for(size_t i = 0; i < links.size(); ++i)
+            {
+                linkIndex.insert(links[i].index, static_cast<uint32_t>(i));
+            }
+
+            // The interfaces come out in the order of their first address,
+            // as they do from ::getifaddrs().
+            dump.request(RTM_GETADDR);
+            while(dump.next(message))
+            {
+                if(message->nlmsg_type != RTM_NEWADDR)
+                    continue;
+
+                struct ifaddrmsg* info = static_cast<struct ifaddrmsg*>(NLMSG_DATA(message));
+                if((info->ifa_family != AF_INET)
+#ifdef HAVE_IPV6_SUPPORT
+                        && (info->ifa_family != AF_INET6)
+#endif
+                  )
+                    continue;
+
+                uint32_t i = linkIndex.find(info->ifa_index);
+                if(i == LinkIndex::NOT_FOUND) // Interface is down
+                    continue;
+
+                InterfaceAddress addrs;
+                if(!readNetlinkAddress(message, addrs))
+                    continue;
+
+                NetlinkLink& link = links[i];
+                if(link.position == NetlinkLink::NO_POSITION)
+                {
+                    link.position = static_cast<uint32_t>(netInterfaces.size());
+                    netInterfaces.push_back(NetworkInterface());
+
+                    NetworkInterface& netInterface = netInterfaces.back();
+                    netInterface.name_ = link.name;
+                    netInterface.displayName_ = netInterface.name_;
+                    netInterface.intfaceIndex_ = link.index;
+                }
+
+                netInterfaces[link.position].addressList_.push_back(addrs);
+            }
+
+            return true;
+        }
+#endif
+
         //--------------------------------------------------------------
         std::string NetworkInterface::toString() const throw()
         {
 
-            char indexTxt[3];
-            ::memset(indexTxt, 0, 3);
-            ::sprintf(indexTxt, "%d", intfaceIndex_);
+            char indexTxt[11];
+            ::memset(indexTxt, 0, sizeof(indexTxt));
+            ::sprintf(indexTxt, "%u", intfaceIndex_);
 
             std::string niTxt= std::string("name: ") + name_ + std::string(" (") + 
                 displayName_ + std::string(")  index: ") + std::string(indexTxt)+ std::string("  addresses: ");
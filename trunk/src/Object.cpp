@@ -43,7 +43,8 @@ namespace frog
         if(hash_ == 0)
         {
             int32_t* hash_p = const_cast<int32_t*>(&hash_);
-            int32_t key = (int32_t)this;
+            uint64_t ptr = static_cast<uint64_t>(reinterpret_cast<size_t>(this));
+            int32_t key = static_cast<int32_t>(ptr ^ (ptr >> 32));
             key += ~(key << 15U);
             key ^= (key >> 10U);
             key += (key << 3U);
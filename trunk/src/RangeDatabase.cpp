@@ -0,0 +1,302 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#include <cstring>
+
+#include <frog/RangeDatabase.h>
+#include <frog/AddressFamily.h>
+
+namespace frog
+{
+    namespace net
+    {
+        const char RangeDatabase::MAGIC[8] = { 'F', 'R', 'O', 'G', 'R', 'D', 'B', '\0' };
+        const uint32_t RangeDatabase::FORMAT_VERSION;
+        const uint32_t RangeDatabase::BYTE_ORDER_MARK;
+        const size_t RangeDatabase::INDEX4_SIZE;
+
+        //--------------------------------------------------------------
+        // Tests that a section lies within the file and is aligned.
+        static inline bool inFile(uint64_t offset, uint64_t size, uint64_t fileSize) throw()
+        {
+            return ((offset & 7U) == 0) && (offset <= fileSize) && (size <= fileSize - offset);
+        }
+
+        static inline bool lessKey(uint64_t aHigh, uint64_t aLow, uint64_t bHigh, uint64_t bLow) throw()
+        {
+            return (aHigh < bHigh) | ((aHigh == bHigh) & (aLow < bLow));
+        }
+
+        //--------------------------------------------------------------
+        RangeDatabase::RangeDatabase() throw()
+        {
+            detach();
+        }
+
+        //--------------------------------------------------------------
+        RangeDatabase::RangeDatabase(const std::string& path) throw(sys::IOException)
+        {
+            detach();
+            open(path);
+        }
+
+        //--------------------------------------------------------------
+        void RangeDatabase::open(const std::string& path) throw(sys::IOException)
+        {
+            close();
+            file_.open(path);
+            try
+            {
+                attach(path);
+            }
+            catch(sys::IOException&)
+            {
+                close();
+                throw;
+            }
+        }
+
+        //--------------------------------------------------------------
+        void RangeDatabase::close() throw()
+        {
+            detach();
+            file_.close();
+        }
+
+        //--------------------------------------------------------------
+        void RangeDatabase::attach(const std::string& path) throw(sys::IOException)
+        {
+            const uint8_t* data = file_.data();
+            uint64_t size = file_.size();
+
+            if(size < sizeof(Header))
+            {
+                throw sys::IOException(path + ": not a range database");
+            }
+            Header header;
+            ::memcpy(&header, data, sizeof(header));
+            if(::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+            {
+                throw sys::IOException(path + ": not a range database");
+            }
+            if(header.byteOrder != BYTE_ORDER_MARK)
+            {
+                throw sys::IOException(path + ": range database has the wrong byte order");
+            }
+            if(header.version != FORMAT_VERSION)
+            {
+                throw sys::IOException(path + ": unsupported range database version");
+            }
+
+            uint64_t range4Count = header.range4Count;
+            uint64_t range6Count = header.range6Count;
+            uint64_t recordCount = header.recordCount;
+            uint64_t fieldCount = header.fieldCount;
+            // The record area is checked against the file size before it
+            // is computed, so that the product cannot wrap around.
+            if((header.headerSize != sizeof(Header)) ||
+                    !inFile(header.index4Offset, (INDEX4_SIZE + 1U) * 4U, size) ||
+                    !inFile(header.range4Offset, range4Count * 12U, size) ||
+                    !inFile(header.range6Offset, range6Count * 36U, size) ||
+                    ((fieldCount != 0) && (recordCount > (size / 4U) / fieldCount)) ||
+                    !inFile(header.recordOffset, recordCount * fieldCount * 4U, size) ||
+                    !inFile(header.fieldOffset, fieldCount * 4U, size) ||
+                    !inFile(header.stringOffset, header.stringSize, size) ||
+                    (header.stringSize == 0) || (header.stringSize > 0xFFFFFFFFU))
+            {
+                throw sys::IOException(path + ": range database is damaged");
+            }
+
+            const uint32_t* index4 = reinterpret_cast<const uint32_t*>(data + header.index4Offset);
+            const uint32_t* last4 = reinterpret_cast<const uint32_t*>(data + header.range4Offset);
+            const uint32_t* first4 = last4 + range4Count;
+            const uint32_t* record4 = first4 + range4Count;
+            const uint64_t* last6 = reinterpret_cast<const uint64_t*>(data + header.range6Offset);
+            const uint64_t* first6 = last6 + 2U * range6Count;
+            const uint32_t* record6 = reinterpret_cast<const uint32_t*>(first6 + 2U * range6Count);
+            const uint32_t* records = reinterpret_cast<const uint32_t*>(data + header.recordOffset);
+            const uint32_t* fieldNames = reinterpret_cast<const uint32_t*>(data + header.fieldOffset);
+            const char* strings = reinterpret_cast<const char*>(data + header.stringOffset);
+            uint64_t stringSize = header.stringSize;
+
+            // Everything a lookup follows is checked here once, so that
+            // lookups need no bounds checks: the ranges are sorted and
+            // disjoint, indexes and offsets are in range and every string
+            // is terminated.
+            bool valid = (strings[0] == '\0') && (strings[stringSize - 1] == '\0');
+            for(uint64_t i = 0; valid && (i < range4Count); ++i)
+            {
+                valid = (first4[i] <= last4[i]) && (record4[i] < recordCount) &&
+                    ((i == 0) || (last4[i - 1] < first4[i]));
+            }
+            for(uint64_t i = 0; valid && (i <= INDEX4_SIZE); ++i)
+            {
+                uint64_t bound = index4[i];
+                valid = (bound <= range4Count) &&
+                    ((bound == 0) || (last4[bound - 1] < (i << 16))) &&
+                    ((bound == range4Count) || (i == INDEX4_SIZE) || (last4[bound] >= (i << 16)));
+            }
+            valid = valid && (index4[INDEX4_SIZE] == range4Count);
+            for(uint64_t i = 0; valid && (i < range6Count); ++i)
+            {
+                valid = !lessKey(last6[2 * i], last6[2 * i + 1], first6[2 * i], first6[2 * i + 1]) &&
+                    (record6[i] < recordCount) &&
+                    ((i == 0) || lessKey(last6[2 * i - 2], last6[2 * i - 1], first6[2 * i], first6[2 * i + 1]));
+            }
+            for(uint64_t i = 0; valid && (i < recordCount * fieldCount); ++i)
+            {
+                valid = (records[i] < stringSize);
+            }
+            for(uint64_t i = 0; valid && (i < fieldCount); ++i)
+            {
+                valid = (fieldNames[i] < stringSize);
+            }
+            if(!valid)
+            {
+                throw sys::IOException(path + ": range database is damaged");
+            }
+
+            index4_ = index4;
+            last4_ = last4;
+            first4_ = first4;
+            record4_ = record4;
+            range4Count_ = static_cast<size_t>(range4Count);
+            last6_ = last6;
+            first6_ = first6;
+            record6_ = record6;
+            range6Count_ = static_cast<size_t>(range6Count);
+            records_ = records;
+            fieldNames_ = fieldNames;
+            strings_ = strings;
+            fieldCount_ = static_cast<size_t>(fieldCount);
+        }
+
+        //--------------------------------------------------------------
+        void RangeDatabase::detach() throw()
+        {
+            index4_ = NULL;
+            last4_ = NULL;
+            first4_ = NULL;
+            record4_ = NULL;
+            range4Count_ = 0;
+            last6_ = NULL;
+            first6_ = NULL;
+            record6_ = NULL;
+            range6Count_ = 0;
+            records_ = NULL;
+            fieldNames_ = NULL;
+            strings_ = NULL;
+            fieldCount_ = 0;
+        }
+
+        //--------------------------------------------------------------
+        bool RangeDatabase::lookup(const InetAddressValue& value, Record& record) const throw()
+        {
+            size_t index;
+            if(index4_ == NULL)
+            {
+                return false;
+            }
+            if(value.family == AddressFamily::InterNetwork)
+            {
+                const uint8_t* p = value.address + InetAddressValue::IPV4_OFFSET;
+                uint32_t key = (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+                    (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+
+                // The top 16 bits of the key narrow the search to the
+                // ranges that end in its /16; the lower bound of the key in
+                // their last addresses is then found without branches.
+                const uint32_t* base = last4_ + index4_[key >> 16];
+                size_t n = index4_[(key >> 16) + 1] - index4_[key >> 16];
+                while(n > 1)
+                {
+                    size_t half = n >> 1;
+                    base = (base[half] < key) ? base + half : base;
+                    n -= half;
+                }
+                index = static_cast<size_t>(base - last4_) + ((n != 0) && (*base < key));
+                if((index == range4Count_) || (key < first4_[index]))
+                {
+                    return false;
+                }
+                index = record4_[index];
+            }
+#ifdef HAVE_IPV6_SUPPORT
+            else if(value.family == AddressFamily::InterNetworkV6)
+            {
+                size_t n = range6Count_;
+                if(n == 0)
+                {
+                    return false;
+                }
+                uint64_t high = value.high();
+                uint64_t low = value.low();
+
+                const uint64_t* base = last6_;
+                while(n > 1)
+                {
+                    size_t half = n >> 1;
+                    base = lessKey(base[2 * half], base[2 * half + 1], high, low) ? base + 2 * half : base;
+                    n -= half;
+                }
+                index = static_cast<size_t>(base - last6_) / 2 + lessKey(base[0], base[1], high, low);
+                if((index == range6Count_) || lessKey(high, low, first6_[2 * index], first6_[2 * index + 1]))
+                {
+                    return false;
+                }
+                index = record6_[index];
+            }
+#endif
+            else
+            {
+                return false;
+            }
+
+            record.database_ = this;
+            record.fields_ = records_ + index * fieldCount_;
+            return true;
+        }
+
+        //--------------------------------------------------------------
+        const char* RangeDatabase::getFieldName(size_t field) const throw()
+        {
+            if(field >= fieldCount_)
+            {
+                return NULL;
+            }
+            return strings_ + fieldNames_[field];
+        }
+
+        //--------------------------------------------------------------
+        size_t RangeDatabase::findField(const std::string& name) const throw()
+        {
+            for(size_t i = 0; i < fieldCount_; ++i)
+            {
+                if(name == strings_ + fieldNames_[i])
+                {
+                    return i;
+                }
+            }
+            return fieldCount_;
+        }
+
+    } // net ns
+} // frog ns
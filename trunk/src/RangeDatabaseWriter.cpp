@@ -0,0 +1,312 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#include <frog/RangeDatabaseWriter.h>
+#include <frog/AddressFamily.h>
+
+namespace frog
+{
+    namespace net
+    {
+        //--------------------------------------------------------------
+        template <typename K>
+            static bool lessFirst(const K& a, const K& b) throw()
+            {
+                return a.first < b.first;
+            }
+
+        //--------------------------------------------------------------
+        // Appends the bytes of an array, then zeros up to a multiple of 8.
+        template <typename T>
+            static void append(std::string& out, const T* p, size_t count) throw()
+            {
+                if(count > 0)
+                {
+                    out.append(reinterpret_cast<const char*>(p), count * sizeof(T));
+                }
+                out.append((8U - (out.size() & 7U)) & 7U, '\0');
+            }
+
+        //--------------------------------------------------------------
+        static void writeAll(int fd, const char* p, size_t n, const std::string& path)
+            throw(sys::IOException)
+        {
+            while(n > 0)
+            {
+                ssize_t written = ::write(fd, p, n);
+                if(written < 0)
+                {
+                    if(errno == EINTR)
+                    {
+                        continue;
+                    }
+                    throw sys::IOException(path + ": " + ::strerror(errno));
+                }
+                p += written;
+                n -= static_cast<size_t>(written);
+            }
+        }
+
+        //--------------------------------------------------------------
+        RangeDatabaseWriter::RangeDatabaseWriter(const Values& fieldNames) throw(sys::IllegalArgumentException)
+        {
+            // The empty string is always at offset 0.
+            intern(std::string());
+            for(size_t i = 0; i < fieldNames.size(); ++i)
+            {
+                if(std::find(fieldNames.begin(), fieldNames.begin() + i, fieldNames[i]) != fieldNames.begin() + i)
+                {
+                    throw sys::IllegalArgumentException("Field name is repeated.");
+                }
+                fieldNames_.push_back(intern(fieldNames[i]));
+            }
+        }
+
+        //--------------------------------------------------------------
+        void RangeDatabaseWriter::add(const InetAddress& first, const InetAddress& last,
+                const Values& values) throw(sys::IllegalArgumentException)
+        {
+            const InetAddressValue& a = first.getValue();
+            const InetAddressValue& b = last.getValue();
+            if(a.family != b.family)
+            {
+                throw sys::IllegalArgumentException("Addresses are of different families.");
+            }
+            if(values.size() != fieldNames_.size())
+            {
+                throw sys::IllegalArgumentException("Number of values does not match the number of fields.");
+            }
+
+            if(a.family == AddressFamily::InterNetwork)
+            {
+                Entry<uint32_t> entry;
+                entry.first = static_cast<uint32_t>(a.low());
+                entry.last = static_cast<uint32_t>(b.low());
+                if(entry.last < entry.first)
+                {
+                    throw sys::IllegalArgumentException("Range is empty.");
+                }
+                entry.record = addRecord(values);
+                ranges4_.push_back(entry);
+            }
+#ifdef HAVE_IPV6_SUPPORT
+            else if(a.family == AddressFamily::InterNetworkV6)
+            {
+                Entry<Word128> entry;
+                entry.first.high = a.high();
+                entry.first.low = a.low();
+                entry.last.high = b.high();
+                entry.last.low = b.low();
+                if(entry.last < entry.first)
+                {
+                    throw sys::IllegalArgumentException("Range is empty.");
+                }
+                entry.record = addRecord(values);
+                ranges6_.push_back(entry);
+            }
+#endif
+            else
+            {
+                throw sys::IllegalArgumentException("Address family is not supported.");
+            }
+        }
+
+        //--------------------------------------------------------------
+        void RangeDatabaseWriter::add(const Subnet& subnet, const Values& values) throw(sys::IllegalArgumentException)
+        {
+            InetAddressValue first = subnet.getNetwork().getValue();
+            InetAddressValue last = first;
+            InetAddressValue mask = subnet.getNetmask().getValue();
+            for(size_t i = 0; i < sizeof(last.address); ++i)
+            {
+                last.address[i] |= static_cast<uint8_t>(~mask.address[i]);
+            }
+            if(first.family == AddressFamily::InterNetwork)
+            {
+                // Only the last four bytes of an IPv4 address are used.
+                ::memset(last.address, 0, InetAddressValue::IPV4_OFFSET);
+            }
+            add(InetAddress(first), InetAddress(last), values);
+        }
+
+        //--------------------------------------------------------------
+        uint32_t RangeDatabaseWriter::intern(const std::string& s) throw(sys::IllegalArgumentException)
+        {
+            std::map<std::string, uint32_t>::const_iterator it = stringIndex_.find(s);
+            if(it != stringIndex_.end())
+            {
+                return it->second;
+            }
+            if(s.find('\0') != std::string::npos)
+            {
+                throw sys::IllegalArgumentException("String holds a NUL character.");
+            }
+            if(strings_.size() + s.size() >= 0xFFFFFFFFU)
+            {
+                throw sys::IllegalArgumentException("String pool is full.");
+            }
+            uint32_t offset = static_cast<uint32_t>(strings_.size());
+            strings_.append(s.c_str(), s.size() + 1);
+            stringIndex_.insert(std::make_pair(s, offset));
+            return offset;
+        }
+
+        //--------------------------------------------------------------
+        uint32_t RangeDatabaseWriter::addRecord(const Values& values) throw(sys::IllegalArgumentException)
+        {
+            std::vector<uint32_t> record(values.size());
+            for(size_t i = 0; i < values.size(); ++i)
+            {
+                record[i] = intern(values[i]);
+            }
+            std::map<std::vector<uint32_t>, uint32_t>::const_iterator it = recordIndex_.find(record);
+            if(it != recordIndex_.end())
+            {
+                return it->second;
+            }
+            uint32_t index = static_cast<uint32_t>(recordIndex_.size());
+            records_.insert(records_.end(), record.begin(), record.end());
+            recordIndex_.insert(std::make_pair(record, index));
+            return index;
+        }
+
+        //--------------------------------------------------------------
+        void RangeDatabaseWriter::write(const std::string& path) const
+            throw(sys::IllegalArgumentException, sys::IOException)
+        {
+            std::vector<Entry<uint32_t> > ranges4(ranges4_);
+            std::vector<Entry<Word128> > ranges6(ranges6_);
+            std::sort(ranges4.begin(), ranges4.end(), lessFirst<Entry<uint32_t> >);
+            std::sort(ranges6.begin(), ranges6.end(), lessFirst<Entry<Word128> >);
+
+            size_t n4 = ranges4.size();
+            size_t n6 = ranges6.size();
+            std::vector<uint32_t> sections4(3 * n4);
+            std::vector<uint64_t> sections6(4 * n6);
+            std::vector<uint32_t> records6(n6);
+            for(size_t i = 0; i < n4; ++i)
+            {
+                if((i > 0) && !(ranges4[i - 1].last < ranges4[i].first))
+                {
+                    throw sys::IllegalArgumentException("Ranges overlap.");
+                }
+                sections4[i] = ranges4[i].last;
+                sections4[n4 + i] = ranges4[i].first;
+                sections4[2 * n4 + i] = ranges4[i].record;
+            }
+            for(size_t i = 0; i < n6; ++i)
+            {
+                if((i > 0) && !(ranges6[i - 1].last < ranges6[i].first))
+                {
+                    throw sys::IllegalArgumentException("Ranges overlap.");
+                }
+                sections6[2 * i] = ranges6[i].last.high;
+                sections6[2 * i + 1] = ranges6[i].last.low;
+                sections6[2 * n6 + 2 * i] = ranges6[i].first.high;
+                sections6[2 * n6 + 2 * i + 1] = ranges6[i].first.low;
+                records6[i] = ranges6[i].record;
+            }
+
+            std::vector<uint32_t> index4(RangeDatabase::INDEX4_SIZE + 1U);
+            for(size_t i = 0, j = 0; i < RangeDatabase::INDEX4_SIZE; ++i)
+            {
+                while((j < n4) && ((ranges4[j].last >> 16) < i))
+                {
+                    ++j;
+                }
+                index4[i] = static_cast<uint32_t>(j);
+            }
+            index4[RangeDatabase::INDEX4_SIZE] = static_cast<uint32_t>(n4);
+
+            RangeDatabase::Header header;
+            ::memset(&header, 0, sizeof(header));
+            ::memcpy(header.magic, RangeDatabase::MAGIC, sizeof(header.magic));
+            header.version = RangeDatabase::FORMAT_VERSION;
+            header.byteOrder = RangeDatabase::BYTE_ORDER_MARK;
+            header.headerSize = sizeof(header);
+            header.fieldCount = static_cast<uint32_t>(fieldNames_.size());
+            header.range4Count = static_cast<uint32_t>(n4);
+            header.range6Count = static_cast<uint32_t>(n6);
+            header.recordCount = static_cast<uint32_t>(recordIndex_.size());
+
+            std::string out;
+            out.append(sizeof(header), '\0');
+            header.index4Offset = out.size();
+            append(out, &index4[0], index4.size());
+            header.range4Offset = out.size();
+            append(out, sections4.empty() ? NULL : &sections4[0], sections4.size());
+            header.range6Offset = out.size();
+            append(out, sections6.empty() ? NULL : &sections6[0], sections6.size());
+            append(out, records6.empty() ? NULL : &records6[0], records6.size());
+            header.recordOffset = out.size();
+            append(out, records_.empty() ? NULL : &records_[0], records_.size());
+            header.fieldOffset = out.size();
+            append(out, fieldNames_.empty() ? NULL : &fieldNames_[0], fieldNames_.size());
+            header.stringOffset = out.size();
+            header.stringSize = strings_.size();
+            append(out, strings_.data(), strings_.size());
+            ::memcpy(&out[0], &header, sizeof(header));
+
+            std::string temporary = path + ".tmp";
+            int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if(fd < 0)
+            {
+                throw sys::IOException(temporary + ": " + ::strerror(errno));
+            }
+            try
+            {
+                writeAll(fd, out.data(), out.size(), temporary);
+                if(::fsync(fd) < 0)
+                {
+                    throw sys::IOException(temporary + ": " + ::strerror(errno));
+                }
+            }
+            catch(sys::IOException&)
+            {
+                ::close(fd);
+                ::unlink(temporary.c_str());
+                throw;
+            }
+            if(::close(fd) < 0)
+            {
+                int error = errno;
+                ::unlink(temporary.c_str());
+                throw sys::IOException(temporary + ": " + ::strerror(error));
+            }
+            if(::rename(temporary.c_str(), path.c_str()) < 0)
+            {
+                int error = errno;
+                ::unlink(temporary.c_str());
+                throw sys::IOException(path + ": " + ::strerror(error));
+            }
+        }
+
+    } // net ns
+} // frog ns
@@ -0,0 +1,491 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <frog/Subnet.h>
+
+namespace frog
+{
+    namespace net
+    {
+        //--------------------------------------------------------------
+        // Returns the largest prefix length allowed for a family, or 0
+        // if the family is not an IP family.
+        static uint32_t maxPrefixLength(AddressFamily::TYPE family) throw()
+        {
+            if(family == AddressFamily::InterNetwork)
+            {
+                return 32U;
+            }
+#ifdef HAVE_IPV6_SUPPORT
+            if(family == AddressFamily::InterNetworkV6)
+            {
+                return 128U;
+            }
+#endif
+            return 0U;
+        }
+
+        //--------------------------------------------------------------
+        Subnet::Subnet() throw() : prefixLength_(0)
+        {
+            ::memset(&network_, 0, sizeof(network_));
+            network_.family = AddressFamily::Unspecified;
+            bits_[0] = bits_[1] = 0;
+            mask_[0] = mask_[1] = 0;
+        }
+
+        //--------------------------------------------------------------
+        Subnet::Subnet(const Subnet& subnet) throw() : Object(),
+          network_(subnet.network_), prefixLength_(subnet.prefixLength_)
+        {
+            bits_[0] = subnet.bits_[0];
+            bits_[1] = subnet.bits_[1];
+            mask_[0] = subnet.mask_[0];
+            mask_[1] = subnet.mask_[1];
+        }
+
+        //--------------------------------------------------------------
+        Subnet::Subnet(const InetAddress& network, uint32_t prefixLength)
+            throw(sys::IllegalArgumentException)
+        {
+            uint32_t maxLength = maxPrefixLength(network.getAddressFamily());
+            if(maxLength == 0)
+            {
+                throw sys::IllegalArgumentException("Address family is not supported.");
+            }
+            if(prefixLength > maxLength)
+            {
+                throw sys::IllegalArgumentException("Prefix length is out of range.");
+            }
+            init(network.getValue(), prefixLength);
+        }
+
+        //--------------------------------------------------------------
+        Subnet::Subnet(const std::string& text) throw(sys::IllegalArgumentException)
+        {
+            if(!tryParse(text.data(), text.size(), *this))
+            {
+                throw sys::IllegalArgumentException("Subnet is not valid.");
+            }
+        }
+
+        //--------------------------------------------------------------
+        Subnet::Subnet(const NetworkInterface::InterfaceAddress& intfaceAddr)
+            throw(sys::IllegalArgumentException)
+        {
+            const InetAddressValue& unicast = intfaceAddr.unicast.getValue();
+            const InetAddressValue& netmask = intfaceAddr.netmask.getValue();
+
+            uint32_t maxLength = maxPrefixLength(unicast.family);
+            if((maxLength == 0) || (netmask.family != unicast.family))
+            {
+                throw sys::IllegalArgumentException("Netmask is not valid.");
+            }
+
+            // Count the leading one bits, then make sure that no one
+            // bit follows the first zero bit.
+            const uint8_t* end = netmask.address + sizeof(netmask.address);
+            const uint8_t* p = end - maxLength / 8;
+            uint32_t prefixLength = 0;
+            while((p != end) && (*p == 0xff))
+            {
+                prefixLength += 8;
+                ++p;
+            }
+            if(p != end)
+            {
+                uint8_t octet = *p++;
+                while(octet & 0x80)
+                {
+                    ++prefixLength;
+                    octet = static_cast<uint8_t>(octet << 1);
+                }
+                while((octet == 0) && (p != end))
+                {
+                    octet = *p++;
+                }
+                if(octet != 0)
+                {
+                    throw sys::IllegalArgumentException("Netmask is not contiguous.");
+                }
+            }
+            init(unicast, prefixLength);
+        }
+
+        //--------------------------------------------------------------
+        void Subnet::init(const InetAddressValue& network, uint32_t prefixLength) throw()
+        {
+            uint8_t mask[sizeof(network.address)];
+            uint32_t bits = prefixLength;
+            if(network.family == AddressFamily::InterNetwork)
+            {
+                bits += InetAddressValue::IPV4_OFFSET * 8;
+            }
+            for(size_t i = 0; i < sizeof(mask); ++i)
+            {
+                if(bits >= 8)
+                {
+                    mask[i] = 0xff;
+                    bits -= 8;
+                }
+                else
+                {
+                    mask[i] = static_cast<uint8_t>(0xff00U >> bits);
+                    bits = 0;
+                }
+            }
+
+            network_ = network;
+            for(size_t i = 0; i < sizeof(mask); ++i)
+            {
+                network_.address[i] &= mask[i];
+            }
+            ::memcpy(bits_, network_.address, sizeof(bits_));
+            ::memcpy(mask_, mask, sizeof(mask_));
+            prefixLength_ = prefixLength;
+        }
+
+        //--------------------------------------------------------------
+        bool Subnet::tryParse(const char* p, size_t n, Subnet& out) throw()
+        {
+            if((p == NULL) || (n == 0))
+            {
+                return false;
+            }
+
+            const char* slash = static_cast<const char*>(::memchr(p, '/', n));
+            InetAddress addr;
+            if(!InetAddress::tryParse(p, (slash != NULL) ? static_cast<size_t>(slash - p) : n, addr))
+            {
+                return false;
+            }
+
+            uint32_t maxLength = maxPrefixLength(addr.getAddressFamily());
+            uint32_t prefixLength = maxLength;
+            if(slash != NULL)
+            {
+                // One to three decimal digits without leading zeros.
+                const char* q = slash + 1;
+                const char* end = p + n;
+                if((q == end) || (end - q > 3) || ((*q == '0') && (end - q > 1)))
+                {
+                    return false;
+                }
+                prefixLength = 0;
+                for(; q != end; ++q)
+                {
+                    uint32_t digit = static_cast<uint8_t>(*q - '0');
+                    if(digit > 9)
+                    {
+                        return false;
+                    }
+                    prefixLength = prefixLength * 10 + digit;
+                }
+                if(prefixLength > maxLength)
+                {
+                    return false;
+                }
+            }
+
+            out.init(addr.getValue(), prefixLength);
+            return true;
+        }
+
+        //--------------------------------------------------------------
+        Subnet& Subnet::operator=(const Subnet& subnet) throw()
+        {
+            if(this != &subnet)
+            {
+                network_ = subnet.network_;
+                bits_[0] = subnet.bits_[0];
+                bits_[1] = subnet.bits_[1];
+                mask_[0] = subnet.mask_[0];
+                mask_[1] = subnet.mask_[1];
+                prefixLength_ = subnet.prefixLength_;
+            }
+            return *this;
+        }
+
+        //--------------------------------------------------------------
+        bool Subnet::operator==(const Subnet& subnet) const throw()
+        {
+            return ((network_ == subnet.network_) && (prefixLength_ == subnet.prefixLength_));
+        }
+
+        //--------------------------------------------------------------
+        bool Subnet::operator!=(const Subnet& subnet) const throw()
+        {
+            return !(*this == subnet);
+        }
+
+        //--------------------------------------------------------------
+        InetAddress Subnet::getNetmask() const throw()
+        {
+            InetAddressValue netmask;
+            ::memset(&netmask, 0, sizeof(netmask));
+            ::memcpy(netmask.address, mask_, sizeof(mask_));
+            netmask.family = network_.family;
+            if(network_.family == AddressFamily::InterNetwork)
+            {
+                ::memset(netmask.address, 0, InetAddressValue::IPV4_OFFSET);
+            }
+            return InetAddress(netmask);
+        }
+
+        //--------------------------------------------------------------
+        InetAddress Subnet::getLastAddress() const throw()
+        {
+            uint8_t mask[sizeof(mask_)];
+            ::memcpy(mask, mask_, sizeof(mask));
+            InetAddressValue last = network_;
+            for(size_t i = 0; i < sizeof(mask); ++i)
+            {
+                last.address[i] |= static_cast<uint8_t>(~mask[i]);
+            }
+            return InetAddress(last);
+        }
+
+        //--------------------------------------------------------------
+        Subnet::iterator Subnet::begin() const throw()
+        {
+            return iterator(*this, 1U, 0, false);
+        }
+
+        //--------------------------------------------------------------
+        Subnet::Range Subnet::stride(uint64_t step) const throw(sys::IllegalArgumentException)
+        {
+            if(step == 0)
+            {
+                throw sys::IllegalArgumentException("Step must not be 0.");
+            }
+            return Range(iterator(*this, step, 0, false));
+        }
+
+        //--------------------------------------------------------------
+        Subnet::Range Subnet::permutation(uint64_t seed) const throw(sys::IllegalArgumentException)
+        {
+            if(maxPrefixLength(network_.family) - prefixLength_ > 64U)
+            {
+                throw sys::IllegalArgumentException("Subnet has more than 64 host bits.");
+            }
+            return Range(iterator(*this, 1U, seed, true));
+        }
+
+        //--------------------------------------------------------------
+        // The SplitMix64 finalizer, used to turn a seed into the
+        // constants of a permutation.
+        static uint64_t splitMix64(uint64_t x) throw()
+        {
+            x += 0x9E3779B97F4A7C15ULL;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+            return x ^ (x >> 31);
+        }
+
+        //--------------------------------------------------------------
+        // Writes a number as 8 big-endian bytes. Compilers turn this
+        // into a byte swap and a single store.
+        static void storeBigEndian64(uint8_t* p, uint64_t v) throw()
+        {
+            p[0] = static_cast<uint8_t>(v >> 56);
+            p[1] = static_cast<uint8_t>(v >> 48);
+            p[2] = static_cast<uint8_t>(v >> 40);
+            p[3] = static_cast<uint8_t>(v >> 32);
+            p[4] = static_cast<uint8_t>(v >> 24);
+            p[5] = static_cast<uint8_t>(v >> 16);
+            p[6] = static_cast<uint8_t>(v >> 8);
+            p[7] = static_cast<uint8_t>(v);
+        }
+
+        //--------------------------------------------------------------
+        Subnet::iterator::iterator() throw() :
+          step_(0), multiplier_(0), increment_(0), shift_(0), end_(true)
+        {
+            ::memset(&network_, 0, sizeof(network_));
+            network_.family = AddressFamily::Unspecified;
+            base_ = hostMask_ = position_ = makeWord128(0, 0);
+        }
+
+        //--------------------------------------------------------------
+        Subnet::iterator::iterator(const Subnet& subnet, uint64_t step, uint64_t seed, bool shuffle) throw() :
+          network_(subnet.network_), step_(step), multiplier_(0), increment_(0), shift_(0),
+          end_(maxPrefixLength(subnet.network_.family) == 0)
+        {
+            InetAddressValue mask;
+            ::memset(&mask, 0, sizeof(mask));
+            ::memcpy(mask.address, subnet.mask_, sizeof(subnet.mask_));
+            base_ = makeWord128(network_.high(), network_.low());
+            hostMask_ = ~makeWord128(mask.high(), mask.low());
+            position_ = makeWord128(0, 0);
+            if(shuffle)
+            {
+                // x -> x * odd + c, x -> x ^ (x >> s) and x -> x * odd are
+                // all one to one on the host bits, so their composition
+                // visits every position once.
+                multiplier_ = splitMix64(seed) | 1U;
+                increment_ = splitMix64(seed ^ 0x5851F42D4C957F2DULL);
+                shift_ = (128U - countLeadingZeros(hostMask_)) / 2U + 1U;
+            }
+            if(!end_)
+            {
+                update();
+            }
+        }
+
+        //--------------------------------------------------------------
+        void Subnet::iterator::update() throw()
+        {
+            Word128 offset = position_;
+            if(multiplier_ != 0)
+            {
+                uint64_t hostMask = hostMask_.low;
+                uint64_t x = ((position_.low * multiplier_) + increment_) & hostMask;
+                x ^= x >> shift_;
+                x = (x * 0x9E3779B97F4A7C15ULL) & hostMask;
+                x ^= x >> shift_;
+                offset = makeWord128(0, x);
+            }
+
+            Word128 word = base_ | offset;
+            InetAddressValue value = network_;
+            storeBigEndian64(value.address, word.high);
+            storeBigEndian64(value.address + 8, word.low);
+            address_ = InetAddress(value);
+        }
+
+        //--------------------------------------------------------------
+        Subnet::iterator& Subnet::iterator::operator++() throw()
+        {
+            if(!end_)
+            {
+                Word128 next = position_ + makeWord128(0, step_);
+                if((next < position_) || ((next & ~hostMask_) != makeWord128(0, 0)))
+                {
+                    end_ = true;
+                }
+                else
+                {
+                    position_ = next;
+                    update();
+                }
+            }
+            return *this;
+        }
+
+        //--------------------------------------------------------------
+        Subnet::iterator Subnet::iterator::operator++(int) throw()
+        {
+            iterator previous(*this);
+            ++*this;
+            return previous;
+        }
+
+        //--------------------------------------------------------------
+        size_t Subnet::containsMany(const InetAddressValue* addrs, size_t count,
+                uint8_t* result) const throw()
+        {
+            size_t matches = 0;
+            size_t i = 0;
+#ifdef __SSE2__
+            // Compare the masked address with the network sixteen bytes
+            // at a time; the family is compared on the side.
+            const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask_));
+            const __m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bits_));
+            for(; i < count; ++i)
+            {
+                __m128i addr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(addrs[i].address));
+                int equal = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(addr, mask), bits));
+                uint8_t found = static_cast<uint8_t>((equal == 0xffff) & (addrs[i].family == network_.family));
+                result[i] = found;
+                matches += found;
+            }
+#endif
+            for(; i < count; ++i)
+            {
+                uint8_t found = static_cast<uint8_t>(contains(addrs[i]));
+                result[i] = found;
+                matches += found;
+            }
+            return matches;
+        }
+
+        //--------------------------------------------------------------
+        size_t Subnet::format(char* buf, size_t cap) const throw()
+        {
+            char text[MAX_TEXT_SIZE];
+            size_t length = InetAddress(network_).format(text, InetAddress::MAX_TEXT_SIZE);
+            if(length == 0)
+            {
+                if(cap > 0)
+                {
+                    buf[0] = '\0';
+                }
+                return 0;
+            }
+
+            char* end = text + length;
+            *end++ = '/';
+            if(prefixLength_ >= 100)
+            {
+                *end++ = static_cast<char>('0' + prefixLength_ / 100);
+            }
+            if(prefixLength_ >= 10)
+            {
+                *end++ = static_cast<char>('0' + (prefixLength_ / 10) % 10);
+            }
+            *end++ = static_cast<char>('0' + prefixLength_ % 10);
+
+            length = end - text;
+            if(length >= cap)
+            {
+                if(cap > 0)
+                {
+                    buf[0] = '\0';
+                }
+                return 0;
+            }
+            ::memcpy(buf, text, length);
+            buf[length] = '\0';
+            return length;
+        }
+
+        //--------------------------------------------------------------
+        int32_t Subnet::hashCode() const throw()
+        {
+            uint64_t h = network_.hash(prefixLength_);
+            return static_cast<int32_t>(h ^ (h >> 32));
+        }
+
+        //--------------------------------------------------------------
+        std::string Subnet::toString() const throw()
+        {
+            char text[MAX_TEXT_SIZE];
+            return std::string(text, format(text, sizeof(text)));
+        }
+
+    } // net ns
+} // frog ns
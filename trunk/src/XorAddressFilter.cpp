@@ -0,0 +1,197 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#include <algorithm>
+#include <vector>
+#include <frog/XorAddressFilter.h>
+
+namespace frog
+{
+    namespace net
+    {
+        //--------------------------------------------------------------
+        // Addresses tested ahead in mayContainBatch().
+        static const size_t XOR_BATCH = 16U;
+
+        //--------------------------------------------------------------
+        // Returns the table size, in slots of each of the three blocks,
+        // for a number of addresses.
+        static uint64_t xorBlockLength(uint64_t count) throw()
+        {
+            uint64_t capacity = 32U + (count * 123U + 99U) / 100U;
+            return (capacity + 2U) / 3U;
+        }
+
+        //--------------------------------------------------------------
+        XorAddressFilter::XorAddressFilter() throw() : AddressFilter(KIND_XOR)
+        {
+            params_[1] = xorBlockLength(0);
+            allocate(static_cast<size_t>((3U * params_[1] + 7U) / 8U));
+        }
+
+        //--------------------------------------------------------------
+        void XorAddressFilter::build(const InetAddressValue* values, size_t count)
+            throw(sys::IllegalArgumentException)
+        {
+            if(count > (1U << 30))
+            {
+                throw sys::IllegalArgumentException("Too many addresses.");
+            }
+            uint64_t blockLength = xorBlockLength(count);
+            size_t capacity = static_cast<size_t>(3U * blockLength);
+            params_[1] = blockLength;
+
+            std::vector<uint64_t> hashes(count);
+            std::vector<uint64_t> xors(capacity);
+            std::vector<uint32_t> counts(capacity);
+            std::vector<uint32_t> queue;
+            std::vector<std::pair<uint64_t, uint32_t> > stack;
+            queue.reserve(capacity);
+            stack.reserve(count);
+
+            // Peeling fails with a small probability; a new seed gives
+            // new positions to all addresses.
+            uint64_t seed = 0x9E3779B97F4A7C15ULL;
+            size_t distinct = 0;
+            for(;;)
+            {
+                seed = (seed ^ (seed >> 31)) * 0xBF58476D1CE4E5B9ULL + 0x94D049BB133111EBULL;
+                for(size_t i = 0; i < count; ++i)
+                {
+                    hashes[i] = values[i].hash(seed);
+                }
+                std::sort(hashes.begin(), hashes.end());
+                distinct = std::unique(hashes.begin(), hashes.end()) - hashes.begin();
+
+                params_[0] = seed;
+                std::fill(xors.begin(), xors.end(), 0);
+                std::fill(counts.begin(), counts.end(), 0);
+                for(size_t i = 0; i < distinct; ++i)
+                {
+                    uint32_t positions[3];
+                    positionsOf(hashes[i], positions);
+                    for(size_t j = 0; j < 3; ++j)
+                    {
+                        xors[positions[j]] ^= hashes[i];
+                        ++counts[positions[j]];
+                    }
+                }
+
+                queue.clear();
+                stack.clear();
+                for(size_t i = 0; i < capacity; ++i)
+                {
+                    if(counts[i] == 1)
+                    {
+                        queue.push_back(static_cast<uint32_t>(i));
+                    }
+                }
+                while(!queue.empty())
+                {
+                    uint32_t position = queue.back();
+                    queue.pop_back();
+                    if(counts[position] != 1)
+                    {
+                        continue;
+                    }
+                    uint64_t hash = xors[position];
+                    stack.push_back(std::make_pair(hash, position));
+                    uint32_t positions[3];
+                    positionsOf(hash, positions);
+                    for(size_t j = 0; j < 3; ++j)
+                    {
+                        xors[positions[j]] ^= hash;
+                        if(--counts[positions[j]] == 1)
+                        {
+                            queue.push_back(positions[j]);
+                        }
+                    }
+                }
+                if(stack.size() == distinct)
+                {
+                    break;
+                }
+            }
+
+            allocate(static_cast<size_t>((capacity + 7U) / 8U));
+            uint8_t* table = reinterpret_cast<uint8_t*>(getMutableWords());
+            // Each address is the only one left at its position when it
+            // is assigned, so the fingerprints of the others are final.
+            for(size_t i = stack.size(); i-- > 0;)
+            {
+                uint32_t positions[3];
+                positionsOf(stack[i].first, positions);
+                table[stack[i].second] = static_cast<uint8_t>(fingerprintOf(stack[i].first) ^
+                        table[positions[0]] ^ table[positions[1]] ^ table[positions[2]]);
+            }
+            count_ = distinct;
+        }
+
+        //--------------------------------------------------------------
+        bool XorAddressFilter::mayContain(const InetAddressValue& value) const throw()
+        {
+            uint64_t hash = value.hash(params_[0]);
+            uint32_t positions[3];
+            positionsOf(hash, positions);
+            const uint8_t* table = getTable();
+            return fingerprintOf(hash) == (table[positions[0]] ^ table[positions[1]] ^ table[positions[2]]);
+        }
+
+        //--------------------------------------------------------------
+        size_t XorAddressFilter::mayContainBatch(const InetAddressValue* values, size_t count,
+                uint8_t* result) const throw()
+        {
+            size_t found = 0;
+            const uint8_t* table = getTable();
+            uint64_t hashes[XOR_BATCH];
+            uint32_t positions[XOR_BATCH][3];
+            for(size_t start = 0; start < count; start += XOR_BATCH)
+            {
+                size_t n = (count - start < XOR_BATCH) ? count - start : XOR_BATCH;
+                for(size_t i = 0; i < n; ++i)
+                {
+                    hashes[i] = values[start + i].hash(params_[0]);
+                    positionsOf(hashes[i], positions[i]);
+#ifdef __GNUC__
+                    __builtin_prefetch(table + positions[i][0]);
+                    __builtin_prefetch(table + positions[i][1]);
+                    __builtin_prefetch(table + positions[i][2]);
+#endif
+                }
+                for(size_t i = 0; i < n; ++i)
+                {
+                    bool hit = fingerprintOf(hashes[i]) ==
+                        (table[positions[i][0]] ^ table[positions[i][1]] ^ table[positions[i][2]]);
+                    result[start + i] = static_cast<uint8_t>(hit);
+                    found += hit;
+                }
+            }
+            return found;
+        }
+
+        //--------------------------------------------------------------
+        bool XorAddressFilter::checkParams() const throw()
+        {
+            uint64_t blockLength = params_[1];
+            return (blockLength != 0) && (blockLength < (1ULL << 31)) &&
+                (wordCount_ == (3U * blockLength + 7U) / 8U);
+        }
+    } // net ns
+} // frog ns
@@ -0,0 +1,262 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_ADDRESSFILTER_H
+#define FROG_NET_ADDRESSFILTER_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string>
+#include <vector>
+
+#include <frog/stdint.h>
+#include <frog/NonCopyable.h>
+#include <frog/MappedFile.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/IOException.h>
+#include <frog/RuntimeException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * The base class of the approximate membership filters:
+         * BloomAddressFilter, CuckooAddressFilter and XorAddressFilter.
+         * A filter answers "maybe" for every address that was added and
+         * "no" for most others, in far less memory than the addresses
+         * themselves, so it can sit in front of an exact but larger
+         * structure such as a blocklist.
+         *
+         * Addresses are hashed with InetAddressValue::hash(), which reads
+         * the raw address bytes, the family and the scope id; an IPv4
+         * address and its IPv4-mapped IPv6 form are different keys.
+         *
+         * A filter is an array of 64-bit words. write() saves it to a file
+         * and open() maps such a file back read-only, so that a large
+         * filter is shared by every process that opens it and needs no
+         * loading. A mapped filter cannot be changed. The file holds
+         * numbers in the byte order of the host that wrote it.
+         */
+        class AddressFilter : private NonCopyable
+        {
+          public:
+              /**
+               * The header at the start of a filter file.
+               */
+              struct Header
+              {
+                  char magic[8]; /**< AddressFilter::MAGIC */
+                  uint32_t version; /**< AddressFilter::FORMAT_VERSION */
+                  uint32_t byteOrder; /**< AddressFilter::BYTE_ORDER_MARK */
+                  uint32_t headerSize; /**< sizeof(Header) */
+                  uint32_t kind; /**< One of the KIND_* constants */
+                  uint64_t count; /**< Number of addresses in the filter */
+                  uint64_t params[4]; /**< Parameters of the kind of filter */
+                  uint64_t wordCount; /**< Number of 64-bit words after the header */
+              };
+
+              /**
+               * The first eight bytes of a filter file.
+               */
+              static const char MAGIC[8];
+
+              /**
+               * The version of the file format written by this library.
+               */
+              static const uint32_t FORMAT_VERSION = 1U;
+
+              /**
+               * The value of Header::byteOrder, as stored by the writer.
+               */
+              static const uint32_t BYTE_ORDER_MARK = 0x01020304U;
+
+              /**
+               * @name Kinds of filter
+               */
+              //@{
+              static const uint32_t KIND_BLOOM = 1U;
+              static const uint32_t KIND_CUCKOO = 2U;
+              static const uint32_t KIND_XOR = 3U;
+              //@}
+
+              /**
+               * Default destructor.
+               */
+              virtual ~AddressFilter() throw();
+
+              /**
+               * Tests if an address may be in the filter.
+               * @return @c false if the address was certainly not added;
+               * @c true if it was added, or, with a small probability, if
+               * it was not.
+               */
+              virtual bool mayContain(const InetAddressValue& value) const throw() = 0;
+
+              /**
+               * Tests if an address may be in the filter. See
+               * mayContain(const InetAddressValue&).
+               */
+              bool mayContain(const InetAddress& address) const throw()
+              {
+                  return mayContain(address.getValue());
+              }
+
+              /**
+               * Tests many addresses. The filter words of an address are
+               * prefetched while the addresses before it are tested, which
+               * hides most of the cache misses of a filter larger than the
+               * cache.
+               * @param[in] values The addresses to test.
+               * @param[in] count The number of addresses.
+               * @param[out] result Receives @arg count bytes: 1 for every
+               * address that may be in the filter and 0 for the others.
+               * @return The number of addresses that may be in the filter.
+               */
+              virtual size_t mayContainBatch(const InetAddressValue* values, size_t count,
+                      uint8_t* result) const throw() = 0;
+
+              /**
+               * Returns the number of addresses in the filter.
+               */
+              uint64_t getCount() const throw()
+              {
+                  return count_;
+              }
+
+              /**
+               * Returns the size of the filter in bytes.
+               */
+              size_t getMemoryUsage() const throw()
+              {
+                  return wordCount_ * sizeof(uint64_t);
+              }
+
+              /**
+               * Tests if the filter was opened from a file.
+               */
+              bool isMapped() const throw()
+              {
+                  return file_.isOpen();
+              }
+
+              /**
+               * Writes the filter to a file. The file is written under a
+               * temporary name and renamed, so readers never see half a
+               * filter.
+               * @param[in] path The path of the file.
+               * @exception frog::sys::IOException Thrown when the file
+               * cannot be written.
+               */
+              void write(const std::string& path) const throw(sys::IOException);
+
+              /**
+               * Maps a filter file written by write() from a filter of the
+               * same kind. The previous contents of the filter are dropped.
+               * @param[in] path The path of the file.
+               * @exception frog::sys::IOException Thrown when the file
+               * cannot be mapped or is not a filter of this kind.
+               */
+              void open(const std::string& path) throw(sys::IOException);
+          protected:
+              /**
+               * Creates an empty filter of a kind.
+               */
+              explicit AddressFilter(uint32_t kind) throw();
+
+              /**
+               * Replaces the words of the filter with @arg wordCount zero
+               * words in memory.
+               */
+              void allocate(size_t wordCount) throw();
+
+              /**
+               * Tests if params_, count_ and wordCount_ describe a valid
+               * filter of this kind. Called by open() on the header of
+               * the file.
+               */
+              virtual bool checkParams() const throw() = 0;
+
+              /**
+               * Returns the words for changing. Only filters built in memory
+               * can be changed.
+               * @exception frog::sys::RuntimeException Thrown when the filter
+               * is mapped from a file.
+               */
+              uint64_t* getMutableWords() throw(sys::RuntimeException);
+
+              /**
+               * The kind of the filter.
+               */
+              uint32_t kind_;
+
+              /**
+               * The number of addresses in the filter.
+               */
+              uint64_t count_;
+
+              /**
+               * Parameters of the filter, saved in the file header.
+               */
+              uint64_t params_[4];
+
+              /**
+               * The words of the filter, in storage_ or in file_.
+               */
+              const uint64_t* words_;
+
+              /**
+               * The number of words of the filter.
+               */
+              size_t wordCount_;
+          private:
+              /**
+               * Checks the header of the mapped file and points the filter
+               * at its words.
+               */
+              void attach(const std::string& path) throw(sys::IOException);
+
+              /**
+               * The words of a filter built in memory.
+               */
+              std::vector<uint64_t> storage_;
+
+              /**
+               * The file of a mapped filter.
+               */
+              sys::MappedFile file_;
+        }; // AddressFilter cls
+    } // net ns
+} // frog ns
+#endif // FROG_NET_ADDRESSFILTER_H
@@ -0,0 +1,210 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_ADDRESSPOOL_H
+#define FROG_NET_ADDRESSPOOL_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <vector>
+
+#include <frog/stdint.h>
+#include <frog/NonCopyable.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/IllegalArgumentException.h>
+#include <frog/OverflowException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * Interns addresses: gives every distinct address a small id, so
+         * tables that see the same addresses over and over can keep a
+         * 4-byte id instead of a whole InetAddress. Ids are dense and
+         * given in order of first insertion: 0, 1, 2 and so on. getValue()
+         * turns an id back into the address.
+         *
+         * Any number of threads may call intern(), tryIntern() and find()
+         * at the same time, without locks. The hash table is open
+         * addressed with linear probing; a slot is a 64-bit word holding
+         * 32 bits of the hash and the id, and is claimed with one
+         * compare-and-swap. The thread that claims a slot takes the next
+         * id, stores the address and then publishes the id. A thread that
+         * meets a slot being filled with the same hash bits waits for
+         * that one store; no other thread ever waits.
+         *
+         * The capacity is fixed when the pool is created, so that nothing
+         * moves while other threads read. Entries are never removed.
+         * @note Uses the GCC atomic builtins.
+         */
+        class AddressPool : private NonCopyable
+        {
+          public:
+              /**
+               * Creates an empty pool.
+               * @param[in] capacity The largest number of distinct addresses
+               * the pool will hold. The hash table has at least twice as
+               * many slots.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * @arg capacity is 0 or larger than AddressPool::MAX_CAPACITY.
+               */
+              explicit AddressPool(size_t capacity) throw(sys::IllegalArgumentException);
+
+              /**
+               * Returns the id of an address, adding the address if it is
+               * not in the pool yet. Safe to call from many threads.
+               * @param[in] value The address. Every byte counts, including
+               * the scope id.
+               * @param[out] id Receives the id.
+               * @return @c false if the address is new and the pool is full.
+               */
+              bool tryIntern(const InetAddressValue& value, uint32_t& id) throw();
+
+              /**
+               * Returns the id of an address, adding the address if it is
+               * not in the pool yet. Safe to call from many threads.
+               * @exception frog::sys::OverflowException Thrown when the
+               * address is new and the pool is full.
+               */
+              uint32_t intern(const InetAddressValue& value) throw(sys::OverflowException);
+
+              /**
+               * Returns the id of an address. See
+               * intern(const InetAddressValue&).
+               */
+              uint32_t intern(const InetAddress& address) throw(sys::OverflowException)
+              {
+                  return intern(address.getValue());
+              }
+
+              /**
+               * Looks an address up without adding it. Safe to call from
+               * many threads.
+               * @param[in] value The address.
+               * @param[out] id Receives the id of the address when it is
+               * found.
+               * @return @c true if the address is in the pool.
+               */
+              bool find(const InetAddressValue& value, uint32_t& id) const throw();
+
+              /**
+               * Returns the address of an id. Any thread may call this with
+               * an id it got from intern(), tryIntern() or find(), or that
+               * was handed to it by a thread that did.
+               * @param[in] id An id below getSize().
+               */
+              const InetAddressValue& getValue(uint32_t id) const throw()
+              {
+                  return values_[id];
+              }
+
+              /**
+               * Returns the address of an id as an InetAddress. See
+               * getValue().
+               */
+              InetAddress getAddress(uint32_t id) const throw()
+              {
+                  return InetAddress(values_[id]);
+              }
+
+              /**
+               * Returns the number of addresses in the pool. While other
+               * threads insert, this counts addresses that are still being
+               * stored.
+               */
+              size_t getSize() const throw();
+
+              /**
+               * Returns the largest number of addresses the pool holds.
+               */
+              size_t getCapacity() const throw()
+              {
+                  return values_.size();
+              }
+
+              /**
+               * Returns the number of bytes used by the hash table and the
+               * id to address array.
+               */
+              size_t getMemoryUsage() const throw()
+              {
+                  return (slots_.size() * sizeof(uint64_t)) + (values_.size() * sizeof(InetAddressValue));
+              }
+
+              /**
+               * The largest capacity of a pool.
+               */
+              static const size_t MAX_CAPACITY = 0x40000000U;
+          private:
+              /**
+               * Slot states, kept in the low 32 bits of a claimed slot. A
+               * slot that is 0 is empty; any other state holds id + 1.
+               */
+              static const uint32_t SLOT_BUSY = 0U;
+              static const uint32_t SLOT_DROPPED = 0xffffffffU;
+
+              /**
+               * Returns the 32 hash bits kept in a slot. They are never 0,
+               * so a claimed slot is never 0.
+               */
+              static uint64_t tagOf(uint64_t hash) throw()
+              {
+                  return ((hash >> 32) | 1U) << 32;
+              }
+
+              /**
+               * Waits until a slot is no longer being filled and returns it.
+               */
+              uint64_t waitForSlot(size_t index) const throw();
+
+              /**
+               * The hash table. Its size is a power of two.
+               */
+              std::vector<uint64_t> slots_;
+
+              /**
+               * The addresses, by id.
+               */
+              std::vector<InetAddressValue> values_;
+
+              /**
+               * The number of ids given out, which may go beyond the
+               * capacity once the pool is full.
+               */
+              volatile uint32_t count_;
+        }; // AddressPool cls
+    } // net ns
+} // frog ns
+#endif // FROG_NET_ADDRESSPOOL_H
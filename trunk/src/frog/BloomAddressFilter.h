@@ -0,0 +1,122 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_BLOOMADDRESSFILTER_H
+#define FROG_NET_BLOOMADDRESSFILTER_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <frog/stdint.h>
+#include <frog/AddressFilter.h>
+#include <frog/IllegalArgumentException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * A blocked Bloom filter of addresses. The filter is an array of
+         * 32-byte blocks; an address sets and tests 8 bits, one in each
+         * 32-bit lane of a single block, so a test touches one cache line
+         * and has no loop that depends on the data. With the default 12
+         * bits per address about 0.4% of the addresses that were not
+         * added test positive. Addresses cannot be removed; see
+         * CuckooAddressFilter.
+         * <HR>
+         * <H3>Inherits from:</H3>
+         *     &nbsp;&nbsp;&nbsp;&nbsp;&nbsp;
+         *     AddressFilter
+         * <HR>
+         */
+        class BloomAddressFilter : public AddressFilter
+        {
+          public:
+              /**
+               * Creates an empty filter.
+               * @param[in] expectedCount The number of addresses the filter
+               * is sized for. More may be added at the cost of a higher
+               * false positive rate.
+               * @param[in] bitsPerAddress The number of bits of filter per
+               * expected address, from 1 to 64.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * @arg bitsPerAddress is out of range or the filter would be
+               * too large.
+               */
+              explicit BloomAddressFilter(uint64_t expectedCount = 0, uint32_t bitsPerAddress = 12U)
+                  throw(sys::IllegalArgumentException);
+
+              /**
+               * Adds an address.
+               * @exception frog::sys::RuntimeException Thrown when the filter
+               * is mapped from a file.
+               */
+              void add(const InetAddressValue& value) throw(sys::RuntimeException);
+
+              /**
+               * Adds an address. See add(const InetAddressValue&).
+               */
+              void add(const InetAddress& address) throw(sys::RuntimeException)
+              {
+                  add(address.getValue());
+              }
+
+              using AddressFilter::mayContain;
+
+              virtual bool mayContain(const InetAddressValue& value) const throw();
+
+              virtual size_t mayContainBatch(const InetAddressValue* values, size_t count,
+                      uint8_t* result) const throw();
+          protected:
+              virtual bool checkParams() const throw();
+          private:
+              /**
+               * The number of 64-bit words of a block.
+               */
+              static const size_t BLOCK_WORDS = 4U;
+
+              /**
+               * Returns the first word of the block of a hash.
+               */
+              size_t blockOf(uint64_t hash) const throw()
+              {
+                  return static_cast<size_t>(((hash >> 32) * params_[0]) >> 32) * BLOCK_WORDS;
+              }
+
+              /**
+               * Computes the bits a hash sets in its block.
+               */
+              static void maskOf(uint64_t hash, uint64_t mask[BLOCK_WORDS]) throw();
+        }; // BloomAddressFilter cls
+    } // net ns
+} // frog ns
+#endif // FROG_NET_BLOOMADDRESSFILTER_H
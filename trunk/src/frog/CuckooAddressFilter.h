@@ -0,0 +1,179 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_CUCKOOADDRESSFILTER_H
+#define FROG_NET_CUCKOOADDRESSFILTER_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <frog/stdint.h>
+#include <frog/AddressFilter.h>
+#include <frog/IllegalArgumentException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * A cuckoo filter of addresses, which unlike BloomAddressFilter
+         * supports removal. Each address is stored as a 16-bit fingerprint
+         * in one of two buckets of four fingerprints; a bucket is a single
+         * 64-bit word, so a test reads two words and compares all four
+         * fingerprints at once. About 0.01% of the addresses that were not
+         * added test positive.
+         * <HR>
+         * <H3>Inherits from:</H3>
+         *     &nbsp;&nbsp;&nbsp;&nbsp;&nbsp;
+         *     AddressFilter
+         * <HR>
+         */
+        class CuckooAddressFilter : public AddressFilter
+        {
+          public:
+              /**
+               * Creates an empty filter.
+               * @param[in] capacity The number of addresses the filter must
+               * hold. The filter may hold more, depending on the number of
+               * buckets this is rounded up to.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * the filter would be too large.
+               */
+              explicit CuckooAddressFilter(uint64_t capacity = 0) throw(sys::IllegalArgumentException);
+
+              /**
+               * Adds an address. An address added twice is stored twice and
+               * must be removed twice.
+               * @return false when the filter is full and the address was
+               * not added.
+               * @exception frog::sys::RuntimeException Thrown when the filter
+               * is mapped from a file.
+               */
+              bool add(const InetAddressValue& value) throw(sys::RuntimeException);
+
+              /**
+               * Adds an address. See add(const InetAddressValue&).
+               */
+              bool add(const InetAddress& address) throw(sys::RuntimeException)
+              {
+                  return add(address.getValue());
+              }
+
+              /**
+               * Removes an address. Only addresses that were added may be
+               * removed, otherwise the fingerprint of another address may be
+               * removed with it.
+               * @return false when the address was not found.
+               * @exception frog::sys::RuntimeException Thrown when the filter
+               * is mapped from a file.
+               */
+              bool remove(const InetAddressValue& value) throw(sys::RuntimeException);
+
+              /**
+               * Removes an address. See remove(const InetAddressValue&).
+               */
+              bool remove(const InetAddress& address) throw(sys::RuntimeException)
+              {
+                  return remove(address.getValue());
+              }
+
+              using AddressFilter::mayContain;
+
+              virtual bool mayContain(const InetAddressValue& value) const throw();
+
+              virtual size_t mayContainBatch(const InetAddressValue* values, size_t count,
+                      uint8_t* result) const throw();
+          protected:
+              virtual bool checkParams() const throw();
+          private:
+              /**
+               * Returns the fingerprint of a hash, which is never 0, the
+               * value of an empty slot.
+               */
+              static uint64_t fingerprintOf(uint64_t hash) throw()
+              {
+                  uint64_t fingerprint = hash & 0xffffU;
+                  return fingerprint + (fingerprint == 0);
+              }
+
+              /**
+               * Returns the first bucket of a hash.
+               */
+              uint64_t bucketOf(uint64_t hash) const throw()
+              {
+                  return ((hash >> 32) * params_[0]) >> 32;
+              }
+
+              /**
+               * Returns the other bucket of a fingerprint. The buckets of
+               * a fingerprint add up to a value that only depends on the
+               * fingerprint, so either one gives the other without the
+               * number of buckets having to be a power of two.
+               */
+              uint64_t alternateOf(uint64_t bucket, uint64_t fingerprint) const throw()
+              {
+                  uint64_t bucketCount = params_[0];
+                  uint64_t sum = (((fingerprint * 0x5bd1e995U) & 0xffffffffU) * bucketCount) >> 32;
+                  return (sum >= bucket) ? sum - bucket : sum + bucketCount - bucket;
+              }
+
+              /**
+               * Returns whether a bucket holds a fingerprint.
+               */
+              static bool holds(uint64_t bucket, uint64_t fingerprint) throw()
+              {
+                  uint64_t x = bucket ^ (fingerprint * 0x0001000100010001ULL);
+                  return ((x - 0x0001000100010001ULL) & ~x & 0x8000800080008000ULL) != 0;
+              }
+
+              /**
+               * Stores a fingerprint in a free slot of a bucket.
+               * @return false when the bucket is full.
+               */
+              static bool store(uint64_t& bucket, uint64_t fingerprint) throw();
+
+              /**
+               * Removes one copy of a fingerprint from a bucket.
+               * @return false when the bucket does not hold it.
+               */
+              static bool erase(uint64_t& bucket, uint64_t fingerprint) throw();
+
+              /**
+               * Places a fingerprint, moving others to their other bucket
+               * as needed. The fingerprint left over after too many moves
+               * is kept in params_[1].
+               */
+              void place(uint64_t* words, uint64_t bucket, uint64_t fingerprint) throw();
+        }; // CuckooAddressFilter cls
+    } // net ns
+} // frog ns
+#endif // FROG_NET_CUCKOOADDRESSFILTER_H
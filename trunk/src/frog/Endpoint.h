@@ -65,18 +65,42 @@ namespace frog
                */
               virtual ~Endpoint() throw() { }
 
+#if __cplusplus >= 201103L
               /**
-               * Address family property of this endpoint. This
-               * address family is a @e read-only attribute.
+               * Copy constructor.
                */
-              const AddressFamily::TYPE& addressFamily;
+              Endpoint(const Endpoint& ep) = default;
+
+              /**
+               * Move constructor.
+               */
+              Endpoint(Endpoint&& ep) noexcept = default;
+
+              /**
+               * Copies an endpoint to another endpoint.
+               */
+              Endpoint& operator=(const Endpoint& ep) = default;
+
+              /**
+               * Move assignment.
+               */
+              Endpoint& operator=(Endpoint&& ep) noexcept = default;
+#endif
+
+              /**
+               * Address family property of this endpoint. The address
+               * family can only be set by the subclass.
+               */
+              AddressFamily::TYPE getAddressFamily() const throw()
+              {
+                  return addressFamily_;
+              }
           protected:
               /**
                * Default constructor. The address family is set
                * to AddressFamily::Unspecified.
                */
               Endpoint() :
-                addressFamily(addressFamily_),
                 addressFamily_(AddressFamily::Unspecified) { }
 
               /**
@@ -0,0 +1,311 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#ifndef FROG_NET_FLOWKEY_H
+#define FROG_NET_FLOWKEY_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <netinet/in.h>
+#include <cstring>
+
+#include <frog/stdint.h>
+#include <frog/IPEndpoint.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * Combines the hashes of the two ends of a flow into the hash of
+         * the flow. The result does not depend on the order of @arg a and
+         * @arg b, so that both directions of a flow hash alike.
+         * @param[in] a The hash of one end.
+         * @param[in] b The hash of the other end.
+         * @param[in] protocol The IP protocol number.
+         */
+        inline uint64_t hashFlowEnds(uint64_t a, uint64_t b, uint8_t protocol) throw()
+        {
+            uint64_t low = (a < b) ? a : b;
+            uint64_t high = (a < b) ? b : a;
+            high *= 0xC2B2AE3D27D4EB4FULL;
+            uint64_t h = (low * 0x9E3779B97F4A7C15ULL) ^ ((high << 32) | (high >> 32)) ^ protocol;
+
+            // The MurmurHash3 64-bit finalizer.
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDULL;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        /**
+         * The key of an IPv4 flow: source and destination addresses and
+         * ports and the IP protocol, packed in 13 bytes. Addresses and
+         * ports are in network byte order, as in the packet headers, so a
+         * key can be filled straight from a packet.
+         *
+         * Both directions of a flow have the same hash(), and
+         * isReverseOf() tells the reply direction from the original one,
+         * so FlowTable keeps one entry per connection.
+         */
+        struct FlowKey4
+        {
+            uint8_t source[4]; /**< Source address */
+            uint8_t destination[4]; /**< Destination address */
+            uint8_t sourcePort[2]; /**< Source port */
+            uint8_t destinationPort[2]; /**< Destination port */
+            uint8_t protocol; /**< IP protocol number, such as IPPROTO_TCP */
+
+            /**
+             * Builds the key of a flow between two IPv4 endpoints.
+             * @param[in] src The source endpoint.
+             * @param[in] dst The destination endpoint.
+             * @param[in] proto The IP protocol number.
+             * @param[out] out Receives the key.
+             * @return @c false, leaving @arg out untouched, unless both
+             * endpoints are IPv4.
+             */
+            static bool make(const IPEndpoint& src, const IPEndpoint& dst, uint8_t proto,
+                    FlowKey4& out) throw();
+
+            /**
+             * Returns the source endpoint.
+             */
+            IPEndpoint getSource() const throw();
+
+            /**
+             * Returns the destination endpoint.
+             */
+            IPEndpoint getDestination() const throw();
+
+            /**
+             * Returns the key of the other direction of this flow.
+             */
+            FlowKey4 reverse() const throw()
+            {
+                FlowKey4 key;
+                ::memcpy(key.source, destination, sizeof(source));
+                ::memcpy(key.destination, source, sizeof(destination));
+                ::memcpy(key.sourcePort, destinationPort, sizeof(sourcePort));
+                ::memcpy(key.destinationPort, sourcePort, sizeof(destinationPort));
+                key.protocol = protocol;
+                return key;
+            }
+
+            /**
+             * Tests if two keys are the same flow in the same direction.
+             */
+            bool operator==(const FlowKey4& other) const throw()
+            {
+                return (load64(source) == load64(other.source)) &&
+                    (load32(sourcePort) == load32(other.sourcePort)) && (protocol == other.protocol);
+            }
+
+            /**
+             * Tests if two keys differ.
+             */
+            bool operator!=(const FlowKey4& other) const throw()
+            {
+                return !(*this == other);
+            }
+
+            /**
+             * Tests if @arg other is the reply direction of this flow.
+             */
+            bool isReverseOf(const FlowKey4& other) const throw()
+            {
+                return (load32(source) == load32(other.destination)) &&
+                    (load32(destination) == load32(other.source)) &&
+                    (load16(sourcePort) == load16(other.destinationPort)) &&
+                    (load16(destinationPort) == load16(other.sourcePort)) && (protocol == other.protocol);
+            }
+
+            /**
+             * Returns a 64-bit hash of the flow, the same for both
+             * directions.
+             */
+            uint64_t hash() const throw()
+            {
+                uint64_t a = load32(source) | (static_cast<uint64_t>(load16(sourcePort)) << 32);
+                uint64_t b = load32(destination) | (static_cast<uint64_t>(load16(destinationPort)) << 32);
+                return hashFlowEnds(a, b, protocol);
+            }
+          private:
+            static uint64_t load64(const uint8_t* p) throw()
+            {
+                uint64_t word;
+                ::memcpy(&word, p, sizeof(word));
+                return word;
+            }
+
+            static uint32_t load32(const uint8_t* p) throw()
+            {
+                uint32_t word;
+                ::memcpy(&word, p, sizeof(word));
+                return word;
+            }
+
+            static uint16_t load16(const uint8_t* p) throw()
+            {
+                uint16_t word;
+                ::memcpy(&word, p, sizeof(word));
+                return word;
+            }
+        }; // FlowKey4 struct
+
+        /**
+         * The key of an IPv6 flow, packed in 37 bytes. See FlowKey4. An
+         * IPv4 endpoint is kept as an IPv4-mapped address, so that one
+         * table can track the flows of a dual-stack host. Scope ids are
+         * not kept.
+         */
+        struct FlowKey6
+        {
+            uint8_t source[16]; /**< Source address */
+            uint8_t destination[16]; /**< Destination address */
+            uint8_t sourcePort[2]; /**< Source port */
+            uint8_t destinationPort[2]; /**< Destination port */
+            uint8_t protocol; /**< IP protocol number, such as IPPROTO_TCP */
+
+            /**
+             * Builds the key of a flow between two endpoints. IPv4
+             * endpoints are mapped to IPv6.
+             * @param[in] src The source endpoint.
+             * @param[in] dst The destination endpoint.
+             * @param[in] proto The IP protocol number.
+             * @param[out] out Receives the key.
+             * @return @c false, leaving @arg out untouched, if either
+             * endpoint has the unspecified family, or always when the
+             * library is built without IPv6 support.
+             */
+            static bool make(const IPEndpoint& src, const IPEndpoint& dst, uint8_t proto,
+                    FlowKey6& out) throw();
+
+            /**
+             * Returns the source endpoint, as an IPv6 endpoint.
+             */
+            IPEndpoint getSource() const throw();
+
+            /**
+             * Returns the destination endpoint, as an IPv6 endpoint.
+             */
+            IPEndpoint getDestination() const throw();
+
+            /**
+             * Returns the key of the other direction of this flow.
+             */
+            FlowKey6 reverse() const throw()
+            {
+                FlowKey6 key;
+                ::memcpy(key.source, destination, sizeof(source));
+                ::memcpy(key.destination, source, sizeof(destination));
+                ::memcpy(key.sourcePort, destinationPort, sizeof(sourcePort));
+                ::memcpy(key.destinationPort, sourcePort, sizeof(destinationPort));
+                key.protocol = protocol;
+                return key;
+            }
+
+            /**
+             * Tests if two keys are the same flow in the same direction.
+             */
+            bool operator==(const FlowKey6& other) const throw()
+            {
+                return ((load64(source) ^ load64(other.source)) | (load64(source + 8) ^ load64(other.source + 8)) |
+                        (load64(destination) ^ load64(other.destination)) |
+                        (load64(destination + 8) ^ load64(other.destination + 8))) == 0 &&
+                    (load32(sourcePort) == load32(other.sourcePort)) && (protocol == other.protocol);
+            }
+
+            /**
+             * Tests if two keys differ.
+             */
+            bool operator!=(const FlowKey6& other) const throw()
+            {
+                return !(*this == other);
+            }
+
+            /**
+             * Tests if @arg other is the reply direction of this flow.
+             */
+            bool isReverseOf(const FlowKey6& other) const throw()
+            {
+                return ((load64(source) ^ load64(other.destination)) |
+                        (load64(source + 8) ^ load64(other.destination + 8)) |
+                        (load64(destination) ^ load64(other.source)) |
+                        (load64(destination + 8) ^ load64(other.source + 8))) == 0 &&
+                    (load16(sourcePort) == load16(other.destinationPort)) &&
+                    (load16(destinationPort) == load16(other.sourcePort)) && (protocol == other.protocol);
+            }
+
+            /**
+             * Returns a 64-bit hash of the flow, the same for both
+             * directions.
+             */
+            uint64_t hash() const throw()
+            {
+                return hashFlowEnds(hashEnd(source, sourcePort), hashEnd(destination, destinationPort), protocol);
+            }
+          private:
+            static uint64_t hashEnd(const uint8_t* address, const uint8_t* port) throw()
+            {
+                uint64_t high = load64(address) * 0x87C37B91114253D5ULL;
+                uint64_t low = load64(address + 8) * 0x4CF5AD432745937FULL;
+                return high ^ ((low << 31) | (low >> 33)) ^ (load16(port) * 0x9E3779B97F4A7C15ULL);
+            }
+
+            static uint64_t load64(const uint8_t* p) throw()
+            {
+                uint64_t word;
+                ::memcpy(&word, p, sizeof(word));
+                return word;
+            }
+
+            static uint32_t load32(const uint8_t* p) throw()
+            {
+                uint32_t word;
+                ::memcpy(&word, p, sizeof(word));
+                return word;
+            }
+
+            static uint16_t load16(const uint8_t* p) throw()
+            {
+                uint16_t word;
+                ::memcpy(&word, p, sizeof(word));
+                return word;
+            }
+        }; // FlowKey6 struct
+    }  // net ns
+}  // frog ns
+
+#endif // FROG_NET_FLOWKEY_H
@@ -0,0 +1,737 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#ifndef FROG_NET_FLOWTABLE_H
+#define FROG_NET_FLOWTABLE_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <frog/stdint.h>
+#include <frog/NonCopyable.h>
+#include <frog/FlowKey.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * A hash table of flows for connection tracking, mapping flow keys
+         * of type @c K (FlowKey4 or FlowKey6) to values of type @c V.
+         *
+         * Both directions of a flow find the same entry: the key hash is
+         * symmetric, and a lookup matches the stored key as well as its
+         * reverse. find(const K&, bool&) tells which direction was seen.
+         *
+         * The table is open addressed, Swiss table style. Besides the
+         * slots there is one control byte per slot that holds 7 bits of
+         * the hash of a used slot, or marks it empty or deleted. Slots
+         * are probed in groups of 16: the control bytes of a group are
+         * compared with the hash bits in one SSE2 instruction, and only
+         * the slots that match are compared with the key. The table holds
+         * at most 7/8 of its capacity.
+         *
+         * The table grows without a pause: the new arrays are allocated
+         * with @c calloc, which gives large blocks as untouched zero pages,
+         * and every insert() moves 8 slots of the old arrays. Until they
+         * are all moved, lookups probe both.
+         *
+         * insert() and operator[]() may move entries, so the pointers they
+         * and find() return are only valid until the next insert.
+         */
+        template <typename K, typename V>
+            class FlowTable : private NonCopyable
+            {
+              public:
+                  /**
+                   * Creates an empty table.
+                   * @param[in] capacity The number of flows the table holds
+                   * before its first resize.
+                   */
+                  explicit FlowTable(size_t capacity = 0) : migrate_(0)
+                  {
+                      reset(current_);
+                      reset(old_);
+                      if(capacity > 0)
+                      {
+                          allocate(current_, capacityFor(capacity));
+                      }
+                  }
+
+                  /**
+                   * Destroys the table and its values.
+                   */
+                  ~FlowTable() throw()
+                  {
+                      release(current_);
+                      release(old_);
+                  }
+
+                  /**
+                   * Finds the value of a flow, in either direction.
+                   * @param[in] key The key of the flow.
+                   * @param[out] reply Set to @c true when @arg key is the
+                   * reverse of the key the flow was inserted with.
+                   * @return A pointer to the value, or @c NULL when the flow
+                   * is not in the table.
+                   */
+                  V* find(const K& key, bool& reply) throw()
+                  {
+                      Slot* slot = findHashed(key, key.hash(), reply);
+                      return (slot != NULL) ? &slot->value : NULL;
+                  }
+
+                  /**
+                   * Finds the value of a flow, in either direction.
+                   */
+                  V* find(const K& key) throw()
+                  {
+                      bool reply;
+                      return find(key, reply);
+                  }
+
+                  /**
+                   * Finds the value of a flow, in either direction.
+                   */
+                  const V* find(const K& key) const throw()
+                  {
+                      bool reply;
+                      Slot* slot = findHashed(key, key.hash(), reply);
+                      return (slot != NULL) ? &slot->value : NULL;
+                  }
+
+                  /**
+                   * Looks up a batch of flows. The hashes of a few keys are
+                   * computed first and their control bytes and slots are
+                   * prefetched, so that the cache misses of consecutive
+                   * lookups overlap.
+                   * @param[in] keys The keys to look up.
+                   * @param[in] count The number of keys in @arg keys.
+                   * @param[out] result Receives @arg count pointers, as
+                   * returned by find().
+                   * @return The number of keys found.
+                   */
+                  size_t findMany(const K* keys, size_t count, V** result) throw()
+                  {
+                      uint64_t hashes[BATCH];
+                      size_t found = 0;
+                      for(size_t base = 0; base < count; base += BATCH)
+                      {
+                          size_t n = (count - base < BATCH) ? (count - base) : BATCH;
+                          for(size_t i = 0; i < n; ++i)
+                          {
+                              hashes[i] = keys[base + i].hash();
+#ifdef __GNUC__
+                              if(current_.size != 0)
+                              {
+                                  __builtin_prefetch(current_.ctrl + groupOf(current_, hashes[i]) * GROUP);
+                              }
+#endif
+                          }
+#ifdef __GNUC__
+                          for(size_t i = 0; (i < n) && (current_.size != 0); ++i)
+                          {
+                              size_t first = groupOf(current_, hashes[i]) * GROUP;
+                              uint32_t match = matchTag(current_.ctrl + first, tagOf(hashes[i]));
+                              if(match != 0)
+                              {
+                                  __builtin_prefetch(current_.slots + first + lowestBit(match));
+                              }
+                          }
+#endif
+                          for(size_t i = 0; i < n; ++i)
+                          {
+                              bool reply;
+                              Slot* slot = findHashed(keys[base + i], hashes[i], reply);
+                              result[base + i] = (slot != NULL) ? &slot->value : NULL;
+                              found += (slot != NULL);
+                          }
+                      }
+                      return found;
+                  }
+
+                  /**
+                   * Adds a flow unless it is already in the table, in
+                   * either direction.
+                   * @param[in] key The key of the flow.
+                   * @param[in] value The value of a new flow.
+                   * @return A pointer to the value of the flow, and @c true
+                   * if the flow was added or @c false if it was already
+                   * there.
+                   * @exception std::bad_alloc Thrown when the table must
+                   * grow and memory is short.
+                   */
+                  std::pair<V*, bool> insert(const K& key, const V& value)
+                  {
+                      if(old_.ctrl != NULL)
+                      {
+                          migrate(MIGRATE_STEP);
+                      }
+
+                      uint64_t hash = key.hash();
+                      bool reply;
+                      Slot* slot = findHashed(key, hash, reply);
+                      if(slot != NULL)
+                      {
+                          return std::make_pair(&slot->value, false);
+                      }
+
+                      size_t index = (current_.capacity != 0) ? findFree(current_, hash) : 0;
+                      if((current_.capacity == 0) ||
+                              ((current_.growthLeft == 0) && (current_.ctrl[index] == CTRL_EMPTY)))
+                      {
+                          grow();
+                          index = findFree(current_, hash);
+                      }
+                      put(current_, index, tagOf(hash), key, value);
+                      return std::make_pair(&current_.slots[index].value, true);
+                  }
+
+                  /**
+                   * Returns the value of a flow, adding the flow with a
+                   * default constructed value if it is not in the table.
+                   */
+                  V& operator[](const K& key)
+                  {
+                      return *insert(key, V()).first;
+                  }
+
+                  /**
+                   * Removes a flow, in either direction.
+                   * @return @c true if the flow was in the table.
+                   */
+                  bool erase(const K& key) throw()
+                  {
+                      uint64_t hash = key.hash();
+                      bool reply;
+                      Slot* slot = findIn(current_, key, hash, reply);
+                      if(slot != NULL)
+                      {
+                          remove(current_, slot - current_.slots);
+                          return true;
+                      }
+                      slot = findIn(old_, key, hash, reply);
+                      if(slot != NULL)
+                      {
+                          remove(old_, slot - old_.slots);
+                          return true;
+                      }
+                      return false;
+                  }
+
+                  /**
+                   * Removes the flows for which a predicate holds, such as
+                   * the flows that timed out.
+                   * @param[in] pred Called as <TT>pred(const K&, V&)</TT> for
+                   * every flow; the flow is removed if it returns @c true.
+                   * @return The number of flows removed.
+                   */
+                  template <typename P>
+                      size_t eraseIf(P pred)
+                      {
+                          return eraseFrom(current_, pred) + eraseFrom(old_, pred);
+                      }
+
+                  /**
+                   * Removes every flow and frees the arrays.
+                   */
+                  void clear() throw()
+                  {
+                      release(current_);
+                      release(old_);
+                      migrate_ = 0;
+                  }
+
+                  /**
+                   * Returns the number of flows in the table.
+                   */
+                  size_t getSize() const throw()
+                  {
+                      return current_.size + old_.size;
+                  }
+
+                  /**
+                   * Checks if the table holds no flow.
+                   */
+                  bool isEmpty() const throw()
+                  {
+                      return (getSize() == 0);
+                  }
+
+                  /**
+                   * Returns the number of slots. The table holds up to 7/8
+                   * of it before it grows.
+                   */
+                  size_t getCapacity() const throw()
+                  {
+                      return current_.capacity;
+                  }
+
+                  /**
+                   * Checks if entries are still being moved to larger
+                   * arrays.
+                   */
+                  bool isResizing() const throw()
+                  {
+                      return (old_.ctrl != NULL);
+                  }
+
+                  /**
+                   * Returns the number of bytes used by the control bytes
+                   * and the slots, including the arrays being moved from.
+                   */
+                  size_t getMemoryUsage() const throw()
+                  {
+                      return (current_.capacity + old_.capacity) * (1 + sizeof(Slot));
+                  }
+              private:
+                  /**
+                   * A key and its value.
+                   */
+                  struct Slot
+                  {
+                      K key;
+                      V value;
+                  };
+
+                  /**
+                   * The control bytes and the slots of a table.
+                   */
+                  struct Store
+                  {
+                      uint8_t* ctrl; /**< One control byte per slot */
+                      Slot* slots; /**< The slots; only used ones are constructed */
+                      size_t capacity; /**< The number of slots, a power of two */
+                      size_t size; /**< The number of used slots */
+                      size_t growthLeft; /**< The number of empty slots that may still be used */
+                  };
+
+                  /**
+                   * The number of slots probed at once.
+                   */
+                  static const size_t GROUP = 16U;
+
+                  /**
+                   * The number of old slots moved by every insert while the
+                   * table grows. New slots run out after at least 7/16 of
+                   * the old capacity inserts, by which time all old slots
+                   * have been moved.
+                   */
+                  static const size_t MIGRATE_STEP = 8U;
+
+                  /**
+                   * The number of keys hashed and prefetched ahead by
+                   * findMany().
+                   */
+                  static const size_t BATCH = 16U;
+
+                  /**
+                   * Control bytes. A used slot has the top bit set and 7
+                   * bits of the hash below it. An empty slot is 0, so that
+                   * @c calloc gives an empty table.
+                   */
+                  static const uint8_t CTRL_EMPTY = 0x00U;
+                  static const uint8_t CTRL_DELETED = 0x01U;
+                  static const uint8_t CTRL_USED = 0x80U;
+
+                  /**
+                   * Returns the control byte of a used slot.
+                   */
+                  static uint8_t tagOf(uint64_t hash) throw()
+                  {
+                      return static_cast<uint8_t>(CTRL_USED | (hash & 0x7fU));
+                  }
+
+                  /**
+                   * Returns the first group probed for a hash.
+                   */
+                  static size_t groupOf(const Store& store, uint64_t hash) throw()
+                  {
+                      return static_cast<size_t>(hash >> 7) & ((store.capacity / GROUP) - 1);
+                  }
+
+                  /**
+                   * Returns a bit mask of the control bytes of a group equal
+                   * to @arg tag.
+                   */
+                  static uint32_t matchTag(const uint8_t* ctrl, uint8_t tag) throw()
+                  {
+#if defined(__GNUC__) && defined(__SSE2__)
+                      __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+                      return static_cast<uint32_t>(_mm_movemask_epi8(
+                                  _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(tag)))));
+#else
+                      uint32_t mask = 0;
+                      for(size_t i = 0; i < GROUP; ++i)
+                      {
+                          mask |= static_cast<uint32_t>(ctrl[i] == tag) << i;
+                      }
+                      return mask;
+#endif
+                  }
+
+                  /**
+                   * Returns a bit mask of the empty or deleted slots of a
+                   * group.
+                   */
+                  static uint32_t matchFree(const uint8_t* ctrl) throw()
+                  {
+#if defined(__GNUC__) && defined(__SSE2__)
+                      __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+                      return static_cast<uint32_t>(~_mm_movemask_epi8(group)) & 0xffffU;
+#else
+                      uint32_t mask = 0;
+                      for(size_t i = 0; i < GROUP; ++i)
+                      {
+                          mask |= static_cast<uint32_t>(ctrl[i] < CTRL_USED) << i;
+                      }
+                      return mask;
+#endif
+                  }
+
+                  /**
+                   * Returns the index of the lowest bit set in a non-zero
+                   * mask.
+                   */
+                  static size_t lowestBit(uint32_t mask) throw()
+                  {
+#ifdef __GNUC__
+                      return static_cast<size_t>(__builtin_ctz(mask));
+#else
+                      size_t bit = 0;
+                      while(!(mask & 1U))
+                      {
+                          mask >>= 1;
+                          ++bit;
+                      }
+                      return bit;
+#endif
+                  }
+
+                  /**
+                   * Returns the smallest capacity that holds @arg count
+                   * flows.
+                   */
+                  static size_t capacityFor(size_t count) throw()
+                  {
+                      size_t capacity = GROUP;
+                      while(capacity - (capacity / 8) < count)
+                      {
+                          capacity *= 2;
+                      }
+                      return capacity;
+                  }
+
+                  /**
+                   * Sets a store to no arrays.
+                   */
+                  static void reset(Store& store) throw()
+                  {
+                      store.ctrl = NULL;
+                      store.slots = NULL;
+                      store.capacity = 0;
+                      store.size = 0;
+                      store.growthLeft = 0;
+                  }
+
+                  /**
+                   * Allocates the arrays of an empty store.
+                   */
+                  static void allocate(Store& store, size_t capacity)
+                  {
+                      uint8_t* ctrl = static_cast<uint8_t*>(::calloc(capacity, 1));
+                      Slot* slots = static_cast<Slot*>(::malloc(capacity * sizeof(Slot)));
+                      if((ctrl == NULL) || (slots == NULL))
+                      {
+                          ::free(ctrl);
+                          ::free(slots);
+                          throw std::bad_alloc();
+                      }
+                      store.ctrl = ctrl;
+                      store.slots = slots;
+                      store.capacity = capacity;
+                      store.size = 0;
+                      store.growthLeft = capacity - (capacity / 8);
+                  }
+
+                  /**
+                   * Destroys the values of a store and frees its arrays.
+                   */
+                  static void release(Store& store) throw()
+                  {
+                      for(size_t i = 0; (store.size != 0) && (i < store.capacity); ++i)
+                      {
+                          if(store.ctrl[i] & CTRL_USED)
+                          {
+                              destroy(store, i);
+                          }
+                      }
+                      ::free(store.ctrl);
+                      ::free(store.slots);
+                      reset(store);
+                  }
+
+                  /**
+                   * Destroys the key and the value of a used slot.
+                   */
+                  static void destroy(Store& store, size_t index) throw()
+                  {
+                      store.slots[index].value.~V();
+                      store.slots[index].key.~K();
+                      --store.size;
+                  }
+
+                  /**
+                   * Finds a flow in a store.
+                   */
+                  static Slot* findIn(const Store& store, const K& key, uint64_t hash, bool& reply) throw()
+                  {
+                      if(store.size == 0)
+                      {
+                          return NULL;
+                      }
+
+                      uint8_t tag = tagOf(hash);
+                      size_t mask = (store.capacity / GROUP) - 1;
+                      size_t group = groupOf(store, hash);
+                      for(size_t step = 1; ; ++step)
+                      {
+                          const uint8_t* ctrl = store.ctrl + group * GROUP;
+                          for(uint32_t match = matchTag(ctrl, tag); match != 0; match &= match - 1)
+                          {
+                              Slot* slot = store.slots + group * GROUP + lowestBit(match);
+                              if(slot->key == key)
+                              {
+                                  reply = false;
+                                  return slot;
+                              }
+                              if(slot->key.isReverseOf(key))
+                              {
+                                  reply = true;
+                                  return slot;
+                              }
+                          }
+                          if(matchTag(ctrl, CTRL_EMPTY) != 0)
+                          {
+                              return NULL;
+                          }
+                          // Triangular steps visit every group.
+                          group = (group + step) & mask;
+                      }
+                  }
+
+                  /**
+                   * Finds a flow in the table.
+                   */
+                  Slot* findHashed(const K& key, uint64_t hash, bool& reply) const throw()
+                  {
+                      Slot* slot = findIn(current_, key, hash, reply);
+                      if((slot == NULL) && (old_.ctrl != NULL))
+                      {
+                          slot = findIn(old_, key, hash, reply);
+                      }
+                      return slot;
+                  }
+
+                  /**
+                   * Returns the first empty or deleted slot on the probe
+                   * sequence of a hash.
+                   */
+                  static size_t findFree(const Store& store, uint64_t hash) throw()
+                  {
+                      size_t mask = (store.capacity / GROUP) - 1;
+                      size_t group = groupOf(store, hash);
+                      for(size_t step = 1; ; ++step)
+                      {
+                          uint32_t match = matchFree(store.ctrl + group * GROUP);
+                          if(match != 0)
+                          {
+                              return group * GROUP + lowestBit(match);
+                          }
+                          group = (group + step) & mask;
+                      }
+                  }
+
+                  /**
+                   * Stores a flow in a free slot.
+                   */
+                  static void put(Store& store, size_t index, uint8_t tag, const K& key, const V& value)
+                  {
+                      new (&store.slots[index].value) V(value);
+                      new (&store.slots[index].key) K(key);
+                      if((store.ctrl[index] == CTRL_EMPTY) && (store.growthLeft != 0))
+                      {
+                          --store.growthLeft;
+                      }
+                      store.ctrl[index] = tag;
+                      ++store.size;
+                  }
+
+                  /**
+                   * Removes the flow of a used slot. When its group has an
+                   * empty slot, no probe goes past the group, so the slot
+                   * can be made empty rather than deleted.
+                   */
+                  static void remove(Store& store, size_t index) throw()
+                  {
+                      destroy(store, index);
+                      if(matchTag(store.ctrl + (index & ~(GROUP - 1)), CTRL_EMPTY) != 0)
+                      {
+                          store.ctrl[index] = CTRL_EMPTY;
+                          ++store.growthLeft;
+                      }
+                      else
+                      {
+                          store.ctrl[index] = CTRL_DELETED;
+                      }
+                  }
+
+                  /**
+                   * Removes the flows of a store for which a predicate
+                   * holds.
+                   */
+                  template <typename P>
+                      static size_t eraseFrom(Store& store, P& pred)
+                      {
+                          size_t removed = 0;
+                          for(size_t i = 0; (store.size != 0) && (i < store.capacity); ++i)
+                          {
+                              if((store.ctrl[i] & CTRL_USED) && pred(store.slots[i].key, store.slots[i].value))
+                              {
+                                  remove(store, i);
+                                  ++removed;
+                              }
+                          }
+                          return removed;
+                      }
+
+                  /**
+                   * Starts moving the flows to new arrays, with room for
+                   * twice as many flows, or as many when the table is
+                   * mostly deleted slots.
+                   */
+                  void grow()
+                  {
+                      if(old_.ctrl != NULL)
+                      {
+                          migrate(old_.capacity);
+                      }
+
+                      size_t capacity = capacityFor(2 * current_.size);
+                      if(capacity < current_.capacity)
+                      {
+                          capacity = current_.capacity;
+                      }
+
+                      Store next;
+                      allocate(next, capacity);
+                      if(current_.size == 0)
+                      {
+                          release(current_);
+                          current_ = next;
+                          return;
+                      }
+                      old_ = current_;
+                      current_ = next;
+                      migrate_ = 0;
+                  }
+
+                  /**
+                   * Moves up to @arg count slots of the old arrays to the
+                   * new ones, and frees the old arrays when they are empty.
+                   * A moved slot is marked deleted, which keeps the probe
+                   * sequences of the slots not moved yet.
+                   */
+                  void migrate(size_t count)
+                  {
+                      size_t end = (old_.capacity - migrate_ < count) ? old_.capacity : (migrate_ + count);
+                      for(; (migrate_ < end) && (old_.size != 0); ++migrate_)
+                      {
+                          if(old_.ctrl[migrate_] & CTRL_USED)
+                          {
+                              Slot& slot = old_.slots[migrate_];
+                              uint64_t hash = slot.key.hash();
+                              put(current_, findFree(current_, hash), tagOf(hash), slot.key, slot.value);
+                              destroy(old_, migrate_);
+                              old_.ctrl[migrate_] = CTRL_DELETED;
+                          }
+                      }
+                      if((migrate_ == old_.capacity) || (old_.size == 0))
+                      {
+                          release(old_);
+                          migrate_ = 0;
+                      }
+                  }
+
+                  /**
+                   * The arrays inserts go to.
+                   */
+                  Store current_;
+
+                  /**
+                   * The arrays being moved to @c current_, if any.
+                   */
+                  Store old_;
+
+                  /**
+                   * The next slot of @c old_ to move.
+                   */
+                  size_t migrate_;
+            }; // FlowTable tmpl
+
+        template <typename K, typename V>
+            const size_t FlowTable<K, V>::GROUP;
+
+        template <typename K, typename V>
+            const size_t FlowTable<K, V>::MIGRATE_STEP;
+
+        template <typename K, typename V>
+            const size_t FlowTable<K, V>::BATCH;
+
+        template <typename K, typename V>
+            const uint8_t FlowTable<K, V>::CTRL_EMPTY;
+
+        template <typename K, typename V>
+            const uint8_t FlowTable<K, V>::CTRL_DELETED;
+
+        template <typename K, typename V>
+            const uint8_t FlowTable<K, V>::CTRL_USED;
+    } // net ns
+} // frog ns
+#endif // FROG_NET_FLOWTABLE_H
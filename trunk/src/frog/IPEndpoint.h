@@ -28,6 +28,7 @@
 #endif
 
 #include <netinet/in.h>
+#include <sys/socket.h>
 #include <string>
 
 #include <frog/Endpoint.h>
@@ -58,15 +59,38 @@ namespace frog
         class IPEndpoint : public Endpoint
         {
           public:
+              /**
+               * Constructs an empty IP endpoint: an unspecified address and
+               * port 0. Fill it in with IPEndpoint::fromSockAddr().
+               */
+              IPEndpoint() throw();
+
               /**
                * Constructs an IP endpoint from an IP address and port.
                */
               IPEndpoint(InetAddress& ipAddress, in_port_t portNo) throw();
 
+#if __cplusplus >= 201103L
+              /**
+               * Copy constructor.
+               */
+              IPEndpoint(const IPEndpoint& ep) = default;
+
+              /**
+               * Move constructor.
+               */
+              IPEndpoint(IPEndpoint&& ep) noexcept = default;
+
               /**
                * Copies an IP endpoint to another IP endpoint.
                */
-              IPEndpoint& operator=(const IPEndpoint& ep) throw();
+              IPEndpoint& operator=(const IPEndpoint& ep) = default;
+
+              /**
+               * Move assignment.
+               */
+              IPEndpoint& operator=(IPEndpoint&& ep) noexcept = default;
+#endif
 
               /**
                * Default destructor.
@@ -83,6 +107,73 @@ namespace frog
                */
               bool operator!=(const IPEndpoint& ep) const throw();
 
+              /**
+               * Orders IP endpoints by address (see InetAddress::operator<())
+               * and then by port.
+               */
+              bool operator<(const IPEndpoint& ep) const throw()
+              {
+                  int result = address.getValue().compare(ep.address.getValue());
+                  return (result < 0) || ((result == 0) && (port < ep.port));
+              }
+
+              /**
+               * Size of the key written by sortKey().
+               */
+              static const size_t SORT_KEY_SIZE = InetAddressValue::SORT_KEY_SIZE + 2U;
+
+              /**
+               * Writes a key of IPEndpoint::SORT_KEY_SIZE bytes whose @c memcmp
+               * order is the order of IPEndpoint::operator<(): the sort key of
+               * the address followed by the port in network byte order.
+               * @param[out] key Receives the key.
+               */
+              void sortKey(uint8_t* key) const throw()
+              {
+                  address.sortKey(key);
+                  key[InetAddressValue::SORT_KEY_SIZE] = static_cast<uint8_t>(port >> 8);
+                  key[InetAddressValue::SORT_KEY_SIZE + 1] = static_cast<uint8_t>(port);
+              }
+
+              /**
+               * Parses the textual representation of an IP endpoint without
+               * throwing and without allocating memory, in one pass over the
+               * text. The accepted forms are <I>ipv4-address:port</I>,
+               * <I>[ipv6-address\%scope-id]:port</I>, and a bare
+               * <I>ipv4-address</I>, <I>ipv6-address\%scope-id</I> or
+               * <I>[ipv6-address\%scope-id]</I> which take @arg defaultPort.
+               * Addresses are parsed as by InetAddress::tryParse(); host
+               * names are not resolved.
+               * @param[in] p The text to parse. It need not be NUL terminated.
+               * @param[in] n The number of characters in @arg p.
+               * @param[out] out Receives the parsed endpoint. It is left
+               * untouched when the text is not a valid endpoint.
+               * @param[in] defaultPort The port of a text without one.
+               * @return Returns @c true if the text is a valid endpoint;
+               * @c false otherwise.
+               */
+              static bool tryParse(const char* p, size_t n, IPEndpoint& out, in_port_t defaultPort = 0) throw();
+
+              /**
+               * Parses a comma separated list of endpoints, such as an
+               * <I>X-Forwarded-For</I> header or a list of peers in a
+               * configuration file. Every item is parsed as by
+               * tryParse(const char*, size_t, IPEndpoint&, in_port_t) after
+               * dropping the blanks around it. Nothing is allocated.
+               * @param[in] p The list to parse. It need not be NUL terminated.
+               * @param[in] n The number of characters in @arg p.
+               * @param[out] out Receives one endpoint per item, in the order
+               * of the list. An item that is not a valid endpoint gives an
+               * endpoint with the unspecified family and port 0.
+               * @param[in] capacity The number of endpoints @arg out can
+               * hold. Items past it are not parsed.
+               * @param[in] defaultPort The port of an item without one.
+               * @return The number of endpoints written to @arg out, which is
+               * 0 for an empty list.
+               */
+              static size_t tryParseList(const char* p, size_t n, IPEndpoint* out, size_t capacity,
+                      in_port_t defaultPort = 0) throw();
+
               /**
                * Converts this IPEndpoint to its textual representation.
                * IPv4 Endpoints are represented as <I>ipv4-address:port</I> while
@@ -94,6 +185,41 @@ namespace frog
                */
               virtual std::string toString() const throw();
 
+              /**
+               * Writes the textual representation of this IPEndpoint into a
+               * caller supplied buffer. The text is the same as the one
+               * returned by IPEndpoint::toString() and is NUL terminated.
+               * No memory is allocated.
+               * @param[out] buf The buffer that receives the text.
+               * @param[in] cap The size of @arg buf in bytes. A buffer of
+               * IPEndpoint::MAX_TEXT_SIZE bytes is always large enough.
+               * @return The number of characters written, not counting the
+               * terminating NUL, or 0 if @arg buf is too small or the
+               * address family is unspecified.
+               */
+              size_t format(char* buf, size_t cap) const throw();
+
+              /**
+               * Returns a 32-bit hash code computed from the address and
+               * the port. Equal IPEndpoint%s have equal hash codes.
+               */
+              virtual int32_t hashCode() const throw();
+
+              /**
+               * Returns a 64-bit hash of the address and the port. This is
+               * the value used by IPEndpointHash.
+               */
+              uint64_t hash() const throw()
+              {
+                  return address.getValue().hash(port);
+              }
+
+              /**
+               * Size of a buffer that can hold the textual representation
+               * of any IPEndpoint, including the terminating NUL.
+               */
+              static const size_t MAX_TEXT_SIZE = InetAddress::MAX_TEXT_SIZE + 8U;
+
               /**
                * IP address of this endpoint. The address is a
                * @e read-write attribute.
@@ -105,13 +231,61 @@ namespace frog
                * @e read-write attribute.
                */
               in_port_t port;
-          private:
+
               /**
-               * Default constructor.
+               * Writes this endpoint as a <I>sockaddr_in</I> or
+               * <I>sockaddr_in6</I>, ready to be passed to <I>sendto</I>,
+               * <I>connect</I> or <I>bind</I>. The address bytes are copied
+               * straight from the stored value; no InetAddress or
+               * <I>in_addr</I> is built on the way.
+               * @param[out] storage Receives the socket address.
+               * @param[out] length Receives the length of the socket address.
+               * @return @e true on success, @e false if the address family
+               * is unspecified, in which case @arg storage and @arg length
+               * are left untouched.
                */
-              IPEndpoint() throw();
+              bool toSockAddr(struct sockaddr_storage& storage, socklen_t& length) const throw();
+
+              /**
+               * Sets this endpoint from a socket address, as returned by
+               * <I>recvfrom</I>, <I>accept</I> or <I>getsockname</I>. The
+               * address and the port are overwritten in place; nothing is
+               * allocated.
+               * @param[in] addr The socket address.
+               * @param[in] length The length of @arg addr in bytes.
+               * @return @e true on success, @e false if @arg addr is NULL, is
+               * shorter than its family requires or is neither AF_INET nor
+               * AF_INET6. The endpoint is left untouched on failure.
+               */
+              bool fromSockAddr(const struct sockaddr* addr, socklen_t length) throw();
         }; // IPEndpoint cls
+
+        /**
+         * Hash function object for IPEndpoint, for use with hash based
+         * containers. It hashes the address bytes, family, scope id and port.
+         */
+        struct IPEndpointHash
+        {
+            size_t operator()(const IPEndpoint& ep) const throw()
+            {
+                return static_cast<size_t>(ep.hash());
+            }
+        };
     }  // net ns
 }  // frog ns
 
+#if __cplusplus >= 201103L
+namespace std
+{
+    /**
+     * Lets IPEndpoint be used as the key of std::unordered_map and
+     * std::unordered_set.
+     */
+    template<>
+        struct hash<frog::net::IPEndpoint> : public frog::net::IPEndpointHash
+        {
+        };
+} // std ns
+#endif
+
 #endif // FROG_NET_IPENDPOINT_H
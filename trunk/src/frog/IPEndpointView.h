@@ -0,0 +1,304 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#ifndef FROG_NET_IPENDPOINTVIEW_H
+#define FROG_NET_IPENDPOINTVIEW_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <cstring>
+
+#include <frog/InetAddress.h>
+#include <frog/IPEndpoint.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * A read-only view of an IP socket address held in a caller
+         * owned buffer, typically the <I>sockaddr_storage</I> filled by
+         * <I>recvfrom</I>. The address and the port are read straight out
+         * of the buffer; nothing is copied until asked for with getValue(),
+         * getAddress() or copyTo().
+         *
+         * The view holds a pointer to the buffer, which must outlive it.
+         */
+        class IPEndpointView
+        {
+          public:
+              /**
+               * Views a socket address.
+               * @param[in] storage The buffer holding the socket address.
+               * @param[in] length The length of the socket address, as
+               * returned by <I>recvfrom</I>.
+               */
+              explicit IPEndpointView(const struct sockaddr_storage& storage,
+                      socklen_t length = sizeof(struct sockaddr_storage)) throw() :
+                addr_(reinterpret_cast<const struct sockaddr*>(&storage)),
+                family_(familyOf(addr_, length))
+              {
+              }
+
+              /**
+               * Views a socket address.
+               * @param[in] addr The socket address. May be NULL, which gives
+               * an invalid view.
+               * @param[in] length The length of @arg addr in bytes.
+               */
+              IPEndpointView(const struct sockaddr* addr, socklen_t length) throw() :
+                addr_(addr), family_(familyOf(addr, length))
+              {
+              }
+
+              /**
+               * Checks if the buffer holds a complete AF_INET or AF_INET6
+               * socket address. The other methods give an unspecified
+               * address and port 0 when it does not.
+               */
+              bool isValid() const throw()
+              {
+                  return (family_ != AddressFamily::Unspecified);
+              }
+
+              /**
+               * Returns AddressFamily::InterNetwork,
+               * AddressFamily::InterNetworkV6 or AddressFamily::Unspecified
+               * for an invalid view.
+               */
+              AddressFamily::TYPE getAddressFamily() const throw()
+              {
+                  return family_;
+              }
+
+              /**
+               * Returns the port in host byte order.
+               */
+              in_port_t getPort() const throw()
+              {
+                  if(family_ == AddressFamily::InterNetwork)
+                  {
+                      return ntohs(in4()->sin_port);
+                  }
+#ifdef HAVE_IPV6_SUPPORT
+                  else if(family_ == AddressFamily::InterNetworkV6)
+                  {
+                      return ntohs(in6()->sin6_port);
+                  }
+#endif
+                  return 0;
+              }
+
+              /**
+               * Returns the scope id of an IPv6 address; zero otherwise.
+               */
+              uint32_t getScopeId() const throw()
+              {
+#ifdef HAVE_IPV6_SUPPORT
+                  if(family_ == AddressFamily::InterNetworkV6)
+                  {
+                      return in6()->sin6_scope_id;
+                  }
+#endif
+                  return 0;
+              }
+
+              /**
+               * Returns the raw address in network byte order, pointing into
+               * the viewed buffer: 4 bytes for IPv4, 16 bytes for IPv6, or
+               * NULL for an invalid view.
+               */
+              const uint8_t* getAddressBytes() const throw()
+              {
+                  if(family_ == AddressFamily::InterNetwork)
+                  {
+                      return reinterpret_cast<const uint8_t*>(&in4()->sin_addr);
+                  }
+#ifdef HAVE_IPV6_SUPPORT
+                  else if(family_ == AddressFamily::InterNetworkV6)
+                  {
+                      return reinterpret_cast<const uint8_t*>(&in6()->sin6_addr);
+                  }
+#endif
+                  return NULL;
+              }
+
+              /**
+               * Returns the number of bytes at getAddressBytes().
+               */
+              size_t getAddressSize() const throw()
+              {
+                  if(family_ == AddressFamily::InterNetwork)
+                  {
+                      return sizeof(struct in_addr);
+                  }
+#ifdef HAVE_IPV6_SUPPORT
+                  else if(family_ == AddressFamily::InterNetworkV6)
+                  {
+                      return sizeof(struct in6_addr);
+                  }
+#endif
+                  return 0;
+              }
+
+              /**
+               * Returns the address as an InetAddressValue. Nothing is
+               * allocated.
+               */
+              InetAddressValue getValue() const throw()
+              {
+                  InetAddressValue value;
+                  ::memset(&value, 0, sizeof(InetAddressValue));
+                  if(isValid())
+                  {
+                      size_t size = getAddressSize();
+                      ::memcpy(value.address + sizeof(value.address) - size, getAddressBytes(), size);
+                  }
+                  value.scope = getScopeId();
+                  value.family = family_;
+                  return value;
+              }
+
+              /**
+               * Returns the address as an InetAddress.
+               */
+              InetAddress getAddress() const throw()
+              {
+                  return InetAddress(getValue());
+              }
+
+              /**
+               * Copies the viewed address and port into an IPEndpoint, as
+               * IPEndpoint::fromSockAddr() does.
+               * @param[out] ep The endpoint to overwrite.
+               * @return @e false if the view is invalid, in which case
+               * @arg ep is left untouched.
+               */
+              bool copyTo(IPEndpoint& ep) const throw()
+              {
+                  return isValid() && ep.fromSockAddr(addr_,
+                          (family_ == AddressFamily::InterNetwork) ? sizeof(struct sockaddr_in)
+                          : sizeof(struct sockaddr_in6));
+              }
+
+              /**
+               * Tests if the viewed socket address equals an IPEndpoint,
+               * without building one. An invalid view equals no endpoint.
+               */
+              bool operator==(const IPEndpoint& ep) const throw()
+              {
+                  const InetAddressValue& value = ep.address.getValue();
+                  if(!isValid() || (value.family != family_) || (ep.port != getPort())
+                          || (value.scope != getScopeId()))
+                  {
+                      return false;
+                  }
+
+                  size_t size = getAddressSize();
+                  return (::memcmp(value.address + sizeof(value.address) - size,
+                              getAddressBytes(), size) == 0);
+              }
+
+              /**
+               * Tests if the viewed socket address differs from an IPEndpoint.
+               */
+              bool operator!=(const IPEndpoint& ep) const throw()
+              {
+                  return !(*this == ep);
+              }
+
+              /**
+               * Returns the same 64-bit hash as IPEndpoint::hash() for the
+               * endpoint this view would copy to, so a view can probe a
+               * hash table keyed by IPEndpoint.
+               */
+              uint64_t hash() const throw()
+              {
+                  return getValue().hash(getPort());
+              }
+          private:
+              /**
+               * Gives the family of a socket address, or
+               * AddressFamily::Unspecified when it is NULL, too short or
+               * of another family.
+               */
+              static AddressFamily::TYPE familyOf(const struct sockaddr* addr, socklen_t length) throw()
+              {
+                  if((addr == NULL) || (length < static_cast<socklen_t>(sizeof(sa_family_t))))
+                  {
+                      return AddressFamily::Unspecified;
+                  }
+                  if((addr->sa_family == AF_INET)
+                          && (length >= static_cast<socklen_t>(sizeof(struct sockaddr_in))))
+                  {
+                      return AddressFamily::InterNetwork;
+                  }
+#ifdef HAVE_IPV6_SUPPORT
+                  if((addr->sa_family == AF_INET6)
+                          && (length >= static_cast<socklen_t>(sizeof(struct sockaddr_in6))))
+                  {
+                      return AddressFamily::InterNetworkV6;
+                  }
+#endif
+                  return AddressFamily::Unspecified;
+              }
+
+              const struct sockaddr_in* in4() const throw()
+              {
+                  return reinterpret_cast<const struct sockaddr_in*>(addr_);
+              }
+
+#ifdef HAVE_IPV6_SUPPORT
+              const struct sockaddr_in6* in6() const throw()
+              {
+                  return reinterpret_cast<const struct sockaddr_in6*>(addr_);
+              }
+#endif
+
+              /**
+               * The viewed socket address.
+               */
+              const struct sockaddr* addr_;
+
+              /**
+               * The family of the socket address, or
+               * AddressFamily::Unspecified if the view is invalid.
+               */
+              AddressFamily::TYPE family_;
+        }; // IPEndpointView cls
+    }  // net ns
+}  // frog ns
+
+#endif // FROG_NET_IPENDPOINTVIEW_H
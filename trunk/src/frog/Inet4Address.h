@@ -0,0 +1,359 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_INET4ADDRESS_H
+#define FROG_NET_INET4ADDRESS_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <cstring>
+#include <string>
+
+#include <frog/stdint.h>
+#include <frog/constexpr.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/InetAddressAlgorithms.h>
+#include <frog/IllegalArgumentException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * An IPv4 address, kept as a 32-bit number in host byte order.
+         * It is 4 bytes long and every member is a handful of integer
+         * operations, without any test of the family; code that only
+         * deals with IPv4, such as an IPv4 flow table, should use it
+         * instead of InetAddress. Convert from and to InetAddress or
+         * InetAddressValue when the family is only known at run time.
+         * The algorithms of InetAddressAlgorithms.h work on it.
+         */
+        class Inet4Address
+        {
+          public:
+              /**
+               * The numeric form of an address.
+               */
+              typedef uint32_t Word;
+
+              /**
+               * The number of bits of an address.
+               */
+              static const uint32_t BITS = 32U;
+
+              /**
+               * Size of a buffer that can hold the textual representation
+               * of any Inet4Address, including the terminating NUL.
+               */
+              static const size_t MAX_TEXT_SIZE = 16U;
+
+              /**
+               * Creates the address 0.0.0.0.
+               */
+              FROG_CONSTEXPR Inet4Address() throw() : word_(0)
+              {
+              }
+
+              /**
+               * Creates an address from its numeric form.
+               * @param[in] word The address in host byte order:
+               * 0x7f000001 is 127.0.0.1.
+               */
+              explicit FROG_CONSTEXPR Inet4Address(Word word) throw() : word_(word)
+              {
+              }
+
+              /**
+               * Creates an address from an @c in_addr.
+               */
+              explicit Inet4Address(const struct in_addr& addr) throw() : word_(ntohl(addr.s_addr))
+              {
+              }
+
+              /**
+               * Creates an address from its compact form.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * @arg value is not an IPv4 address.
+               */
+              explicit Inet4Address(const InetAddressValue& value) throw(sys::IllegalArgumentException);
+
+              /**
+               * Creates an address from an InetAddress.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * @arg address is not an IPv4 address.
+               */
+              explicit Inet4Address(const InetAddress& address) throw(sys::IllegalArgumentException);
+
+              /**
+               * Creates an address from its dotted-quad representation.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * the text is not an IPv4 address.
+               */
+              explicit Inet4Address(const std::string& text) throw(sys::IllegalArgumentException);
+
+              /**
+               * Parses a dotted quad without throwing and without
+               * allocating memory. See InetAddress::tryParse().
+               * @return @c true if the text is an IPv4 address. @arg out
+               * is left untouched otherwise.
+               */
+              static bool tryParse(const char* p, size_t n, Inet4Address& out) throw();
+
+              /**
+               * Converts the compact form of an address.
+               * @return @c true if @arg value is an IPv4 address. @arg out
+               * is left untouched otherwise.
+               */
+              static bool fromValue(const InetAddressValue& value, Inet4Address& out) throw()
+              {
+                  if(value.family != AF_INET)
+                  {
+                      return false;
+                  }
+                  out.word_ = static_cast<uint32_t>(value.low());
+                  return true;
+              }
+
+              /**
+               * Returns the address in host byte order.
+               */
+              FROG_CONSTEXPR Word getWord() const throw()
+              {
+                  return word_;
+              }
+
+              /**
+               * Returns the address @arg word. Used by the algorithms of
+               * InetAddressAlgorithms.h.
+               */
+              Inet4Address withWord(Word word) const throw()
+              {
+                  return Inet4Address(word);
+              }
+
+              /**
+               * Returns the netmask of a prefix length, in host byte order.
+               * @param[in] prefixLength The prefix length, at most 32.
+               */
+              static FROG_CONSTEXPR Word prefixMask(uint32_t prefixLength) throw()
+              {
+                  return static_cast<Word>(~0ULL << (BITS - prefixLength));
+              }
+
+              /**
+               * Returns the address as an @c in_addr.
+               */
+              struct in_addr toInAddr() const throw()
+              {
+                  struct in_addr addr;
+                  addr.s_addr = htonl(word_);
+                  return addr;
+              }
+
+              /**
+               * Returns the compact form of the address.
+               */
+              InetAddressValue toValue() const throw()
+              {
+                  InetAddressValue value;
+                  ::memset(&value, 0, sizeof(value));
+                  value.address[InetAddressValue::IPV4_OFFSET] = static_cast<uint8_t>(word_ >> 24);
+                  value.address[InetAddressValue::IPV4_OFFSET + 1] = static_cast<uint8_t>(word_ >> 16);
+                  value.address[InetAddressValue::IPV4_OFFSET + 2] = static_cast<uint8_t>(word_ >> 8);
+                  value.address[InetAddressValue::IPV4_OFFSET + 3] = static_cast<uint8_t>(word_);
+                  value.family = AF_INET;
+                  return value;
+              }
+
+              /**
+               * Returns the address as an InetAddress.
+               */
+              InetAddress toInetAddress() const throw()
+              {
+                  return InetAddress(toValue());
+              }
+
+              /**
+               * Returns the properties of the address as a combination of
+               * the InetAddressValue::CLASS_* flags.
+               * See InetAddressValue::classify().
+               */
+              uint32_t classify() const throw()
+              {
+                  return InetAddressValue::classify4(word_);
+              }
+
+              /**
+               * @name Predicates
+               * These give the same answers as the InetAddress predicates
+               * of the same names. Each compiles to a few instructions, as
+               * the flags that are not asked for are dropped from
+               * classify().
+               */
+              //@{
+              bool isAnyLocalAddress() const throw()
+              {
+                  return (classify() & InetAddressValue::CLASS_ANY_LOCAL) != 0;
+              }
+
+              bool isLoopbackAddress() const throw()
+              {
+                  return (classify() & InetAddressValue::CLASS_LOOPBACK) != 0;
+              }
+
+              bool isLinkLocalAddress() const throw()
+              {
+                  return (classify() & InetAddressValue::CLASS_LINK_LOCAL) != 0;
+              }
+
+              bool isSiteLocalAddress() const throw()
+              {
+                  return (classify() & InetAddressValue::CLASS_SITE_LOCAL) != 0;
+              }
+
+              bool isMulticastAddress() const throw()
+              {
+                  return (classify() & InetAddressValue::CLASS_MULTICAST) != 0;
+              }
+
+              bool isMulticastGlobal() const throw()
+              {
+                  return (classify() & InetAddressValue::CLASS_MULTICAST_GLOBAL) != 0;
+              }
+
+              bool isMulticastNodeLocal() const throw()
+              {
+                  return false;
+              }
+
+              bool isMulticastLinkLocal() const throw()
+              {
+                  return (classify() & InetAddressValue::CLASS_MULTICAST_LINK_LOCAL) != 0;
+              }
+
+              bool isMulticastSiteLocal() const throw()
+              {
+                  return (classify() & InetAddressValue::CLASS_MULTICAST_SITE_LOCAL) != 0;
+              }
+
+              bool isMulticastOrgLocal() const throw()
+              {
+                  return (classify() & InetAddressValue::CLASS_MULTICAST_ORG_LOCAL) != 0;
+              }
+              //@}
+
+              /**
+               * Compares two addresses numerically.
+               * @return A negative number, zero or a positive number if this
+               * address is less than, equal to or greater than @arg other.
+               */
+              FROG_CONSTEXPR int compare(const Inet4Address& other) const throw()
+              {
+                  return (word_ > other.word_) - (word_ < other.word_);
+              }
+
+              FROG_CONSTEXPR bool operator==(const Inet4Address& other) const throw()
+              {
+                  return (word_ == other.word_);
+              }
+
+              FROG_CONSTEXPR bool operator!=(const Inet4Address& other) const throw()
+              {
+                  return (word_ != other.word_);
+              }
+
+              FROG_CONSTEXPR bool operator<(const Inet4Address& other) const throw()
+              {
+                  return (word_ < other.word_);
+              }
+
+              FROG_CONSTEXPR bool operator>(const Inet4Address& other) const throw()
+              {
+                  return (word_ > other.word_);
+              }
+
+              FROG_CONSTEXPR bool operator<=(const Inet4Address& other) const throw()
+              {
+                  return (word_ <= other.word_);
+              }
+
+              FROG_CONSTEXPR bool operator>=(const Inet4Address& other) const throw()
+              {
+                  return (word_ >= other.word_);
+              }
+
+              /**
+               * Returns a 64-bit hash of the address. It is the hash of
+               * toValue(), so an Inet4Address and the InetAddress of the
+               * same address hash alike.
+               * @param[in] seed Extra data to mix in, for example a port.
+               */
+              uint64_t hash(uint64_t seed = 0) const throw()
+              {
+                  return toValue().hash(seed);
+              }
+
+              /**
+               * Writes the dotted-quad representation into a caller supplied
+               * buffer. See InetAddress::format().
+               */
+              size_t format(char* buf, size_t cap) const throw();
+
+              /**
+               * Returns the dotted-quad representation.
+               */
+              std::string toString() const throw();
+          private:
+              /**
+               * The address in host byte order.
+               */
+              Word word_;
+        }; // Inet4Address cls
+
+        /**
+         * Hash function object for Inet4Address, for use with hash based
+         * containers.
+         */
+        struct Inet4AddressHash
+        {
+            size_t operator()(const Inet4Address& address) const throw()
+            {
+                return static_cast<size_t>(address.hash());
+            }
+        };
+    } // net ns
+} // frog ns
+#endif // FROG_NET_INET4ADDRESS_H
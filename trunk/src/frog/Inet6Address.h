@@ -0,0 +1,447 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_INET6ADDRESS_H
+#define FROG_NET_INET6ADDRESS_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <netinet/in.h>
+#include <cstring>
+#include <string>
+
+#include <frog/stdint.h>
+#include <frog/constexpr.h>
+#include <frog/Word128.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/InetAddressAlgorithms.h>
+#include <frog/IllegalArgumentException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * An IPv6 address and its scope id, kept as two 64-bit numbers in
+         * host byte order. Like Inet4Address, every member works on the
+         * numbers directly, without any test of the family; convert from
+         * and to InetAddress or InetAddressValue when the family is only
+         * known at run time. The algorithms of InetAddressAlgorithms.h
+         * work on it and keep the scope id.
+         */
+        class Inet6Address
+        {
+          public:
+              /**
+               * The numeric form of an address.
+               */
+              typedef Word128 Word;
+
+              /**
+               * The number of bits of an address.
+               */
+              static const uint32_t BITS = 128U;
+
+              /**
+               * Size of a buffer that can hold the textual representation
+               * of any Inet6Address, including the terminating NUL.
+               */
+              static const size_t MAX_TEXT_SIZE = InetAddress::MAX_TEXT_SIZE;
+
+              /**
+               * Creates the address :: with a scope id of 0.
+               */
+              FROG_CONSTEXPR Inet6Address() throw() : high_(0), low_(0), scope_(0)
+              {
+              }
+
+              /**
+               * Creates an address from its numeric form.
+               * @param[in] high The first 8 bytes of the address, read as a
+               * big-endian number: 0xfe80000000000000 for fe80::.
+               * @param[in] low The last 8 bytes of the address.
+               * @param[in] scope The scope id.
+               */
+              FROG_CONSTEXPR Inet6Address(uint64_t high, uint64_t low, uint32_t scope = 0) throw()
+                  : high_(high), low_(low), scope_(scope)
+              {
+              }
+
+              /**
+               * Creates an address from an @c in6_addr and a scope id.
+               */
+              explicit Inet6Address(const struct in6_addr& addr, uint32_t scope = 0) throw()
+                  : high_(loadBigEndian64(addr.s6_addr)), low_(loadBigEndian64(addr.s6_addr + 8)),
+                    scope_(scope)
+              {
+              }
+
+              /**
+               * Creates an address from its compact form.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * @arg value is not an IPv6 address.
+               */
+              explicit Inet6Address(const InetAddressValue& value) throw(sys::IllegalArgumentException);
+
+              /**
+               * Creates an address from an InetAddress.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * @arg address is not an IPv6 address.
+               */
+              explicit Inet6Address(const InetAddress& address) throw(sys::IllegalArgumentException);
+
+              /**
+               * Creates an address from its textual representation, with an
+               * optional <I>\%scope-id</I>.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * the text is not an IPv6 address.
+               */
+              explicit Inet6Address(const std::string& text) throw(sys::IllegalArgumentException);
+
+              /**
+               * Parses an IPv6 address without throwing and without
+               * allocating memory. See InetAddress::tryParse().
+               * @return @c true if the text is an IPv6 address. @arg out
+               * is left untouched otherwise.
+               */
+              static bool tryParse(const char* p, size_t n, Inet6Address& out) throw();
+
+              /**
+               * Converts the compact form of an address.
+               * @return @c true if @arg value is an IPv6 address. @arg out
+               * is left untouched otherwise.
+               */
+              static bool fromValue(const InetAddressValue& value, Inet6Address& out) throw()
+              {
+                  if(value.family != AF_INET6)
+                  {
+                      return false;
+                  }
+                  out.high_ = value.high();
+                  out.low_ = value.low();
+                  out.scope_ = value.scope;
+                  return true;
+              }
+
+              /**
+               * Returns the first 8 bytes of the address as a number.
+               */
+              FROG_CONSTEXPR uint64_t getHigh() const throw()
+              {
+                  return high_;
+              }
+
+              /**
+               * Returns the last 8 bytes of the address as a number.
+               */
+              FROG_CONSTEXPR uint64_t getLow() const throw()
+              {
+                  return low_;
+              }
+
+              /**
+               * Returns the scope id.
+               */
+              FROG_CONSTEXPR uint32_t getScope() const throw()
+              {
+                  return scope_;
+              }
+
+              /**
+               * Returns the address as a 128-bit number.
+               */
+              Word getWord() const throw()
+              {
+                  return makeWord128(high_, low_);
+              }
+
+              /**
+               * Returns the address @arg word with the scope id of this
+               * address. Used by the algorithms of InetAddressAlgorithms.h.
+               */
+              Inet6Address withWord(const Word& word) const throw()
+              {
+                  return Inet6Address(word.high, word.low, scope_);
+              }
+
+              /**
+               * Returns the netmask of a prefix length as a number.
+               * @param[in] prefixLength The prefix length, at most 128.
+               */
+              static Word prefixMask(uint32_t prefixLength) throw()
+              {
+                  uint32_t highLength = (prefixLength < 64U) ? prefixLength : 64U;
+                  return makeWord128(mask64(highLength), mask64(prefixLength - highLength));
+              }
+
+              /**
+               * Returns the address as an @c in6_addr.
+               */
+              struct in6_addr toIn6Addr() const throw()
+              {
+                  struct in6_addr addr;
+                  storeBigEndian64(addr.s6_addr, high_);
+                  storeBigEndian64(addr.s6_addr + 8, low_);
+                  return addr;
+              }
+
+              /**
+               * Returns the compact form of the address.
+               */
+              InetAddressValue toValue() const throw()
+              {
+                  InetAddressValue value;
+                  ::memset(&value, 0, sizeof(value));
+                  storeBigEndian64(value.address, high_);
+                  storeBigEndian64(value.address + 8, low_);
+                  value.scope = scope_;
+                  value.family = AF_INET6;
+                  return value;
+              }
+
+              /**
+               * Returns the address as an InetAddress.
+               */
+              InetAddress toInetAddress() const throw()
+              {
+                  return InetAddress(toValue());
+              }
+
+              /**
+               * Returns the properties of the address as a combination of
+               * the InetAddressValue::CLASS_* flags.
+               * See InetAddressValue::classify().
+               */
+              uint32_t classify() const throw()
+              {
+                  return InetAddressValue::classify6(high_, low_);
+              }
+
+              /**
+               * @name Predicates
+               * These give the same answers as the InetAddress predicates
+               * of the same names, computed on the two numbers.
+               */
+              //@{
+              bool isIPv4Compatible() const throw()
+              {
+                  return ((high_ | (low_ >> 32)) == 0) && (low_ > 1U);
+              }
+
+              bool isAnyLocalAddress() const throw()
+              {
+                  return (high_ | low_) == 0;
+              }
+
+              bool isLoopbackAddress() const throw()
+              {
+                  return (high_ == 0) && (low_ == 1U);
+              }
+
+              bool isLinkLocalAddress() const throw()
+              {
+                  return (high_ >> 54) == (0xfe80U >> 6);
+              }
+
+              bool isSiteLocalAddress() const throw()
+              {
+                  return (high_ >> 54) == (0xfec0U >> 6);
+              }
+
+              bool isMulticastAddress() const throw()
+              {
+                  return (high_ >> 56) == 0xffU;
+              }
+
+              bool isMulticastGlobal() const throw()
+              {
+                  return (high_ >> 48 & 0xff0fU) == 0xff0eU;
+              }
+
+              bool isMulticastNodeLocal() const throw()
+              {
+                  return (high_ >> 48 & 0xff0fU) == 0xff01U;
+              }
+
+              bool isMulticastLinkLocal() const throw()
+              {
+                  return (high_ >> 48 & 0xff0fU) == 0xff02U;
+              }
+
+              bool isMulticastSiteLocal() const throw()
+              {
+                  return (high_ >> 48 & 0xff0fU) == 0xff05U;
+              }
+
+              bool isMulticastOrgLocal() const throw()
+              {
+                  return (high_ >> 48 & 0xff0fU) == 0xff08U;
+              }
+              //@}
+
+              /**
+               * Compares two addresses numerically, then by scope id.
+               * @return A negative number, zero or a positive number if this
+               * address is less than, equal to or greater than @arg other.
+               */
+              int compare(const Inet6Address& other) const throw()
+              {
+                  if(high_ != other.high_)
+                  {
+                      return (high_ < other.high_) ? -1 : 1;
+                  }
+                  if(low_ != other.low_)
+                  {
+                      return (low_ < other.low_) ? -1 : 1;
+                  }
+                  return (scope_ > other.scope_) - (scope_ < other.scope_);
+              }
+
+              FROG_CONSTEXPR bool operator==(const Inet6Address& other) const throw()
+              {
+                  return ((high_ ^ other.high_) | (low_ ^ other.low_) | (scope_ ^ other.scope_)) == 0;
+              }
+
+              FROG_CONSTEXPR bool operator!=(const Inet6Address& other) const throw()
+              {
+                  return !(*this == other);
+              }
+
+              bool operator<(const Inet6Address& other) const throw()
+              {
+                  return compare(other) < 0;
+              }
+
+              bool operator>(const Inet6Address& other) const throw()
+              {
+                  return compare(other) > 0;
+              }
+
+              bool operator<=(const Inet6Address& other) const throw()
+              {
+                  return compare(other) <= 0;
+              }
+
+              bool operator>=(const Inet6Address& other) const throw()
+              {
+                  return compare(other) >= 0;
+              }
+
+              /**
+               * Returns a 64-bit hash of the address and scope id. It is
+               * the hash of toValue(), so an Inet6Address and the
+               * InetAddress of the same address hash alike.
+               * @param[in] seed Extra data to mix in, for example a port.
+               */
+              uint64_t hash(uint64_t seed = 0) const throw()
+              {
+                  return toValue().hash(seed);
+              }
+
+              /**
+               * Writes the textual representation into a caller supplied
+               * buffer. See InetAddress::format().
+               */
+              size_t format(char* buf, size_t cap) const throw();
+
+              /**
+               * Returns the textual representation.
+               */
+              std::string toString() const throw();
+          private:
+              /**
+               * Returns a 64-bit word whose first @arg length bits are ones.
+               */
+              static FROG_CONSTEXPR uint64_t mask64(uint32_t length) throw()
+              {
+                  return (length == 0) ? 0 : (~0ULL << (64U - length));
+              }
+
+              /**
+               * Reads 8 bytes as a big-endian number.
+               */
+              static uint64_t loadBigEndian64(const uint8_t* p) throw()
+              {
+                  return (static_cast<uint64_t>(p[0]) << 56) | (static_cast<uint64_t>(p[1]) << 48) |
+                      (static_cast<uint64_t>(p[2]) << 40) | (static_cast<uint64_t>(p[3]) << 32) |
+                      (static_cast<uint64_t>(p[4]) << 24) | (static_cast<uint64_t>(p[5]) << 16) |
+                      (static_cast<uint64_t>(p[6]) << 8) | static_cast<uint64_t>(p[7]);
+              }
+
+              /**
+               * Writes a number as 8 big-endian bytes. Compilers turn this
+               * into a byte swap and a single store.
+               */
+              static void storeBigEndian64(uint8_t* p, uint64_t v) throw()
+              {
+                  p[0] = static_cast<uint8_t>(v >> 56);
+                  p[1] = static_cast<uint8_t>(v >> 48);
+                  p[2] = static_cast<uint8_t>(v >> 40);
+                  p[3] = static_cast<uint8_t>(v >> 32);
+                  p[4] = static_cast<uint8_t>(v >> 24);
+                  p[5] = static_cast<uint8_t>(v >> 16);
+                  p[6] = static_cast<uint8_t>(v >> 8);
+                  p[7] = static_cast<uint8_t>(v);
+              }
+
+              /**
+               * The first 8 bytes of the address.
+               */
+              uint64_t high_;
+
+              /**
+               * The last 8 bytes of the address.
+               */
+              uint64_t low_;
+
+              /**
+               * The scope id.
+               */
+              uint32_t scope_;
+        }; // Inet6Address cls
+
+        /**
+         * Hash function object for Inet6Address, for use with hash based
+         * containers.
+         */
+        struct Inet6AddressHash
+        {
+            size_t operator()(const Inet6Address& address) const throw()
+            {
+                return static_cast<size_t>(address.hash());
+            }
+        };
+    } // net ns
+} // frog ns
+#endif // FROG_NET_INET6ADDRESS_H
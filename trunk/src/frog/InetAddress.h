@@ -33,6 +33,7 @@
 #include <frog/stdint.h>
 #include <frog/Object.h>
 #include <frog/AddressFamily.h>
+#include <frog/InetAddressValue.h>
 #include <frog/ArgumentOutOfBoundsException.h>
 #include <frog/NotImplementedException.h>
 #include <frog/UnknownHostException.h>
@@ -64,10 +65,18 @@ namespace frog
                */
               InetAddress() throw();
 
+#if __cplusplus >= 201103L
               /**
                * Copy constructor.
                */
-              InetAddress(const InetAddress& addr) throw();
+              InetAddress(const InetAddress& addr) = default;
+
+              /**
+               * Move constructor. An InetAddress owns no resources, so
+               * this is a plain copy that the compiler can elide.
+               */
+              InetAddress(InetAddress&& addr) noexcept = default;
+#endif
 
               /**
                * Creates an InetAddress given the textual representation
@@ -103,6 +112,56 @@ namespace frog
                   throw(sys::ArgumentOutOfBoundsException);
 #endif
 
+              /**
+               * Creates an InetAddress from its compact form. The conversion
+               * is lossless: <TT>InetAddress(v).getValue() == v</TT>.
+               * @param[in] value The compact address.
+               */
+              explicit InetAddress(const InetAddressValue& value) throw();
+
+              /**
+               * Parses the textual representation of an IP address without
+               * throwing and without allocating memory. The text is scanned
+               * once and accepts dotted-quad IPv4 addresses as well as IPv6
+               * addresses, including the "::" shorthand, an embedded IPv4 tail
+               * and a trailing <I>\%scope-id</I>. A scope id is either the
+               * numeric interface index or the name of a local interface.
+               * @param[in] p The text to parse. It need not be NUL terminated.
+               * @param[in] n The number of characters in @arg p.
+               * @param[out] out Receives the parsed address. It is left
+               * untouched when the text is not a valid IP address.
+               * @return Returns @c true if the text is a valid IP address;
+               * @c false otherwise.
+               */
+              static bool tryParse(const char* p, size_t n, InetAddress& out) throw();
+
+              /**
+               * Parses the textual representation of an IP address into its
+               * compact form. See tryParse(const char*, size_t, InetAddress&).
+               * This is the form to use when filling large arrays of
+               * addresses, as it touches nothing but @arg out.
+               */
+              static bool tryParse(const char* p, size_t n, InetAddressValue& out) throw();
+
+              /**
+               * Parses many addresses at once, such as a column of a CSV
+               * file. Every text is parsed as by
+               * tryParse(const char*, size_t, InetAddressValue&). On
+               * processors with SSE4.1, dotted quads are checked and
+               * converted with vector instructions, 16 characters at a
+               * time; any other text goes through the scalar parser.
+               * @param[in] texts The texts to parse. They need not be NUL
+               * terminated.
+               * @param[in] lengths The number of characters of each text.
+               * @param[in] count The number of texts.
+               * @param[out] out Receives the @arg count parsed addresses. The
+               * address of a text that is not valid has the unspecified
+               * family.
+               * @return The number of valid texts.
+               */
+              static size_t tryParseBatch(const char* const* texts, const size_t* lengths, size_t count,
+                      InetAddressValue* out) throw();
+
               /**
                * Returns the local host. This gives the first IP address that is
                * not a loopback address.
@@ -122,21 +181,30 @@ namespace frog
                * @return Returns @c true if this address
                * is a wildcard address.
                */
-              bool isAnyLocalAddress() throw();
+              bool isAnyLocalAddress() const throw()
+              {
+                  return value_.isAnyLocalAddress();
+              }
 
               /**
                * Checks to see if this is a loopback address.
                * @return Returns @c true if the address is a
                * loopback address.
                */
-              bool isLoopbackAddress() throw();
+              bool isLoopbackAddress() const throw()
+              {
+                  return value_.isLoopbackAddress();
+              }
 
               /**
                * Checks if this is an IP multicast address.
                * @return Returns @c true if the address is a
                * multicast address.
                */
-              bool isMulticastAddress() throw();
+              bool isMulticastAddress() const throw()
+              {
+                  return value_.isMulticastAddress();
+              }
 
               /**
                * Checks to see if this is a link local
@@ -144,7 +212,10 @@ namespace frog
                * @return Returns @c true if the address is a
                * link local unicast address.
                */
-              bool isLinkLocalAddress() throw();
+              bool isLinkLocalAddress() const throw()
+              {
+                  return value_.isLinkLocalAddress();
+              }
 
               /**
                * Checks to see if this is a site local
@@ -152,7 +223,10 @@ namespace frog
                * @return Returns @c true if the address is a
                * site local unicast address.
                */
-              bool isSiteLocalAddress() throw();
+              bool isSiteLocalAddress() const throw()
+              {
+                  return value_.isSiteLocalAddress();
+              }
 
               /**
                * Checks to see if this if a multicast address
@@ -161,7 +235,10 @@ namespace frog
                * has a global scope; @c false if is not or if the
                * address is not a multicast address.
                */
-              bool isMulticastGlobal() throw();
+              bool isMulticastGlobal() const throw()
+              {
+                  return value_.isMulticastGlobal();
+              }
 
               /**
                * Checks to see if this if a multicast address
@@ -170,7 +247,10 @@ namespace frog
                * has a node-local scope; @c false if it is not or
                * if the address is not a multicast address.
                */
-              bool isMulticastNodeLocal() throw();
+              bool isMulticastNodeLocal() const throw()
+              {
+                  return value_.isMulticastNodeLocal();
+              }
 
               /**
                * Checks to see if the multicast address
@@ -179,7 +259,10 @@ namespace frog
                * has link-local scope; @c false if it is not or
                * if the address is not a multicast address.
                */
-              bool isMulticastLinkLocal() throw();
+              bool isMulticastLinkLocal() const throw()
+              {
+                  return value_.isMulticastLinkLocal();
+              }
 
               /**
                * Checks to see if the multicast address
@@ -188,7 +271,10 @@ namespace frog
                * has site-local scope; @c false if it is not or
                * if the address is not a multicast address.
                */
-              bool isMulticastSiteLocal() throw();
+              bool isMulticastSiteLocal() const throw()
+              {
+                  return value_.isMulticastSiteLocal();
+              }
 
               /**
                * Checks to see if the multicast address
@@ -197,7 +283,41 @@ namespace frog
                * has organization-local scope; @c false if it is not
                * or if the address is not a multicast address.
                */
-              bool isMulticastOrgLocal() throw();
+              bool isMulticastOrgLocal() const throw()
+              {
+                  return value_.isMulticastOrgLocal();
+              }
+
+              /**
+               * Checks if this is an IPv4-mapped IPv6 address, ::ffff:a.b.c.d.
+               * See canonical().
+               */
+              bool isIPv4Mapped() const throw()
+              {
+                  return value_.isIPv4Mapped();
+              }
+
+              /**
+               * Returns the canonical form of this address: the IPv4 address
+               * for an IPv4-mapped IPv6 address and a copy of this address
+               * otherwise. Use it, or InetAddressCanonicalHash and
+               * InetAddressCanonicalEqual, to count a peer seen on a
+               * dual-stack socket and on an IPv4 socket once.
+               */
+              InetAddress canonical() const throw()
+              {
+                  return InetAddress(value_.canonical());
+              }
+
+              /**
+               * Computes all the properties tested by the predicates above in
+               * one pass. See InetAddressValue::classify().
+               * @return A combination of the InetAddressValue::CLASS_* flags.
+               */
+              uint32_t classify() const throw()
+              {
+                  return value_.classify();
+              }
 
               /**
                * Gives the raw IPv4 address wrapped in a <TT>struct in_addr</TT>.
@@ -211,26 +331,172 @@ namespace frog
                */
               void getPrimitive(struct in6_addr& rawIPAddress) const;
 
+              /**
+               * Gives the compact form of this IP address. This is a
+               * plain-old-data copy of the address, its family and its
+               * scope id.
+               * @return A reference to the compact address held by this
+               * InetAddress.
+               */
+              const InetAddressValue& getValue() const throw()
+              {
+                  return value_;
+              }
+
               /**
                * Returns the IP address in textual presentation.
                * @return The raw IP address in a string format.
                */
               std::string getHostAddress() const throw();
 
+              /**
+               * Writes the IP address in textual presentation into a caller
+               * supplied buffer. The text is the same as the one returned by
+               * InetAddress::getHostAddress() and is NUL terminated. IPv6
+               * addresses are written in the form recommended by RFC 5952.
+               * No memory is allocated.
+               * @param[out] buf The buffer that receives the text.
+               * @param[in] cap The size of @arg buf in bytes. A buffer of
+               * InetAddress::MAX_TEXT_SIZE bytes is always large enough.
+               * @return The number of characters written, not counting the
+               * terminating NUL, or 0 if @arg buf is too small or the
+               * address family is unspecified.
+               */
+              size_t format(char* buf, size_t cap) const throw();
+
               /**
                * Tests for InetAddress equality.
                */
-              bool operator==(const InetAddress& addr) const throw();
+              bool operator==(const InetAddress& addr) const throw()
+              {
+                  return (value_ == addr.value_);
+              }
 
               /**
                * Tests for InetAddress inequality.
                */
-              bool operator!=(const InetAddress& addr) const throw();
+              bool operator!=(const InetAddress& addr) const throw()
+              {
+                  return !(value_ == addr.value_);
+              }
 
+              /**
+               * Orders IP addresses by family, then by the numeric value of
+               * the address and then by scope id. See InetAddressValue::compare().
+               */
+              bool operator<(const InetAddress& addr) const throw()
+              {
+                  return (value_.compare(addr.value_) < 0);
+              }
+
+              /**
+               * Orders IP addresses. See InetAddress::operator<().
+               */
+              bool operator>(const InetAddress& addr) const throw()
+              {
+                  return (value_.compare(addr.value_) > 0);
+              }
+
+              /**
+               * Orders IP addresses. See InetAddress::operator<().
+               */
+              bool operator<=(const InetAddress& addr) const throw()
+              {
+                  return (value_.compare(addr.value_) <= 0);
+              }
+
+              /**
+               * Orders IP addresses. See InetAddress::operator<().
+               */
+              bool operator>=(const InetAddress& addr) const throw()
+              {
+                  return (value_.compare(addr.value_) >= 0);
+              }
+
+              /**
+               * Writes a key of InetAddressValue::SORT_KEY_SIZE bytes whose
+               * @c memcmp order is the order of InetAddress::operator<().
+               * @param[out] key Receives the key.
+               */
+              void sortKey(uint8_t* key) const throw()
+              {
+                  value_.sortKey(key);
+              }
+
+              /**
+               * @name Address arithmetic
+               * These move an address within its family without going
+               * through its text. The arithmetic is modulo 2^32 for IPv4
+               * and 2^128 for IPv6, so the address after 255.255.255.255 is
+               * 0.0.0.0. The scope id is kept. An address of the unspecified
+               * family is left as it is.
+               */
+              //@{
+              InetAddress& operator++() throw();
+              InetAddress operator++(int) throw();
+              InetAddress& operator--() throw();
+              InetAddress operator--(int) throw();
+              InetAddress& operator+=(int64_t offset) throw();
+              InetAddress& operator-=(int64_t offset) throw();
+
+              InetAddress operator+(int64_t offset) const throw()
+              {
+                  InetAddress result(*this);
+                  return (result += offset);
+              }
+
+              InetAddress operator-(int64_t offset) const throw()
+              {
+                  InetAddress result(*this);
+                  return (result -= offset);
+              }
+              //@}
+
+              /**
+               * Computes the number of addresses from this address to
+               * another one, so that <TT>*this + distance(to) == to</TT>
+               * apart from the scope id.
+               * @param[in] to An address of the same family.
+               * @return The distance; it is negative when @arg to comes
+               * before this address.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * the families differ or are unspecified.
+               * @exception frog::sys::ArgumentOutOfBoundsException Thrown
+               * when the distance does not fit in an @c int64_t.
+               */
+              int64_t distance(const InetAddress& to) const throw(sys::IllegalArgumentException);
+
+              /**
+               * Returns this address with its host bits cleared: the network
+               * address of the subnet of the given prefix length.
+               * @param[in] prefixLength The number of bits to keep: up to 32
+               * for IPv4 and up to 128 for IPv6.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * the family is unspecified or the prefix length is too long.
+               */
+              InetAddress mask(uint32_t prefixLength) const throw(sys::IllegalArgumentException);
+
+              /**
+               * Returns this address ANDed with a netmask, such as the one
+               * given by NetworkInterface. The netmask need not be
+               * contiguous.
+               * @param[in] netmask An address of the same family.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * the families differ or are unspecified.
+               */
+              InetAddress mask(const InetAddress& netmask) const throw(sys::IllegalArgumentException);
+
+#if __cplusplus >= 201103L
               /**
                * Copies an InetAddress to another InetAddress.
                */
-              InetAddress& operator=(const InetAddress& addr) throw();
+              InetAddress& operator=(const InetAddress& addr) = default;
+
+              /**
+               * Move assignment.
+               */
+              InetAddress& operator=(InetAddress&& addr) noexcept = default;
+#endif
 
               /**
                * Converts this InetAddress to a string. The string
@@ -242,25 +508,43 @@ namespace frog
               virtual std::string toString() const throw();
 
               /**
-               * Gives the address family of the IP address. This is a
-               * @e read-only attribute and can only be assigned during
-               * construction.
+               * Returns a 32-bit hash code computed from the address, its
+               * family and its scope id. Equal addresses have equal hash
+               * codes, so two InetAddress%es are "the same" in the sense
+               * of Object::sameObject() when they hold the same address.
                */
-              const AddressFamily::TYPE& addressFamily;
+              virtual int32_t hashCode() const throw();
 
               /**
-               * This is set to @e true if the InetAddress is an IPv4-compatible
-               * IPv6 address, or @e false if not. If the InetAddress is already
-               * an IPv4 address, this is set to @e true.
+               * Gives the address family of the IP address. The family
+               * can only be assigned during construction.
+               */
+              AddressFamily::TYPE getAddressFamily() const throw()
+              {
+                  return value_.family;
+              }
+
+              /**
+               * Returns @e true if the InetAddress is an IPv4-compatible
+               * IPv6 address, or @e false if not. If the InetAddress is
+               * already an IPv4 address, this returns @e true.
+               */
+              bool isIPv4Compatible() const throw()
+              {
+                  return ipv4Compatible_;
+              }
+
+              /**
+               * Size of a buffer that can hold the textual presentation
+               * of any IP address, including the IPv6 scope id and the
+               * terminating NUL.
                */
-              const bool& ipv4Compatible;
+              static const size_t MAX_TEXT_SIZE = 57U;
           private:
               /**
-               * The address family. For InetAddress,
-               * this is either AddressFamily::InterNetwork
-               * or AddressFamily::InterNetworkV6.
+               * IPEndpoint::fromSockAddr() writes the value in place.
                */
-              AddressFamily::TYPE addressFamily_;
+              friend class IPEndpoint;
 
               /**
                * This is set to @e true if the InetAddress is an IPv4-compatible
@@ -288,23 +572,22 @@ namespace frog
 #endif
 
               /**
-               * Address index as seen in <I>ifconfig</I>.
-               */
-              uint32_t index_;
-
-              /**
-               * Starting offset of the IPv4 address in address_[].
+               * Starting offset of the IPv4 address in the raw address.
                */
               static const uint16_t IPV4_OFFSET = (MAX_ADDR_SIZE - INADDRSZ);
 
               /**
-               * The raw IP address. The address is stored in network byte order: the
-               * highest order byte of the address is in address_[0] and address_[12]
-               * for IPv6 and IPv4 respectively. The address is 16 bytes (128 bits) long
-               * so we can handle both IPv4 and IPv6. For IPv4, only the the last 4 bytes
-               * (bottom 32 bits) are used, for IPv6 all 16 bytes are used.
+               * The raw IP address, its family and its scope id (the address
+               * index as seen in <I>ifconfig</I>). The address is stored in
+               * network byte order: the highest order byte of the address is in
+               * value_.address[0] and value_.address[12] for IPv6 and IPv4
+               * respectively. The address is 16 bytes (128 bits) long so we can
+               * handle both IPv4 and IPv6. For IPv4, only the the last 4 bytes
+               * (bottom 32 bits) are used, for IPv6 all 16 bytes are used. The
+               * family is either AddressFamily::InterNetwork or
+               * AddressFamily::InterNetworkV6.
                */
-              uint8_t address_[MAX_ADDR_SIZE];
+              InetAddressValue value_;
 
               /**
                * Initializes the underlying IP address with an IPv4 address.
@@ -320,8 +603,69 @@ namespace frog
                   throw(sys::ArgumentOutOfBoundsException);
 #endif
         }; // InetAddress cls
+
+        /**
+         * Hash function object for InetAddress, for use with hash based
+         * containers. It hashes the address bytes, family and scope id.
+         */
+        struct InetAddressHash
+        {
+            size_t operator()(const InetAddress& addr) const throw()
+            {
+                return static_cast<size_t>(addr.getValue().hash());
+            }
+        };
+
+        /**
+         * Hash function object for InetAddress that hashes the canonical()
+         * form. Use it with InetAddressCanonicalEqual.
+         */
+        struct InetAddressCanonicalHash
+        {
+            size_t operator()(const InetAddress& addr) const throw()
+            {
+                return static_cast<size_t>(addr.getValue().canonical().hash());
+            }
+        };
+
+        /**
+         * Equality function object for InetAddress that compares the
+         * canonical() forms.
+         */
+        struct InetAddressCanonicalEqual
+        {
+            bool operator()(const InetAddress& a, const InetAddress& b) const throw()
+            {
+                return a.getValue().canonical() == b.getValue().canonical();
+            }
+        };
     } // net ns
 } // frog ns
 
+#if __cplusplus >= 201103L
+#include <functional>
+
+namespace std
+{
+    /**
+     * Lets InetAddress be used as the key of std::unordered_map and
+     * std::unordered_set.
+     */
+    template<>
+        struct hash<frog::net::InetAddress> : public frog::net::InetAddressHash
+        {
+        };
+
+    /**
+     * Lets InetAddressValue be used as the key of std::unordered_map and
+     * std::unordered_set.
+     */
+    template<>
+        struct hash<frog::net::InetAddressValue> : public frog::net::InetAddressValueHash
+        {
+        };
+} // std ns
+#endif
+
 
 #endif // FROG_NET_INETADDRESS_H
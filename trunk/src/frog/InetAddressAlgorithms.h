@@ -0,0 +1,182 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_INETADDRESSALGORITHMS_H
+#define FROG_NET_INETADDRESSALGORITHMS_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <frog/stdint.h>
+#include <frog/Word128.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * @name Algorithms on typed addresses
+         * These templates work on Inet4Address and Inet6Address, and on
+         * any type @c A that provides:
+         * <UL>
+         * <LI><TT>A::Word</TT>, the numeric form of an address, with the
+         *     operators <TT>== < & | ^ ~ + -</TT>, countLeadingZeros(),
+         *     fromInt64() and toUint64();</LI>
+         * <LI><TT>A::BITS</TT>, the number of bits of an address;</LI>
+         * <LI><TT>a.getWord()</TT> and <TT>a.withWord(w)</TT>, which
+         *     returns @c a with its address replaced by @c w;</LI>
+         * <LI><TT>A::prefixMask(n)</TT>, the word whose first @c n bits
+         *     are ones.</LI>
+         * </UL>
+         * As the family is known at compile time, they compile to plain
+         * word operations without any test of the family.
+         */
+        //@{
+
+        /**
+         * Returns the network address of the subnet of the given prefix
+         * length that holds an address: the address with its host bits
+         * cleared. The scope id, if any, is kept.
+         * @param[in] address The address.
+         * @param[in] prefixLength The prefix length, at most A::BITS.
+         */
+        template <typename A>
+            inline A networkAddress(const A& address, uint32_t prefixLength) throw()
+            {
+                return address.withWord(address.getWord() & A::prefixMask(prefixLength));
+            }
+
+        /**
+         * Returns the last address of the subnet of the given prefix
+         * length that holds an address: the address with its host bits
+         * set.
+         * @param[in] address The address.
+         * @param[in] prefixLength The prefix length, at most A::BITS.
+         */
+        template <typename A>
+            inline A lastAddress(const A& address, uint32_t prefixLength) throw()
+            {
+                return address.withWord(address.getWord() | ~A::prefixMask(prefixLength));
+            }
+
+        /**
+         * Tests if two addresses are in the same subnet of the given
+         * prefix length.
+         */
+        template <typename A>
+            inline bool sameNetwork(const A& a, const A& b, uint32_t prefixLength) throw()
+            {
+                typename A::Word zero = typename A::Word();
+                return ((a.getWord() ^ b.getWord()) & A::prefixMask(prefixLength)) == zero;
+            }
+
+        /**
+         * Returns the number of leading bits two addresses have in
+         * common; A::BITS if they are equal.
+         */
+        template <typename A>
+            inline uint32_t commonPrefixLength(const A& a, const A& b) throw()
+            {
+                return countLeadingZeros(a.getWord() ^ b.getWord());
+            }
+
+        /**
+         * Returns the address @arg offset places after an address. The
+         * arithmetic is modulo 2^A::BITS, so the address after the last
+         * one is the first one. The scope id, if any, is kept.
+         * @param[in] address The address.
+         * @param[in] offset The number of addresses to move by; negative
+         * numbers move backwards.
+         */
+        template <typename A>
+            inline A advance(const A& address, int64_t offset) throw()
+            {
+                typename A::Word w;
+                fromInt64(offset, w);
+                return address.withWord(address.getWord() + w);
+            }
+
+        /**
+         * Returns the address @arg offset places before an address. See
+         * advance().
+         */
+        template <typename A>
+            inline A retreat(const A& address, int64_t offset) throw()
+            {
+                typename A::Word w;
+                fromInt64(offset, w);
+                return address.withWord(address.getWord() - w);
+            }
+
+        /**
+         * Computes the number of addresses from one address to another:
+         * <TT>advance(from, out) == to</TT>.
+         * @param[in] from The first address.
+         * @param[in] to The second address.
+         * @param[out] out Receives the distance; it is negative when
+         * @arg to is before @arg from.
+         * @return @c false if the distance does not fit in an @c int64_t.
+         * @arg out is left untouched in that case.
+         */
+        template <typename A>
+            inline bool distance(const A& from, const A& to, int64_t& out) throw()
+            {
+                bool negative = (to.getWord() < from.getWord());
+                uint64_t magnitude;
+                if(!toUint64(negative ? from.getWord() - to.getWord() : to.getWord() - from.getWord(),
+                            magnitude))
+                {
+                    return false;
+                }
+                if(negative)
+                {
+                    if(magnitude > (1ULL << 63))
+                    {
+                        return false;
+                    }
+                    out = static_cast<int64_t>(0ULL - magnitude);
+                }
+                else
+                {
+                    if(magnitude >= (1ULL << 63))
+                    {
+                        return false;
+                    }
+                    out = static_cast<int64_t>(magnitude);
+                }
+                return true;
+            }
+
+        //@}
+    } // net ns
+} // frog ns
+#endif // FROG_NET_INETADDRESSALGORITHMS_H
@@ -0,0 +1,524 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_INETADDRESSLITERALS_H
+#define FROG_NET_INETADDRESSLITERALS_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if __cplusplus >= 201402L
+
+#include <cstddef>
+
+#include <frog/stdint.h>
+#include <frog/Inet4Address.h>
+#include <frog/Inet6Address.h>
+#include <frog/Subnet.h>
+#include <frog/IllegalArgumentException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * An IPv4 subnet made of an Inet4Address and a prefix length. It
+         * is a literal type: unlike Subnet it can be built at compile time
+         * and kept in constant tables. The host bits of the network are
+         * cleared, as they are by Subnet.
+         */
+        class Inet4Subnet
+        {
+          public:
+              /**
+               * Creates the subnet 0.0.0.0/0.
+               */
+              constexpr Inet4Subnet() throw() : network_(), prefixLength_(0)
+              {
+              }
+
+              /**
+               * Creates a subnet.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * @arg prefixLength is greater than 32.
+               */
+              constexpr Inet4Subnet(const Inet4Address& network, uint32_t prefixLength)
+                  throw(sys::IllegalArgumentException)
+                  : network_(network.getWord() & Inet4Address::prefixMask(prefixLength)),
+                    prefixLength_(prefixLength)
+              {
+                  if(prefixLength > Inet4Address::BITS)
+                  {
+                      throw sys::IllegalArgumentException("Prefix length is out of range.");
+                  }
+              }
+
+              constexpr Inet4Address getNetwork() const throw()
+              {
+                  return network_;
+              }
+
+              constexpr uint32_t getPrefixLength() const throw()
+              {
+                  return prefixLength_;
+              }
+
+              /**
+               * Tests if an address belongs to this subnet.
+               */
+              constexpr bool contains(const Inet4Address& address) const throw()
+              {
+                  return ((address.getWord() ^ network_.getWord()) &
+                          Inet4Address::prefixMask(prefixLength_)) == 0;
+              }
+
+              constexpr bool operator==(const Inet4Subnet& other) const throw()
+              {
+                  return (network_ == other.network_) && (prefixLength_ == other.prefixLength_);
+              }
+
+              constexpr bool operator!=(const Inet4Subnet& other) const throw()
+              {
+                  return !(*this == other);
+              }
+
+              /**
+               * Returns the subnet as a Subnet.
+               */
+              Subnet toSubnet() const throw()
+              {
+                  return Subnet(network_.toInetAddress(), prefixLength_);
+              }
+          private:
+              Inet4Address network_;
+              uint32_t prefixLength_;
+        }; // Inet4Subnet cls
+
+        /**
+         * An IPv6 subnet made of an Inet6Address and a prefix length. It
+         * is a literal type, see Inet4Subnet. The scope id of the network
+         * is kept but, as with Subnet, contains() does not look at it.
+         */
+        class Inet6Subnet
+        {
+          public:
+              /**
+               * Creates the subnet ::/0.
+               */
+              constexpr Inet6Subnet() throw() : network_(), prefixLength_(0)
+              {
+              }
+
+              /**
+               * Creates a subnet.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * @arg prefixLength is greater than 128.
+               */
+              constexpr Inet6Subnet(const Inet6Address& network, uint32_t prefixLength)
+                  throw(sys::IllegalArgumentException)
+                  : network_(network.getHigh() & highMask(prefixLength),
+                          network.getLow() & lowMask(prefixLength), network.getScope()),
+                    prefixLength_(prefixLength)
+              {
+                  if(prefixLength > Inet6Address::BITS)
+                  {
+                      throw sys::IllegalArgumentException("Prefix length is out of range.");
+                  }
+              }
+
+              constexpr Inet6Address getNetwork() const throw()
+              {
+                  return network_;
+              }
+
+              constexpr uint32_t getPrefixLength() const throw()
+              {
+                  return prefixLength_;
+              }
+
+              /**
+               * Tests if an address belongs to this subnet.
+               */
+              constexpr bool contains(const Inet6Address& address) const throw()
+              {
+                  return (((address.getHigh() ^ network_.getHigh()) & highMask(prefixLength_)) |
+                          ((address.getLow() ^ network_.getLow()) & lowMask(prefixLength_))) == 0;
+              }
+
+              constexpr bool operator==(const Inet6Subnet& other) const throw()
+              {
+                  return (network_ == other.network_) && (prefixLength_ == other.prefixLength_);
+              }
+
+              constexpr bool operator!=(const Inet6Subnet& other) const throw()
+              {
+                  return !(*this == other);
+              }
+
+              /**
+               * Returns the subnet as a Subnet.
+               */
+              Subnet toSubnet() const throw()
+              {
+                  return Subnet(network_.toInetAddress(), prefixLength_);
+              }
+          private:
+              /**
+               * Returns the mask of the first 8 bytes of a prefix length.
+               */
+              static constexpr uint64_t highMask(uint32_t prefixLength) throw()
+              {
+                  return (prefixLength == 0) ? 0 :
+                      (prefixLength >= 64U) ? ~0ULL : (~0ULL << (64U - prefixLength));
+              }
+
+              /**
+               * Returns the mask of the last 8 bytes of a prefix length.
+               */
+              static constexpr uint64_t lowMask(uint32_t prefixLength) throw()
+              {
+                  return (prefixLength <= 64U) ? 0 :
+                      (prefixLength >= 128U) ? ~0ULL : (~0ULL << (128U - prefixLength));
+              }
+
+              Inet6Address network_;
+              uint32_t prefixLength_;
+        }; // Inet6Subnet cls
+
+        /**
+         * Parses a dotted quad, with the grammar of InetAddress::tryParse(),
+         * at compile time when used in a constant expression.
+         * @exception frog::sys::IllegalArgumentException Thrown when the
+         * text is not an IPv4 address. In a constant expression this is a
+         * compile error instead.
+         */
+        constexpr Inet4Address parseInet4Literal(const char* p, size_t n) throw(sys::IllegalArgumentException)
+        {
+            uint32_t word = 0;
+            size_t i = 0;
+            for(int octet = 0; octet < 4; ++octet)
+            {
+                if(octet > 0)
+                {
+                    if((i == n) || (p[i] != '.'))
+                    {
+                        throw sys::IllegalArgumentException("IP address is not valid.");
+                    }
+                    ++i;
+                }
+
+                size_t start = i;
+                uint32_t value = 0;
+                while((i != n) && (i - start < 3) && (p[i] >= '0') && (p[i] <= '9'))
+                {
+                    value = (value * 10U) + static_cast<uint32_t>(p[i] - '0');
+                    ++i;
+                }
+                if((i == start) || (value > 255U) || ((p[start] == '0') && (i - start > 1)))
+                {
+                    throw sys::IllegalArgumentException("IP address is not valid.");
+                }
+                word = (word << 8) | value;
+            }
+            if(i != n)
+            {
+                throw sys::IllegalArgumentException("IP address is not valid.");
+            }
+            return Inet4Address(word);
+        }
+
+        /**
+         * Parses an IPv6 address, with the grammar of
+         * InetAddress::tryParse(), at compile time when used in a constant
+         * expression. The scope id, if any, must be numeric, as interface
+         * names are only known at run time.
+         * @exception frog::sys::IllegalArgumentException Thrown when the
+         * text is not an IPv6 address. In a constant expression this is a
+         * compile error instead.
+         */
+        constexpr Inet6Address parseInet6Literal(const char* p, size_t n) throw(sys::IllegalArgumentException)
+        {
+            size_t end = n;
+            uint32_t scope = 0;
+            for(size_t i = 0; i < n; ++i)
+            {
+                if(p[i] == '%')
+                {
+                    end = i;
+                    if(i + 1 == n)
+                    {
+                        throw sys::IllegalArgumentException("IP address is not valid.");
+                    }
+                    uint64_t value = 0;
+                    for(size_t j = i + 1; j < n; ++j)
+                    {
+                        if((p[j] < '0') || (p[j] > '9'))
+                        {
+                            throw sys::IllegalArgumentException("Scope id of a literal must be numeric.");
+                        }
+                        value = (value * 10U) + static_cast<uint64_t>(p[j] - '0');
+                        if(value > 0xFFFFFFFFU)
+                        {
+                            throw sys::IllegalArgumentException("IP address is not valid.");
+                        }
+                    }
+                    scope = static_cast<uint32_t>(value);
+                    break;
+                }
+            }
+
+            uint8_t words[16] = {};
+            int length = 0;
+            int gap = -1; // Where the "::" was found, if any
+            size_t i = 0;
+            if((i != end) && (p[i] == ':'))
+            {
+                ++i;
+                if((i == end) || (p[i] != ':'))
+                {
+                    throw sys::IllegalArgumentException("IP address is not valid.");
+                }
+            }
+
+            while(i != end)
+            {
+                if(p[i] == ':')
+                {
+                    if(gap >= 0)
+                    {
+                        throw sys::IllegalArgumentException("IP address is not valid.");
+                    }
+                    gap = length;
+                    ++i;
+                    continue;
+                }
+
+                size_t start = i;
+                uint32_t value = 0;
+                while((i != end) && (i - start < 4))
+                {
+                    char c = p[i];
+                    uint32_t digit = ((c >= '0') && (c <= '9')) ? static_cast<uint32_t>(c - '0') :
+                        ((c >= 'a') && (c <= 'f')) ? static_cast<uint32_t>(c - 'a' + 10) :
+                        ((c >= 'A') && (c <= 'F')) ? static_cast<uint32_t>(c - 'A' + 10) : 16U;
+                    if(digit == 16U)
+                    {
+                        break;
+                    }
+                    value = (value << 4) | digit;
+                    ++i;
+                }
+
+                if((i != end) && (p[i] == '.'))
+                {
+                    // Embedded IPv4 address which must be the last part.
+                    if(length > 12)
+                    {
+                        throw sys::IllegalArgumentException("IP address is not valid.");
+                    }
+                    uint32_t word = parseInet4Literal(p + start, end - start).getWord();
+                    words[length++] = static_cast<uint8_t>(word >> 24);
+                    words[length++] = static_cast<uint8_t>(word >> 16);
+                    words[length++] = static_cast<uint8_t>(word >> 8);
+                    words[length++] = static_cast<uint8_t>(word);
+                    break;
+                }
+
+                if((i == start) || (length > 14))
+                {
+                    throw sys::IllegalArgumentException("IP address is not valid.");
+                }
+                words[length++] = static_cast<uint8_t>(value >> 8);
+                words[length++] = static_cast<uint8_t>(value);
+
+                if(i != end)
+                {
+                    if(p[i] != ':')
+                    {
+                        throw sys::IllegalArgumentException("IP address is not valid.");
+                    }
+                    ++i;
+                    if(i == end)
+                    {
+                        // A trailing single colon.
+                        throw sys::IllegalArgumentException("IP address is not valid.");
+                    }
+                }
+            }
+
+            if((gap >= 0) ? (length == 16) : (length != 16))
+            {
+                throw sys::IllegalArgumentException("IP address is not valid.");
+            }
+
+            // Moves the part after the "::" to the end.
+            uint8_t bytes[16] = {};
+            int tail = (gap >= 0) ? length - gap : 0;
+            int head = length - tail;
+            for(int k = 0; k < head; ++k)
+            {
+                bytes[k] = words[k];
+            }
+            for(int k = 0; k < tail; ++k)
+            {
+                bytes[16 - tail + k] = words[head + k];
+            }
+
+            uint64_t high = 0;
+            uint64_t low = 0;
+            for(int k = 0; k < 8; ++k)
+            {
+                high = (high << 8) | bytes[k];
+                low = (low << 8) | bytes[k + 8];
+            }
+            return Inet6Address(high, low, scope);
+        }
+
+        /**
+         * Returns the prefix length after the slash of a subnet literal, or
+         * @arg maxLength if there is no slash.
+         * @param[in] slash The position of the slash, @arg n if none.
+         */
+        constexpr uint32_t parsePrefixLengthLiteral(const char* p, size_t n, size_t slash,
+                uint32_t maxLength) throw(sys::IllegalArgumentException)
+        {
+            if(slash == n)
+            {
+                return maxLength;
+            }
+            // One to three decimal digits without leading zeros.
+            size_t digits = n - slash - 1;
+            if((digits == 0) || (digits > 3) || ((p[slash + 1] == '0') && (digits > 1)))
+            {
+                throw sys::IllegalArgumentException("Subnet is not valid.");
+            }
+            uint32_t prefixLength = 0;
+            for(size_t i = slash + 1; i < n; ++i)
+            {
+                if((p[i] < '0') || (p[i] > '9'))
+                {
+                    throw sys::IllegalArgumentException("Subnet is not valid.");
+                }
+                prefixLength = (prefixLength * 10U) + static_cast<uint32_t>(p[i] - '0');
+            }
+            if(prefixLength > maxLength)
+            {
+                throw sys::IllegalArgumentException("Subnet is not valid.");
+            }
+            return prefixLength;
+        }
+
+        /**
+         * Returns the position of the slash of a subnet literal, or @arg n
+         * if there is none.
+         */
+        constexpr size_t findSlashLiteral(const char* p, size_t n) throw()
+        {
+            size_t slash = 0;
+            while((slash != n) && (p[slash] != '/'))
+            {
+                ++slash;
+            }
+            return slash;
+        }
+
+        /**
+         * Parses an IPv4 subnet such as "10.0.0.0/8", with the grammar of
+         * Subnet::tryParse(), at compile time when used in a constant
+         * expression.
+         * @exception frog::sys::IllegalArgumentException Thrown when the
+         * text is not an IPv4 subnet. In a constant expression this is a
+         * compile error instead.
+         */
+        constexpr Inet4Subnet parseInet4SubnetLiteral(const char* p, size_t n) throw(sys::IllegalArgumentException)
+        {
+            size_t slash = findSlashLiteral(p, n);
+            return Inet4Subnet(parseInet4Literal(p, slash),
+                    parsePrefixLengthLiteral(p, n, slash, Inet4Address::BITS));
+        }
+
+        /**
+         * Parses an IPv6 subnet such as "fe80::/10", with the grammar of
+         * Subnet::tryParse(), at compile time when used in a constant
+         * expression.
+         * @exception frog::sys::IllegalArgumentException Thrown when the
+         * text is not an IPv6 subnet. In a constant expression this is a
+         * compile error instead.
+         */
+        constexpr Inet6Subnet parseInet6SubnetLiteral(const char* p, size_t n) throw(sys::IllegalArgumentException)
+        {
+            size_t slash = findSlashLiteral(p, n);
+            return Inet6Subnet(parseInet6Literal(p, slash),
+                    parsePrefixLengthLiteral(p, n, slash, Inet6Address::BITS));
+        }
+
+        /**
+         * @namespace frog::net::literals User-defined literals for
+         * addresses and subnets. A table declared @c constexpr is parsed
+         * by the compiler and placed in read-only data, so it costs
+         * nothing at start-up and a typo is a compile error:
+         * <PRE>
+         * using namespace frog::net::literals;
+         * constexpr Inet4Subnet privateNetworks[] = {
+         *     "10.0.0.0/8"_net4, "172.16.0.0/12"_net4, "192.168.0.0/16"_net4 };
+         * </PRE>
+         * Outside of a constant expression a bad literal throws
+         * frog::sys::IllegalArgumentException when it is evaluated.
+         */
+        inline namespace literals
+        {
+            constexpr Inet4Address operator"" _ip4(const char* p, size_t n) throw(sys::IllegalArgumentException)
+            {
+                return parseInet4Literal(p, n);
+            }
+
+            constexpr Inet6Address operator"" _ip6(const char* p, size_t n) throw(sys::IllegalArgumentException)
+            {
+                return parseInet6Literal(p, n);
+            }
+
+            constexpr Inet4Subnet operator"" _net4(const char* p, size_t n) throw(sys::IllegalArgumentException)
+            {
+                return parseInet4SubnetLiteral(p, n);
+            }
+
+            constexpr Inet6Subnet operator"" _net6(const char* p, size_t n) throw(sys::IllegalArgumentException)
+            {
+                return parseInet6SubnetLiteral(p, n);
+            }
+        } // literals ns
+    } // net ns
+} // frog ns
+
+#endif // __cplusplus >= 201402L
+
+#endif // FROG_NET_INETADDRESSLITERALS_H
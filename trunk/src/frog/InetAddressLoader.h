@@ -0,0 +1,149 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_INETADDRESSLOADER_H
+#define FROG_NET_INETADDRESSLOADER_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <new>
+#include <string>
+#include <vector>
+
+#include <frog/stdint.h>
+#include <frog/NonCopyable.h>
+#include <frog/InetAddressValue.h>
+#include <frog/IOException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * Loads large text files of IP addresses, one per line, into an
+         * array of InetAddressValue.
+         *
+         * The file is mapped into memory and cut at line boundaries into
+         * one chunk per thread. Each thread first counts the lines of its
+         * chunk, so that every thread knows the number of its first line
+         * and where its results go in the output array, and then parses
+         * its lines with InetAddress::tryParse() straight into that array.
+         * Nothing is allocated per line and the threads share nothing
+         * but the output array, so the load scales with the number of
+         * cores.
+         *
+         * Spaces, tabs and carriage returns around an address are
+         * ignored, as are empty lines and lines that start with '#'.
+         * Lines that hold no valid address are not loaded; their numbers
+         * are returned by getBadLines().
+         */
+        class InetAddressLoader : private NonCopyable
+        {
+          public:
+              /**
+               * Creates a loader.
+               * @param[in] threads The number of threads to use. 0 uses one
+               * thread per online processor.
+               */
+              explicit InetAddressLoader(size_t threads = 0) throw();
+
+              /**
+               * Loads the addresses of a file, replacing those loaded
+               * before. An empty file clears them.
+               * @param[in] path The path of the file.
+               * @exception frog::sys::IOException Thrown when the file
+               * cannot be mapped. The addresses loaded before are kept.
+               * @exception std::bad_alloc Thrown when memory is short. The
+               * loader is then empty.
+               */
+              void load(const std::string& path) throw(sys::IOException, std::bad_alloc);
+
+              /**
+               * Loads the addresses of a text held in memory, replacing
+               * those loaded before.
+               * @param[in] text The text.
+               * @param[in] size The size of @arg text in bytes.
+               * @exception std::bad_alloc Thrown when memory is short. The
+               * loader is then empty.
+               */
+              void load(const char* text, size_t size) throw(std::bad_alloc);
+
+              /**
+               * Returns the addresses loaded, in the order of the lines.
+               */
+              const std::vector<InetAddressValue>& getValues() const throw()
+              {
+                  return values_;
+              }
+
+              /**
+               * Returns the numbers of the lines that hold no valid address,
+               * in increasing order. The first line is line 1.
+               */
+              const std::vector<size_t>& getBadLines() const throw()
+              {
+                  return badLines_;
+              }
+
+              /**
+               * Returns the number of threads used by load().
+               */
+              size_t getThreadCount() const throw()
+              {
+                  return threads_;
+              }
+          private:
+              /**
+               * Does the work of load(const char*, size_t), which empties
+               * the loader when this throws.
+               */
+              void loadChunks(const char* text, size_t size);
+
+              /**
+               * The number of threads.
+               */
+              size_t threads_;
+
+              /**
+               * The addresses loaded.
+               */
+              std::vector<InetAddressValue> values_;
+
+              /**
+               * The numbers of the bad lines.
+               */
+              std::vector<size_t> badLines_;
+        }; // InetAddressLoader cls
+    } // net ns
+} // frog ns
+#endif // FROG_NET_INETADDRESSLOADER_H
@@ -0,0 +1,257 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_INETADDRESSRANGESET_H
+#define FROG_NET_INETADDRESSRANGESET_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <frog/stdint.h>
+#include <frog/Object.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/Word128.h>
+#include <frog/Subnet.h>
+#include <frog/IllegalArgumentException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * A set of IP addresses made up of address ranges and subnets,
+         * such as an allow or a deny list.
+         *
+         * Entries are added with add() and merged by compact(): the set
+         * then holds sorted, disjoint and non-adjacent ranges, IPv4 ranges
+         * before IPv6 ranges and each ordered by the numeric (big-endian)
+         * value of the address. contains() runs a branch-free binary
+         * search over a copy of the ranges kept in Eytzinger
+         * (breadth-first) order, which needs one cache line per few levels
+         * of the search. Scope ids are ignored.
+         *
+         * contains() never modifies the set: until compact() is called
+         * after the last add() it scans the ranges one by one. The other
+         * queries call compact() themselves. Once compacted, the set can
+         * be queried by many threads at the same time. add() and
+         * compact() must not run concurrently with any other member.
+         * <HR>
+         * <H3>Inherits from:</H3>
+         *     &nbsp;&nbsp;&nbsp;&nbsp;&nbsp;
+         *     Object
+         * <HR>
+         */
+        class InetAddressRangeSet : public Object
+        {
+          public:
+              /**
+               * A 128-bit number, most significant word first.
+               */
+              typedef net::Word128 Word128;
+
+              /**
+               * An inclusive range of addresses, as numbers. IPv4 ranges use
+               * @c uint32_t and IPv6 ranges use Word128.
+               */
+              template <typename K>
+                  struct Range
+                  {
+                      K first; /**< First address of the range */
+                      K last; /**< Last address of the range */
+                  };
+
+              /**
+               * Type of a list of ranges as returned by getRanges().
+               */
+              typedef std::vector<std::pair<InetAddress, InetAddress> > RangeList;
+
+              /**
+               * Creates an empty set.
+               */
+              InetAddressRangeSet() throw();
+
+              /**
+               * Copy constructor.
+               */
+              InetAddressRangeSet(const InetAddressRangeSet& set);
+
+              /**
+               * Default destructor.
+               */
+              virtual ~InetAddressRangeSet() throw() { }
+
+              /**
+               * Copies a set to another set.
+               */
+              InetAddressRangeSet& operator=(const InetAddressRangeSet& set);
+
+              /**
+               * Tests for set equality: both sets hold the same addresses.
+               */
+              bool operator==(const InetAddressRangeSet& set) const;
+
+              /**
+               * Tests for set inequality.
+               */
+              bool operator!=(const InetAddressRangeSet& set) const;
+
+              /**
+               * Adds every address of a subnet.
+               * @exception frog::sys::IllegalArgumentException Thrown when the
+               * subnet is empty.
+               */
+              void add(const Subnet& subnet) throw(sys::IllegalArgumentException);
+
+              /**
+               * Adds an inclusive range of addresses.
+               * @param[in] first The first address of the range.
+               * @param[in] last The last address of the range.
+               * @exception frog::sys::IllegalArgumentException Thrown when the
+               * addresses are of different or unspecified families or when
+               * @arg last comes before @arg first.
+               */
+              void add(const InetAddress& first, const InetAddress& last)
+                  throw(sys::IllegalArgumentException);
+
+              /**
+               * Adds a single address.
+               * @exception frog::sys::IllegalArgumentException Thrown when the
+               * address family is unspecified.
+               */
+              void add(const InetAddress& addr) throw(sys::IllegalArgumentException);
+
+              /**
+               * Sorts and merges the ranges added since the last call and
+               * rebuilds the search index. Call it once the set is built
+               * and before contains() is used, or shared between threads.
+               */
+              void compact() const;
+
+              /**
+               * Tests if an address is in this set. Takes logarithmic time
+               * once the set is compacted and linear time before.
+               * @param[in] addr The address to test.
+               * @return Returns @c true if @arg addr is in this set;
+               * @c false otherwise.
+               */
+              bool contains(const InetAddressValue& addr) const throw();
+
+              /**
+               * Tests if an address is in this set. See
+               * InetAddressRangeSet::contains(const InetAddressValue&).
+               */
+              bool contains(const InetAddress& addr) const throw()
+              {
+                  return contains(addr.getValue());
+              }
+
+              /**
+               * Returns the addresses that are in this set or in @arg set.
+               */
+              InetAddressRangeSet setUnion(const InetAddressRangeSet& set) const;
+
+              /**
+               * Returns the addresses that are in both this set and @arg set.
+               */
+              InetAddressRangeSet setIntersection(const InetAddressRangeSet& set) const;
+
+              /**
+               * Returns the addresses that are in this set but not in @arg set.
+               */
+              InetAddressRangeSet setDifference(const InetAddressRangeSet& set) const;
+
+              /**
+               * Returns the smallest list of subnets that holds exactly the
+               * addresses of this set, in the order of the set. This is the
+               * form most firewalls accept.
+               */
+              std::vector<Subnet> toCidrs() const;
+
+              /**
+               * Returns the merged ranges of this set, in order.
+               */
+              RangeList getRanges() const;
+
+              /**
+               * Returns the number of merged ranges in this set.
+               */
+              size_t getRangeCount() const;
+
+              /**
+               * Tests if this set holds no address.
+               */
+              bool isEmpty() const throw();
+
+              /**
+               * Returns the ranges of this set, for example
+               * <I>{10.0.0.0-10.255.255.255, 2001:db8::-2001:db8::ff}</I>.
+               */
+              virtual std::string toString() const throw();
+          private:
+              /**
+               * Rebuilds the search index from the merged ranges.
+               */
+              void buildIndex() const;
+
+              /**
+               * IPv4 ranges. Sorted and merged unless dirty_ is set.
+               */
+              mutable std::vector<Range<uint32_t> > ranges4_;
+
+              /**
+               * IPv6 ranges. Sorted and merged unless dirty_ is set.
+               */
+              mutable std::vector<Range<Word128> > ranges6_;
+
+              /**
+               * IPv4 ranges in Eytzinger order, starting at index 1.
+               */
+              mutable std::vector<Range<uint32_t> > index4_;
+
+              /**
+               * IPv6 ranges in Eytzinger order, starting at index 1.
+               */
+              mutable std::vector<Range<Word128> > index6_;
+
+              /**
+               * Set when ranges were added since the last compact().
+               */
+              mutable bool dirty_;
+        }; // InetAddressRangeSet cls
+    } // net ns
+} // frog ns
+#endif // FROG_NET_INETADDRESSRANGESET_H
@@ -0,0 +1,124 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_INETADDRESSSORT_H
+#define FROG_NET_INETADDRESSSORT_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cstddef>
+#include <vector>
+
+#include <frog/stdint.h>
+#include <frog/InetAddressValue.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * @name Sorting and set operations on address arrays
+         * These work on arrays of InetAddressValue in the order of
+         * InetAddressValue::compare(): by family, then by address and then
+         * by scope id. The set operations take arrays that are sorted and
+         * free of repeated values, as left by sortAddresses() and
+         * uniqueAddresses(), and write sorted, repeat-free arrays.
+         */
+        //@{
+        /**
+         * Sorts addresses with a radix sort, one byte per pass, on several
+         * threads. Bytes that are the same in every address are skipped.
+         * When at most four bytes vary, as in an array of IPv4 addresses,
+         * the addresses are sorted from the least significant byte up;
+         * otherwise they are split on the most significant byte that
+         * varies and each part is sorted the same way. The sort is stable
+         * and uses a second array as large as the first.
+         * @param[in,out] values The addresses to sort.
+         * @param[in] count The number of addresses.
+         * @param[in] threads The number of threads, or 0 for one per
+         * online processor.
+         */
+        void sortAddresses(InetAddressValue* values, size_t count, size_t threads = 0) throw();
+
+        /**
+         * Sorts addresses. See sortAddresses(InetAddressValue*, size_t, size_t).
+         */
+        inline void sortAddresses(std::vector<InetAddressValue>& values, size_t threads = 0) throw()
+        {
+            if(!values.empty())
+            {
+                sortAddresses(&values[0], values.size(), threads);
+            }
+        }
+
+        /**
+         * Removes repeated addresses from a sorted array, keeping the
+         * first of each.
+         * @return The number of addresses left at the start of @arg values.
+         */
+        size_t uniqueAddresses(InetAddressValue* values, size_t count) throw();
+
+        /**
+         * Writes the addresses that are in @arg a or in @arg b.
+         * @param[out] out Receives at most @arg countA + @arg countB
+         * addresses. It must not overlap the inputs.
+         * @return The number of addresses written.
+         */
+        size_t mergeAddresses(const InetAddressValue* a, size_t countA,
+                const InetAddressValue* b, size_t countB, InetAddressValue* out) throw();
+
+        /**
+         * Writes the addresses that are in both @arg a and @arg b. When one
+         * array is much smaller, each of its addresses is looked up in the
+         * other with a galloping search, so the time grows with the size
+         * of the smaller array times the logarithm of the ratio.
+         * @param[out] out Receives at most the smaller of @arg countA and
+         * @arg countB addresses. It may be @arg a.
+         * @return The number of addresses written.
+         */
+        size_t intersectAddresses(const InetAddressValue* a, size_t countA,
+                const InetAddressValue* b, size_t countB, InetAddressValue* out) throw();
+
+        /**
+         * Writes the addresses of @arg a that are not in @arg b, skipping
+         * over runs of @arg b with a galloping search.
+         * @param[out] out Receives at most @arg countA addresses. It may be
+         * @arg a.
+         * @return The number of addresses written.
+         */
+        size_t differenceAddresses(const InetAddressValue* a, size_t countA,
+                const InetAddressValue* b, size_t countB, InetAddressValue* out) throw();
+        //@}
+    } // net ns
+} // frog ns
+#endif // FROG_NET_INETADDRESSSORT_H
@@ -0,0 +1,669 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_INETADDRESSVALUE_H
+#define FROG_NET_INETADDRESSVALUE_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <cstddef>
+#include <cstring>
+
+#include <frog/stdint.h>
+#include <frog/AddressFamily.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * A compact, plain-old-data form of an InetAddress. It holds the
+         * same information as an InetAddress in 24 bytes, has no virtual
+         * functions and no constructors, so arrays of it can be copied
+         * with @c memcpy, written to disk or shared between processes.
+         * It is meant for large tables of addresses; convert to and from
+         * InetAddress with InetAddress::getValue() and
+         * InetAddress::InetAddress(const InetAddressValue&).
+         *
+         * Every byte of the value is significant, including @c reserved
+         * which must be zero, so two values are equal exactly when
+         * their bytes are equal. A zero-filled value is the unspecified
+         * address.
+         *
+         * With GCC the value is 8-byte aligned, so that it is three
+         * aligned 64-bit words for operator==() and hash().
+         */
+#ifdef __GNUC__
+        struct __attribute__((aligned(8))) InetAddressValue
+#else
+        struct InetAddressValue
+#endif
+        {
+            /**
+             * Starting offset of an IPv4 address in @c address.
+             */
+            static const size_t IPV4_OFFSET = 12U;
+
+            /**
+             * @name Flags returned by classify()
+             * Each flag matches the predicate of the same name.
+             */
+            //@{
+            static const uint32_t CLASS_IPV4 = 0x0001U; /**< isIPv4() */
+            static const uint32_t CLASS_IPV6 = 0x0002U; /**< isIPv6() */
+            static const uint32_t CLASS_IPV4_COMPATIBLE = 0x0004U; /**< isIPv4Compatible() */
+            static const uint32_t CLASS_ANY_LOCAL = 0x0008U; /**< isAnyLocalAddress() */
+            static const uint32_t CLASS_LOOPBACK = 0x0010U; /**< isLoopbackAddress() */
+            static const uint32_t CLASS_LINK_LOCAL = 0x0020U; /**< isLinkLocalAddress() */
+            static const uint32_t CLASS_SITE_LOCAL = 0x0040U; /**< isSiteLocalAddress() */
+            static const uint32_t CLASS_MULTICAST = 0x0080U; /**< isMulticastAddress() */
+            static const uint32_t CLASS_MULTICAST_GLOBAL = 0x0100U; /**< isMulticastGlobal() */
+            static const uint32_t CLASS_MULTICAST_NODE_LOCAL = 0x0200U; /**< isMulticastNodeLocal() */
+            static const uint32_t CLASS_MULTICAST_LINK_LOCAL = 0x0400U; /**< isMulticastLinkLocal() */
+            static const uint32_t CLASS_MULTICAST_SITE_LOCAL = 0x0800U; /**< isMulticastSiteLocal() */
+            static const uint32_t CLASS_MULTICAST_ORG_LOCAL = 0x1000U; /**< isMulticastOrgLocal() */
+            //@}
+
+            /**
+             * The raw IP address in network byte order. An IPv6 address
+             * uses all 16 bytes, an IPv4 address uses the last 4 bytes
+             * and the first 12 bytes are zero.
+             */
+            uint8_t address[16];
+
+            /**
+             * The scope id of an IPv6 address; zero otherwise.
+             */
+            uint32_t scope;
+
+            /**
+             * The address family: AddressFamily::InterNetwork,
+             * AddressFamily::InterNetworkV6 or AddressFamily::Unspecified.
+             */
+            AddressFamily::TYPE family;
+
+            /**
+             * Padding. This is always zero.
+             */
+            uint16_t reserved;
+
+            /**
+             * Checks if this is an IPv4 address.
+             */
+            bool isIPv4() const throw()
+            {
+                return (family == AF_INET);
+            }
+
+            /**
+             * Checks if this is an IPv6 address.
+             */
+            bool isIPv6() const throw()
+            {
+                return (family == AF_INET6);
+            }
+
+            /**
+             * Checks if this is an IPv4 address or an IPv4-compatible
+             * IPv6 address. This is the value of InetAddress::isIPv4Compatible().
+             */
+            bool isIPv4Compatible() const throw()
+            {
+                if(family != AF_INET6)
+                {
+                    return true;
+                }
+                uint64_t tail = low();
+                return ((high() == 0) && ((tail >> 32) == 0) && (tail > 1U));
+            }
+
+            /**
+             * Checks if this is an IPv4-mapped IPv6 address, ::ffff:a.b.c.d,
+             * which is how a dual-stack socket reports an IPv4 peer.
+             */
+            bool isIPv4Mapped() const throw()
+            {
+                return (family == AF_INET6) & (high() == 0) & ((low() >> 32) == 0xffffU);
+            }
+
+            /**
+             * Returns the canonical form of this value: an IPv4-mapped IPv6
+             * address becomes the IPv4 address it maps and any other value
+             * is returned as is. Canonical values of ::ffff:10.0.0.1 and
+             * 10.0.0.1 are equal and hash alike.
+             */
+            InetAddressValue canonical() const throw()
+            {
+                // On whole words and without a branch: byte stores
+                // followed by the word loads of hash() and operator==()
+                // would stall, and dual-stack peers are mapped or not at
+                // random.
+                // The ffff of the mapped prefix, then the tail word of an
+                // IPv4 value: scope 0, AF_INET and no padding.
+                uint8_t bytes[sizeof(uint64_t)] = { 0, 0, 0xff, 0xff, 0, 0, 0, 0 };
+                uint64_t prefix;
+                ::memcpy(&prefix, bytes, sizeof(prefix));
+                AddressFamily::TYPE inet = AF_INET;
+                ::memset(bytes, 0, sizeof(bytes));
+                ::memcpy(bytes + offsetof(InetAddressValue, family) - 2 * sizeof(uint64_t), &inet, sizeof(inet));
+                uint64_t tail;
+                ::memcpy(&tail, bytes, sizeof(tail));
+
+                uint64_t mapped = 0 - static_cast<uint64_t>(isIPv4Mapped());
+                uint64_t words[3] = { loadWord(0), loadWord(1) & ~(prefix & mapped),
+                    (loadWord(2) & ~mapped) | (tail & mapped) };
+                InetAddressValue value;
+                ::memcpy(&value, words, sizeof(value));
+                return value;
+            }
+
+            /**
+             * Checks if this IP address is a wildcard addess.
+             */
+            bool isAnyLocalAddress() const throw()
+            {
+                if(family == AF_INET)
+                {
+                    return ((low() & 0xffffffffU) == 0);
+                }
+                else if(family == AF_INET6)
+                {
+                    return ((high() | low()) == 0);
+                }
+                return false;
+            }
+
+            /**
+             * Checks to see if this is a loopback address.
+             */
+            bool isLoopbackAddress() const throw()
+            {
+                if(family == AF_INET)
+                {
+                    return (address[IPV4_OFFSET + 0] == 127U);
+                }
+                else if(family == AF_INET6)
+                {
+                    return ((high() == 0) && (low() == 1U));
+                }
+                return false;
+            }
+
+            /**
+             * Checks if this is an IP multicast address.
+             */
+            bool isMulticastAddress() const throw()
+            {
+                if(family == AF_INET)
+                {
+                    return ((address[IPV4_OFFSET + 0] & 0xf0U) == 224U);
+                }
+                else if(family == AF_INET6)
+                {
+                    return (address[0] == 0xffU);
+                }
+                return false;
+            }
+
+            /**
+             * Checks to see if this is a link local unicast address.
+             */
+            bool isLinkLocalAddress() const throw()
+            {
+                if(family == AF_INET)
+                {
+                    return ((address[IPV4_OFFSET + 0] == 169U) &&
+                            (address[IPV4_OFFSET + 1] == 254U));
+                }
+                else if(family == AF_INET6)
+                {
+                    return ((address[0] == 0xfeU) && ((address[1] & 0xc0U) == 0x80U));
+                }
+                return false;
+            }
+
+            /**
+             * Checks to see if this is a site local unicast address.
+             */
+            bool isSiteLocalAddress() const throw()
+            {
+                if(family == AF_INET)
+                {
+                    return (address[IPV4_OFFSET + 0] == 10U) ||
+                        ((address[IPV4_OFFSET + 0] == 172U) && (address[IPV4_OFFSET + 1] == 16U)) ||
+                        ((address[IPV4_OFFSET + 0] == 192U) && (address[IPV4_OFFSET + 1] == 168U));
+                }
+                else if(family == AF_INET6)
+                {
+                    return ((address[0] == 0xfeU) && ((address[1] & 0xc0U) == 0xc0U));
+                }
+                return false;
+            }
+
+            /**
+             * Checks to see if this if a multicast address has global scope.
+             */
+            bool isMulticastGlobal() const throw()
+            {
+                if(family == AF_INET)
+                {
+                    return ((address[IPV4_OFFSET + 0] >= 224U) && (address[IPV4_OFFSET + 0] <= 238U)) &&
+                        !((address[IPV4_OFFSET + 0] == 224U) && (address[IPV4_OFFSET + 1] == 0) &&
+                                (address[IPV4_OFFSET + 2] == 0));
+                }
+                else if(family == AF_INET6)
+                {
+                    return ((address[0] == 0xffU) && ((address[1] & 0x0fU) == 0x0eU));
+                }
+                return false;
+            }
+
+            /**
+             * Checks to see if this if a multicast address has node scope.
+             */
+            bool isMulticastNodeLocal() const throw()
+            {
+                if(family == AF_INET6)
+                {
+                    return ((address[0] == 0xffU) && ((address[1] & 0x0fU) == 0x01U));
+                }
+                // IPv4 has no node scope, unless ttl == 0
+                return false;
+            }
+
+            /**
+             * Checks to see if the multicast address has link scope.
+             */
+            bool isMulticastLinkLocal() const throw()
+            {
+                if(family == AF_INET)
+                {
+                    return (address[IPV4_OFFSET + 0] == 224U) &&
+                        (address[IPV4_OFFSET + 1] == 0) && (address[IPV4_OFFSET + 2] == 0);
+                }
+                else if(family == AF_INET6)
+                {
+                    return ((address[0] == 0xffU) && ((address[1] & 0x0fU) == 0x02U));
+                }
+                return false;
+            }
+
+            /**
+             * Checks to see if the multicast address has site-local scope.
+             */
+            bool isMulticastSiteLocal() const throw()
+            {
+                if(family == AF_INET)
+                {
+                    return (address[IPV4_OFFSET + 0] == 239U) && (address[IPV4_OFFSET + 1] == 255U);
+                }
+                else if(family == AF_INET6)
+                {
+                    return ((address[0] == 0xffU) && ((address[1] & 0x0fU) == 0x05U));
+                }
+                return false;
+            }
+
+            /**
+             * Checks to see if the multicast address has organization scope.
+             */
+            bool isMulticastOrgLocal() const throw()
+            {
+                if(family == AF_INET)
+                {
+                    return ((address[IPV4_OFFSET + 0] == 239U) &&
+                            (address[IPV4_OFFSET + 1] >= 192U) && (address[IPV4_OFFSET + 1] <= 195U));
+                }
+                else if(family == AF_INET6)
+                {
+                    return ((address[0] == 0xffU) && ((address[1] & 0x0fU) == 0x08U));
+                }
+                return false;
+            }
+
+            /**
+             * Computes all the properties tested by the predicates above in
+             * one pass, without loops and with few branches. The address is
+             * read as words instead of one byte at a time.
+             * @return A combination of the CLASS_* flags; 0 when the family
+             * is unspecified.
+             */
+            uint32_t classify() const throw()
+            {
+                if(family == AF_INET)
+                {
+                    return classify4(static_cast<uint32_t>(low()));
+                }
+                else if(family == AF_INET6)
+                {
+                    return classify6(high(), low());
+                }
+                return 0;
+            }
+
+            /**
+             * Classifies an IPv4 address given as a number, like classify()
+             * does for an InetAddressValue of the AF_INET family.
+             * @param[in] v The address in host byte order.
+             */
+            static uint32_t classify4(uint32_t v) throw()
+            {
+                uint32_t top8 = v >> 24, top16 = v >> 16;
+                bool linkScope = ((v >> 8) == 0xe00000U);
+                bool multicast = ((v >> 28) == 0xeU);
+                return CLASS_IPV4 | CLASS_IPV4_COMPATIBLE |
+                    select(v == 0, CLASS_ANY_LOCAL) |
+                    select(top8 == 127U, CLASS_LOOPBACK) |
+                    select(top16 == 0xa9feU, CLASS_LINK_LOCAL) |
+                    select((top8 == 10U) | (top16 == 0xac10U) | (top16 == 0xc0a8U), CLASS_SITE_LOCAL) |
+                    select(multicast, CLASS_MULTICAST) |
+                    select(multicast & (top8 != 239U) & !linkScope, CLASS_MULTICAST_GLOBAL) |
+                    select(linkScope, CLASS_MULTICAST_LINK_LOCAL) |
+                    select(top16 == 0xefffU, CLASS_MULTICAST_SITE_LOCAL) |
+                    select((v >> 18) == (0xefc0U >> 2), CLASS_MULTICAST_ORG_LOCAL);
+            }
+
+            /**
+             * Classifies an IPv6 address given as two numbers, like
+             * classify() does for an InetAddressValue of the AF_INET6
+             * family.
+             * @param[in] hi The first 8 bytes of the address, see high().
+             * @param[in] lo The last 8 bytes of the address, see low().
+             */
+            static uint32_t classify6(uint64_t hi, uint64_t lo) throw()
+            {
+                static const uint16_t scopeFlags[16] = {
+                    0, CLASS_MULTICAST_NODE_LOCAL, CLASS_MULTICAST_LINK_LOCAL, 0, 0,
+                    CLASS_MULTICAST_SITE_LOCAL, 0, 0, CLASS_MULTICAST_ORG_LOCAL, 0, 0, 0, 0, 0,
+                    CLASS_MULTICAST_GLOBAL, 0 };
+                uint32_t top = static_cast<uint32_t>(hi >> 48);
+                bool zeroPrefix = ((hi | (lo >> 32)) == 0);
+                return CLASS_IPV6 |
+                    select(zeroPrefix & (lo > 1U), CLASS_IPV4_COMPATIBLE) |
+                    select(zeroPrefix & (lo == 0), CLASS_ANY_LOCAL) |
+                    select(zeroPrefix & (lo == 1U), CLASS_LOOPBACK) |
+                    select((top >> 6) == (0xfe80U >> 6), CLASS_LINK_LOCAL) |
+                    select((top >> 6) == (0xfec0U >> 6), CLASS_SITE_LOCAL) |
+                    select((top >> 8) == 0xffU, CLASS_MULTICAST | scopeFlags[top & 0x0fU]);
+            }
+
+            /**
+             * Classifies an array of values: <TT>out[i] = values[i].classify()</TT>.
+             * On x86 the widest of AVX2 and SSE2 supported by the processor
+             * is picked at run time; other hosts use classify().
+             * @param[in] values The values to classify.
+             * @param[in] count The number of values.
+             * @param[out] out Receives @arg count flag sets.
+             */
+            static void classifyBatch(const InetAddressValue* values, size_t count, uint32_t* out) throw();
+
+            /**
+             * Returns a 64-bit hash of the address, family and scope. The
+             * address is read as two 64-bit words and mixed with a
+             * multiply-rotate step and the MurmurHash3 finalizer, so there
+             * is no loop over the bytes. Equal values have equal hashes.
+             * The hash depends on the byte order of the host and must not
+             * be stored.
+             * @param[in] seed Extra data to mix in, for example a port.
+             */
+            uint64_t hash(uint64_t seed = 0) const throw()
+            {
+                uint64_t high, low;
+                ::memcpy(&high, address, sizeof(high));
+                ::memcpy(&low, address + sizeof(high), sizeof(low));
+
+                uint64_t tail = (static_cast<uint64_t>(scope) << 16) ^ family;
+                high ^= (tail + seed) * 0x9E3779B97F4A7C15ULL;
+                high *= 0x87C37B91114253D5ULL;
+                low ^= seed;
+                low *= 0x4CF5AD432745937FULL;
+                return mix64(high ^ ((low << 31) | (low >> 33)));
+            }
+
+            /**
+             * Size of the key written by sortKey().
+             */
+            static const size_t SORT_KEY_SIZE = 20U;
+
+            /**
+             * Returns the first 8 bytes of the address as a big-endian
+             * number, so that comparing high() and then low() compares
+             * the addresses numerically.
+             */
+            uint64_t high() const throw()
+            {
+                return loadBigEndian64(address);
+            }
+
+            /**
+             * Returns the last 8 bytes of the address as a big-endian number.
+             */
+            uint64_t low() const throw()
+            {
+                return loadBigEndian64(address + 8);
+            }
+
+            /**
+             * Compares two values. Values are ordered by family, then by
+             * the numeric (big-endian) value of the address and then by
+             * scope id. The address is compared as two 64-bit words.
+             * @return A negative number, zero or a positive number if this
+             * value is less than, equal to or greater than @arg other.
+             */
+            int compare(const InetAddressValue& other) const throw()
+            {
+                if(family != other.family)
+                {
+                    return (family < other.family) ? -1 : 1;
+                }
+
+                uint64_t a = high(), b = other.high();
+                if(a != b)
+                {
+                    return (a < b) ? -1 : 1;
+                }
+
+                a = low();
+                b = other.low();
+                if(a != b)
+                {
+                    return (a < b) ? -1 : 1;
+                }
+
+                if(scope != other.scope)
+                {
+                    return (scope < other.scope) ? -1 : 1;
+                }
+                return 0;
+            }
+
+            /**
+             * Writes a key of SORT_KEY_SIZE bytes whose @c memcmp order is
+             * the order of compare(): one byte of family, the 16 address
+             * bytes and the scope id as a 24-bit big-endian number. Scope
+             * ids above 0xFFFFFF, which do not occur in practice, all get
+             * the same key. Keys can be used for radix sorts and byte-wise
+             * merges.
+             * @param[out] key Receives SORT_KEY_SIZE bytes.
+             */
+            void sortKey(uint8_t* key) const throw()
+            {
+                uint32_t s = (scope > 0xFFFFFFU) ? 0xFFFFFFU : scope;
+                key[0] = static_cast<uint8_t>(family);
+                ::memcpy(key + 1, address, sizeof(address));
+                key[17] = static_cast<uint8_t>(s >> 16);
+                key[18] = static_cast<uint8_t>(s >> 8);
+                key[19] = static_cast<uint8_t>(s);
+            }
+
+            /**
+             * Orders values as described in compare().
+             */
+            bool operator<(const InetAddressValue& other) const throw()
+            {
+                return (compare(other) < 0);
+            }
+
+            /**
+             * Orders values as described in compare().
+             */
+            bool operator>(const InetAddressValue& other) const throw()
+            {
+                return (compare(other) > 0);
+            }
+
+            /**
+             * Orders values as described in compare().
+             */
+            bool operator<=(const InetAddressValue& other) const throw()
+            {
+                return (compare(other) <= 0);
+            }
+
+            /**
+             * Orders values as described in compare().
+             */
+            bool operator>=(const InetAddressValue& other) const throw()
+            {
+                return (compare(other) >= 0);
+            }
+
+            /**
+             * Tests for equality of address, family and scope.
+             */
+            bool operator==(const InetAddressValue& other) const throw()
+            {
+                // Three 64-bit words: the address, then scope, family and
+                // padding.
+                return ((loadWord(0) ^ other.loadWord(0)) | (loadWord(1) ^ other.loadWord(1)) |
+                        (loadWord(2) ^ other.loadWord(2))) == 0;
+            }
+
+            /**
+             * Tests for inequality of address, family or scope.
+             */
+            bool operator!=(const InetAddressValue& other) const throw()
+            {
+                return !(*this == other);
+            }
+
+          private:
+            /**
+             * Returns the 64-bit word @arg i of the value, in host byte
+             * order.
+             */
+            uint64_t loadWord(size_t i) const throw()
+            {
+                uint64_t word;
+                ::memcpy(&word, reinterpret_cast<const uint8_t*>(this) + i * sizeof(word), sizeof(word));
+                return word;
+            }
+
+            /**
+             * Returns @arg flag if @arg condition holds and 0 otherwise,
+             * without a branch.
+             */
+            static uint32_t select(bool condition, uint32_t flag) throw()
+            {
+                return (0U - static_cast<uint32_t>(condition)) & flag;
+            }
+
+            /**
+             * Reads 8 bytes as a big-endian number. Compilers turn this
+             * into a single load and byte swap.
+             */
+            static uint64_t loadBigEndian64(const uint8_t* p) throw()
+            {
+                return (static_cast<uint64_t>(p[0]) << 56) | (static_cast<uint64_t>(p[1]) << 48) |
+                    (static_cast<uint64_t>(p[2]) << 40) | (static_cast<uint64_t>(p[3]) << 32) |
+                    (static_cast<uint64_t>(p[4]) << 24) | (static_cast<uint64_t>(p[5]) << 16) |
+                    (static_cast<uint64_t>(p[6]) << 8) | static_cast<uint64_t>(p[7]);
+            }
+
+            /**
+             * The MurmurHash3 64-bit finalizer.
+             */
+            static uint64_t mix64(uint64_t h) throw()
+            {
+                h ^= h >> 33;
+                h *= 0xFF51AFD7ED558CCDULL;
+                h ^= h >> 33;
+                h *= 0xC4CEB9FE1A85EC53ULL;
+                h ^= h >> 33;
+                return h;
+            }
+        }; // InetAddressValue struct
+
+        /**
+         * Hash function object for InetAddressValue, for use with hash
+         * based containers.
+         */
+        struct InetAddressValueHash
+        {
+            size_t operator()(const InetAddressValue& value) const throw()
+            {
+                return static_cast<size_t>(value.hash());
+            }
+        };
+
+        /**
+         * Hash function object for InetAddressValue that hashes the
+         * canonical() form, so that IPv4-mapped IPv6 addresses and the IPv4
+         * addresses they map are one key. Use it with
+         * InetAddressValueCanonicalEqual.
+         */
+        struct InetAddressValueCanonicalHash
+        {
+            size_t operator()(const InetAddressValue& value) const throw()
+            {
+                return static_cast<size_t>(value.canonical().hash());
+            }
+        };
+
+        /**
+         * Equality function object for InetAddressValue that compares the
+         * canonical() forms.
+         */
+        struct InetAddressValueCanonicalEqual
+        {
+            bool operator()(const InetAddressValue& a, const InetAddressValue& b) const throw()
+            {
+                return a.canonical() == b.canonical();
+            }
+        };
+    } // net ns
+} // frog ns
+
+#endif // FROG_NET_INETADDRESSVALUE_H
@@ -0,0 +1,364 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+#ifndef FROG_NET_IPV4SET_H
+#define FROG_NET_IPV4SET_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string>
+#include <vector>
+
+#include <frog/stdint.h>
+#include <frog/Object.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/Inet4Address.h>
+#include <frog/Subnet.h>
+#include <frog/IllegalArgumentException.h>
+#include <frog/FormatException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * A set of IPv4 addresses kept as a roaring bitmap, for sets that
+         * may hold millions of addresses anywhere in the IPv4 space, such
+         * as the sources seen in a minute of traffic.
+         *
+         * Addresses are grouped by their first 16 bits into containers of
+         * up to 65536 addresses, kept in order of those bits. A container
+         * holds its last 16 bits in one of three forms:
+         * <UL>
+         * <LI>an <I>array</I>, a sorted array of up to 4096 16-bit values;</LI>
+         * <LI>a <I>bitmap</I> of 65536 bits, for more than 4096 addresses;</LI>
+         * <LI>a list of <I>runs</I>, a first value and a length, for ranges
+         *     of consecutive addresses.</LI>
+         * </UL>
+         * Single adds and removes keep arrays and bitmaps. Ranges, set
+         * operations and optimize() use runs when they take less memory.
+         * Unions, intersections and cardinalities of bitmaps run 256 bits
+         * at a time when the processor supports AVX2.
+         *
+         * serialize() writes the portable format of the Roaring bitmap
+         * libraries, so sets can be exchanged with programs that use
+         * them, on hosts of either byte order.
+         *
+         * IPv4-mapped IPv6 addresses are taken as the IPv4 addresses they
+         * hold. Like the other containers, a set can be read by many
+         * threads at the same time, but not while it is changed.
+         * <HR>
+         * <H3>Inherits from:</H3>
+         *     &nbsp;&nbsp;&nbsp;&nbsp;&nbsp;
+         *     Object
+         * <HR>
+         */
+        class Ipv4Set : public Object
+        {
+          public:
+              /**
+               * Creates an empty set.
+               */
+              Ipv4Set() throw();
+
+              /**
+               * Copy constructor.
+               */
+              Ipv4Set(const Ipv4Set& set);
+
+              /**
+               * Default destructor.
+               */
+              virtual ~Ipv4Set() throw();
+
+              /**
+               * Copies a set to another set.
+               */
+              Ipv4Set& operator=(const Ipv4Set& set);
+
+              /**
+               * Tests for set equality: both sets hold the same addresses,
+               * whatever the forms of their containers.
+               */
+              bool operator==(const Ipv4Set& set) const throw();
+
+              /**
+               * Tests for set inequality.
+               */
+              bool operator!=(const Ipv4Set& set) const throw()
+              {
+                  return !(*this == set);
+              }
+
+              /**
+               * Adds an address.
+               * @param[in] address The address in host byte order.
+               * @return Returns @c true if the address was added; @c false
+               * if it was already in this set.
+               */
+              bool add(uint32_t address);
+
+              /**
+               * Adds an address. See Ipv4Set::add(uint32_t).
+               */
+              bool add(const Inet4Address& address)
+              {
+                  return add(address.getWord());
+              }
+
+              /**
+               * Adds an IPv4 or an IPv4-mapped IPv6 address. See
+               * Ipv4Set::add(uint32_t).
+               * @exception frog::sys::IllegalArgumentException Thrown when the
+               * address is not an IPv4 address.
+               */
+              bool add(const InetAddress& address) throw(sys::IllegalArgumentException);
+
+              /**
+               * Adds an inclusive range of addresses.
+               * @param[in] first The first address, in host byte order.
+               * @param[in] last The last address, in host byte order.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * @arg last comes before @arg first.
+               */
+              void add(uint32_t first, uint32_t last) throw(sys::IllegalArgumentException);
+
+              /**
+               * Adds every address of an IPv4 subnet.
+               * @exception frog::sys::IllegalArgumentException Thrown when the
+               * subnet is not an IPv4 subnet.
+               */
+              void add(const Subnet& subnet) throw(sys::IllegalArgumentException);
+
+              /**
+               * Removes an address.
+               * @param[in] address The address in host byte order.
+               * @return Returns @c true if the address was removed; @c false
+               * if it was not in this set.
+               */
+              bool remove(uint32_t address);
+
+              /**
+               * Removes an IPv4 or an IPv4-mapped IPv6 address. Other
+               * addresses are never in a set. See Ipv4Set::remove(uint32_t).
+               */
+              bool remove(const InetAddress& address);
+
+              /**
+               * Tests if an address is in this set.
+               * @param[in] address The address in host byte order.
+               */
+              bool contains(uint32_t address) const throw();
+
+              /**
+               * Tests if an address is in this set.
+               */
+              bool contains(const Inet4Address& address) const throw()
+              {
+                  return contains(address.getWord());
+              }
+
+              /**
+               * Tests if an address is in this set. Addresses that are not
+               * IPv4 or IPv4-mapped addresses are never in a set.
+               */
+              bool contains(const InetAddressValue& address) const throw();
+
+              /**
+               * Tests if an address is in this set. See
+               * Ipv4Set::contains(const InetAddressValue&).
+               */
+              bool contains(const InetAddress& address) const throw()
+              {
+                  return contains(address.getValue());
+              }
+
+              /**
+               * Returns the number of addresses in this set.
+               */
+              uint64_t getCardinality() const throw();
+
+              /**
+               * Tests if this set holds no address.
+               */
+              bool isEmpty() const throw()
+              {
+                  return containers_.empty();
+              }
+
+              /**
+               * Removes every address.
+               */
+              void clear() throw();
+
+              /**
+               * Returns the addresses that are in this set or in @arg set.
+               */
+              Ipv4Set setUnion(const Ipv4Set& set) const;
+
+              /**
+               * Returns the addresses that are in both this set and @arg set.
+               */
+              Ipv4Set setIntersection(const Ipv4Set& set) const;
+
+              /**
+               * Returns the addresses that are in this set but not in @arg set.
+               */
+              Ipv4Set setDifference(const Ipv4Set& set) const;
+
+              /**
+               * Returns the number of addresses that are in both this set
+               * and @arg set, without building their intersection.
+               */
+              uint64_t intersectionCardinality(const Ipv4Set& set) const throw();
+
+              /**
+               * Returns the union of many sets. The containers of each group
+               * of 65536 addresses are combined into one bitmap and counted
+               * once, which is much faster than a chain of setUnion() calls.
+               * @param[in] sets The sets.
+               * @param[in] count The number of sets.
+               */
+              static Ipv4Set unionOf(const Ipv4Set* const* sets, size_t count);
+
+              /**
+               * Returns the addresses of this set that have one of the
+               * given flags in their InetAddressValue::classify() result,
+               * for example InetAddressValue::CLASS_SITE_LOCAL for the
+               * addresses for which InetAddress::isSiteLocalAddress() is
+               * @c true. Most flags depend only on the first 16 bits of an
+               * address, so whole containers are kept or dropped at once.
+               * @param[in] classes A combination of InetAddressValue::CLASS_*
+               * flags.
+               */
+              Ipv4Set select(uint32_t classes) const;
+
+              /**
+               * Converts every container to the form that takes the least
+               * memory, using runs where they are smaller, and releases
+               * the memory that removes left unused.
+               */
+              void optimize();
+
+              /**
+               * Writes the addresses of this set in order.
+               * @param[out] out Receives getCardinality() addresses, in host
+               * byte order.
+               * @return The number of addresses written.
+               */
+              size_t toArray(uint32_t* out) const throw();
+
+              /**
+               * Returns the addresses of this set in order.
+               */
+              std::vector<InetAddress> getAddresses() const;
+
+              /**
+               * Returns the number of bytes used by this set.
+               */
+              size_t getMemoryUsage() const throw();
+
+              /**
+               * Returns the number of bytes written by serialize().
+               */
+              size_t getSerializedSize() const throw();
+
+              /**
+               * Writes this set in the portable format of the Roaring
+               * bitmap libraries.
+               * @param[out] out Receives getSerializedSize() bytes. Its
+               * previous contents are replaced.
+               */
+              void serialize(std::vector<uint8_t>& out) const;
+
+              /**
+               * Reads a set written by serialize() or by a Roaring bitmap
+               * library in its portable format.
+               * @param[in] data The serialized set.
+               * @param[in] size The number of bytes of the serialized set.
+               * @exception frog::sys::FormatException Thrown when the data is
+               * not a valid serialized set or is not @arg size bytes long.
+               */
+              static Ipv4Set deserialize(const uint8_t* data, size_t size) throw(sys::FormatException);
+
+              /**
+               * Reads a set. See Ipv4Set::deserialize(const uint8_t*, size_t).
+               */
+              static Ipv4Set deserialize(const std::vector<uint8_t>& data) throw(sys::FormatException)
+              {
+                  return deserialize(data.empty() ? NULL : &data[0], data.size());
+              }
+
+              /**
+               * Returns the ranges of consecutive addresses of this set, for
+               * example <I>{10.0.0.1, 10.0.0.5-10.0.0.9}</I>.
+               */
+              virtual std::string toString() const throw();
+
+              /**
+               * A group of up to 65536 addresses that share their first
+               * 16 bits. Defined in the implementation.
+               */
+              struct Container;
+
+          private:
+              /**
+               * Returns the index of the container for the first 16 bits of
+               * an address, or the index where it would be inserted.
+               */
+              size_t find(uint16_t key) const throw();
+
+              /**
+               * Inserts a container at an index, taking ownership of it.
+               */
+              void insert(size_t index, uint16_t key, Container* container);
+
+              /**
+               * Removes the container at an index.
+               */
+              void erase(size_t index) throw();
+
+              /**
+               * The first 16 bits of the addresses of each container, in
+               * increasing order.
+               */
+              std::vector<uint16_t> keys_;
+
+              /**
+               * The containers, owned by this set, in the order of keys_.
+               */
+              std::vector<Container*> containers_;
+        }; // Ipv4Set cls
+    } // net ns
+} // frog ns
+#endif // FROG_NET_IPV4SET_H
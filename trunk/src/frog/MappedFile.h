@@ -0,0 +1,123 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_SYS_MAPPEDFILE_H
+#define FROG_SYS_MAPPEDFILE_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string>
+
+#include <frog/stdint.h>
+#include <frog/NonCopyable.h>
+#include <frog/IOException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::sys Contains fundamental classes and base classes that
+     * define commonly used value and data types, interfaces, attributes,
+     * and processing exceptions.
+     */
+    namespace sys
+    {
+        /**
+         * A file mapped read-only into memory. The pages are shared with
+         * every other process that maps the same file and are loaded by
+         * the kernel on first access. The mapping is removed when the
+         * MappedFile is closed or destroyed.
+         */
+        class MappedFile : private NonCopyable
+        {
+          public:
+              /**
+               * Creates a MappedFile that maps nothing.
+               */
+              MappedFile() throw();
+
+              /**
+               * Maps a file. See MappedFile::open().
+               */
+              explicit MappedFile(const std::string& path) throw(IOException);
+
+              /**
+               * Unmaps the file.
+               */
+              ~MappedFile() throw();
+
+              /**
+               * Maps a file read-only, replacing the current mapping.
+               * @param[in] path The path of the file.
+               * @exception frog::sys::IOException Thrown when the file cannot
+               * be opened or mapped.
+               */
+              void open(const std::string& path) throw(IOException);
+
+              /**
+               * Unmaps the file. Does nothing if no file is mapped.
+               */
+              void close() throw();
+
+              /**
+               * Returns the first byte of the file, or @c NULL if no file is
+               * mapped. The address is aligned to a page.
+               */
+              const uint8_t* data() const throw()
+              {
+                  return data_;
+              }
+
+              /**
+               * Returns the size of the file in bytes.
+               */
+              size_t size() const throw()
+              {
+                  return size_;
+              }
+
+              /**
+               * Tests if a file is mapped.
+               */
+              bool isOpen() const throw()
+              {
+                  return (data_ != NULL);
+              }
+          private:
+              /**
+               * The mapped file.
+               */
+              const uint8_t* data_;
+
+              /**
+               * The size of the mapped file.
+               */
+              size_t size_;
+        }; // MappedFile cls
+    } // sys ns
+} // frog ns
+#endif // FROG_SYS_MAPPEDFILE_H
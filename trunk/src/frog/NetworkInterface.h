@@ -94,17 +94,6 @@ namespace frog
                */
               typedef std::vector<InterfaceAddress>::const_iterator InterfaceAddrListConstIterator;
 
-              /**
-               * Get the name of this network interface.
-               */
-              const std::string& name;
-
-              /**
-               * Get the display name of this network interface. A display name
-               * is a human-readable string describing the network device.
-               */
-              const std::string& displayName;
-
               /**
                * Construct a network interface that has the specified
                * Internet Protocol (IP) address bound to it. If the
@@ -128,15 +117,46 @@ namespace frog
                */
               ~NetworkInterface() throw();
 
+#if __cplusplus >= 201103L
               /**
                * Copy constructor.
                */
-              NetworkInterface(const NetworkInterface& netInterface) throw();
+              NetworkInterface(const NetworkInterface& netInterface) = default;
+
+              /**
+               * Move constructor. The name and address list are taken
+               * over rather than copied, so a std::vector of interfaces
+               * does not deep copy them when it grows.
+               */
+              NetworkInterface(NetworkInterface&& netInterface) noexcept = default;
 
               /**
                * Copies one network interface to another.
                */
-              NetworkInterface& operator=(const NetworkInterface& netInterface) throw();
+              NetworkInterface& operator=(const NetworkInterface& netInterface) = default;
+
+              /**
+               * Move assignment.
+               */
+              NetworkInterface& operator=(NetworkInterface&& netInterface) noexcept = default;
+#endif
+
+              /**
+               * Get the name of this network interface.
+               */
+              const std::string& getName() const throw()
+              {
+                  return name_;
+              }
+
+              /**
+               * Get the display name of this network interface. A display name
+               * is a human-readable string describing the network device.
+               */
+              const std::string& getDisplayName() const throw()
+              {
+                  return displayName_;
+              }
 
               /**
                * Compares two network interfaces.
@@ -149,7 +169,11 @@ namespace frog
               bool operator!=(const NetworkInterface& netInterface) const throw();
 
               /**
-               * Returns all the interfaces on this machine.
+               * Returns all the interfaces on this machine that are up and
+               * have at least one IP address. On Linux the interfaces are
+               * read from the kernel over netlink, so that the cost stays
+               * linear in the number of addresses; the addresses of an
+               * alias such as "eth0:1" are then listed under "eth0".
                * @return A list of NetworkInterface%s on this machine.
                */
               static std::vector<NetworkInterface> getNetworkInterfaces();
@@ -157,9 +181,10 @@ namespace frog
               /**
                * Returns all the IP addresses bound to this network interface.
                * These includes the unicast, netmask, and broadcast addresses
-               * if available.
+               * if available. The list belongs to this interface; copy it
+               * if it has to outlive the interface.
                */
-              NetworkInterface::InterfaceAddrList getInterfaceAddresses() const;
+              const NetworkInterface::InterfaceAddrList& getInterfaceAddresses() const throw();
 
               /**
                * Returns the string representation of this object.
@@ -169,7 +194,7 @@ namespace frog
               /**
                * Default do nothing constructor.
                */
-              NetworkInterface() : name(name_), displayName(displayName_) { }
+              NetworkInterface() : intfaceIndex_(0) { }
 
               /**
                * Finds the network interface associated with either the
@@ -183,6 +208,15 @@ namespace frog
                */
               static std::vector<NetworkInterface> findAll() throw(SocketException);
 
+#ifdef HAVE_LINUX_RTNETLINK_H
+              /**
+               * Finds all the network interfaces in this machine with one
+               * RTM_GETLINK and one RTM_GETADDR netlink dump.
+               * @return @e false if no netlink socket could be opened.
+               */
+              static bool findAllNetlink(std::vector<NetworkInterface>& netInterfaces)
+                  throw(SocketException);
+#endif
 
               /**
                * Interface name
@@ -39,7 +39,7 @@ namespace frog
       private:
           NonCopyable(const NonCopyable&);
           const NonCopyable& operator=(const NonCopyable&);
-    }
+    };
 } // frog ns
 
 
@@ -0,0 +1,432 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_PREFIXTABLE_H
+#define FROG_NET_PREFIXTABLE_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <frog/stdint.h>
+#include <frog/NonCopyable.h>
+#include <frog/AddressFamily.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/Subnet.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * A longest-prefix-match table that maps IP addresses to values
+         * of type @c V, typically a route or a tenant id.
+         *
+         * IPv4 uses a DIR-24-8 layout: a direct table indexed by the first
+         * 24 bits of the address whose entries are either a result or a
+         * block of 256 entries indexed by the last 8 bits. A lookup takes
+         * one or two memory accesses. The direct table takes 64 MB and is
+         * only allocated when the table holds IPv4 prefixes.
+         *
+         * IPv6 uses a multibit trie with a stride of 8 bits and leaf pushing:
+         * every entry of a 1 KB node is either a result or the next node,
+         * so a lookup reads at most one entry per address byte.
+         *
+         * The table is built in bulk by PrefixTable::build() and is then
+         * read-only, so any number of threads can call lookup() at the same
+         * time. To update a table in use, build a new one and publish it
+         * with AtomicPrefixTable.
+         */
+        template <typename V>
+            class PrefixTable
+            {
+              public:
+                  /**
+                   * Type of a prefix and its value, as given to build().
+                   */
+                  typedef std::pair<Subnet, V> Route;
+
+                  /**
+                   * Creates an empty table.
+                   */
+                  PrefixTable() : nodes6_(NODE_SIZE, 0U) { }
+
+                  /**
+                   * Creates a table from a list of prefixes. See build().
+                   */
+                  explicit PrefixTable(const std::vector<Route>& routes) :
+                    nodes6_(NODE_SIZE, 0U)
+                  {
+                      build(routes);
+                  }
+
+                  /**
+                   * Replaces the contents of this table with a list of
+                   * prefixes. The list need not be sorted. When a prefix
+                   * appears more than once, the last value wins. Prefixes
+                   * of an unspecified family are ignored.
+                   * @param[in] routes The prefixes and their values.
+                   */
+                  void build(const std::vector<Route>& routes)
+                  {
+                      std::vector<uint32_t>().swap(root4_);
+                      std::vector<uint32_t>().swap(nodes4_);
+                      std::vector<uint32_t>(NODE_SIZE, 0U).swap(nodes6_);
+                      values_.clear();
+                      values_.reserve(routes.size());
+
+                      // Shorter prefixes are written first so that longer
+                      // ones overwrite them; the stable sort keeps the
+                      // last duplicate last.
+                      std::vector<std::pair<uint32_t, size_t> > order;
+                      order.reserve(routes.size());
+                      for(size_t i = 0; i < routes.size(); ++i)
+                      {
+                          order.push_back(std::make_pair(routes[i].first.getPrefixLength(), i));
+                      }
+                      std::stable_sort(order.begin(), order.end(), lessPrefixLength);
+
+                      for(size_t i = 0; i < order.size(); ++i)
+                      {
+                          const Route& route = routes[order[i].second];
+                          InetAddressValue network = route.first.getNetwork().getValue();
+                          if(network.family == AddressFamily::InterNetwork)
+                          {
+                              values_.push_back(route.second);
+                              insert4(network, order[i].first, static_cast<uint32_t>(values_.size()));
+                          }
+#ifdef HAVE_IPV6_SUPPORT
+                          else if(network.family == AddressFamily::InterNetworkV6)
+                          {
+                              values_.push_back(route.second);
+                              insert6(network, order[i].first, static_cast<uint32_t>(values_.size()));
+                          }
+#endif
+                      }
+                  }
+
+                  /**
+                   * Finds the value of the longest prefix that contains an
+                   * address.
+                   * @param[in] addr The address to look up.
+                   * @return A pointer to the value, or @c NULL when no prefix
+                   * contains @arg addr. The pointer is valid as long as the
+                   * table is neither rebuilt nor destroyed.
+                   */
+                  const V* lookup(const InetAddressValue& addr) const throw()
+                  {
+                      uint32_t entry = find(addr);
+                      return (entry != 0) ? &values_[entry - 1] : NULL;
+                  }
+
+                  /**
+                   * Finds the value of the longest prefix that contains an
+                   * address. See lookup(const InetAddressValue&).
+                   */
+                  const V* lookup(const InetAddress& addr) const throw()
+                  {
+                      return lookup(addr.getValue());
+                  }
+
+                  /**
+                   * Looks up a batch of addresses. The IPv4 direct table entry of
+                   * an address is prefetched a few addresses before it is read,
+                   * so that the cache misses of consecutive lookups overlap.
+                   * @param[in] addrs The addresses to look up.
+                   * @param[in] count The number of addresses in @arg addrs.
+                   * @param[out] result Receives @arg count pointers, as returned
+                   * by lookup().
+                   * @return The number of addresses that matched a prefix.
+                   */
+                  size_t lookupMany(const InetAddressValue* addrs, size_t count,
+                          const V** result) const throw()
+                  {
+                      const size_t AHEAD = 16;
+                      size_t matches = 0;
+                      for(size_t i = 0; i < count; ++i)
+                      {
+#ifdef __GNUC__
+                          if((i + AHEAD < count) && !root4_.empty() &&
+                                  (addrs[i + AHEAD].family == AddressFamily::InterNetwork))
+                          {
+                              __builtin_prefetch(&root4_[key4(addrs[i + AHEAD]) >> 8]);
+                          }
+#endif
+                          uint32_t entry = find(addrs[i]);
+                          result[i] = (entry != 0) ? &values_[entry - 1] : NULL;
+                          matches += (entry != 0);
+                      }
+                      return matches;
+                  }
+
+                  /**
+                   * Returns the number of prefixes in this table.
+                   */
+                  size_t size() const throw()
+                  {
+                      return values_.size();
+                  }
+
+                  /**
+                   * Swaps the contents of two tables.
+                   */
+                  void swap(PrefixTable& other) throw()
+                  {
+                      root4_.swap(other.root4_);
+                      nodes4_.swap(other.nodes4_);
+                      nodes6_.swap(other.nodes6_);
+                      values_.swap(other.values_);
+                  }
+              private:
+                  /**
+                   * Entries of a table are 0 for no match, the index of a value
+                   * plus one, or CHILD ored with the index of the next node.
+                   */
+                  static const uint32_t CHILD = 0x80000000U;
+
+                  /**
+                   * Number of entries in a node (8 bits).
+                   */
+                  static const size_t NODE_SIZE = 256U;
+
+                  /**
+                   * Number of entries in the IPv4 direct table (24 bits).
+                   */
+                  static const size_t ROOT4_SIZE = 1U << 24;
+
+                  /**
+                   * Orders prefixes by length for build().
+                   */
+                  static bool lessPrefixLength(const std::pair<uint32_t, size_t>& a,
+                          const std::pair<uint32_t, size_t>& b)
+                  {
+                      return (a.first < b.first);
+                  }
+
+                  /**
+                   * Returns an IPv4 address as a number.
+                   */
+                  static uint32_t key4(const InetAddressValue& addr) throw()
+                  {
+                      const uint8_t* p = addr.address + InetAddressValue::IPV4_OFFSET;
+                      return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+                          (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+                  }
+
+                  /**
+                   * Returns the table entry that matches an address.
+                   */
+                  uint32_t find(const InetAddressValue& addr) const throw()
+                  {
+                      if(addr.family == AddressFamily::InterNetwork)
+                      {
+                          if(root4_.empty())
+                          {
+                              return 0;
+                          }
+                          uint32_t key = key4(addr);
+                          uint32_t entry = root4_[key >> 8];
+                          if(entry & CHILD)
+                          {
+                              entry = nodes4_[((entry & ~CHILD) << 8) | (key & 0xffU)];
+                          }
+                          return entry;
+                      }
+#ifdef HAVE_IPV6_SUPPORT
+                      if(addr.family == AddressFamily::InterNetworkV6)
+                      {
+                          uint32_t entry = nodes6_[addr.address[0]];
+                          for(size_t i = 1; (entry & CHILD) && (i < sizeof(addr.address)); ++i)
+                          {
+                              entry = nodes6_[((entry & ~CHILD) << 8) | addr.address[i]];
+                          }
+                          return entry;
+                      }
+#endif
+                      return 0;
+                  }
+
+                  /**
+                   * Adds a node to a node list, filled with @arg entry, and
+                   * returns the entry that points to it.
+                   */
+                  static uint32_t addNode(std::vector<uint32_t>& nodes, uint32_t entry)
+                  {
+                      uint32_t index = static_cast<uint32_t>(nodes.size() / NODE_SIZE);
+                      nodes.resize(nodes.size() + NODE_SIZE, entry);
+                      return (index | CHILD);
+                  }
+
+                  /**
+                   * Writes an IPv4 prefix. Longer prefixes must come later.
+                   */
+                  void insert4(const InetAddressValue& network, uint32_t prefixLength, uint32_t entry)
+                  {
+                      if(root4_.empty())
+                      {
+                          root4_.resize(ROOT4_SIZE, 0U);
+                      }
+
+                      uint32_t key = key4(network);
+                      if(prefixLength <= 24)
+                      {
+                          size_t first = key >> 8;
+                          std::fill(root4_.begin() + first,
+                                  root4_.begin() + first + (static_cast<size_t>(1) << (24 - prefixLength)), entry);
+                          return;
+                      }
+
+                      uint32_t& slot = root4_[key >> 8];
+                      if(!(slot & CHILD))
+                      {
+                          slot = addNode(nodes4_, slot);
+                      }
+                      size_t first = (static_cast<size_t>(slot & ~CHILD) << 8) | (key & 0xffU);
+                      std::fill(nodes4_.begin() + first,
+                              nodes4_.begin() + first + (static_cast<size_t>(1) << (32 - prefixLength)), entry);
+                  }
+
+                  /**
+                   * Writes an IPv6 prefix. Longer prefixes must come later.
+                   */
+                  void insert6(const InetAddressValue& network, uint32_t prefixLength, uint32_t entry)
+                  {
+                      // Walk down to the node that holds the last, possibly
+                      // partial, byte of the prefix.
+                      size_t depth = (prefixLength == 0) ? 0 : (prefixLength - 1) / 8;
+                      size_t node = 0;
+                      for(size_t i = 0; i < depth; ++i)
+                      {
+                          size_t index = (node << 8) | network.address[i];
+                          if(!(nodes6_[index] & CHILD))
+                          {
+                              uint32_t child = addNode(nodes6_, nodes6_[index]);
+                              nodes6_[index] = child;
+                          }
+                          node = nodes6_[index] & ~CHILD;
+                      }
+
+                      uint32_t bits = prefixLength - static_cast<uint32_t>(depth * 8);
+                      size_t first = (node << 8) | network.address[depth];
+                      std::fill(nodes6_.begin() + first,
+                              nodes6_.begin() + first + (static_cast<size_t>(1) << (8 - bits)), entry);
+                  }
+
+                  /**
+                   * IPv4 direct table indexed by the first 24 bits.
+                   */
+                  std::vector<uint32_t> root4_;
+
+                  /**
+                   * IPv4 blocks indexed by the last 8 bits.
+                   */
+                  std::vector<uint32_t> nodes4_;
+
+                  /**
+                   * IPv6 trie nodes. Node 0 is the root.
+                   */
+                  std::vector<uint32_t> nodes6_;
+
+                  /**
+                   * The values, in the order they were written.
+                   */
+                  std::vector<V> values_;
+            }; // PrefixTable tmpl
+
+        template <typename V>
+            const uint32_t PrefixTable<V>::CHILD;
+
+        template <typename V>
+            const size_t PrefixTable<V>::NODE_SIZE;
+
+        template <typename V>
+            const size_t PrefixTable<V>::ROOT4_SIZE;
+
+        /**
+         * Publishes a PrefixTable to reader threads and replaces it without
+         * locking. Readers call get() for the current table; a writer builds
+         * a new table and installs it with exchange(). The old table is
+         * returned to the writer, which must delete it only after every
+         * reader that may still use it is done (for example after a grace
+         * period or when reference counts drop to zero).
+         * @note Uses the GCC atomic builtins.
+         */
+        template <typename V>
+            class AtomicPrefixTable : private NonCopyable
+            {
+              public:
+                  /**
+                   * Creates a handle that publishes @arg table. The handle does
+                   * not own the table.
+                   */
+                  explicit AtomicPrefixTable(PrefixTable<V>* table = NULL) throw() : table_(table) { }
+
+                  /**
+                   * Returns the table currently published. Once a reader holds
+                   * this pointer it sees a complete table.
+                   */
+                  const PrefixTable<V>* get() const throw()
+                  {
+#ifdef __ATOMIC_ACQUIRE
+                      return __atomic_load_n(&table_, __ATOMIC_ACQUIRE);
+#else
+                      PrefixTable<V>* table = table_;
+                      __sync_synchronize();
+                      return table;
+#endif
+                  }
+
+                  /**
+                   * Publishes a new table.
+                   * @param[in] table The new table. It must be completely built.
+                   * @return The table that was published before.
+                   */
+                  PrefixTable<V>* exchange(PrefixTable<V>* table) throw()
+                  {
+                      PrefixTable<V>* old = table_;
+                      PrefixTable<V>* seen;
+                      while((seen = __sync_val_compare_and_swap(&table_, old, table)) != old)
+                      {
+                          old = seen;
+                      }
+                      return old;
+                  }
+              private:
+                  PrefixTable<V>* volatile table_;
+            }; // AtomicPrefixTable tmpl
+    } // net ns
+} // frog ns
+#endif // FROG_NET_PREFIXTABLE_H
@@ -0,0 +1,302 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_RANGEDATABASE_H
+#define FROG_NET_RANGEDATABASE_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string>
+
+#include <frog/stdint.h>
+#include <frog/NonCopyable.h>
+#include <frog/MappedFile.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/IOException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * A read-only database that maps IP address ranges to records of
+         * text fields, such as an AS number, a region or a tenant.
+         *
+         * The database is a file written by RangeDatabaseWriter. open()
+         * maps it into memory and checks it once; lookups then read the
+         * mapped pages directly, so nothing is parsed or copied and every
+         * process that opens the same file shares its pages.
+         *
+         * The file holds, after a RangeDatabase::Header, 8-byte aligned
+         * sections that refer to each other by offset and index only:
+         * <UL>
+         * <LI>the IPv4 index: for each of the RangeDatabase::INDEX4_SIZE
+         *     /16 prefixes, the index of the first IPv4 range that ends
+         *     in or after it, followed by the number of IPv4 ranges;</LI>
+         * <LI>the IPv4 ranges as three @c uint32_t arrays: last addresses,
+         *     first addresses and record indexes, sorted and disjoint;</LI>
+         * <LI>the IPv6 ranges in the same way, each address being two
+         *     @c uint64_t words, most significant first;</LI>
+         * <LI>the records, each RangeDatabase::Header::fieldCount string
+         *     offsets; equal records are stored once;</LI>
+         * <LI>the field names, as string offsets;</LI>
+         * <LI>the string pool, NUL terminated strings stored once each.</LI>
+         * </UL>
+         * Numbers are in the byte order of the host that wrote the file.
+         * A file written on a host of the other byte order is rejected.
+         *
+         * A RangeDatabase can be queried by many threads at the same time.
+         * open() and close() must not run concurrently with any other
+         * member.
+         */
+        class RangeDatabase : private NonCopyable
+        {
+          public:
+              /**
+               * The header at the start of a database file.
+               */
+              struct Header
+              {
+                  char magic[8]; /**< RangeDatabase::MAGIC */
+                  uint32_t version; /**< RangeDatabase::FORMAT_VERSION */
+                  uint32_t byteOrder; /**< RangeDatabase::BYTE_ORDER_MARK */
+                  uint32_t headerSize; /**< sizeof(Header) */
+                  uint32_t fieldCount; /**< Number of fields of a record */
+                  uint32_t range4Count; /**< Number of IPv4 ranges */
+                  uint32_t range6Count; /**< Number of IPv6 ranges */
+                  uint32_t recordCount; /**< Number of records */
+                  uint32_t reserved; /**< Zero */
+                  uint64_t index4Offset; /**< Offset of the IPv4 index */
+                  uint64_t range4Offset; /**< Offset of the IPv4 ranges */
+                  uint64_t range6Offset; /**< Offset of the IPv6 ranges */
+                  uint64_t recordOffset; /**< Offset of the records */
+                  uint64_t fieldOffset; /**< Offset of the field names */
+                  uint64_t stringOffset; /**< Offset of the string pool */
+                  uint64_t stringSize; /**< Size of the string pool in bytes */
+              };
+
+              /**
+               * The first eight bytes of a database file.
+               */
+              static const char MAGIC[8];
+
+              /**
+               * The version of the file format written by this library.
+               */
+              static const uint32_t FORMAT_VERSION = 1U;
+
+              /**
+               * The value of Header::byteOrder, as stored by the writer.
+               */
+              static const uint32_t BYTE_ORDER_MARK = 0x01020304U;
+
+              /**
+               * The number of entries of the IPv4 index, one per /16, not
+               * counting the last entry.
+               */
+              static const size_t INDEX4_SIZE = 65536U;
+
+              /**
+               * The fields of the record found by RangeDatabase::lookup().
+               * A Record points into the mapped file and is valid until the
+               * database is closed.
+               */
+              class Record
+              {
+                public:
+                    /**
+                     * Creates a record with no fields.
+                     */
+                    Record() throw() : database_(NULL), fields_(NULL)
+                    {
+                    }
+
+                    /**
+                     * Returns a field of the record, or @c NULL if @arg field
+                     * is not less than RangeDatabase::getFieldCount() or the
+                     * record is empty.
+                     * @param[in] field The index of the field.
+                     */
+                    const char* get(size_t field) const throw()
+                    {
+                        if((fields_ == NULL) || (field >= database_->fieldCount_))
+                        {
+                            return NULL;
+                        }
+                        return database_->strings_ + fields_[field];
+                    }
+                private:
+                    friend class RangeDatabase;
+
+                    /**
+                     * The database the record belongs to.
+                     */
+                    const RangeDatabase* database_;
+
+                    /**
+                     * The string offsets of the fields.
+                     */
+                    const uint32_t* fields_;
+              }; // Record cls
+
+              /**
+               * Creates a database that is not open.
+               */
+              RangeDatabase() throw();
+
+              /**
+               * Opens a database. See RangeDatabase::open().
+               */
+              explicit RangeDatabase(const std::string& path) throw(sys::IOException);
+
+              /**
+               * Closes the database.
+               */
+              ~RangeDatabase() throw() { }
+
+              /**
+               * Maps a database file read-only and checks that it is well
+               * formed. The database that was open is closed.
+               * @param[in] path The path of the file.
+               * @exception frog::sys::IOException Thrown when the file cannot
+               * be mapped, is not a database, has an unsupported version or
+               * byte order or is damaged.
+               */
+              void open(const std::string& path) throw(sys::IOException);
+
+              /**
+               * Closes the database. Records found before become invalid.
+               */
+              void close() throw();
+
+              /**
+               * Tests if a database is open.
+               */
+              bool isOpen() const throw()
+              {
+                  return file_.isOpen();
+              }
+
+              /**
+               * Finds the range that holds an address. The scope id is
+               * ignored. The search is a branch-free binary search over the
+               * last addresses of the ranges; for IPv4 it only covers the
+               * ranges found through the index.
+               * @param[in] value The address.
+               * @param[out] record Receives the record of the range. It is
+               * unchanged when no range holds the address.
+               * @return @c true if a range holds the address.
+               */
+              bool lookup(const InetAddressValue& value, Record& record) const throw();
+
+              /**
+               * Finds the range that holds an address.
+               * See lookup(const InetAddressValue&, Record&).
+               */
+              bool lookup(const InetAddress& address, Record& record) const throw()
+              {
+                  return lookup(address.getValue(), record);
+              }
+
+              /**
+               * Returns the number of fields of a record.
+               */
+              size_t getFieldCount() const throw()
+              {
+                  return fieldCount_;
+              }
+
+              /**
+               * Returns the name of a field, or @c NULL if @arg field is not
+               * less than getFieldCount().
+               */
+              const char* getFieldName(size_t field) const throw();
+
+              /**
+               * Returns the index of the field named @arg name, or
+               * getFieldCount() if there is no such field.
+               */
+              size_t findField(const std::string& name) const throw();
+
+              /**
+               * Returns the number of ranges, IPv4 and IPv6.
+               */
+              size_t getRangeCount() const throw()
+              {
+                  return range4Count_ + range6Count_;
+              }
+          private:
+              /**
+               * Checks the mapped file and sets the section pointers.
+               */
+              void attach(const std::string& path) throw(sys::IOException);
+
+              /**
+               * Forgets the section pointers.
+               */
+              void detach() throw();
+
+              /**
+               * The mapped file.
+               */
+              sys::MappedFile file_;
+
+              /**
+               * The IPv4 sections.
+               */
+              const uint32_t* index4_;
+              const uint32_t* last4_;
+              const uint32_t* first4_;
+              const uint32_t* record4_;
+              size_t range4Count_;
+
+              /**
+               * The IPv6 sections, two words per address.
+               */
+              const uint64_t* last6_;
+              const uint64_t* first6_;
+              const uint32_t* record6_;
+              size_t range6Count_;
+
+              /**
+               * The records, the field names and the string pool.
+               */
+              const uint32_t* records_;
+              const uint32_t* fieldNames_;
+              const char* strings_;
+              size_t fieldCount_;
+        }; // RangeDatabase cls
+    } // net ns
+} // frog ns
+#endif // FROG_NET_RANGEDATABASE_H
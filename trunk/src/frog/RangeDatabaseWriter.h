@@ -0,0 +1,178 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_RANGEDATABASEWRITER_H
+#define FROG_NET_RANGEDATABASEWRITER_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <frog/stdint.h>
+#include <frog/NonCopyable.h>
+#include <frog/InetAddress.h>
+#include <frog/Subnet.h>
+#include <frog/RangeDatabase.h>
+#include <frog/IOException.h>
+#include <frog/IllegalArgumentException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * Builds a RangeDatabase file. Ranges are added in any order with
+         * their field values, and write() sorts them and writes the file.
+         * Strings and records that occur more than once are stored once.
+         */
+        class RangeDatabaseWriter : private NonCopyable
+        {
+          public:
+              /**
+               * Type of the field values of a range.
+               */
+              typedef std::vector<std::string> Values;
+
+              /**
+               * Creates a writer for records with the given fields.
+               * @param[in] fieldNames The names of the fields.
+               * @exception frog::sys::IllegalArgumentException Thrown when a
+               * name is repeated or holds a NUL character.
+               */
+              explicit RangeDatabaseWriter(const Values& fieldNames) throw(sys::IllegalArgumentException);
+
+              /**
+               * Adds an inclusive range of addresses. Scope ids are ignored.
+               * @param[in] first The first address of the range.
+               * @param[in] last The last address of the range.
+               * @param[in] values The field values, one per field name.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * the addresses are of different families or out of order,
+               * when the number of values is wrong or when a value holds a
+               * NUL character.
+               */
+              void add(const InetAddress& first, const InetAddress& last,
+                      const Values& values) throw(sys::IllegalArgumentException);
+
+              /**
+               * Adds every address of a subnet.
+               * See add(const InetAddress&, const InetAddress&, const Values&).
+               */
+              void add(const Subnet& subnet, const Values& values) throw(sys::IllegalArgumentException);
+
+              /**
+               * Returns the number of ranges added.
+               */
+              size_t getRangeCount() const throw()
+              {
+                  return ranges4_.size() + ranges6_.size();
+              }
+
+              /**
+               * Writes the database. The file is written under a temporary
+               * name and then renamed, so that processes that open @arg path
+               * never see a partial file.
+               * @param[in] path The path of the file.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * two ranges overlap.
+               * @exception frog::sys::IOException Thrown when the file cannot
+               * be written.
+               */
+              void write(const std::string& path) const
+                  throw(sys::IllegalArgumentException, sys::IOException);
+          private:
+              /**
+               * A range and the index of its record.
+               */
+              template <typename K>
+                  struct Entry
+                  {
+                      K first;
+                      K last;
+                      uint32_t record;
+                  };
+
+              /**
+               * An IPv6 address as two words, most significant first.
+               */
+              struct Word128
+              {
+                  uint64_t high;
+                  uint64_t low;
+
+                  bool operator<(const Word128& w) const throw()
+                  {
+                      return (high < w.high) || ((high == w.high) && (low < w.low));
+                  }
+              };
+
+              /**
+               * Returns the offset of a string in the pool, adding it if
+               * needed.
+               */
+              uint32_t intern(const std::string& s) throw(sys::IllegalArgumentException);
+
+              /**
+               * Returns the index of a record, adding it if needed.
+               */
+              uint32_t addRecord(const Values& values) throw(sys::IllegalArgumentException);
+
+              /**
+               * The number of fields and the string offsets of their names.
+               */
+              std::vector<uint32_t> fieldNames_;
+
+              /**
+               * The ranges.
+               */
+              std::vector<Entry<uint32_t> > ranges4_;
+              std::vector<Entry<Word128> > ranges6_;
+
+              /**
+               * The records, fieldNames_.size() string offsets each, and
+               * the index of each record.
+               */
+              std::vector<uint32_t> records_;
+              std::map<std::vector<uint32_t>, uint32_t> recordIndex_;
+
+              /**
+               * The string pool and the offset of each string.
+               */
+              std::string strings_;
+              std::map<std::string, uint32_t> stringIndex_;
+        }; // RangeDatabaseWriter cls
+    } // net ns
+} // frog ns
+#endif // FROG_NET_RANGEDATABASEWRITER_H
@@ -0,0 +1,467 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_SUBNET_H
+#define FROG_NET_SUBNET_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <iterator>
+
+#include <frog/stdint.h>
+#include <frog/Object.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/Word128.h>
+#include <frog/NetworkInterface.h>
+#include <frog/IllegalArgumentException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * This class represents an IP subnet: a network address and a
+         * prefix length, written as <I>10.0.0.0/8</I> or <I>2001:db8::/32</I>.
+         * The netmask is kept as two 64-bit words in the same byte order
+         * as InetAddressValue::address, so that testing an address for
+         * membership is a masked compare of two words and the family,
+         * without any branches.
+         * <HR>
+         * <H3>Inherits from:</H3>
+         *     &nbsp;&nbsp;&nbsp;&nbsp;&nbsp;
+         *     Object
+         * <HR>
+         */
+        class Subnet : public Object
+        {
+          public:
+              /**
+               * Creates an empty subnet. Its address family is
+               * AddressFamily::Unspecified and it contains no address.
+               */
+              Subnet() throw();
+
+              /**
+               * Copy constructor.
+               */
+              Subnet(const Subnet& subnet) throw();
+
+              /**
+               * Creates a subnet from a network address and a prefix length.
+               * Host bits set in @arg network are cleared.
+               * @param[in] network Any address in the subnet.
+               * @param[in] prefixLength The number of network bits: up to 32
+               * for IPv4 and up to 128 for IPv6.
+               * @exception frog::sys::IllegalArgumentException Thrown when the
+               * address family is unspecified or the prefix length is too long.
+               */
+              Subnet(const InetAddress& network, uint32_t prefixLength)
+                  throw(sys::IllegalArgumentException);
+
+              /**
+               * Creates a subnet from its textual representation, see
+               * Subnet::tryParse().
+               * @param[in] text The textual representation of a subnet.
+               * @exception frog::sys::IllegalArgumentException Thrown when the
+               * text is not a valid subnet.
+               */
+              explicit Subnet(const std::string& text) throw(sys::IllegalArgumentException);
+
+              /**
+               * Creates the subnet an interface address belongs to. The prefix
+               * length is the number of leading one bits of the netmask.
+               * @param[in] intfaceAddr An address found by NetworkInterface.
+               * @exception frog::sys::IllegalArgumentException Thrown when the
+               * netmask is missing, of another family than the unicast address,
+               * or not contiguous.
+               */
+              explicit Subnet(const NetworkInterface::InterfaceAddress& intfaceAddr)
+                  throw(sys::IllegalArgumentException);
+
+              /**
+               * Default destructor.
+               */
+              virtual ~Subnet() throw() { }
+
+              /**
+               * Parses the textual representation of a subnet without throwing
+               * and without allocating memory. The text is an IP address as
+               * accepted by InetAddress::tryParse() followed by a slash and the
+               * decimal prefix length. Without a prefix length the subnet holds
+               * a single address. Host bits set in the address are cleared, so
+               * <I>10.1.2.3/8</I> is read as <I>10.0.0.0/8</I>.
+               * @param[in] p The text to parse. It need not be NUL terminated.
+               * @param[in] n The number of characters in @arg p.
+               * @param[out] out Receives the parsed subnet. It is left untouched
+               * when the text is not a valid subnet.
+               * @return Returns @c true if the text is a valid subnet;
+               * @c false otherwise.
+               */
+              static bool tryParse(const char* p, size_t n, Subnet& out) throw();
+
+              /**
+               * Copies a subnet to another subnet.
+               */
+              Subnet& operator=(const Subnet& subnet) throw();
+
+              /**
+               * Tests for subnet equality.
+               */
+              bool operator==(const Subnet& subnet) const throw();
+
+              /**
+               * Tests for subnet inequality.
+               */
+              bool operator!=(const Subnet& subnet) const throw();
+
+              /**
+               * Returns the network address, the first address of the subnet.
+               */
+              InetAddress getNetwork() const throw()
+              {
+                  return InetAddress(network_);
+              }
+
+              /**
+               * Returns the netmask as an address of the same family.
+               */
+              InetAddress getNetmask() const throw();
+
+              /**
+               * Returns the last address of the subnet: the network address
+               * with all the host bits set.
+               */
+              InetAddress getLastAddress() const throw();
+
+              /**
+               * A forward iterator over addresses of a subnet. It holds the
+               * current address and yields it without allocating memory, so
+               * even a whole IPv6 /64 can be walked lazily. A
+               * default-constructed iterator is the end of every walk.
+               */
+              class iterator
+              {
+                public:
+                    typedef std::forward_iterator_tag iterator_category;
+                    typedef InetAddress value_type;
+                    typedef ptrdiff_t difference_type;
+                    typedef const InetAddress* pointer;
+                    typedef const InetAddress& reference;
+
+                    /**
+                     * Creates an iterator past the end of any walk.
+                     */
+                    iterator() throw();
+
+                    const InetAddress& operator*() const throw()
+                    {
+                        return address_;
+                    }
+
+                    const InetAddress* operator->() const throw()
+                    {
+                        return &address_;
+                    }
+
+                    /**
+                     * Moves to the next address of the walk.
+                     */
+                    iterator& operator++() throw();
+
+                    /**
+                     * Moves to the next address of the walk.
+                     */
+                    iterator operator++(int) throw();
+
+                    /**
+                     * Tests if two iterators are both at the end, or at the
+                     * same step of a walk.
+                     */
+                    bool operator==(const iterator& other) const throw()
+                    {
+                        return (end_ == other.end_) && (end_ || (position_ == other.position_));
+                    }
+
+                    bool operator!=(const iterator& other) const throw()
+                    {
+                        return !(*this == other);
+                    }
+                private:
+                    friend class Subnet;
+
+                    /**
+                     * Starts a walk over a subnet.
+                     * @param[in] subnet The subnet to walk.
+                     * @param[in] step The distance between two positions.
+                     * @param[in] seed Picks the permutation; only used when
+                     * @arg shuffle is @c true.
+                     * @param[in] shuffle Whether positions are permuted.
+                     */
+                    iterator(const Subnet& subnet, uint64_t step, uint64_t seed, bool shuffle) throw();
+
+                    /**
+                     * Sets address_ from position_.
+                     */
+                    void update() throw();
+
+                    /**
+                     * The network address, with its family and scope id.
+                     */
+                    InetAddressValue network_;
+
+                    /**
+                     * The network address as a number.
+                     */
+                    Word128 base_;
+
+                    /**
+                     * The host bits of the subnet.
+                     */
+                    Word128 hostMask_;
+
+                    /**
+                     * The offset of the current position from the network
+                     * address, before any permutation.
+                     */
+                    Word128 position_;
+
+                    /**
+                     * The distance between two positions.
+                     */
+                    uint64_t step_;
+
+                    /**
+                     * The odd multiplier and the increment of the
+                     * permutation. The multiplier is 0 for walks in order.
+                     */
+                    uint64_t multiplier_;
+                    uint64_t increment_;
+
+                    /**
+                     * The xorshift of the permutation, half the host bits.
+                     */
+                    uint32_t shift_;
+
+                    /**
+                     * Set at the end of the walk.
+                     */
+                    bool end_;
+
+                    /**
+                     * The current address.
+                     */
+                    InetAddress address_;
+              }; // iterator cls
+
+              /**
+               * A walk over a subnet, for use with algorithms and range
+               * based for loops. See Subnet::stride() and
+               * Subnet::permutation().
+               */
+              class Range
+              {
+                public:
+                    iterator begin() const throw()
+                    {
+                        return begin_;
+                    }
+
+                    iterator end() const throw()
+                    {
+                        return iterator();
+                    }
+                private:
+                    friend class Subnet;
+
+                    explicit Range(const iterator& begin) throw() : begin_(begin)
+                    {
+                    }
+
+                    /**
+                     * The first address of the walk.
+                     */
+                    iterator begin_;
+              }; // Range cls
+
+              /**
+               * Returns an iterator on the network address. The walk yields
+               * every address of the subnet in increasing order, up to and
+               * including getLastAddress().
+               */
+              iterator begin() const throw();
+
+              /**
+               * Returns the end of every walk over this subnet.
+               */
+              iterator end() const throw()
+              {
+                  return iterator();
+              }
+
+              /**
+               * Returns a walk over every @arg step th address of the subnet,
+               * starting with the network address: for example every 256th
+               * address of a /8 to probe one host per /24.
+               * @param[in] step The distance between two addresses.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * @arg step is 0.
+               */
+              Range stride(uint64_t step) const throw(sys::IllegalArgumentException);
+
+              /**
+               * Returns a walk over every address of the subnet in a
+               * pseudo-random order, so that consecutive probes land far
+               * apart. Every address is yielded exactly once. The order is
+               * a fixed bijection of the host bits (multiply, add and
+               * xorshift steps), so a walk needs no memory and the same
+               * seed gives the same order. It is not meant to be secret.
+               * @param[in] seed Picks one of many orders.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * the subnet has more than 64 host bits.
+               */
+              Range permutation(uint64_t seed) const throw(sys::IllegalArgumentException);
+
+              /**
+               * Returns the number of network bits.
+               */
+              uint32_t getPrefixLength() const throw()
+              {
+                  return prefixLength_;
+              }
+
+              /**
+               * Returns the address family of this subnet.
+               */
+              AddressFamily::TYPE getAddressFamily() const throw()
+              {
+                  return network_.family;
+              }
+
+              /**
+               * Tests if an address belongs to this subnet. The address must
+               * be of the same family; its scope id is not considered.
+               * @param[in] addr The address to test.
+               * @return Returns @c true if @arg addr is in this subnet;
+               * @c false otherwise.
+               */
+              bool contains(const InetAddressValue& addr) const throw()
+              {
+                  uint64_t word[2];
+                  ::memcpy(word, addr.address, sizeof(word));
+                  return ((((word[0] & mask_[0]) ^ bits_[0]) | ((word[1] & mask_[1]) ^ bits_[1])
+                              | static_cast<uint64_t>(addr.family ^ network_.family)) == 0);
+              }
+
+              /**
+               * Tests if an address belongs to this subnet. See
+               * Subnet::contains(const InetAddressValue&).
+               */
+              bool contains(const InetAddress& addr) const throw()
+              {
+                  return contains(addr.getValue());
+              }
+
+              /**
+               * Tests a batch of addresses for membership. Uses SSE2 where
+               * available.
+               * @param[in] addrs The addresses to test.
+               * @param[in] count The number of addresses in @arg addrs.
+               * @param[out] result Receives @arg count bytes: 1 for every address
+               * that is in this subnet and 0 for every other address.
+               * @return The number of addresses in this subnet.
+               */
+              size_t containsMany(const InetAddressValue* addrs, size_t count,
+                      uint8_t* result) const throw();
+
+              /**
+               * Writes the textual representation of this subnet, for example
+               * <I>10.0.0.0/8</I>, into a caller supplied buffer.
+               * @param[out] buf The buffer that receives the text.
+               * @param[in] cap The size of @arg buf in bytes. A buffer of
+               * Subnet::MAX_TEXT_SIZE bytes is always large enough.
+               * @return The number of characters written, not counting the
+               * terminating NUL, or 0 if @arg buf is too small or the
+               * address family is unspecified.
+               */
+              size_t format(char* buf, size_t cap) const throw();
+
+              /**
+               * Returns a hash code computed from the network and the prefix
+               * length.
+               */
+              virtual int32_t hashCode() const throw();
+
+              /**
+               * Returns the textual representation of this subnet.
+               */
+              virtual std::string toString() const throw();
+
+              /**
+               * Size of a buffer that can hold the textual representation
+               * of any subnet, including the terminating NUL.
+               */
+              static const size_t MAX_TEXT_SIZE = InetAddress::MAX_TEXT_SIZE + 4U;
+          private:
+              /**
+               * Sets the network and the mask. Requires a valid prefix length.
+               */
+              void init(const InetAddressValue& network, uint32_t prefixLength) throw();
+
+              /**
+               * The network address with the host bits cleared.
+               */
+              InetAddressValue network_;
+
+              /**
+               * The address bytes of network_ as two words.
+               */
+              uint64_t bits_[2];
+
+              /**
+               * The netmask as two words. IPv4 prefixes are offset by 96 bits
+               * to cover the leading zero bytes of InetAddressValue::address.
+               */
+              uint64_t mask_[2];
+
+              /**
+               * The number of network bits.
+               */
+              uint32_t prefixLength_;
+        }; // Subnet cls
+    } // net ns
+} // frog ns
+#endif // FROG_NET_SUBNET_H
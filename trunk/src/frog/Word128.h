@@ -0,0 +1,201 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_WORD128_H
+#define FROG_NET_WORD128_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <frog/stdint.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * A 128-bit unsigned number made of two 64-bit words, most
+         * significant first. It is the numeric form of an IPv6 address,
+         * see Inet6Address::getWord().
+         */
+        struct Word128
+        {
+            uint64_t high; /**< The most significant 64 bits */
+            uint64_t low; /**< The least significant 64 bits */
+        };
+
+        /**
+         * Builds a Word128.
+         */
+        inline Word128 makeWord128(uint64_t high, uint64_t low) throw()
+        {
+            Word128 w;
+            w.high = high;
+            w.low = low;
+            return w;
+        }
+
+        inline bool operator==(const Word128& a, const Word128& b) throw()
+        {
+            return ((a.high ^ b.high) | (a.low ^ b.low)) == 0;
+        }
+
+        inline bool operator!=(const Word128& a, const Word128& b) throw()
+        {
+            return !(a == b);
+        }
+
+        inline bool operator<(const Word128& a, const Word128& b) throw()
+        {
+            return (a.high < b.high) | ((a.high == b.high) & (a.low < b.low));
+        }
+
+        inline Word128 operator&(const Word128& a, const Word128& b) throw()
+        {
+            return makeWord128(a.high & b.high, a.low & b.low);
+        }
+
+        inline Word128 operator|(const Word128& a, const Word128& b) throw()
+        {
+            return makeWord128(a.high | b.high, a.low | b.low);
+        }
+
+        inline Word128 operator^(const Word128& a, const Word128& b) throw()
+        {
+            return makeWord128(a.high ^ b.high, a.low ^ b.low);
+        }
+
+        inline Word128 operator~(const Word128& a) throw()
+        {
+            return makeWord128(~a.high, ~a.low);
+        }
+
+        /**
+         * Adds two numbers modulo 2^128.
+         */
+        inline Word128 operator+(const Word128& a, const Word128& b) throw()
+        {
+            uint64_t low = a.low + b.low;
+            return makeWord128(a.high + b.high + (low < a.low), low);
+        }
+
+        /**
+         * Subtracts two numbers modulo 2^128.
+         */
+        inline Word128 operator-(const Word128& a, const Word128& b) throw()
+        {
+            return makeWord128(a.high - b.high - (a.low < b.low), a.low - b.low);
+        }
+
+        /**
+         * @name Conversions from and to 64-bit integers
+         * Overloaded for the words of Inet4Address and Inet6Address, so
+         * that the algorithms of InetAddressAlgorithms.h can do address
+         * arithmetic on both.
+         */
+        //@{
+
+        /**
+         * Converts a signed number to a word modulo 2^32.
+         */
+        inline void fromInt64(int64_t value, uint32_t& out) throw()
+        {
+            out = static_cast<uint32_t>(value);
+        }
+
+        /**
+         * Converts a signed number to a word modulo 2^128: negative
+         * numbers are sign extended.
+         */
+        inline void fromInt64(int64_t value, Word128& out) throw()
+        {
+            out.high = (value < 0) ? ~0ULL : 0;
+            out.low = static_cast<uint64_t>(value);
+        }
+
+        /**
+         * Converts a word to an unsigned 64-bit number.
+         * @return Always @c true.
+         */
+        inline bool toUint64(uint32_t w, uint64_t& out) throw()
+        {
+            out = w;
+            return true;
+        }
+
+        /**
+         * Converts a word to an unsigned 64-bit number.
+         * @return @c false if the word does not fit in 64 bits.
+         */
+        inline bool toUint64(const Word128& w, uint64_t& out) throw()
+        {
+            out = w.low;
+            return (w.high == 0);
+        }
+        //@}
+
+        /**
+         * Returns the number of leading zero bits of a number: 32 for 0.
+         */
+        inline uint32_t countLeadingZeros(uint32_t w) throw()
+        {
+#ifdef __GNUC__
+            return (w == 0) ? 32U : static_cast<uint32_t>(__builtin_clz(w));
+#else
+            uint32_t n = 0;
+            for(uint32_t bit = 0x80000000U; (bit != 0) && !(w & bit); bit >>= 1)
+            {
+                ++n;
+            }
+            return n;
+#endif
+        }
+
+        /**
+         * Returns the number of leading zero bits of a number: 64 for 0.
+         */
+        inline uint32_t countLeadingZeros(uint64_t w) throw()
+        {
+            uint32_t high = static_cast<uint32_t>(w >> 32);
+            return (high != 0) ? countLeadingZeros(high) : 32U + countLeadingZeros(static_cast<uint32_t>(w));
+        }
+
+        /**
+         * Returns the number of leading zero bits of a number: 128 for 0.
+         */
+        inline uint32_t countLeadingZeros(const Word128& w) throw()
+        {
+            return (w.high != 0) ? countLeadingZeros(w.high) : 64U + countLeadingZeros(w.low);
+        }
+    } // net ns
+} // frog ns
+#endif // FROG_NET_WORD128_H
@@ -0,0 +1,120 @@
+// C++ header file -------------------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+#ifndef FROG_NET_XORADDRESSFILTER_H
+#define FROG_NET_XORADDRESSFILTER_H
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <frog/stdint.h>
+#include <frog/AddressFilter.h>
+#include <frog/IllegalArgumentException.h>
+
+/**
+ * @namespace frog The Frog Framework is library of C++ classes,
+ * interfaces, and value types.
+ */
+namespace frog
+{
+    /**
+     * @namespace frog::net Provides a simple programming
+     * interface for many of the protocols used on networking
+     * applications.
+     */
+    namespace net
+    {
+        /**
+         * A static xor filter of addresses. The filter is built once from
+         * a set of addresses and then only tested: an address is found when
+         * the xor of three 8-bit fingerprints at three positions of the
+         * table matches its own. It takes about 9.9 bits per address, less
+         * than BloomAddressFilter for the same 0.4% false positive rate.
+         * <HR>
+         * <H3>Inherits from:</H3>
+         *     &nbsp;&nbsp;&nbsp;&nbsp;&nbsp;
+         *     AddressFilter
+         * <HR>
+         */
+        class XorAddressFilter : public AddressFilter
+        {
+          public:
+              /**
+               * Creates an empty filter, which may be built or opened.
+               */
+              XorAddressFilter() throw();
+
+              /**
+               * Replaces the addresses of the filter. Repeated addresses are
+               * counted once. A mapped filter is detached from its file.
+               * @param[in] values The addresses.
+               * @param[in] count The number of addresses.
+               * @exception frog::sys::IllegalArgumentException Thrown when
+               * there are too many addresses.
+               */
+              void build(const InetAddressValue* values, size_t count) throw(sys::IllegalArgumentException);
+
+              using AddressFilter::mayContain;
+
+              virtual bool mayContain(const InetAddressValue& value) const throw();
+
+              virtual size_t mayContainBatch(const InetAddressValue* values, size_t count,
+                      uint8_t* result) const throw();
+          protected:
+              virtual bool checkParams() const throw();
+          private:
+              /**
+               * Returns the three positions of a hash.
+               */
+              void positionsOf(uint64_t hash, uint32_t positions[3]) const throw()
+              {
+                  uint64_t blockLength = params_[1];
+                  positions[0] = static_cast<uint32_t>(
+                          (static_cast<uint32_t>(hash) * blockLength) >> 32);
+                  positions[1] = static_cast<uint32_t>(
+                          (static_cast<uint32_t>((hash << 21) | (hash >> 43)) * blockLength) >> 32) +
+                      static_cast<uint32_t>(blockLength);
+                  positions[2] = static_cast<uint32_t>(
+                          (static_cast<uint32_t>((hash << 42) | (hash >> 22)) * blockLength) >> 32) +
+                      2U * static_cast<uint32_t>(blockLength);
+              }
+
+              /**
+               * Returns the fingerprint of a hash.
+               */
+              static uint8_t fingerprintOf(uint64_t hash) throw()
+              {
+                  return static_cast<uint8_t>(hash ^ (hash >> 32));
+              }
+
+              /**
+               * Returns the table of fingerprints.
+               */
+              const uint8_t* getTable() const throw()
+              {
+                  return reinterpret_cast<const uint8_t*>(words_);
+              }
+        }; // XorAddressFilter cls
+    } // net ns
+} // frog ns
+#endif // FROG_NET_XORADDRESSFILTER_H
@@ -34,8 +34,11 @@
  */
 namespace frog
 {
+#if __cplusplus < 201103L
     /**
-     * A null-pointer type.
+     * A null-pointer type. C++11 has the @c nullptr keyword, so this is
+     * only defined for older compilers; code inside namespace @c frog
+     * should use it unqualified so that it builds either way.
      *
      * @note Adapted from Item 25 of <I>Effective C++</I> by Scott Meyers.
      */
@@ -57,6 +60,7 @@ namespace frog
            */
           void operator&() const;
     } nullptr = {};
+#endif
 } // frog ns
 
 #endif // FROG_SYS_NULLPTR_H
@@ -0,0 +1,342 @@
+// C++ test file ---------------------------------------------------------//
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@gmail.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License as
+//   published by the Free Software Foundation; either version 2 of the
+//   License, or (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+//   This file is part of the Frog Framework.
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/AddressFilter.h>
+#include <frog/BloomAddressFilter.h>
+#include <frog/CuckooAddressFilter.h>
+#include <frog/XorAddressFilter.h>
+#include <frog/IllegalArgumentException.h>
+#include <frog/IOException.h>
+#include <frog/RuntimeException.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::AddressFilter;
+using frog::net::BloomAddressFilter;
+using frog::net::CuckooAddressFilter;
+using frog::net::XorAddressFilter;
+using frog::sys::IllegalArgumentException;
+using frog::sys::IOException;
+using frog::sys::RuntimeException;
+
+class AddressFilterTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(AddressFilterTest);
+
+    CPPUNIT_TEST(testBloom);
+    CPPUNIT_TEST(testCuckoo);
+    CPPUNIT_TEST(testCuckooRemove);
+    CPPUNIT_TEST(testCuckooFull);
+    CPPUNIT_TEST(testXor);
+    CPPUNIT_TEST(testBatch);
+    CPPUNIT_TEST(testReopen);
+    CPPUNIT_TEST_EXCEPTION(testBitsPerAddress, IllegalArgumentException);
+    CPPUNIT_TEST_EXCEPTION(testMappedAdd, RuntimeException);
+    CPPUNIT_TEST_EXCEPTION(testOtherKind, IOException);
+    CPPUNIT_TEST_EXCEPTION(testTruncated, IOException);
+
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void setUp()
+    {
+        std::ostringstream name;
+        name << "/tmp/AddressFilterTest." << ::getpid() << ".amf";
+        path = name.str();
+    }
+
+    void tearDown()
+    {
+        ::unlink(path.c_str());
+    }
+
+    void testBloom()
+    {
+        BloomAddressFilter filter(ADDRESS_COUNT);
+        CPPUNIT_ASSERT(filter.getCount() == 0);
+        CPPUNIT_ASSERT(!filter.mayContain(InetAddress("10.0.0.1")));
+        for(uint32_t i = 0; i < ADDRESS_COUNT; ++i)
+        {
+            filter.add(address(i));
+        }
+        CPPUNIT_ASSERT(filter.getCount() == ADDRESS_COUNT);
+        CPPUNIT_ASSERT(filter.getMemoryUsage() - ADDRESS_COUNT * 12 / 8 < 32);
+        checkFilter(filter, 0.01);
+    }
+
+    void testCuckoo()
+    {
+        CuckooAddressFilter filter(ADDRESS_COUNT);
+        CPPUNIT_ASSERT(!filter.mayContain(InetAddress("10.0.0.1")));
+        for(uint32_t i = 0; i < ADDRESS_COUNT; ++i)
+        {
+            CPPUNIT_ASSERT(filter.add(address(i)));
+        }
+        CPPUNIT_ASSERT(filter.getCount() == ADDRESS_COUNT);
+        checkFilter(filter, 0.001);
+    }
+
+    void testCuckooRemove()
+    {
+        CuckooAddressFilter filter(ADDRESS_COUNT);
+        for(uint32_t i = 0; i < ADDRESS_COUNT; ++i)
+        {
+            filter.add(address(i));
+        }
+        for(uint32_t i = 0; i < ADDRESS_COUNT; i += 2)
+        {
+            CPPUNIT_ASSERT(filter.remove(address(i)));
+        }
+        CPPUNIT_ASSERT(filter.getCount() == ADDRESS_COUNT / 2);
+        size_t positives = 0;
+        for(uint32_t i = 0; i < ADDRESS_COUNT; ++i)
+        {
+            if((i & 1) != 0)
+            {
+                CPPUNIT_ASSERT(filter.mayContain(address(i)));
+            }
+            else
+            {
+                positives += filter.mayContain(address(i));
+            }
+        }
+        CPPUNIT_ASSERT(positives < 10);
+        CPPUNIT_ASSERT(!filter.remove(InetAddress("192.0.2.1")));
+
+        // An address added twice stays until removed twice.
+#ifdef HAVE_IPV6_SUPPORT
+        InetAddress twice("2001:db8::1");
+#else
+        InetAddress twice("192.0.2.2");
+#endif
+        CPPUNIT_ASSERT(filter.add(twice));
+        CPPUNIT_ASSERT(filter.add(twice));
+        CPPUNIT_ASSERT(filter.remove(twice));
+        CPPUNIT_ASSERT(filter.mayContain(twice));
+        CPPUNIT_ASSERT(filter.remove(twice));
+    }
+
+    void testCuckooFull()
+    {
+        CuckooAddressFilter filter(100);
+        uint32_t added = 0;
+        while(filter.add(address(added)))
+        {
+            ++added;
+            CPPUNIT_ASSERT(added < 10000);
+        }
+        CPPUNIT_ASSERT(added >= 100);
+        CPPUNIT_ASSERT(filter.getCount() == added);
+        for(uint32_t i = 0; i < added; ++i)
+        {
+            CPPUNIT_ASSERT(filter.mayContain(address(i)));
+        }
+
+        // Removing any address makes room again.
+        CPPUNIT_ASSERT(filter.remove(address(7)));
+        CPPUNIT_ASSERT(filter.add(address(added)));
+        for(uint32_t i = 0; i <= added; ++i)
+        {
+            CPPUNIT_ASSERT((i == 7) || filter.mayContain(address(i)));
+        }
+    }
+
+    void testXor()
+    {
+        XorAddressFilter empty;
+        CPPUNIT_ASSERT(empty.getCount() == 0);
+
+        std::vector<InetAddressValue> values;
+        for(uint32_t i = 0; i < ADDRESS_COUNT; ++i)
+        {
+            values.push_back(address(i).getValue());
+        }
+        values.push_back(values[0]);
+        XorAddressFilter filter;
+        filter.build(&values[0], values.size());
+        CPPUNIT_ASSERT(filter.getCount() == ADDRESS_COUNT);
+        CPPUNIT_ASSERT(filter.getMemoryUsage() < ADDRESS_COUNT * 10 / 8 + 64);
+        checkFilter(filter, 0.01);
+    }
+
+    void testBatch()
+    {
+        BloomAddressFilter bloom(1000);
+        CuckooAddressFilter cuckoo(1000);
+        std::vector<InetAddressValue> values;
+        for(uint32_t i = 0; i < 1000; ++i)
+        {
+            bloom.add(address(i));
+            cuckoo.add(address(i));
+            values.push_back(address(i).getValue());
+        }
+        XorAddressFilter xor8;
+        xor8.build(&values[0], values.size());
+
+        // Tests added and other addresses, in a count that is not a
+        // multiple of the batch.
+        std::vector<InetAddressValue> queries;
+        for(uint32_t i = 500; i < 1537; ++i)
+        {
+            queries.push_back(address(i).getValue());
+        }
+        const AddressFilter* filters[] = { &bloom, &cuckoo, &xor8 };
+        for(size_t f = 0; f < 3; ++f)
+        {
+            std::vector<uint8_t> result(queries.size(), 2);
+            size_t found = filters[f]->mayContainBatch(&queries[0], queries.size(), &result[0]);
+            size_t expected = 0;
+            for(size_t i = 0; i < queries.size(); ++i)
+            {
+                CPPUNIT_ASSERT(result[i] == filters[f]->mayContain(queries[i]));
+                expected += result[i];
+            }
+            CPPUNIT_ASSERT(found == expected);
+            CPPUNIT_ASSERT(found >= 500);
+        }
+    }
+
+    void testReopen()
+    {
+        CuckooAddressFilter filter(1000);
+        for(uint32_t i = 0; i < 1000; ++i)
+        {
+            filter.add(address(i));
+        }
+        filter.write(path);
+
+        CuckooAddressFilter mapped;
+        mapped.open(path);
+        CPPUNIT_ASSERT(mapped.isMapped());
+        CPPUNIT_ASSERT(mapped.getCount() == 1000);
+        CPPUNIT_ASSERT(mapped.getMemoryUsage() == filter.getMemoryUsage());
+        for(uint32_t i = 0; i < 2000; ++i)
+        {
+            CPPUNIT_ASSERT(mapped.mayContain(address(i)) == filter.mayContain(address(i)));
+        }
+
+        std::vector<InetAddressValue> values(1, InetAddress("10.1.2.3").getValue());
+        XorAddressFilter xor8;
+        xor8.build(&values[0], values.size());
+        xor8.write(path);
+        XorAddressFilter reopened;
+        reopened.open(path);
+        CPPUNIT_ASSERT(reopened.mayContain(InetAddress("10.1.2.3")));
+
+        // Building again detaches the filter from the file.
+        reopened.build(&values[0], 0);
+        CPPUNIT_ASSERT(!reopened.isMapped());
+        CPPUNIT_ASSERT(reopened.getCount() == 0);
+    }
+
+    void testBitsPerAddress()
+    {
+        BloomAddressFilter filter(100, 0);
+    }
+
+    void testMappedAdd()
+    {
+        BloomAddressFilter filter(100);
+        filter.add(InetAddress("10.0.0.1"));
+        filter.write(path);
+        BloomAddressFilter mapped;
+        mapped.open(path);
+        CPPUNIT_ASSERT(mapped.mayContain(InetAddress("10.0.0.1")));
+        mapped.add(InetAddress("10.0.0.2"));
+    }
+
+    void testOtherKind()
+    {
+        BloomAddressFilter filter(100);
+        filter.write(path);
+        CuckooAddressFilter other;
+        try
+        {
+            other.open(path);
+        }
+        catch(const IOException&)
+        {
+            CPPUNIT_ASSERT(!other.isMapped());
+            throw;
+        }
+    }
+
+    void testTruncated()
+    {
+        BloomAddressFilter filter(1000);
+        filter.write(path);
+        CPPUNIT_ASSERT(::truncate(path.c_str(), sizeof(AddressFilter::Header) + 8) == 0);
+        BloomAddressFilter truncated;
+        truncated.open(path);
+    }
+
+  private:
+    static const uint32_t ADDRESS_COUNT = 20000;
+
+    std::string path;
+
+    /**
+     * Returns the address number @arg i, mixing IPv4 and IPv6 addresses
+     * when IPv6 is supported.
+     */
+    static InetAddress address(uint32_t i)
+    {
+#ifdef HAVE_IPV6_SUPPORT
+        if((i & 1) != 0)
+        {
+            return InetAddress("2001:db8::") + i;
+        }
+#endif
+        return InetAddress("10.0.0.0") + i;
+    }
+
+    /**
+     * Checks the filter holds the first ADDRESS_COUNT addresses and that
+     * at most @arg rate of the next ones test positive.
+     */
+    static void checkFilter(const AddressFilter& filter, double rate)
+    {
+        for(uint32_t i = 0; i < ADDRESS_COUNT; ++i)
+        {
+            CPPUNIT_ASSERT(filter.mayContain(address(i)));
+        }
+        size_t positives = 0;
+        for(uint32_t i = ADDRESS_COUNT; i < 6 * ADDRESS_COUNT; ++i)
+        {
+            positives += filter.mayContain(address(i));
+        }
+        CPPUNIT_ASSERT(positives <= rate * 5 * ADDRESS_COUNT);
+    }
+};
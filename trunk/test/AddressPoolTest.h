@@ -0,0 +1,221 @@
+// C++ test file ---------------------------------------------------------//
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@gmail.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License as
+//   published by the Free Software Foundation; either version 2 of the
+//   License, or (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+//   This file is part of the Frog Framework.
+
+#include <sys/types.h>
+#include <pthread.h>
+
+#include <string>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/AddressPool.h>
+#include <frog/IllegalArgumentException.h>
+#include <frog/OverflowException.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::AddressPool;
+using frog::sys::IllegalArgumentException;
+using frog::sys::OverflowException;
+
+class AddressPoolTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(AddressPoolTest);
+
+    CPPUNIT_TEST(testIntern);
+    CPPUNIT_TEST(testFind);
+    CPPUNIT_TEST(testFull);
+    CPPUNIT_TEST_EXCEPTION(testFullException, OverflowException);
+    CPPUNIT_TEST_EXCEPTION(testCapacityZero, IllegalArgumentException);
+    CPPUNIT_TEST(testThreads);
+
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void setUp()
+    {
+    }
+
+    void tearDown()
+    {
+    }
+
+    void testIntern()
+    {
+        AddressPool pool(100);
+        CPPUNIT_ASSERT(pool.getSize() == 0);
+        CPPUNIT_ASSERT(pool.getCapacity() == 100);
+
+#ifdef HAVE_IPV6_SUPPORT
+        // The same address in another scope is another address.
+        InetAddress second("fe80::1");
+        InetAddress third("fe80::1", 2);
+#else
+        InetAddress second("10.0.0.2");
+        InetAddress third("10.0.0.3");
+#endif
+        CPPUNIT_ASSERT(pool.intern(InetAddress("10.0.0.1")) == 0);
+        CPPUNIT_ASSERT(pool.intern(second) == 1);
+        CPPUNIT_ASSERT(pool.intern(third) == 2);
+        CPPUNIT_ASSERT(pool.intern(InetAddress("10.0.0.1")) == 0);
+        CPPUNIT_ASSERT(pool.intern(third) == 2);
+        CPPUNIT_ASSERT(pool.getSize() == 3);
+
+        CPPUNIT_ASSERT(pool.getAddress(0) == InetAddress("10.0.0.1"));
+        CPPUNIT_ASSERT(pool.getAddress(2) == third);
+        CPPUNIT_ASSERT(pool.getValue(1) == second.getValue());
+        CPPUNIT_ASSERT(pool.getMemoryUsage() >= 100 * sizeof(InetAddressValue));
+    }
+
+    void testFind()
+    {
+        AddressPool pool(1000);
+        for(uint32_t i = 0; i < 1000; ++i)
+        {
+            CPPUNIT_ASSERT(pool.intern(InetAddress("192.168.0.0") + i) == i);
+        }
+        for(uint32_t i = 0; i < 1000; ++i)
+        {
+            uint32_t id = ~0U;
+            CPPUNIT_ASSERT(pool.find((InetAddress("192.168.0.0") + i).getValue(), id));
+            CPPUNIT_ASSERT(id == i);
+        }
+        uint32_t id = 12345;
+        CPPUNIT_ASSERT(!pool.find(InetAddress("192.168.3.232").getValue(), id));
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(!pool.find(InetAddress("::").getValue(), id));
+#endif
+        CPPUNIT_ASSERT(id == 12345);
+        CPPUNIT_ASSERT(pool.getSize() == 1000);
+    }
+
+    void testFull()
+    {
+        AddressPool pool(3);
+        uint32_t id = 0;
+        InetAddress addr("10.0.0.0");
+        for(uint32_t i = 0; i < 3; ++i)
+        {
+            CPPUNIT_ASSERT(pool.tryIntern((addr + i).getValue(), id));
+            CPPUNIT_ASSERT(id == i);
+        }
+        for(uint32_t i = 3; i < 100; ++i)
+        {
+            CPPUNIT_ASSERT(!pool.tryIntern((addr + i).getValue(), id));
+        }
+        CPPUNIT_ASSERT(pool.tryIntern((addr + 1).getValue(), id));
+        CPPUNIT_ASSERT(id == 1);
+        CPPUNIT_ASSERT(pool.getSize() == 3);
+    }
+
+    void testFullException()
+    {
+        AddressPool pool(1);
+        pool.intern(InetAddress("10.0.0.1"));
+        pool.intern(InetAddress("10.0.0.2"));
+    }
+
+    void testCapacityZero()
+    {
+        AddressPool pool(0);
+    }
+
+    void testThreads()
+    {
+        // Every thread interns the same addresses in a different order.
+        AddressPool pool(THREAD_ADDRESSES);
+        std::vector<Worker> workers(THREAD_COUNT);
+        std::vector<pthread_t> threads(THREAD_COUNT);
+        for(size_t t = 0; t < THREAD_COUNT; ++t)
+        {
+            workers[t].pool = &pool;
+            workers[t].start = static_cast<uint32_t>(t * 7919U);
+            workers[t].ids.resize(THREAD_ADDRESSES);
+            CPPUNIT_ASSERT(::pthread_create(&threads[t], NULL, work, &workers[t]) == 0);
+        }
+        for(size_t t = 0; t < THREAD_COUNT; ++t)
+        {
+            ::pthread_join(threads[t], NULL);
+        }
+
+        CPPUNIT_ASSERT(pool.getSize() == THREAD_ADDRESSES);
+        std::vector<bool> used(THREAD_ADDRESSES, false);
+        for(uint32_t i = 0; i < THREAD_ADDRESSES; ++i)
+        {
+            uint32_t id = workers[0].ids[i];
+            CPPUNIT_ASSERT(id < THREAD_ADDRESSES);
+            CPPUNIT_ASSERT(!used[id]);
+            used[id] = true;
+            CPPUNIT_ASSERT(pool.getValue(id) == address(i));
+            for(size_t t = 1; t < THREAD_COUNT; ++t)
+            {
+                CPPUNIT_ASSERT(workers[t].ids[i] == id);
+            }
+        }
+    }
+  private:
+    static const size_t THREAD_COUNT = 8;
+    static const uint32_t THREAD_ADDRESSES = 50000;
+
+    struct Worker
+    {
+        AddressPool* pool;
+        uint32_t start;
+        std::vector<uint32_t> ids;
+        Worker() : pool(NULL), start(0) { }
+    };
+
+    // The i th address of the test: IPv4 and IPv6 addresses mixed
+    // when IPv6 is supported.
+    static InetAddressValue address(uint32_t i)
+    {
+#ifdef HAVE_IPV6_SUPPORT
+        InetAddress base((i & 1) ? "2001:db8::" : "100.64.0.0");
+#else
+        InetAddress base("100.64.0.0");
+#endif
+        return (base + i).getValue();
+    }
+
+    static void* work(void* arg)
+    {
+        Worker* worker = static_cast<Worker*>(arg);
+        for(uint32_t n = 0; n < THREAD_ADDRESSES; ++n)
+        {
+            uint32_t i = (worker->start + n) % THREAD_ADDRESSES;
+            uint32_t id;
+            if(worker->pool->tryIntern(address(i), id))
+            {
+                worker->ids[i] = id;
+            }
+            else
+            {
+                worker->ids[i] = ~0U;
+            }
+        }
+        return NULL;
+    }
+};
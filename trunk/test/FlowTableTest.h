@@ -0,0 +1,379 @@
+// C++ test file ---------------------------------------------------------//
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@gmail.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License as
+//   published by the Free Software Foundation; either version 2 of the
+//   License, or (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+//   This file is part of the Frog Framework.
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <frog/InetAddress.h>
+#include <frog/IPEndpoint.h>
+#include <frog/FlowKey.h>
+#include <frog/FlowTable.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+using frog::net::InetAddress;
+using frog::net::IPEndpoint;
+using frog::net::FlowKey4;
+using frog::net::FlowKey6;
+using frog::net::FlowTable;
+
+// Flows whose value is odd, for eraseIf().
+static bool isOdd(const FlowKey4&, uint32_t& value)
+{
+    return (value & 1U) != 0;
+}
+
+class FlowTableTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(FlowTableTest);
+
+    CPPUNIT_TEST(testFlowKey4);
+#ifdef HAVE_IPV6_SUPPORT
+    CPPUNIT_TEST(testFlowKey6);
+#endif
+    CPPUNIT_TEST(testInsertFind);
+    CPPUNIT_TEST(testErase);
+    CPPUNIT_TEST(testGrow);
+    CPPUNIT_TEST(testChurn);
+    CPPUNIT_TEST(testEraseIf);
+    CPPUNIT_TEST(testFindMany);
+#ifdef HAVE_IPV6_SUPPORT
+    CPPUNIT_TEST(testValues);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void setUp()
+    {
+    }
+
+    void tearDown()
+    {
+    }
+
+    void testFlowKey4()
+    {
+        CPPUNIT_ASSERT(sizeof(FlowKey4) == 13);
+
+        InetAddress client("192.168.1.10");
+        InetAddress server("203.0.113.80");
+        IPEndpoint src(client, 51000);
+        IPEndpoint dst(server, 443);
+        FlowKey4 key;
+        CPPUNIT_ASSERT(FlowKey4::make(src, dst, IPPROTO_TCP, key));
+        CPPUNIT_ASSERT(key.source[0] == 192 && key.destination[3] == 80);
+        CPPUNIT_ASSERT(key.sourcePort[0] == (51000 >> 8) && key.sourcePort[1] == (51000 & 0xff));
+        CPPUNIT_ASSERT(key.protocol == IPPROTO_TCP);
+        CPPUNIT_ASSERT(key.getSource() == src);
+        CPPUNIT_ASSERT(key.getDestination() == dst);
+
+        FlowKey4 reply = key.reverse();
+        CPPUNIT_ASSERT(reply.getSource() == dst);
+        CPPUNIT_ASSERT(reply.getDestination() == src);
+        CPPUNIT_ASSERT(reply != key);
+        CPPUNIT_ASSERT(reply.isReverseOf(key));
+        CPPUNIT_ASSERT(key.isReverseOf(reply));
+        CPPUNIT_ASSERT(!key.isReverseOf(key));
+        CPPUNIT_ASSERT(reply.reverse() == key);
+        CPPUNIT_ASSERT(reply.hash() == key.hash());
+
+        FlowKey4 udp;
+        CPPUNIT_ASSERT(FlowKey4::make(src, dst, IPPROTO_UDP, udp));
+        CPPUNIT_ASSERT(udp != key);
+        CPPUNIT_ASSERT(!udp.isReverseOf(reply));
+        CPPUNIT_ASSERT(udp.hash() != key.hash());
+
+        // Swapping only the ports is another flow.
+        IPEndpoint swapped(client, 443);
+        IPEndpoint swapped2(server, 51000);
+        FlowKey4 other;
+        CPPUNIT_ASSERT(FlowKey4::make(swapped, swapped2, IPPROTO_TCP, other));
+        CPPUNIT_ASSERT(other != key && !other.isReverseOf(key));
+
+#ifdef HAVE_IPV6_SUPPORT
+        InetAddress v6("2001:db8::1");
+        IPEndpoint dst6(v6, 443);
+        FlowKey4 untouched = key;
+        CPPUNIT_ASSERT(!FlowKey4::make(src, dst6, IPPROTO_TCP, untouched));
+        CPPUNIT_ASSERT(untouched == key);
+#else
+        FlowKey6 key6;
+        CPPUNIT_ASSERT(!FlowKey6::make(src, dst, IPPROTO_TCP, key6));
+#endif
+    }
+
+    void testFlowKey6()
+    {
+        CPPUNIT_ASSERT(sizeof(FlowKey6) == 37);
+
+        InetAddress client("2001:db8::10");
+        InetAddress server("2001:db8:1::80");
+        IPEndpoint src(client, 40000);
+        IPEndpoint dst(server, 53);
+        FlowKey6 key;
+        CPPUNIT_ASSERT(FlowKey6::make(src, dst, IPPROTO_UDP, key));
+        CPPUNIT_ASSERT(key.getSource() == src);
+        CPPUNIT_ASSERT(key.getDestination() == dst);
+        CPPUNIT_ASSERT(key.reverse().isReverseOf(key));
+        CPPUNIT_ASSERT(key.reverse().hash() == key.hash());
+        CPPUNIT_ASSERT(!key.isReverseOf(key));
+
+        // IPv4 endpoints are mapped.
+        InetAddress v4("192.0.2.1");
+        IPEndpoint src4(v4, 1234);
+        FlowKey6 mixed;
+        CPPUNIT_ASSERT(FlowKey6::make(src4, dst, IPPROTO_UDP, mixed));
+        CPPUNIT_ASSERT(mixed.getSource().address == InetAddress("::ffff:192.0.2.1"));
+        CPPUNIT_ASSERT(mixed.getSource().port == 1234);
+
+        IPEndpoint empty;
+        CPPUNIT_ASSERT(!FlowKey6::make(empty, dst, IPPROTO_UDP, mixed));
+    }
+
+    void testInsertFind()
+    {
+        FlowTable<FlowKey4, uint32_t> table;
+        CPPUNIT_ASSERT(table.isEmpty());
+        CPPUNIT_ASSERT(table.getCapacity() == 0);
+
+        FlowKey4 key = makeKey(1);
+        bool reply = true;
+        CPPUNIT_ASSERT(table.find(key) == NULL);
+        CPPUNIT_ASSERT(table.find(key, reply) == NULL);
+
+        std::pair<uint32_t*, bool> result = table.insert(key, 7);
+        CPPUNIT_ASSERT(result.second);
+        CPPUNIT_ASSERT(*result.first == 7);
+        CPPUNIT_ASSERT(table.getSize() == 1);
+        CPPUNIT_ASSERT(table.getCapacity() == 16);
+
+        CPPUNIT_ASSERT(table.find(key, reply) == result.first);
+        CPPUNIT_ASSERT(!reply);
+        CPPUNIT_ASSERT(table.find(key.reverse(), reply) == result.first);
+        CPPUNIT_ASSERT(reply);
+
+        // The reply direction is the same flow.
+        result = table.insert(key.reverse(), 8);
+        CPPUNIT_ASSERT(!result.second);
+        CPPUNIT_ASSERT(*result.first == 7);
+        CPPUNIT_ASSERT(table.getSize() == 1);
+
+        table[makeKey(2)] = 9;
+        table[makeKey(2).reverse()] += 1;
+        CPPUNIT_ASSERT(*table.find(makeKey(2)) == 10);
+        CPPUNIT_ASSERT(table.getSize() == 2);
+
+        const FlowTable<FlowKey4, uint32_t>& constTable = table;
+        CPPUNIT_ASSERT(*constTable.find(key) == 7);
+        CPPUNIT_ASSERT(constTable.find(makeKey(3)) == NULL);
+
+        table.clear();
+        CPPUNIT_ASSERT(table.isEmpty());
+        CPPUNIT_ASSERT(table.find(key) == NULL);
+        CPPUNIT_ASSERT(table.getMemoryUsage() == 0);
+    }
+
+    void testErase()
+    {
+        FlowTable<FlowKey4, uint32_t> table(100);
+        CPPUNIT_ASSERT(table.getCapacity() == 128);
+        for(uint32_t i = 0; i < 100; ++i)
+        {
+            table.insert(makeKey(i), i);
+        }
+        CPPUNIT_ASSERT(table.getCapacity() == 128);
+
+        CPPUNIT_ASSERT(table.erase(makeKey(10)));
+        CPPUNIT_ASSERT(table.erase(makeKey(11).reverse()));
+        CPPUNIT_ASSERT(!table.erase(makeKey(10)));
+        CPPUNIT_ASSERT(!table.erase(makeKey(1000)));
+        CPPUNIT_ASSERT(table.getSize() == 98);
+        CPPUNIT_ASSERT(table.find(makeKey(10)) == NULL);
+        CPPUNIT_ASSERT(table.find(makeKey(11)) == NULL);
+        for(uint32_t i = 0; i < 100; ++i)
+        {
+            if((i != 10) && (i != 11))
+            {
+                CPPUNIT_ASSERT(*table.find(makeKey(i)) == i);
+            }
+        }
+
+        CPPUNIT_ASSERT(table.insert(makeKey(10), 20).second);
+        CPPUNIT_ASSERT(*table.find(makeKey(10).reverse()) == 20);
+    }
+
+    void testGrow()
+    {
+        const uint32_t count = 200000;
+        FlowTable<FlowKey4, uint32_t> table;
+        bool resized = false;
+        for(uint32_t i = 0; i < count; ++i)
+        {
+            CPPUNIT_ASSERT(table.insert(makeKey(i * 2654435761U), i).second);
+            if(table.isResizing())
+            {
+                resized = true;
+                // Every flow is found while the table grows.
+                CPPUNIT_ASSERT(*table.find(makeKey(i * 2654435761U)) == i);
+                CPPUNIT_ASSERT(*table.find(makeKey(0).reverse()) == 0);
+            }
+        }
+        CPPUNIT_ASSERT(resized);
+        CPPUNIT_ASSERT(table.getSize() == count);
+        CPPUNIT_ASSERT(table.getCapacity() == 262144);
+
+        for(uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t* value = table.find(makeKey(i * 2654435761U).reverse());
+            CPPUNIT_ASSERT(value != NULL && *value == i);
+        }
+        CPPUNIT_ASSERT(table.find(makeKey(1)) == NULL);
+        CPPUNIT_ASSERT(table.getMemoryUsage() <= 262144 * 22 * 3 / 2);
+    }
+
+    void testChurn()
+    {
+        // Flows come and go; deleted slots must not make the table grow
+        // without bound or break the probe sequences.
+        FlowTable<FlowKey4, uint32_t> table;
+        std::map<uint32_t, uint32_t> reference;
+        uint32_t seed = 1;
+        size_t maxCapacity = 0;
+        for(uint32_t round = 0; round < 400000; ++round)
+        {
+            seed = seed * 1103515245U + 12345U;
+            uint32_t id = (seed >> 8) % 5000;
+            if(seed & 0x80000000U)
+            {
+                CPPUNIT_ASSERT(table.insert(makeKey(id), round).second == (reference.count(id) == 0));
+                reference.insert(std::make_pair(id, round));
+            }
+            else
+            {
+                CPPUNIT_ASSERT(table.erase(makeKey(id).reverse()) == (reference.erase(id) == 1));
+            }
+            if(table.getCapacity() > maxCapacity)
+            {
+                maxCapacity = table.getCapacity();
+            }
+        }
+        CPPUNIT_ASSERT(table.getSize() == reference.size());
+        CPPUNIT_ASSERT(maxCapacity <= 8192);
+        for(uint32_t id = 0; id < 5000; ++id)
+        {
+            const uint32_t* value = table.find(makeKey(id));
+            std::map<uint32_t, uint32_t>::const_iterator it = reference.find(id);
+            CPPUNIT_ASSERT((value == NULL) == (it == reference.end()));
+            CPPUNIT_ASSERT((value == NULL) || (*value == it->second));
+        }
+    }
+
+    void testEraseIf()
+    {
+        FlowTable<FlowKey4, uint32_t> table;
+        for(uint32_t i = 0; i < 1000; ++i)
+        {
+            table.insert(makeKey(i), i);
+        }
+        CPPUNIT_ASSERT(table.eraseIf(isOdd) == 500);
+        CPPUNIT_ASSERT(table.getSize() == 500);
+        for(uint32_t i = 0; i < 1000; ++i)
+        {
+            CPPUNIT_ASSERT((table.find(makeKey(i)) == NULL) == ((i & 1U) != 0));
+        }
+        CPPUNIT_ASSERT(table.eraseIf(isOdd) == 0);
+    }
+
+    void testFindMany()
+    {
+        FlowTable<FlowKey4, uint32_t> table;
+        std::vector<FlowKey4> keys;
+        for(uint32_t i = 0; i < 1000; ++i)
+        {
+            table.insert(makeKey(i), i);
+            keys.push_back((i & 2U) ? makeKey(i).reverse() : makeKey(i + 5000));
+        }
+
+        std::vector<uint32_t*> result(keys.size());
+        CPPUNIT_ASSERT(table.findMany(&keys[0], keys.size(), &result[0]) == 500);
+        for(uint32_t i = 0; i < 1000; ++i)
+        {
+            CPPUNIT_ASSERT(result[i] == table.find(keys[i]));
+        }
+
+        FlowTable<FlowKey4, uint32_t> empty;
+        CPPUNIT_ASSERT(empty.findMany(&keys[0], keys.size(), &result[0]) == 0);
+        CPPUNIT_ASSERT(result[0] == NULL);
+    }
+
+    void testValues()
+    {
+        // Values that own memory are copied when the table grows and
+        // destroyed when flows are removed.
+        FlowTable<FlowKey6, std::string> table;
+        InetAddress client("2001:db8::1");
+        InetAddress server("2001:db8::2");
+        for(uint32_t i = 0; i < 5000; ++i)
+        {
+            IPEndpoint src(client, static_cast<in_port_t>(i));
+            IPEndpoint dst(server, 80);
+            FlowKey6 key;
+            CPPUNIT_ASSERT(FlowKey6::make(src, dst, IPPROTO_TCP, key));
+            table[key] = std::string(100, static_cast<char>('a' + (i % 26)));
+            if(i % 3 == 0)
+            {
+                CPPUNIT_ASSERT(table.erase(key.reverse()));
+            }
+        }
+        CPPUNIT_ASSERT(table.getSize() == 3333);
+
+        IPEndpoint src(client, 4999);
+        IPEndpoint dst(server, 80);
+        FlowKey6 key;
+        FlowKey6::make(dst, src, IPPROTO_TCP, key);
+        CPPUNIT_ASSERT(*table.find(key) == std::string(100, static_cast<char>('a' + (4999 % 26))));
+    }
+
+  private:
+    // A TCP flow from 10.x.y.z:port to 198.51.100.1:443.
+    static FlowKey4 makeKey(uint32_t id)
+    {
+        FlowKey4 key;
+        key.source[0] = 10;
+        key.source[1] = static_cast<uint8_t>(id >> 16);
+        key.source[2] = static_cast<uint8_t>(id >> 8);
+        key.source[3] = static_cast<uint8_t>(id);
+        key.destination[0] = 198;
+        key.destination[1] = 51;
+        key.destination[2] = 100;
+        key.destination[3] = 1;
+        key.sourcePort[0] = static_cast<uint8_t>(id >> 24);
+        key.sourcePort[1] = static_cast<uint8_t>(id >> 3);
+        key.destinationPort[0] = 443 >> 8;
+        key.destinationPort[1] = 443 & 0xff;
+        key.protocol = IPPROTO_TCP;
+        return key;
+    }
+};
@@ -22,9 +22,15 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <frog/InetAddress.h>
 #include <frog/IPEndpoint.h>
+#include <frog/IPEndpointView.h>
 #include <frog/IllegalArgumentException.h>
 
 #include <cstdio>
+#include <cstring>
+#if __cplusplus >= 201103L
+#include <type_traits>
+#include <utility>
+#endif
 
 #ifdef HAVE_CONFIG_H
 #include <config.h>
@@ -32,6 +38,7 @@
 
 using frog::net::InetAddress;
 using frog::net::IPEndpoint;
+using frog::net::IPEndpointView;
 using frog::sys::IllegalArgumentException;
 
 class IPEndpointTest : public CppUnit::TestFixture
@@ -42,6 +49,9 @@ class IPEndpointTest : public CppUnit::TestFixture
     CPPUNIT_TEST(testPropertyChange);
     CPPUNIT_TEST(testAddressFamily);
     CPPUNIT_TEST(testAssignment);
+#if __cplusplus >= 201103L
+    CPPUNIT_TEST(testMove);
+#endif
     CPPUNIT_TEST(testEquality);
 #ifdef HAVE_IPV6_SUPPORT
     CPPUNIT_TEST_FAIL(testEquality1);
@@ -61,6 +71,19 @@ class IPEndpointTest : public CppUnit::TestFixture
 #else
     CPPUNIT_TEST_EXCEPTION(testToString2, frog::sys::IllegalArgumentException);
 #endif
+    CPPUNIT_TEST(testFormat);
+    CPPUNIT_TEST(testHashCode);
+    CPPUNIT_TEST(testOrdering);
+    CPPUNIT_TEST(testSockAddr);
+#ifdef HAVE_IPV6_SUPPORT
+    CPPUNIT_TEST(testSockAddr6);
+#endif
+    CPPUNIT_TEST(testView);
+    CPPUNIT_TEST(testTryParse);
+#ifdef HAVE_IPV6_SUPPORT
+    CPPUNIT_TEST(testTryParse6);
+#endif
+    CPPUNIT_TEST(testTryParseList);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -74,7 +97,7 @@ class IPEndpointTest : public CppUnit::TestFixture
         CPPUNIT_ASSERT(endpoint.address == addr);
         CPPUNIT_ASSERT(endpoint.address.toString() == addr.toString());
         CPPUNIT_ASSERT(endpoint.port == port);
-        CPPUNIT_ASSERT(endpoint.addressFamily == addr.addressFamily);
+        CPPUNIT_ASSERT(endpoint.getAddressFamily() == addr.getAddressFamily());
     }
 
     void testPropertyChange()
@@ -99,8 +122,8 @@ class IPEndpointTest : public CppUnit::TestFixture
         InetAddress addr("255.255.255.255");
         IPEndpoint endpoint(addr, 65535);
 
-        CPPUNIT_ASSERT(endpoint.address.addressFamily == AddressFamily::InterNetwork);
-        CPPUNIT_ASSERT(endpoint.addressFamily == AddressFamily::InterNetwork);
+        CPPUNIT_ASSERT(endpoint.address.getAddressFamily() == AddressFamily::InterNetwork);
+        CPPUNIT_ASSERT(endpoint.getAddressFamily() == AddressFamily::InterNetwork);
     }
 
     void testAssignment()
@@ -116,6 +139,31 @@ class IPEndpointTest : public CppUnit::TestFixture
         CPPUNIT_ASSERT(endpoint == endpoint2);
     }
 
+#if __cplusplus >= 201103L
+    void testMove()
+    {
+        static_assert(std::is_nothrow_move_constructible<IPEndpoint>::value,
+                "IPEndpoint must be nothrow movable");
+        static_assert(std::is_nothrow_move_assignable<InetAddress>::value,
+                "InetAddress must be nothrow movable");
+
+        InetAddress addr("1.1.1.1");
+        IPEndpoint endpoint(addr, 1000);
+        IPEndpoint expected(endpoint);
+
+        IPEndpoint moved(std::move(endpoint));
+        CPPUNIT_ASSERT(moved == expected);
+
+        InetAddress addr2("2.2.2.2");
+        IPEndpoint endpoint2(addr2, 1111);
+        endpoint2 = std::move(moved);
+        CPPUNIT_ASSERT(endpoint2 == expected);
+
+        InetAddress movedAddr(std::move(addr));
+        CPPUNIT_ASSERT(movedAddr == InetAddress("1.1.1.1"));
+    }
+#endif
+
     void testEquality()
     {
         InetAddress addr("1.1.1.1");
@@ -235,4 +283,293 @@ class IPEndpointTest : public CppUnit::TestFixture
 
         CPPUNIT_ASSERT(endpoint2.toString() == "[::1]:1111");
     }
+
+    void testFormat()
+    {
+        char buf[IPEndpoint::MAX_TEXT_SIZE];
+        InetAddress addr("192.168.100.200");
+        IPEndpoint endpoint(addr, 0);
+        CPPUNIT_ASSERT(endpoint.format(buf, sizeof(buf)) == 17);
+        CPPUNIT_ASSERT(!strcmp(buf, "192.168.100.200:0"));
+
+        endpoint.port = 65535;
+        CPPUNIT_ASSERT(endpoint.format(buf, sizeof(buf)) == 21);
+        CPPUNIT_ASSERT(!strcmp(buf, "192.168.100.200:65535"));
+        CPPUNIT_ASSERT(endpoint.toString() == buf);
+        CPPUNIT_ASSERT(endpoint.format(buf, 21) == 0);
+        CPPUNIT_ASSERT(endpoint.format(buf, 22) == 21);
+#ifdef HAVE_IPV6_SUPPORT
+        InetAddress addr2("fe80::1", 3);
+        IPEndpoint endpoint2(addr2, 80);
+        CPPUNIT_ASSERT(endpoint2.format(buf, sizeof(buf)) == 14);
+        CPPUNIT_ASSERT(!strcmp(buf, "[fe80::1%3]:80"));
+#endif
+    }
+
+    void testHashCode()
+    {
+        InetAddress addr("10.1.0.1");
+        IPEndpoint endpoint(addr, 80);
+        IPEndpoint endpoint2(addr, 80);
+        IPEndpoint endpoint3(addr, 81);
+
+        CPPUNIT_ASSERT(endpoint.hashCode() == endpoint2.hashCode());
+        CPPUNIT_ASSERT(endpoint.hashCode() != endpoint3.hashCode());
+        CPPUNIT_ASSERT(endpoint.hashCode() != addr.hashCode());
+        CPPUNIT_ASSERT(frog::net::IPEndpointHash()(endpoint) == frog::net::IPEndpointHash()(endpoint2));
+        CPPUNIT_ASSERT(endpoint.sameObject(&endpoint2));
+    }
+
+    void testOrdering()
+    {
+        InetAddress addr("10.1.0.1");
+        InetAddress addr2("10.1.0.2");
+        IPEndpoint a(addr, 443);
+        IPEndpoint b(addr, 8080);
+        IPEndpoint c(addr2, 80);
+
+        CPPUNIT_ASSERT(a < b);
+        CPPUNIT_ASSERT(b < c);
+        CPPUNIT_ASSERT(a < c);
+        CPPUNIT_ASSERT(!(b < a));
+        CPPUNIT_ASSERT(!(a < a));
+
+        uint8_t key[IPEndpoint::SORT_KEY_SIZE], next[IPEndpoint::SORT_KEY_SIZE];
+        a.sortKey(key);
+        b.sortKey(next);
+        CPPUNIT_ASSERT(memcmp(key, next, sizeof(key)) < 0);
+        b.sortKey(key);
+        c.sortKey(next);
+        CPPUNIT_ASSERT(memcmp(key, next, sizeof(key)) < 0);
+    }
+
+    void testSockAddr()
+    {
+        InetAddress addr("192.168.10.1");
+        IPEndpoint endpoint(addr, 5353);
+        struct sockaddr_storage storage;
+        socklen_t length = 0;
+
+        CPPUNIT_ASSERT(endpoint.toSockAddr(storage, length));
+        CPPUNIT_ASSERT(length == sizeof(struct sockaddr_in));
+        const struct sockaddr_in* in = reinterpret_cast<const struct sockaddr_in*>(&storage);
+        CPPUNIT_ASSERT(in->sin_family == AF_INET);
+        CPPUNIT_ASSERT(in->sin_port == htons(5353));
+        struct in_addr raw;
+        addr.getPrimitive(raw);
+        CPPUNIT_ASSERT(in->sin_addr.s_addr == raw.s_addr);
+
+        IPEndpoint copy;
+        CPPUNIT_ASSERT(copy.getAddressFamily() == frog::net::AddressFamily::Unspecified);
+        CPPUNIT_ASSERT(copy.fromSockAddr(reinterpret_cast<const struct sockaddr*>(&storage), length));
+        CPPUNIT_ASSERT(copy == endpoint);
+        CPPUNIT_ASSERT(copy.getAddressFamily() == frog::net::AddressFamily::InterNetwork);
+        CPPUNIT_ASSERT(copy.address.isIPv4Compatible());
+        CPPUNIT_ASSERT(copy.hash() == endpoint.hash());
+        CPPUNIT_ASSERT(copy.toString() == "192.168.10.1:5353");
+
+        // Failures leave the endpoint untouched.
+        CPPUNIT_ASSERT(!copy.fromSockAddr(NULL, length));
+        CPPUNIT_ASSERT(!copy.fromSockAddr(reinterpret_cast<const struct sockaddr*>(&storage), length - 1));
+        storage.ss_family = AF_UNIX;
+        CPPUNIT_ASSERT(!copy.fromSockAddr(reinterpret_cast<const struct sockaddr*>(&storage), sizeof(storage)));
+        CPPUNIT_ASSERT(copy == endpoint);
+
+        IPEndpoint empty;
+        length = 0;
+        CPPUNIT_ASSERT(!empty.toSockAddr(storage, length));
+        CPPUNIT_ASSERT(length == 0);
+    }
+
+#ifdef HAVE_IPV6_SUPPORT
+    void testSockAddr6()
+    {
+        InetAddress addr("fe80::1", 3);
+        IPEndpoint endpoint(addr, 546);
+        struct sockaddr_storage storage;
+        socklen_t length = 0;
+
+        CPPUNIT_ASSERT(endpoint.toSockAddr(storage, length));
+        CPPUNIT_ASSERT(length == sizeof(struct sockaddr_in6));
+        const struct sockaddr_in6* in6 = reinterpret_cast<const struct sockaddr_in6*>(&storage);
+        CPPUNIT_ASSERT(in6->sin6_family == AF_INET6);
+        CPPUNIT_ASSERT(in6->sin6_port == htons(546));
+        CPPUNIT_ASSERT(in6->sin6_scope_id == 3);
+        CPPUNIT_ASSERT(memcmp(&in6->sin6_addr, addr.getValue().address, 16) == 0);
+
+        InetAddress other("10.0.0.1");
+        IPEndpoint copy(other, 80);
+        CPPUNIT_ASSERT(copy.fromSockAddr(reinterpret_cast<const struct sockaddr*>(&storage), length));
+        CPPUNIT_ASSERT(copy == endpoint);
+        CPPUNIT_ASSERT(copy.getAddressFamily() == frog::net::AddressFamily::InterNetworkV6);
+        CPPUNIT_ASSERT(!copy.address.isIPv4Compatible());
+        CPPUNIT_ASSERT(copy.address.getValue() == addr.getValue());
+        CPPUNIT_ASSERT(copy.toString() == endpoint.toString());
+
+        InetAddress compatible("::ffff:10.0.0.1");
+        IPEndpoint mapped(compatible, 80);
+        CPPUNIT_ASSERT(mapped.toSockAddr(storage, length));
+        CPPUNIT_ASSERT(copy.fromSockAddr(reinterpret_cast<const struct sockaddr*>(&storage), length));
+        CPPUNIT_ASSERT(copy == mapped);
+        CPPUNIT_ASSERT(copy.address.isIPv4Compatible() == compatible.isIPv4Compatible());
+    }
+#endif
+
+    void testView()
+    {
+        InetAddress addr("172.16.0.9");
+        IPEndpoint endpoint(addr, 8080);
+        struct sockaddr_storage storage;
+        socklen_t length = 0;
+        CPPUNIT_ASSERT(endpoint.toSockAddr(storage, length));
+
+        IPEndpointView view(storage, length);
+        CPPUNIT_ASSERT(view.isValid());
+        CPPUNIT_ASSERT(view.getAddressFamily() == frog::net::AddressFamily::InterNetwork);
+        CPPUNIT_ASSERT(view.getPort() == 8080);
+        CPPUNIT_ASSERT(view.getScopeId() == 0);
+        CPPUNIT_ASSERT(view.getAddressSize() == 4);
+        CPPUNIT_ASSERT(view.getAddressBytes() == reinterpret_cast<const uint8_t*>(
+                    &reinterpret_cast<const struct sockaddr_in*>(&storage)->sin_addr));
+        CPPUNIT_ASSERT(view.getValue() == addr.getValue());
+        CPPUNIT_ASSERT(view.getAddress() == addr);
+        CPPUNIT_ASSERT(view == endpoint);
+        CPPUNIT_ASSERT(view.hash() == endpoint.hash());
+
+        InetAddress addr2("172.16.0.10");
+        IPEndpoint other(addr2, 8080);
+        IPEndpoint otherPort(addr, 8081);
+        CPPUNIT_ASSERT(view != other);
+        CPPUNIT_ASSERT(view != otherPort);
+
+        IPEndpoint copy;
+        CPPUNIT_ASSERT(view.copyTo(copy));
+        CPPUNIT_ASSERT(copy == endpoint);
+
+#ifdef HAVE_IPV6_SUPPORT
+        InetAddress addr6("2001:db8::7", 2);
+        IPEndpoint endpoint6(addr6, 53);
+        CPPUNIT_ASSERT(endpoint6.toSockAddr(storage, length));
+        IPEndpointView view6(reinterpret_cast<const struct sockaddr*>(&storage), length);
+        CPPUNIT_ASSERT(view6.getAddressFamily() == frog::net::AddressFamily::InterNetworkV6);
+        CPPUNIT_ASSERT(view6.getPort() == 53);
+        CPPUNIT_ASSERT(view6.getScopeId() == 2);
+        CPPUNIT_ASSERT(view6.getValue() == addr6.getValue());
+        CPPUNIT_ASSERT(view6 == endpoint6);
+        CPPUNIT_ASSERT(view6 != endpoint);
+        CPPUNIT_ASSERT(view6.hash() == endpoint6.hash());
+#endif
+
+        IPEndpointView truncated(storage, sizeof(sa_family_t));
+        CPPUNIT_ASSERT(!truncated.isValid());
+        CPPUNIT_ASSERT(truncated.getPort() == 0);
+        CPPUNIT_ASSERT(truncated.getAddressBytes() == NULL);
+        CPPUNIT_ASSERT(truncated.getAddress().getAddressFamily() == frog::net::AddressFamily::Unspecified);
+        CPPUNIT_ASSERT(truncated != endpoint);
+        CPPUNIT_ASSERT(!truncated.copyTo(copy));
+        CPPUNIT_ASSERT(copy == endpoint);
+
+        IPEndpointView none(NULL, 0);
+        CPPUNIT_ASSERT(!none.isValid());
+    }
+
+    void testTryParse()
+    {
+        InetAddress addr("10.0.0.1");
+        IPEndpoint endpoint(addr, 1);
+        const char* text = "192.168.1.20:8080";
+
+        CPPUNIT_ASSERT(IPEndpoint::tryParse(text, strlen(text), endpoint));
+        CPPUNIT_ASSERT(endpoint.getAddressFamily() == frog::net::AddressFamily::InterNetwork);
+        CPPUNIT_ASSERT(endpoint.address == InetAddress("192.168.1.20"));
+        CPPUNIT_ASSERT(endpoint.port == 8080);
+        CPPUNIT_ASSERT(endpoint.address.isIPv4Compatible());
+
+        // The text need not be NUL terminated.
+        CPPUNIT_ASSERT(IPEndpoint::tryParse("10.9.8.7:6553599", 14, endpoint));
+        CPPUNIT_ASSERT(endpoint.toString() == "10.9.8.7:65535");
+
+        CPPUNIT_ASSERT(IPEndpoint::tryParse("127.0.0.1", 9, endpoint, 53));
+        CPPUNIT_ASSERT(endpoint.toString() == "127.0.0.1:53");
+        CPPUNIT_ASSERT(IPEndpoint::tryParse("127.0.0.1:0", 11, endpoint, 53));
+        CPPUNIT_ASSERT(endpoint.port == 0);
+
+        static const char* invalid[] = { "", "127.0.0.1:", "127.0.0.1:65536", "127.0.0.1:123456",
+            "127.0.0.1:8o", "127.0.0.1 :80", "127.0.0:80", "localhost:80", ":80",
+            "[127.0.0.1]:80", "127.0.0.1:80:80" };
+        for(size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+        {
+            CPPUNIT_ASSERT(!IPEndpoint::tryParse(invalid[i], strlen(invalid[i]), endpoint, 53));
+            CPPUNIT_ASSERT(endpoint.port == 0);
+            CPPUNIT_ASSERT(endpoint.address == InetAddress("127.0.0.1"));
+        }
+        CPPUNIT_ASSERT(!IPEndpoint::tryParse(NULL, 4, endpoint));
+    }
+
+#ifdef HAVE_IPV6_SUPPORT
+    void testTryParse6()
+    {
+        IPEndpoint endpoint;
+        const char* text = "[2001:db8::1]:443";
+
+        CPPUNIT_ASSERT(IPEndpoint::tryParse(text, strlen(text), endpoint));
+        CPPUNIT_ASSERT(endpoint.getAddressFamily() == frog::net::AddressFamily::InterNetworkV6);
+        CPPUNIT_ASSERT(endpoint.address == InetAddress("2001:db8::1"));
+        CPPUNIT_ASSERT(endpoint.port == 443);
+        CPPUNIT_ASSERT(endpoint.toString() == text);
+
+        text = "[fe80::1%7]:546";
+        CPPUNIT_ASSERT(IPEndpoint::tryParse(text, strlen(text), endpoint));
+        CPPUNIT_ASSERT(endpoint.address.getValue().scope == 7);
+        CPPUNIT_ASSERT(endpoint.port == 546);
+        CPPUNIT_ASSERT(endpoint.toString() == text);
+
+        CPPUNIT_ASSERT(IPEndpoint::tryParse("[::1]", 5, endpoint, 80));
+        CPPUNIT_ASSERT(endpoint.toString() == "[::1]:80");
+        CPPUNIT_ASSERT(IPEndpoint::tryParse("::1", 3, endpoint, 81));
+        CPPUNIT_ASSERT(endpoint.toString() == "[::1]:81");
+        CPPUNIT_ASSERT(IPEndpoint::tryParse("[::10.0.0.1]:1", 14, endpoint));
+        CPPUNIT_ASSERT(endpoint.address.isIPv4Compatible());
+        CPPUNIT_ASSERT(endpoint.port == 1);
+
+        static const char* invalid[] = { "[::1", "[::1]:", "[::1]80", "[::1]:99999", "[]:80",
+            "[fe80::1%]:80", "::1:80x", "[::1]:80]" };
+        for(size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+        {
+            CPPUNIT_ASSERT(!IPEndpoint::tryParse(invalid[i], strlen(invalid[i]), endpoint, 53));
+            CPPUNIT_ASSERT(endpoint.port == 1);
+        }
+    }
+#endif
+
+    void testTryParseList()
+    {
+        IPEndpoint endpoints[4];
+        const char* text = "203.0.113.7, 10.0.0.2:8443,\tbogus ,[::1]:9000";
+
+        CPPUNIT_ASSERT(IPEndpoint::tryParseList(text, strlen(text), endpoints, 4, 80) == 4);
+        CPPUNIT_ASSERT(endpoints[0].toString() == "203.0.113.7:80");
+        CPPUNIT_ASSERT(endpoints[1].toString() == "10.0.0.2:8443");
+        CPPUNIT_ASSERT(endpoints[2].getAddressFamily() == frog::net::AddressFamily::Unspecified);
+        CPPUNIT_ASSERT(endpoints[2].port == 0);
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(endpoints[3].toString() == "[::1]:9000");
+#endif
+
+        // Items past the capacity are not parsed, and empty items are
+        // not valid endpoints.
+        text = "1.1.1.1,,2.2.2.2:2,3.3.3.3";
+        CPPUNIT_ASSERT(IPEndpoint::tryParseList(text, strlen(text), endpoints, 3) == 3);
+        CPPUNIT_ASSERT(endpoints[0].toString() == "1.1.1.1:0");
+        CPPUNIT_ASSERT(endpoints[1].getAddressFamily() == frog::net::AddressFamily::Unspecified);
+        CPPUNIT_ASSERT(endpoints[2].toString() == "2.2.2.2:2");
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(endpoints[3].port == 9000);
+#endif
+
+        CPPUNIT_ASSERT(IPEndpoint::tryParseList(" 4.4.4.4 ", 9, endpoints, 4) == 1);
+        CPPUNIT_ASSERT(endpoints[0].toString() == "4.4.4.4:0");
+        CPPUNIT_ASSERT(IPEndpoint::tryParseList("", 0, endpoints, 4) == 0);
+        CPPUNIT_ASSERT(IPEndpoint::tryParseList(text, strlen(text), endpoints, 0) == 0);
+    }
 };
@@ -20,14 +20,21 @@
 //------------------------------------------------------------------------//
 
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <arpa/inet.h>
+#include <unistd.h>
 
 #include <string>
 #include <cstdio>
 #include <iostream>
+#include <algorithm>
+#include <vector>
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/Inet4Address.h>
+#include <frog/InetAddressLiterals.h>
 #include <frog/NotImplementedException.h>
 #include <frog/IllegalArgumentException.h>
 #include <frog/ArgumentOutOfBoundsException.h>
@@ -37,7 +44,12 @@
 #endif
 
 using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::Inet4Address;
 using namespace std;
+#if __cplusplus >= 201402L
+using namespace frog::net::literals;
+#endif
 
 
 class Inet4AddressTest : public CppUnit::TestFixture
@@ -92,6 +104,33 @@ class Inet4AddressTest : public CppUnit::TestFixture
     CPPUNIT_TEST(testIfSame);
     CPPUNIT_TEST_FAIL(testIfNotSame);
 
+    CPPUNIT_TEST(testTryParse);
+    CPPUNIT_TEST(testTryParseInvalid);
+    CPPUNIT_TEST(testTryParseBatch);
+    CPPUNIT_TEST(testTryParseBatchRandom);
+    CPPUNIT_TEST(testTryParseBatchPageEnd);
+    CPPUNIT_TEST(testFormat);
+    CPPUNIT_TEST(testFormatSmallBuffer);
+    CPPUNIT_TEST(testHashCode);
+    CPPUNIT_TEST(testOrdering);
+
+    CPPUNIT_TEST(testTypedConversion);
+    CPPUNIT_TEST_EXCEPTION(testTypedConstructorException, frog::sys::IllegalArgumentException);
+    CPPUNIT_TEST(testTypedPredicates);
+    CPPUNIT_TEST(testTypedAlgorithms);
+    CPPUNIT_TEST(testTypedOrdering);
+#if __cplusplus >= 201402L
+    CPPUNIT_TEST(testLiterals);
+    CPPUNIT_TEST_EXCEPTION(testLiteralException, frog::sys::IllegalArgumentException);
+#endif
+
+    CPPUNIT_TEST(testIncrement);
+    CPPUNIT_TEST(testOffset);
+    CPPUNIT_TEST(testDistance);
+    CPPUNIT_TEST_EXCEPTION(testDistanceFamilies, frog::sys::IllegalArgumentException);
+    CPPUNIT_TEST(testMask);
+    CPPUNIT_TEST_EXCEPTION(testMaskTooLong, frog::sys::IllegalArgumentException);
+
     CPPUNIT_TEST_SUITE_END();
 
   public:
@@ -103,7 +142,7 @@ class Inet4AddressTest : public CppUnit::TestFixture
     void testConstructor1()
     {
         InetAddress addr("10.1.0.1");
-        CPPUNIT_ASSERT(addr.addressFamily == AddressFamily::InterNetwork);
+        CPPUNIT_ASSERT(addr.getAddressFamily() == AddressFamily::InterNetwork);
     }
 
     void testConstructor2()
@@ -118,7 +157,7 @@ class Inet4AddressTest : public CppUnit::TestFixture
 
 #endif
         InetAddress addr(rawAddr_);
-        CPPUNIT_ASSERT(addr.addressFamily == AddressFamily::InterNetwork);
+        CPPUNIT_ASSERT(addr.getAddressFamily() == AddressFamily::InterNetwork);
     }
 
     void testConstructorException1()
@@ -627,15 +666,480 @@ class Inet4AddressTest : public CppUnit::TestFixture
     void testIfNotSame()
     {
         InetAddress addr("127.0.0.1");
-        InetAddress addr2("127.0.0.1");
+        InetAddress addr2("127.0.0.2");
 
         CPPUNIT_ASSERT(addr.sameObject(&addr2));
         CPPUNIT_ASSERT(addr2.sameObject(&addr));
     }
+
+    void testTryParse()
+    {
+        const char* text[] = { "10.1.0.1", "0.0.0.0", "255.255.255.255", "192.168.100.1" };
+        for(size_t i = 0; i < sizeof(text) / sizeof(text[0]); ++i)
+        {
+            InetAddress addr;
+            CPPUNIT_ASSERT(InetAddress::tryParse(text[i], strlen(text[i]), addr));
+            CPPUNIT_ASSERT(addr == InetAddress(text[i]));
+            CPPUNIT_ASSERT(addr.getAddressFamily() == AddressFamily::InterNetwork);
+            CPPUNIT_ASSERT(addr.isIPv4Compatible());
+        }
+
+        // Only the first n characters are looked at.
+        InetAddress addr;
+        CPPUNIT_ASSERT(InetAddress::tryParse("10.1.0.1 trailing", 8, addr));
+        CPPUNIT_ASSERT(addr.toString() == "10.1.0.1");
+    }
+
+    void testTryParseInvalid()
+    {
+        const char* text[] = { "10.1.0.1.x", "...", "z.x.c.v", "zxcv", "333.333.333.333",
+            "255.255.255.256", "10.1.0", "10.1.0.", ".10.1.0.1", "10..0.1", "010.1.0.1",
+            "10.1.0.1 ", "1.2.3.4:80", "" };
+        InetAddress addr("127.0.0.1");
+        for(size_t i = 0; i < sizeof(text) / sizeof(text[0]); ++i)
+        {
+            CPPUNIT_ASSERT(!InetAddress::tryParse(text[i], strlen(text[i]), addr));
+            CPPUNIT_ASSERT(addr == InetAddress("127.0.0.1"));
+        }
+        CPPUNIT_ASSERT(!InetAddress::tryParse(NULL, 0, addr));
+    }
+
+    void testTryParseBatch()
+    {
+        const char* text[] = { "10.1.0.1", "0.0.0.0", "255.255.255.255", "1.2.3.4", "10.1.0.1.x",
+            "...", "333.333.333.333", "255.255.255.256", "256.1.1.1", "10.1.0", "10.1.0.",
+            ".10.1.0.1", "10..0.1", "010.1.0.1", "10.1.00.1", "10.1.0.1 ", "1.2.3.4:80", "",
+            "1.2.3.1000", "1111.2.3.4", "199.299.199.199", "100.200.250.255", "::1", "1:2::3" };
+        size_t count = sizeof(text) / sizeof(text[0]);
+        std::vector<size_t> lengths(count);
+        for(size_t i = 0; i < count; ++i)
+        {
+            lengths[i] = strlen(text[i]);
+        }
+        std::vector<InetAddressValue> values(count);
+        size_t valid = InetAddress::tryParseBatch(text, &lengths[0], count, &values[0]);
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(valid == 7);
+#else
+        CPPUNIT_ASSERT(valid == 5);
+#endif
+        checkBatch(text, &lengths[0], count, &values[0]);
+        CPPUNIT_ASSERT(InetAddress(values[2]) == InetAddress("255.255.255.255"));
+        CPPUNIT_ASSERT(values[4].family == AddressFamily::Unspecified);
+
+        // Only the given number of characters is looked at.
+        const char* trailing = "10.1.0.1 trailing";
+        size_t length = 8;
+        CPPUNIT_ASSERT(InetAddress::tryParseBatch(&trailing, &length, 1, &values[0]) == 1);
+        CPPUNIT_ASSERT(InetAddress(values[0]) == InetAddress("10.1.0.1"));
+    }
+
+    void testTryParseBatchRandom()
+    {
+        // Strings of digits and dots, and dotted quads with octets of one
+        // to four digits, compared with the scalar parser.
+        const size_t count = 100000;
+        std::vector<std::string> strings(count);
+        uint32_t r = 12345U;
+        for(size_t i = 0; i < count; ++i)
+        {
+            std::string& s = strings[i];
+            r = (r * 1103515245U) + 12345U;
+            if(r & 0x10000U)
+            {
+                size_t n = (r >> 17) % 18U;
+                for(size_t j = 0; j < n; ++j)
+                {
+                    r = (r * 1103515245U) + 12345U;
+                    s += "0123456789...."[(r >> 16) % 14U];
+                }
+            }
+            else
+            {
+                for(size_t k = 0; k < 4; ++k)
+                {
+                    r = (r * 1103515245U) + 12345U;
+                    char buf[8];
+                    ::snprintf(buf, sizeof(buf), ((r >> 16) & 7U) ? "%u" : "%02u", (r >> 20) % ((r & 0x1000000U) ? 256U : 1000U));
+                    s += (k > 0) ? "." : "";
+                    s += buf;
+                }
+            }
+        }
+
+        std::vector<const char*> text(count);
+        std::vector<size_t> lengths(count);
+        for(size_t i = 0; i < count; ++i)
+        {
+            text[i] = strings[i].data();
+            lengths[i] = strings[i].size();
+        }
+        std::vector<InetAddressValue> values(count);
+        InetAddress::tryParseBatch(&text[0], &lengths[0], count, &values[0]);
+        checkBatch(&text[0], &lengths[0], count, &values[0]);
+    }
+
+    void testTryParseBatchPageEnd()
+    {
+        // Texts that end right before a page that cannot be read.
+        size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        char* pages = static_cast<char*>(::mmap(NULL, 2 * page, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        CPPUNIT_ASSERT(pages != MAP_FAILED);
+        CPPUNIT_ASSERT(::mprotect(pages + page, page, PROT_NONE) == 0);
+
+        const char* quads[] = { "1.2.3.4", "192.168.100.200", "1.2.3.400" };
+        for(size_t i = 0; i < sizeof(quads) / sizeof(quads[0]); ++i)
+        {
+            size_t length = strlen(quads[i]);
+            char* p = pages + page - length;
+            ::memcpy(p, quads[i], length);
+            const char* text = p;
+            InetAddressValue value;
+            CPPUNIT_ASSERT(InetAddress::tryParseBatch(&text, &length, 1, &value) == ((i < 2) ? 1U : 0U));
+            checkBatch(&text, &length, 1, &value);
+        }
+        ::munmap(pages, 2 * page);
+    }
+
+    void testFormat()
+    {
+        char buf[InetAddress::MAX_TEXT_SIZE];
+        char expected[INET_ADDRSTRLEN];
+        uint32_t value = 0x12345678U;
+        for(int i = 0; i < 10000; ++i)
+        {
+            value = (value * 1103515245U) + 12345U;
+            rawAddr_.s_addr = value;
+            InetAddress addr(rawAddr_);
+            inet_ntop(AF_INET, &rawAddr_, expected, sizeof(expected));
+
+            CPPUNIT_ASSERT(addr.format(buf, sizeof(buf)) == strlen(expected));
+            CPPUNIT_ASSERT(!strcmp(buf, expected));
+            CPPUNIT_ASSERT(addr.toString() == expected);
+        }
+    }
+
+    void testFormatSmallBuffer()
+    {
+        char buf[16];
+        InetAddress addr("255.255.255.255");
+        CPPUNIT_ASSERT(addr.format(buf, 16) == 15);
+        CPPUNIT_ASSERT(!strcmp(buf, "255.255.255.255"));
+        CPPUNIT_ASSERT(addr.format(buf, 15) == 0);
+        CPPUNIT_ASSERT(buf[0] == '\0');
+        CPPUNIT_ASSERT(addr.format(buf, 0) == 0);
+
+        InetAddress unspecified;
+        CPPUNIT_ASSERT(unspecified.format(buf, sizeof(buf)) == 0);
+        CPPUNIT_ASSERT(unspecified.toString() == "");
+    }
+
+    void testHashCode()
+    {
+        InetAddress addr("10.1.0.1");
+        InetAddress addr2("10.1.0.1");
+        InetAddress addr3("10.1.0.2");
+        frog::net::InetAddressHash hasher;
+
+        CPPUNIT_ASSERT(addr.hashCode() == addr2.hashCode());
+        CPPUNIT_ASSERT(addr.hashCode() != addr3.hashCode());
+        CPPUNIT_ASSERT(hasher(addr) == hasher(addr2));
+        CPPUNIT_ASSERT(hasher(addr) != hasher(addr3));
+        CPPUNIT_ASSERT(addr.sameObject(&addr2));
+        CPPUNIT_ASSERT(!addr.sameObject(&addr3));
+
+        // Neighbouring addresses should not collide.
+        std::vector<uint64_t> codes;
+        for(uint32_t i = 0; i < 65536; ++i)
+        {
+            rawAddr_.s_addr = htonl(0x0a000000U | i);
+            codes.push_back(InetAddress(rawAddr_).getValue().hash());
+        }
+        std::sort(codes.begin(), codes.end());
+        CPPUNIT_ASSERT(std::unique(codes.begin(), codes.end()) == codes.end());
+    }
+    void testTypedConversion()
+    {
+        CPPUNIT_ASSERT(sizeof(Inet4Address) == 4U);
+
+        Inet4Address addr("192.168.1.20");
+        CPPUNIT_ASSERT(addr.getWord() == 0xc0a80114U);
+        CPPUNIT_ASSERT(addr.toString() == "192.168.1.20");
+        CPPUNIT_ASSERT(ntohl(addr.toInAddr().s_addr) == 0xc0a80114U);
+
+        InetAddress inet(addr.toInetAddress());
+        CPPUNIT_ASSERT(inet == InetAddress("192.168.1.20"));
+        CPPUNIT_ASSERT(Inet4Address(inet) == addr);
+        CPPUNIT_ASSERT(Inet4Address(inet.getValue()) == addr);
+        CPPUNIT_ASSERT(addr.hash() == inet.getValue().hash());
+        CPPUNIT_ASSERT(Inet4Address(addr.toInAddr()) == addr);
+
+        char buf[Inet4Address::MAX_TEXT_SIZE];
+        CPPUNIT_ASSERT(Inet4Address(0xffffffffU).format(buf, sizeof(buf)) == 15);
+        CPPUNIT_ASSERT(!strcmp(buf, "255.255.255.255"));
+
+        Inet4Address parsed;
+        CPPUNIT_ASSERT(Inet4Address::tryParse("10.0.0.1", 8, parsed));
+        CPPUNIT_ASSERT(parsed.getWord() == 0x0a000001U);
+        CPPUNIT_ASSERT(!Inet4Address::tryParse("::1", 3, parsed));
+        CPPUNIT_ASSERT(!Inet4Address::tryParse("10.0.0.256", 10, parsed));
+        CPPUNIT_ASSERT(parsed.getWord() == 0x0a000001U);
+        CPPUNIT_ASSERT(!Inet4Address::fromValue(InetAddress().getValue(), parsed));
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(!Inet4Address::fromValue(InetAddress("::1").getValue(), parsed));
+#endif
+    }
+
+    void testTypedConstructorException()
+    {
+#ifdef HAVE_IPV6_SUPPORT
+        Inet4Address addr(InetAddress("fe80::1"));
+#else
+        // An unspecified address is not an IPv4 address either.
+        Inet4Address addr((InetAddress()));
+#endif
+    }
+
+    void testTypedPredicates()
+    {
+        uint32_t value = 0x12345678U;
+        for(int i = 0; i < 100000; ++i)
+        {
+            value = (value * 1103515245U) + 12345U;
+            // Also try the interesting first bytes often.
+            uint32_t word = ((i & 1) != 0) ? value : ((value & 0x00ffffffU) | (static_cast<uint32_t>(i % 256) << 24));
+            Inet4Address addr(word);
+            InetAddress inet(addr.toInetAddress());
+
+            CPPUNIT_ASSERT(addr.isAnyLocalAddress() == inet.isAnyLocalAddress());
+            CPPUNIT_ASSERT(addr.isLoopbackAddress() == inet.isLoopbackAddress());
+            CPPUNIT_ASSERT(addr.isLinkLocalAddress() == inet.isLinkLocalAddress());
+            CPPUNIT_ASSERT(addr.isSiteLocalAddress() == inet.isSiteLocalAddress());
+            CPPUNIT_ASSERT(addr.isMulticastAddress() == inet.isMulticastAddress());
+            CPPUNIT_ASSERT(addr.isMulticastGlobal() == inet.isMulticastGlobal());
+            CPPUNIT_ASSERT(addr.isMulticastNodeLocal() == inet.isMulticastNodeLocal());
+            CPPUNIT_ASSERT(addr.isMulticastLinkLocal() == inet.isMulticastLinkLocal());
+            CPPUNIT_ASSERT(addr.isMulticastSiteLocal() == inet.isMulticastSiteLocal());
+            CPPUNIT_ASSERT(addr.isMulticastOrgLocal() == inet.isMulticastOrgLocal());
+            CPPUNIT_ASSERT(addr.classify() == inet.classify());
+        }
+        CPPUNIT_ASSERT(Inet4Address(0x7f000001U).isLoopbackAddress());
+        CPPUNIT_ASSERT(Inet4Address().isAnyLocalAddress());
+    }
+
+    void testTypedAlgorithms()
+    {
+        using frog::net::networkAddress;
+        using frog::net::lastAddress;
+        using frog::net::sameNetwork;
+        using frog::net::commonPrefixLength;
+
+        Inet4Address addr("192.168.37.200");
+        CPPUNIT_ASSERT(networkAddress(addr, 24).toString() == "192.168.37.0");
+        CPPUNIT_ASSERT(networkAddress(addr, 20).toString() == "192.168.32.0");
+        CPPUNIT_ASSERT(networkAddress(addr, 0).toString() == "0.0.0.0");
+        CPPUNIT_ASSERT(networkAddress(addr, 32) == addr);
+        CPPUNIT_ASSERT(lastAddress(addr, 24).toString() == "192.168.37.255");
+        CPPUNIT_ASSERT(lastAddress(addr, 0).toString() == "255.255.255.255");
+        CPPUNIT_ASSERT(lastAddress(addr, 32) == addr);
+
+        CPPUNIT_ASSERT(sameNetwork(addr, Inet4Address("192.168.36.1"), 23));
+        CPPUNIT_ASSERT(!sameNetwork(addr, Inet4Address("192.168.36.1"), 24));
+        CPPUNIT_ASSERT(sameNetwork(addr, Inet4Address("1.2.3.4"), 0));
+
+        CPPUNIT_ASSERT(commonPrefixLength(addr, addr) == 32U);
+        CPPUNIT_ASSERT(commonPrefixLength(addr, Inet4Address("192.168.36.1")) == 23U);
+        CPPUNIT_ASSERT(commonPrefixLength(Inet4Address(0), Inet4Address(0x80000000U)) == 0U);
+    }
+
+    void testTypedOrdering()
+    {
+        std::vector<Inet4Address> addresses;
+        addresses.push_back(Inet4Address("192.168.1.1"));
+        addresses.push_back(Inet4Address("10.1.0.1"));
+        addresses.push_back(Inet4Address("255.255.255.255"));
+        addresses.push_back(Inet4Address("0.0.0.0"));
+        std::sort(addresses.begin(), addresses.end());
+
+        CPPUNIT_ASSERT(addresses[0].toString() == "0.0.0.0");
+        CPPUNIT_ASSERT(addresses[1].toString() == "10.1.0.1");
+        CPPUNIT_ASSERT(addresses[2].toString() == "192.168.1.1");
+        CPPUNIT_ASSERT(addresses[3].toString() == "255.255.255.255");
+        CPPUNIT_ASSERT(addresses[0].compare(addresses[1]) < 0);
+        CPPUNIT_ASSERT(addresses[3].compare(addresses[1]) > 0);
+        CPPUNIT_ASSERT(addresses[2].compare(addresses[2]) == 0);
+        CPPUNIT_ASSERT(addresses[1] <= addresses[2]);
+        CPPUNIT_ASSERT(addresses[3] >= addresses[3]);
+        CPPUNIT_ASSERT(addresses[3] > addresses[2]);
+        CPPUNIT_ASSERT(addresses[0] != addresses[1]);
+    }
+#if __cplusplus >= 201402L
+    void testLiterals()
+    {
+        // Checked by the compiler: a bad literal would not build.
+        constexpr frog::net::Inet4Subnet networks[] = {
+            "10.0.0.0/8"_net4, "172.16.0.0/12"_net4, "192.168.7.1/16"_net4, "0.0.0.0/0"_net4 };
+        static_assert("10.1.2.3"_ip4.getWord() == 0x0a010203U, "literal is parsed at compile time");
+        static_assert(networks[1].contains("172.31.255.255"_ip4), "literal is parsed at compile time");
+        static_assert(!networks[1].contains("172.32.0.0"_ip4), "literal is parsed at compile time");
+
+        CPPUNIT_ASSERT("192.168.100.1"_ip4 == Inet4Address("192.168.100.1"));
+        CPPUNIT_ASSERT("255.255.255.255"_ip4.getWord() == 0xffffffffU);
+        CPPUNIT_ASSERT(networks[2].getNetwork() == "192.168.0.0"_ip4);
+        CPPUNIT_ASSERT(networks[2].getPrefixLength() == 16);
+        CPPUNIT_ASSERT(networks[2].toSubnet().toString() == "192.168.0.0/16");
+        CPPUNIT_ASSERT(networks[3].contains("1.2.3.4"_ip4));
+        CPPUNIT_ASSERT("10.0.0.1"_net4.getPrefixLength() == 32);
+        CPPUNIT_ASSERT("10.0.0.1"_net4 != "10.0.0.1/31"_net4);
+
+        // The literal grammar is the one of tryParse().
+        const char* text[] = { "010.1.0.1", "1.2.3", "1.2.3.256", "1.2.3.4 ", "", "::1" };
+        for(size_t i = 0; i < sizeof(text) / sizeof(text[0]); ++i)
+        {
+            bool thrown = false;
+            try
+            {
+                frog::net::parseInet4Literal(text[i], ::strlen(text[i]));
+            }
+            catch(const frog::sys::IllegalArgumentException&)
+            {
+                thrown = true;
+            }
+            CPPUNIT_ASSERT(thrown);
+        }
+    }
+
+    void testLiteralException()
+    {
+        // Not a constant expression, so the error is found at run time.
+        frog::net::Inet4Subnet subnet = "10.0.0.0/33"_net4;
+        (void)subnet;
+    }
+#endif
+
+    void testIncrement()
+    {
+        InetAddress addr("10.0.0.255");
+        ++addr;
+        CPPUNIT_ASSERT(addr.toString() == "10.0.1.0");
+        CPPUNIT_ASSERT((addr++).toString() == "10.0.1.0");
+        CPPUNIT_ASSERT(addr.toString() == "10.0.1.1");
+        --addr;
+        --addr;
+        CPPUNIT_ASSERT(addr.toString() == "10.0.0.255");
+        CPPUNIT_ASSERT((addr--).toString() == "10.0.0.255");
+        CPPUNIT_ASSERT(addr.toString() == "10.0.0.254");
+
+        // Wraps around like an unsigned number.
+        InetAddress last("255.255.255.255");
+        CPPUNIT_ASSERT((++last).toString() == "0.0.0.0");
+        CPPUNIT_ASSERT((--last).toString() == "255.255.255.255");
+        CPPUNIT_ASSERT(last.getAddressFamily() == frog::net::AddressFamily::InterNetwork);
+
+        InetAddress unspecified;
+        ++unspecified;
+        CPPUNIT_ASSERT(unspecified == InetAddress());
+    }
+
+    void testOffset()
+    {
+        InetAddress addr("192.168.0.1");
+        CPPUNIT_ASSERT((addr + 255).toString() == "192.168.1.0");
+        CPPUNIT_ASSERT((addr - 2).toString() == "192.167.255.255");
+        CPPUNIT_ASSERT((addr + -2) == (addr - 2));
+        CPPUNIT_ASSERT((addr + 0x100000000LL) == addr);
+        CPPUNIT_ASSERT(addr.toString() == "192.168.0.1");
+
+        addr += 65536;
+        CPPUNIT_ASSERT(addr.toString() == "192.169.0.1");
+        addr -= 65537;
+        CPPUNIT_ASSERT(addr.toString() == "192.168.0.0");
+
+        // Agrees with the numeric value for many offsets.
+        uint32_t value = 0x12345678U;
+        for(int i = 0; i < 1000; ++i)
+        {
+            value = (value * 1103515245U) + 12345U;
+            int64_t offset = static_cast<int32_t>(value);
+            rawAddr_.s_addr = htonl(0x80000000U + static_cast<uint32_t>(offset));
+            CPPUNIT_ASSERT(InetAddress("128.0.0.0") + offset == InetAddress(rawAddr_));
+            CPPUNIT_ASSERT(InetAddress(rawAddr_) - offset == InetAddress("128.0.0.0"));
+        }
+    }
+
+    void testDistance()
+    {
+        InetAddress a("10.0.0.0");
+        InetAddress b("10.1.0.5");
+        CPPUNIT_ASSERT(a.distance(b) == 65541);
+        CPPUNIT_ASSERT(b.distance(a) == -65541);
+        CPPUNIT_ASSERT(a.distance(a) == 0);
+        CPPUNIT_ASSERT(a + a.distance(b) == b);
+        CPPUNIT_ASSERT(InetAddress("0.0.0.0").distance(InetAddress("255.255.255.255")) == 0xffffffffLL);
+    }
+
+    void testDistanceFamilies()
+    {
+        InetAddress("10.0.0.1").distance(InetAddress("::1"));
+    }
+
+    void testMask()
+    {
+        InetAddress addr("172.16.201.77");
+        CPPUNIT_ASSERT(addr.mask(16).toString() == "172.16.0.0");
+        CPPUNIT_ASSERT(addr.mask(20).toString() == "172.16.192.0");
+        CPPUNIT_ASSERT(addr.mask(0).toString() == "0.0.0.0");
+        CPPUNIT_ASSERT(addr.mask(32) == addr);
+        CPPUNIT_ASSERT(addr.mask(InetAddress("255.255.240.0")) == addr.mask(20));
+        CPPUNIT_ASSERT(addr.mask(InetAddress("0.255.0.255")).toString() == "0.16.0.77");
+    }
+
+    void testMaskTooLong()
+    {
+        InetAddress("10.0.0.1").mask(33);
+    }
   private:
+    // Checks the results of InetAddress::tryParseBatch() against
+    // InetAddress::tryParse().
+    void checkBatch(const char* const* text, const size_t* lengths, size_t count,
+            const InetAddressValue* values)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            InetAddressValue expected;
+            if(!InetAddress::tryParse(text[i], lengths[i], expected))
+            {
+                ::memset(&expected, 0, sizeof(expected));
+                expected.family = AddressFamily::Unspecified;
+            }
+            CPPUNIT_ASSERT(::memcmp(&values[i], &expected, sizeof(expected)) == 0);
+        }
+    }
+
     struct in_addr rawAddr_;
     void someFn(const InetAddress& addr1, InetAddress addr2)
     {
         CPPUNIT_ASSERT(addr1 == addr2);
     }
+
+    void testOrdering()
+    {
+        std::vector<InetAddress> addresses;
+        addresses.push_back(InetAddress("192.168.1.1"));
+        addresses.push_back(InetAddress("10.1.0.1"));
+        addresses.push_back(InetAddress("255.255.255.255"));
+        addresses.push_back(InetAddress("10.0.255.255"));
+        addresses.push_back(InetAddress("0.0.0.0"));
+        std::sort(addresses.begin(), addresses.end());
+
+        CPPUNIT_ASSERT(addresses[0].toString() == "0.0.0.0");
+        CPPUNIT_ASSERT(addresses[1].toString() == "10.0.255.255");
+        CPPUNIT_ASSERT(addresses[2].toString() == "10.1.0.1");
+        CPPUNIT_ASSERT(addresses[3].toString() == "192.168.1.1");
+        CPPUNIT_ASSERT(addresses[4].toString() == "255.255.255.255");
+        CPPUNIT_ASSERT(addresses[1] <= addresses[2]);
+        CPPUNIT_ASSERT(addresses[2] >= addresses[2]);
+        CPPUNIT_ASSERT(addresses[4] > addresses[3]);
+    }
 };
@@ -28,6 +28,8 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <frog/InetAddress.h>
+#include <frog/Inet6Address.h>
+#include <frog/InetAddressLiterals.h>
 #include <frog/NotImplementedException.h>
 #include <frog/IllegalArgumentException.h>
 #include <frog/ArgumentOutOfBoundsException.h>
@@ -37,7 +39,11 @@
 #endif
 
 using frog::net::InetAddress;
+using frog::net::Inet6Address;
 using namespace std;
+#if __cplusplus >= 201402L
+using namespace frog::net::literals;
+#endif
 
 class Inet6AddressTest : public CppUnit::TestFixture
 {
@@ -90,6 +96,28 @@ class Inet6AddressTest : public CppUnit::TestFixture
 
     CPPUNIT_TEST(testIPv4Compat);
 
+    CPPUNIT_TEST(testTryParse);
+    CPPUNIT_TEST(testTryParseScopeId);
+    CPPUNIT_TEST(testTryParseInvalid);
+    CPPUNIT_TEST(testFormat);
+    CPPUNIT_TEST(testFormatScopeId);
+    CPPUNIT_TEST(testHashCode);
+
+    CPPUNIT_TEST(testTypedConversion);
+    CPPUNIT_TEST_EXCEPTION(testTypedConstructorException, frog::sys::IllegalArgumentException);
+    CPPUNIT_TEST(testTypedPredicates);
+    CPPUNIT_TEST(testTypedAlgorithms);
+    CPPUNIT_TEST(testTypedOrdering);
+#if __cplusplus >= 201402L
+    CPPUNIT_TEST(testLiterals);
+    CPPUNIT_TEST_EXCEPTION(testLiteralException, frog::sys::IllegalArgumentException);
+#endif
+
+    CPPUNIT_TEST(testIncrement);
+    CPPUNIT_TEST(testDistance);
+    CPPUNIT_TEST_EXCEPTION(testDistanceOutOfRange, frog::sys::ArgumentOutOfBoundsException);
+    CPPUNIT_TEST(testMask);
+
     CPPUNIT_TEST_SUITE_END();
 
   public:
@@ -101,21 +129,21 @@ class Inet6AddressTest : public CppUnit::TestFixture
     void testConstructor1()
     {
         InetAddress addr("1080:0:0:0:8:800:200C:417A");
-        CPPUNIT_ASSERT(addr.addressFamily == AddressFamily::InterNetworkV6);
+        CPPUNIT_ASSERT(addr.getAddressFamily() == AddressFamily::InterNetworkV6);
     }
 
     void testConstructor2()
     {
         inet_pton(AF_INET6, "1080:0:0:0:8:800:200C:417A", &rawAddr_);
         InetAddress addr(rawAddr_);
-        CPPUNIT_ASSERT(addr.addressFamily == AddressFamily::InterNetworkV6);
+        CPPUNIT_ASSERT(addr.getAddressFamily() == AddressFamily::InterNetworkV6);
     }
 
     void testConstructor3()
     {
         inet_pton(AF_INET6, "1080::8:800:200c:417a", &rawAddr_);
         InetAddress addr(rawAddr_);
-        CPPUNIT_ASSERT(addr.addressFamily == AddressFamily::InterNetworkV6);
+        CPPUNIT_ASSERT(addr.getAddressFamily() == AddressFamily::InterNetworkV6);
     }
 
     void testConstructorException1()
@@ -384,9 +412,333 @@ class Inet6AddressTest : public CppUnit::TestFixture
         InetAddress addr2("::0a09:0807");
         InetAddress addr3("::10.9.8.7");
 
-        CPPUNIT_ASSERT(addr.ipv4Compatible);
-        CPPUNIT_ASSERT(addr2.ipv4Compatible);
-        CPPUNIT_ASSERT(addr3.ipv4Compatible);
+        CPPUNIT_ASSERT(addr.isIPv4Compatible());
+        CPPUNIT_ASSERT(addr2.isIPv4Compatible());
+        CPPUNIT_ASSERT(addr3.isIPv4Compatible());
+    }
+
+    void testTryParse()
+    {
+        const char* text[] = { "::", "::1", "ff01::43", "1:2:3:4:5:6:7:8", "1::", "1::8",
+            "fe80::fc:ff:fe00:1", "FE80::ABCD", "1080:0:0:0:8:800:200c:417a",
+            "::ffff:10.1.0.1", "::10.9.8.7", "64:ff9b::192.0.2.33", "1:2:3:4:5:6:1.2.3.4" };
+        for(size_t i = 0; i < sizeof(text) / sizeof(text[0]); ++i)
+        {
+            InetAddress addr;
+            CPPUNIT_ASSERT(InetAddress::tryParse(text[i], strlen(text[i]), addr));
+            CPPUNIT_ASSERT(addr == InetAddress(text[i]));
+            CPPUNIT_ASSERT(addr.getAddressFamily() == AddressFamily::InterNetworkV6);
+            CPPUNIT_ASSERT(addr.isIPv4Compatible() == InetAddress(text[i]).isIPv4Compatible());
+        }
+    }
+
+    void testTryParseScopeId()
+    {
+        InetAddress addr;
+        CPPUNIT_ASSERT(InetAddress::tryParse("fe80::1%2", 9, addr));
+        CPPUNIT_ASSERT(addr == InetAddress("fe80::1", 2));
+        CPPUNIT_ASSERT(addr.toString() == "fe80::1%2");
+
+        CPPUNIT_ASSERT(InetAddress::tryParse("::1%lo", 6, addr));
+        CPPUNIT_ASSERT(addr.isLoopbackAddress());
+    }
+
+    void testTryParseInvalid()
+    {
+        const char* text[] = { ":", ":::", ":1", "1:", "1:::2", "1::2::3", "g:g:g:g:g:g:g:g",
+            "1080:0:0:0:8:800:200c:417z", "12345::", "1:2:3:4:5:6:7:8:9", "1:2:3:4:5:6:7::8",
+            "::1.2.3", "::1.2.3.4:1", "::256.1.1.1", "1:2:3:4:5:6:7:1.2.3.4", "fe80::1%",
+            "fe80::1%no-such-interface0", "fe80::1%99999999999", "[::1]" };
+        InetAddress addr("::1");
+        for(size_t i = 0; i < sizeof(text) / sizeof(text[0]); ++i)
+        {
+            CPPUNIT_ASSERT(!InetAddress::tryParse(text[i], strlen(text[i]), addr));
+            CPPUNIT_ASSERT(addr == InetAddress("::1"));
+        }
+    }
+
+    void testFormat()
+    {
+        const char* text[] = { "::", "::1", "::2", "1::", "1::1", "2001:db8::1:0:0:1",
+            "2001:db8:0:0:1::1", "2001:0:0:1::1", "0:0:1::", "1:0:0:2:0:0:0:3",
+            "::ffff:10.1.0.1", "::10.9.8.7", "::ffff:0:0", "::0.1.0.0", "fe80::fc:ff:fe00:1",
+            "1:2:3:4:5:6:7:8", "1:0:2:0:3:0:4:0", "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff" };
+        char buf[InetAddress::MAX_TEXT_SIZE];
+        char expected[INET6_ADDRSTRLEN];
+        for(size_t i = 0; i < sizeof(text) / sizeof(text[0]); ++i)
+        {
+            inet_pton(AF_INET6, text[i], &rawAddr_);
+            inet_ntop(AF_INET6, &rawAddr_, expected, sizeof(expected));
+            InetAddress addr(rawAddr_);
+
+            CPPUNIT_ASSERT(addr.format(buf, sizeof(buf)) == strlen(expected));
+            CPPUNIT_ASSERT(!strcmp(buf, expected));
+        }
+
+        // Every mix of zero and non-zero groups.
+        for(int mask = 0; mask < 256; ++mask)
+        {
+            memset(&rawAddr_, 0, sizeof(rawAddr_));
+            for(int word = 0; word < 8; ++word)
+            {
+                if(mask & (1 << word))
+                {
+                    rawAddr_.s6_addr[2 * word] = static_cast<uint8_t>(word);
+                    rawAddr_.s6_addr[(2 * word) + 1] = static_cast<uint8_t>(0x0a + word);
+                }
+            }
+            inet_ntop(AF_INET6, &rawAddr_, expected, sizeof(expected));
+            InetAddress addr(rawAddr_);
+
+            CPPUNIT_ASSERT(addr.format(buf, sizeof(buf)) == strlen(expected));
+            CPPUNIT_ASSERT(!strcmp(buf, expected));
+            CPPUNIT_ASSERT(addr.getHostAddress() == expected);
+        }
+    }
+
+    void testFormatScopeId()
+    {
+        char buf[InetAddress::MAX_TEXT_SIZE];
+        InetAddress addr("fe80::1", 4294967295U);
+        CPPUNIT_ASSERT(addr.format(buf, sizeof(buf)) == 18);
+        CPPUNIT_ASSERT(!strcmp(buf, "fe80::1%4294967295"));
+
+        InetAddress addr2("ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255", 4294967295U);
+        CPPUNIT_ASSERT(addr2.format(buf, sizeof(buf)) == 50);
+        CPPUNIT_ASSERT(!strcmp(buf, "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff%4294967295"));
+
+        InetAddress addr3("fe80::1", 123);
+        CPPUNIT_ASSERT(addr3.toString() == "fe80::1%123");
+        CPPUNIT_ASSERT(addr3.format(buf, 11) == 0);
+        CPPUNIT_ASSERT(addr3.format(buf, 12) == 11);
+    }
+
+    void testHashCode()
+    {
+        InetAddress addr("fe80::1", 1);
+        InetAddress addr2("fe80::1", 1);
+        InetAddress addr3("fe80::1", 2);
+        InetAddress addr4("::10.1.0.1");
+        InetAddress addr5("10.1.0.1");
+
+        CPPUNIT_ASSERT(addr.hashCode() == addr2.hashCode());
+        CPPUNIT_ASSERT(addr.hashCode() != addr3.hashCode());
+        CPPUNIT_ASSERT(addr4.hashCode() != addr5.hashCode());
+        CPPUNIT_ASSERT(addr.getValue().hash() == addr2.getValue().hash());
+        CPPUNIT_ASSERT(frog::net::InetAddressHash()(addr) == frog::net::InetAddressHash()(addr2));
+    }
+    void testTypedConversion()
+    {
+        CPPUNIT_ASSERT(sizeof(Inet6Address) == 24U);
+
+        Inet6Address addr("fe80::1:2%7");
+        CPPUNIT_ASSERT(addr.getHigh() == 0xfe80000000000000ULL);
+        CPPUNIT_ASSERT(addr.getLow() == 0x0000000000010002ULL);
+        CPPUNIT_ASSERT(addr.getScope() == 7U);
+        CPPUNIT_ASSERT(addr.toString() == "fe80::1:2%7");
+
+        InetAddress inet(addr.toInetAddress());
+        CPPUNIT_ASSERT(inet == InetAddress("fe80::1:2", 7));
+        CPPUNIT_ASSERT(Inet6Address(inet) == addr);
+        CPPUNIT_ASSERT(Inet6Address(inet.getValue()) == addr);
+        CPPUNIT_ASSERT(addr.hash() == inet.getValue().hash());
+
+        rawAddr_ = addr.toIn6Addr();
+        CPPUNIT_ASSERT(rawAddr_.s6_addr[0] == 0xfe);
+        CPPUNIT_ASSERT(rawAddr_.s6_addr[15] == 0x02);
+        CPPUNIT_ASSERT(Inet6Address(rawAddr_, 7) == addr);
+        CPPUNIT_ASSERT(Inet6Address(rawAddr_) != addr);
+
+        Inet6Address parsed;
+        CPPUNIT_ASSERT(Inet6Address::tryParse("2001:db8::1", 11, parsed));
+        CPPUNIT_ASSERT(parsed == Inet6Address(0x20010db800000000ULL, 1U));
+        CPPUNIT_ASSERT(!Inet6Address::tryParse("10.0.0.1", 8, parsed));
+        CPPUNIT_ASSERT(parsed == Inet6Address(0x20010db800000000ULL, 1U));
+        CPPUNIT_ASSERT(!Inet6Address::fromValue(InetAddress("10.0.0.1").getValue(), parsed));
+    }
+
+    void testTypedConstructorException()
+    {
+        Inet6Address addr(InetAddress("10.0.0.1"));
+    }
+
+    void testTypedPredicates()
+    {
+        static const uint64_t prefixes[] = {
+            0, 0xfe80000000000000ULL, 0xfebf000000000000ULL, 0xfec0000000000000ULL,
+            0xff01000000000000ULL, 0xff02000000000000ULL, 0xff05000000000000ULL,
+            0xff08000000000000ULL, 0xff0e000000000000ULL, 0xff1e000000000000ULL,
+            0xff00000000000000ULL, 0x20010db800000000ULL };
+        static const uint64_t tails[] = { 0, 1, 2, 0x0a000001ULL, 0x100000000ULL };
+
+        for(size_t i = 0; i < sizeof(prefixes) / sizeof(prefixes[0]); ++i)
+        {
+            for(size_t j = 0; j < sizeof(tails) / sizeof(tails[0]); ++j)
+            {
+                Inet6Address addr(prefixes[i], tails[j]);
+                InetAddress inet(addr.toInetAddress());
+
+                CPPUNIT_ASSERT(addr.isIPv4Compatible() == inet.getValue().isIPv4Compatible());
+                CPPUNIT_ASSERT(addr.isAnyLocalAddress() == inet.isAnyLocalAddress());
+                CPPUNIT_ASSERT(addr.isLoopbackAddress() == inet.isLoopbackAddress());
+                CPPUNIT_ASSERT(addr.isLinkLocalAddress() == inet.isLinkLocalAddress());
+                CPPUNIT_ASSERT(addr.isSiteLocalAddress() == inet.isSiteLocalAddress());
+                CPPUNIT_ASSERT(addr.isMulticastAddress() == inet.isMulticastAddress());
+                CPPUNIT_ASSERT(addr.isMulticastGlobal() == inet.isMulticastGlobal());
+                CPPUNIT_ASSERT(addr.isMulticastNodeLocal() == inet.isMulticastNodeLocal());
+                CPPUNIT_ASSERT(addr.isMulticastLinkLocal() == inet.isMulticastLinkLocal());
+                CPPUNIT_ASSERT(addr.isMulticastSiteLocal() == inet.isMulticastSiteLocal());
+                CPPUNIT_ASSERT(addr.isMulticastOrgLocal() == inet.isMulticastOrgLocal());
+                CPPUNIT_ASSERT(addr.classify() == inet.classify());
+            }
+        }
+    }
+
+    void testTypedAlgorithms()
+    {
+        using frog::net::networkAddress;
+        using frog::net::lastAddress;
+        using frog::net::sameNetwork;
+        using frog::net::commonPrefixLength;
+
+        Inet6Address addr("2001:db8:aaaa:bbbb:cccc:dddd:eeee:ffff%3");
+        CPPUNIT_ASSERT(networkAddress(addr, 64).toString() == "2001:db8:aaaa:bbbb::%3");
+        CPPUNIT_ASSERT(networkAddress(addr, 36).toString() == "2001:db8:a000::%3");
+        CPPUNIT_ASSERT(networkAddress(addr, 96).toString() == "2001:db8:aaaa:bbbb:cccc:dddd::%3");
+        CPPUNIT_ASSERT(networkAddress(addr, 0).toString() == "::%3");
+        CPPUNIT_ASSERT(networkAddress(addr, 128) == addr);
+        CPPUNIT_ASSERT(lastAddress(addr, 64).toString() == "2001:db8:aaaa:bbbb:ffff:ffff:ffff:ffff%3");
+        CPPUNIT_ASSERT(lastAddress(addr, 120).toString() == "2001:db8:aaaa:bbbb:cccc:dddd:eeee:ffff%3");
+        CPPUNIT_ASSERT(lastAddress(addr, 112).getLow() == 0xccccddddeeeeffffULL);
+        CPPUNIT_ASSERT(lastAddress(addr, 128) == addr);
+
+        Inet6Address other("2001:db8:aaaa:bbbb:cccc:dddd:eeee:0");
+        CPPUNIT_ASSERT(sameNetwork(addr, other, 112));
+        CPPUNIT_ASSERT(!sameNetwork(addr, other, 113));
+        CPPUNIT_ASSERT(sameNetwork(addr, Inet6Address("ff02::1"), 0));
+
+        CPPUNIT_ASSERT(commonPrefixLength(addr, addr) == 128U);
+        CPPUNIT_ASSERT(commonPrefixLength(addr, other) == 112U);
+        CPPUNIT_ASSERT(commonPrefixLength(addr, Inet6Address("2001:db8:aaaa:bbbc::")) == 61U);
+        CPPUNIT_ASSERT(commonPrefixLength(Inet6Address(), Inet6Address(1U << 31, 0)) == 32U);
+    }
+
+    void testTypedOrdering()
+    {
+        Inet6Address a("::1");
+        Inet6Address b("fe80::1%1");
+        Inet6Address c("fe80::1%2");
+        Inet6Address d("fe80::2");
+
+        CPPUNIT_ASSERT(a < b);
+        CPPUNIT_ASSERT(b < c);
+        CPPUNIT_ASSERT(c < d);
+        CPPUNIT_ASSERT(d > a);
+        CPPUNIT_ASSERT(b <= b);
+        CPPUNIT_ASSERT(c >= b);
+        CPPUNIT_ASSERT(b != c);
+        CPPUNIT_ASSERT(a.compare(a) == 0);
+        CPPUNIT_ASSERT((a.compare(d) < 0) == (a.toInetAddress() < d.toInetAddress()));
+        CPPUNIT_ASSERT(Inet6Address(0, 1).compare(Inet6Address(1, 0)) < 0);
+    }
+#if __cplusplus >= 201402L
+    void testLiterals()
+    {
+        // Checked by the compiler: a bad literal would not build.
+        constexpr frog::net::Inet6Subnet networks[] = {
+            "fe80::/10"_net6, "2001:db8::/32"_net6, "fc00::1/7"_net6, "::/0"_net6 };
+        static_assert("fe80::1%2"_ip6.getHigh() == 0xfe80000000000000ULL, "literal is parsed at compile time");
+        static_assert("fe80::1%2"_ip6.getScope() == 2, "literal is parsed at compile time");
+        static_assert(networks[0].contains("febf:ffff::1"_ip6), "literal is parsed at compile time");
+        static_assert(!networks[0].contains("fec0::1"_ip6), "literal is parsed at compile time");
+
+        const char* text[] = { "::", "::1", "1::", "2001:db8::8:800:200c:417a", "::ffff:10.1.2.3",
+            "1:2:3:4:5:6:7:8", "1:2:3:4:5:6:1.2.3.4", "FE80::ABCD" };
+        frog::net::Inet6Address parsed[] = { "::"_ip6, "::1"_ip6, "1::"_ip6, "2001:db8::8:800:200c:417a"_ip6,
+            "::ffff:10.1.2.3"_ip6, "1:2:3:4:5:6:7:8"_ip6, "1:2:3:4:5:6:1.2.3.4"_ip6, "FE80::ABCD"_ip6 };
+        for(size_t i = 0; i < sizeof(text) / sizeof(text[0]); ++i)
+        {
+            CPPUNIT_ASSERT(parsed[i] == Inet6Address(text[i]));
+        }
+        CPPUNIT_ASSERT(networks[1].getNetwork() == "2001:db8::"_ip6);
+        CPPUNIT_ASSERT(networks[2].getNetwork() == "fc00::"_ip6);
+        CPPUNIT_ASSERT(networks[2].toSubnet().toString() == "fc00::/7");
+        CPPUNIT_ASSERT(networks[3].contains("ffff::1"_ip6));
+        CPPUNIT_ASSERT("::1"_net6.getPrefixLength() == 128);
+        CPPUNIT_ASSERT("2001:db8::/64"_net6.contains("2001:db8::ffff:ffff:ffff:ffff"_ip6));
+        CPPUNIT_ASSERT(!"2001:db8::/64"_net6.contains("2001:db8:0:1::"_ip6));
+        CPPUNIT_ASSERT("2001:db8::/80"_net6.contains("2001:db8::ffff:ffff:ffff"_ip6));
+        CPPUNIT_ASSERT(!"2001:db8::/80"_net6.contains("2001:db8::1:0:0:0"_ip6));
+
+        // The literal grammar is the one of tryParse(), with numeric
+        // scope ids only.
+        const char* bad[] = { ":", ":::", "1:::2", "1::2::3", "1:2:3:4:5:6:7:8:9", "1:2:3:4:5:6:7",
+            "12345::", "1:", ":1", "::1.2.3", "1::2%", "fe80::1%eth0", "1:2:3:4:5:6:7:1.2.3.4", "" };
+        for(size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i)
+        {
+            bool thrown = false;
+            try
+            {
+                frog::net::parseInet6Literal(bad[i], ::strlen(bad[i]));
+            }
+            catch(const frog::sys::IllegalArgumentException&)
+            {
+                thrown = true;
+            }
+            CPPUNIT_ASSERT(thrown);
+        }
+    }
+
+    void testLiteralException()
+    {
+        // Not a constant expression, so the error is found at run time.
+        frog::net::Inet6Subnet subnet = "fe80::/129"_net6;
+        (void)subnet;
+    }
+#endif
+
+    void testIncrement()
+    {
+        InetAddress addr("2001:db8::ffff:ffff:ffff:ffff", 5);
+        ++addr;
+        CPPUNIT_ASSERT(addr.toString() == "2001:db8:0:1::%5");
+        --addr;
+        CPPUNIT_ASSERT(addr.toString() == "2001:db8::ffff:ffff:ffff:ffff%5");
+        CPPUNIT_ASSERT((addr + 2).toString() == "2001:db8:0:1::1%5");
+        CPPUNIT_ASSERT((addr - -2) == (addr + 2));
+        CPPUNIT_ASSERT((InetAddress("::") - 1).toString() == "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff");
+        const int64_t minimum = -0x7fffffffffffffffLL - 1;
+        CPPUNIT_ASSERT((InetAddress("::1") + minimum).toString() == "ffff:ffff:ffff:ffff:8000::1");
+        CPPUNIT_ASSERT((InetAddress("::1") - minimum).toString() == "::8000:0:0:1");
+
+        // The IPv4-compatible flag follows the address.
+        InetAddress compat("::1");
+        CPPUNIT_ASSERT(!compat.isIPv4Compatible());
+        ++compat;
+        CPPUNIT_ASSERT(compat.isIPv4Compatible());
+    }
+
+    void testDistance()
+    {
+        const int64_t minimum = -0x7fffffffffffffffLL - 1;
+        CPPUNIT_ASSERT(InetAddress("fe80::1").distance(InetAddress("fe80::1:0")) == 65535);
+        CPPUNIT_ASSERT(InetAddress("::8000:0:0:0").distance(InetAddress("::")) == minimum);
+        CPPUNIT_ASSERT(InetAddress("::").distance(InetAddress("::7fff:ffff:ffff:ffff")) == 0x7fffffffffffffffLL);
+        CPPUNIT_ASSERT(InetAddress("fe80::1", 1).distance(InetAddress("fe80::3", 2)) == 2);
+    }
+
+    void testDistanceOutOfRange()
+    {
+        InetAddress("::").distance(InetAddress("::8000:0:0:0"));
+    }
+
+    void testMask()
+    {
+        InetAddress addr("2001:db8:aaaa:bbbb:cccc::1", 9);
+        CPPUNIT_ASSERT(addr.mask(64).toString() == "2001:db8:aaaa:bbbb::%9");
+        CPPUNIT_ASSERT(addr.mask(40).toString() == "2001:db8:aa00::%9");
+        CPPUNIT_ASSERT(addr.mask(128) == addr);
+        CPPUNIT_ASSERT(addr.mask(InetAddress("ffff:ffff::")).toString() == "2001:db8::%9");
     }
   private:
     struct in6_addr rawAddr_;
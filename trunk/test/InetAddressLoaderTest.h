@@ -0,0 +1,201 @@
+// C++ test file ---------------------------------------------------------//
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@gmail.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License as
+//   published by the Free Software Foundation; either version 2 of the
+//   License, or (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+//   This file is part of the Frog Framework.
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/InetAddressLoader.h>
+#include <frog/IOException.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::InetAddressLoader;
+using frog::sys::IOException;
+
+class InetAddressLoaderTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(InetAddressLoaderTest);
+
+    CPPUNIT_TEST(testEmpty);
+    CPPUNIT_TEST(testLines);
+    CPPUNIT_TEST(testBadLines);
+    CPPUNIT_TEST(testThreads);
+    CPPUNIT_TEST(testFile);
+    CPPUNIT_TEST(testEmptyFile);
+    CPPUNIT_TEST_EXCEPTION(testMissing, IOException);
+
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void setUp()
+    {
+        std::ostringstream name;
+        name << "/tmp/InetAddressLoaderTest." << ::getpid() << ".txt";
+        path = name.str();
+    }
+
+    void tearDown()
+    {
+        ::unlink(path.c_str());
+    }
+
+    void testEmpty()
+    {
+        InetAddressLoader loader(4);
+        CPPUNIT_ASSERT(loader.getThreadCount() == 4);
+        loader.load("", 0);
+        CPPUNIT_ASSERT(loader.getValues().empty());
+        CPPUNIT_ASSERT(loader.getBadLines().empty());
+        CPPUNIT_ASSERT(InetAddressLoader().getThreadCount() >= 1);
+    }
+
+    void testLines()
+    {
+        std::string text = "10.0.0.1\n"
+            "  192.168.1.1\t\r\n"
+            "\n"
+            "# comment\n"
+            "127.0.0.1";
+        InetAddressLoader loader(1);
+        loader.load(text.data(), text.size());
+        const std::vector<InetAddressValue>& values = loader.getValues();
+        CPPUNIT_ASSERT(values.size() == 3);
+        CPPUNIT_ASSERT(InetAddress(values[0]) == InetAddress("10.0.0.1"));
+        CPPUNIT_ASSERT(InetAddress(values[1]) == InetAddress("192.168.1.1"));
+        CPPUNIT_ASSERT(InetAddress(values[2]) == InetAddress("127.0.0.1"));
+        CPPUNIT_ASSERT(loader.getBadLines().empty());
+#ifdef HAVE_IPV6_SUPPORT
+        text = "::1\r\nfe80::1%3\n";
+        loader.load(text.data(), text.size());
+        CPPUNIT_ASSERT(loader.getValues().size() == 2);
+        CPPUNIT_ASSERT(InetAddress(loader.getValues()[0]) == InetAddress("::1"));
+        CPPUNIT_ASSERT(loader.getValues()[1].scope == 3);
+#endif
+    }
+
+    void testBadLines()
+    {
+        std::string text = "10.0.0.1\n"
+            "10.0.0.256\n"
+            "\n"
+            "hello\n"
+            "10.0.0.2\n"
+            "10.0.0.3 10.0.0.4\n";
+        InetAddressLoader loader(1);
+        loader.load(text.data(), text.size());
+        CPPUNIT_ASSERT(loader.getValues().size() == 2);
+        CPPUNIT_ASSERT(InetAddress(loader.getValues()[1]) == InetAddress("10.0.0.2"));
+        const std::vector<size_t>& bad = loader.getBadLines();
+        CPPUNIT_ASSERT(bad.size() == 3);
+        CPPUNIT_ASSERT(bad[0] == 2);
+        CPPUNIT_ASSERT(bad[1] == 4);
+        CPPUNIT_ASSERT(bad[2] == 6);
+    }
+
+    void testThreads()
+    {
+        // Large enough for several chunks, with a bad line every 1000
+        // lines and blank lines in between.
+        std::string text;
+        std::vector<size_t> expectedBad;
+        size_t line = 0;
+        for(uint32_t i = 0; i < 100000; ++i)
+        {
+            char buf[32];
+            if(i % 1000 == 999)
+            {
+                text += "bad\n";
+                expectedBad.push_back(++line);
+            }
+            if(i % 777 == 0)
+            {
+                text += "\n";
+                ++line;
+            }
+            ::snprintf(buf, sizeof(buf), "10.%u.%u.%u\n", (i >> 16) & 0xFF, (i >> 8) & 0xFF, i & 0xFF);
+            text += buf;
+            ++line;
+        }
+
+        for(size_t threads = 1; threads <= 8; threads *= 2)
+        {
+            InetAddressLoader loader(threads);
+            loader.load(text.data(), text.size());
+            const std::vector<InetAddressValue>& values = loader.getValues();
+            CPPUNIT_ASSERT(values.size() == 100000);
+            for(uint32_t i = 0; i < values.size(); ++i)
+            {
+                const uint8_t* p = values[i].address + InetAddressValue::IPV4_OFFSET;
+                CPPUNIT_ASSERT(values[i].family == AF_INET);
+                CPPUNIT_ASSERT((p[0] == 10) && (p[1] == ((i >> 16) & 0xFF)) &&
+                        (p[2] == ((i >> 8) & 0xFF)) && (p[3] == (i & 0xFF)));
+            }
+            CPPUNIT_ASSERT(loader.getBadLines() == expectedBad);
+        }
+    }
+
+    void testFile()
+    {
+        FILE* file = ::fopen(path.c_str(), "w");
+        ::fputs("10.0.0.1\nbad\n10.0.0.2\n", file);
+        ::fclose(file);
+
+        InetAddressLoader loader(2);
+        loader.load(path);
+        CPPUNIT_ASSERT(loader.getValues().size() == 2);
+        CPPUNIT_ASSERT(loader.getBadLines().size() == 1);
+        CPPUNIT_ASSERT(loader.getBadLines()[0] == 2);
+    }
+
+    void testEmptyFile()
+    {
+        InetAddressLoader loader(2);
+        loader.load("10.0.0.1\nbad\n", 13);
+        CPPUNIT_ASSERT(loader.getValues().size() == 1);
+
+        FILE* file = ::fopen(path.c_str(), "w");
+        ::fclose(file);
+
+        loader.load(path);
+        CPPUNIT_ASSERT(loader.getValues().empty());
+        CPPUNIT_ASSERT(loader.getBadLines().empty());
+    }
+
+    void testMissing()
+    {
+        InetAddressLoader loader;
+        loader.load(path);
+    }
+
+  private:
+    std::string path;
+};
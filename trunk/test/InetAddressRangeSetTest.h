@@ -0,0 +1,296 @@
+// C++ test file ---------------------------------------------------------//
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@gmail.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License as
+//   published by the Free Software Foundation; either version 2 of the
+//   License, or (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+//   This file is part of the Frog Framework.
+
+#include <sys/types.h>
+#include <arpa/inet.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <frog/InetAddress.h>
+#include <frog/Subnet.h>
+#include <frog/InetAddressRangeSet.h>
+#include <frog/IllegalArgumentException.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+using frog::net::InetAddress;
+using frog::net::Subnet;
+using frog::net::InetAddressRangeSet;
+using frog::sys::IllegalArgumentException;
+
+class InetAddressRangeSetTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(InetAddressRangeSetTest);
+
+    CPPUNIT_TEST(testEmpty);
+    CPPUNIT_TEST(testMerge);
+    CPPUNIT_TEST(testContains);
+    CPPUNIT_TEST(testToCidrs);
+    CPPUNIT_TEST(testToCidrsFull);
+    CPPUNIT_TEST(testSetOperations);
+    CPPUNIT_TEST(testRandom);
+    CPPUNIT_TEST_EXCEPTION(testReversedRange, IllegalArgumentException);
+#ifdef HAVE_IPV6_SUPPORT
+    CPPUNIT_TEST(testOrder);
+    CPPUNIT_TEST(testIPv6);
+    CPPUNIT_TEST_EXCEPTION(testMixedRange, IllegalArgumentException);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void setUp()
+    {
+    }
+
+    void tearDown()
+    {
+    }
+
+    void testEmpty()
+    {
+        InetAddressRangeSet set;
+        CPPUNIT_ASSERT(set.isEmpty());
+        CPPUNIT_ASSERT(set.getRangeCount() == 0);
+        CPPUNIT_ASSERT(!set.contains(InetAddress("10.1.0.1")));
+        CPPUNIT_ASSERT(!set.contains(InetAddress()));
+        CPPUNIT_ASSERT(set.toCidrs().empty());
+        CPPUNIT_ASSERT(set.toString() == "{}");
+    }
+
+    void testMerge()
+    {
+        InetAddressRangeSet set;
+        set.add(Subnet("10.0.0.0/24"));
+        set.add(Subnet("10.0.1.0/24"));
+        set.add(InetAddress("10.0.2.0"), InetAddress("10.0.2.9"));
+        set.add(InetAddress("10.0.2.5"), InetAddress("10.0.2.20"));
+        set.add(InetAddress("10.0.3.1"));
+        set.add(Subnet("10.0.0.128/25"));
+
+        CPPUNIT_ASSERT(set.getRangeCount() == 2);
+        CPPUNIT_ASSERT(set.toString() == "{10.0.0.0-10.0.2.20, 10.0.3.1}");
+    }
+
+    void testContains()
+    {
+        InetAddressRangeSet set;
+        set.add(Subnet("10.0.0.0/8"));
+        set.add(Subnet("192.168.0.0/16"));
+        set.add(InetAddress("172.16.0.5"), InetAddress("172.16.0.10"));
+
+        // The first pass scans the ranges as added, the second searches
+        // the index built by compact().
+        for(int pass = 0; pass < 2; ++pass)
+        {
+            CPPUNIT_ASSERT(set.contains(InetAddress("10.0.0.0")));
+            CPPUNIT_ASSERT(set.contains(InetAddress("10.255.255.255")));
+            CPPUNIT_ASSERT(!set.contains(InetAddress("11.0.0.0")));
+            CPPUNIT_ASSERT(!set.contains(InetAddress("9.255.255.255")));
+            CPPUNIT_ASSERT(set.contains(InetAddress("172.16.0.5")));
+            CPPUNIT_ASSERT(set.contains(InetAddress("172.16.0.10")));
+            CPPUNIT_ASSERT(!set.contains(InetAddress("172.16.0.11")));
+            CPPUNIT_ASSERT(!set.contains(InetAddress("0.0.0.0")));
+            CPPUNIT_ASSERT(!set.contains(InetAddress("255.255.255.255")));
+            CPPUNIT_ASSERT(set.contains(InetAddress("192.168.77.1")));
+#ifdef HAVE_IPV6_SUPPORT
+            CPPUNIT_ASSERT(!set.contains(InetAddress("::10.0.0.1")));
+#endif
+            set.compact();
+        }
+    }
+
+    void testToCidrs()
+    {
+        InetAddressRangeSet set;
+        set.add(InetAddress("10.0.0.1"), InetAddress("10.0.0.14"));
+        std::vector<Subnet> cidrs = set.toCidrs();
+
+        const char* expected[] = { "10.0.0.1/32", "10.0.0.2/31", "10.0.0.4/30", "10.0.0.8/30",
+            "10.0.0.12/31", "10.0.0.14/32" };
+        CPPUNIT_ASSERT(cidrs.size() == sizeof(expected) / sizeof(expected[0]));
+        for(size_t i = 0; i < cidrs.size(); ++i)
+        {
+            CPPUNIT_ASSERT(cidrs[i].toString() == expected[i]);
+        }
+
+        InetAddressRangeSet set2;
+        set2.add(Subnet("192.168.0.0/24"));
+        set2.add(Subnet("192.168.1.0/24"));
+        cidrs = set2.toCidrs();
+        CPPUNIT_ASSERT(cidrs.size() == 1);
+        CPPUNIT_ASSERT(cidrs[0].toString() == "192.168.0.0/23");
+    }
+
+    void testToCidrsFull()
+    {
+        InetAddressRangeSet set;
+        set.add(InetAddress("0.0.0.0"), InetAddress("255.255.255.255"));
+        std::vector<Subnet> cidrs = set.toCidrs();
+        CPPUNIT_ASSERT(cidrs.size() == 1);
+        CPPUNIT_ASSERT(cidrs[0].toString() == "0.0.0.0/0");
+
+        InetAddressRangeSet top;
+        top.add(InetAddress("255.255.255.254"), InetAddress("255.255.255.255"));
+        top.add(InetAddress("255.255.255.255"));
+        cidrs = top.toCidrs();
+        CPPUNIT_ASSERT(cidrs.size() == 1);
+        CPPUNIT_ASSERT(cidrs[0].toString() == "255.255.255.254/31");
+    }
+
+    void testSetOperations()
+    {
+        InetAddressRangeSet a, b;
+        a.add(Subnet("10.0.0.0/24"));
+        b.add(InetAddress("10.0.0.100"), InetAddress("10.0.1.50"));
+
+        CPPUNIT_ASSERT(a.setUnion(b).toString() == "{10.0.0.0-10.0.1.50}");
+        CPPUNIT_ASSERT(a.setIntersection(b).toString() == "{10.0.0.100-10.0.0.255}");
+        CPPUNIT_ASSERT(a.setDifference(b).toString() == "{10.0.0.0-10.0.0.99}");
+        CPPUNIT_ASSERT(b.setDifference(a).toString() == "{10.0.1.0-10.0.1.50}");
+
+        InetAddressRangeSet all;
+        all.add(InetAddress("0.0.0.0"), InetAddress("255.255.255.255"));
+        InetAddressRangeSet rest = all.setDifference(a);
+        CPPUNIT_ASSERT(rest.toString() == "{0.0.0.0-9.255.255.255, 10.0.1.0-255.255.255.255}");
+        CPPUNIT_ASSERT(rest.setUnion(a) == all);
+        CPPUNIT_ASSERT(rest.setIntersection(a).isEmpty());
+    }
+
+    void testRandom()
+    {
+        // Compare against a bitmap of 10.0.0.0/20.
+        const size_t SIZE = 4096;
+        srand(11);
+        for(size_t round = 0; round < 20; ++round)
+        {
+            std::vector<bool> bitsA(SIZE, false), bitsB(SIZE, false);
+            InetAddressRangeSet a, b;
+            fillRandom(a, bitsA);
+            fillRandom(b, bitsB);
+
+            InetAddressRangeSet both = a.setIntersection(b);
+            InetAddressRangeSet either = a.setUnion(b);
+            InetAddressRangeSet onlyA = a.setDifference(b);
+
+            InetAddressRangeSet fromCidrs;
+            std::vector<Subnet> cidrs = a.toCidrs();
+            for(size_t i = 0; i < cidrs.size(); ++i)
+            {
+                fromCidrs.add(cidrs[i]);
+            }
+            CPPUNIT_ASSERT(fromCidrs == a);
+
+            for(size_t i = 0; i < SIZE; ++i)
+            {
+                InetAddress addr = address(i);
+                CPPUNIT_ASSERT(a.contains(addr) == bitsA[i]);
+                CPPUNIT_ASSERT(both.contains(addr) == (bitsA[i] && bitsB[i]));
+                CPPUNIT_ASSERT(either.contains(addr) == (bitsA[i] || bitsB[i]));
+                CPPUNIT_ASSERT(onlyA.contains(addr) == (bitsA[i] && !bitsB[i]));
+            }
+        }
+    }
+
+    void testReversedRange()
+    {
+        InetAddressRangeSet set;
+        set.add(InetAddress("10.0.0.2"), InetAddress("10.0.0.1"));
+    }
+
+#ifdef HAVE_IPV6_SUPPORT
+    void testOrder()
+    {
+        InetAddressRangeSet set;
+        set.add(Subnet("2001:db8::/120"));
+        set.add(Subnet("10.0.0.0/8"));
+        set.add(InetAddress("::1"));
+        CPPUNIT_ASSERT(set.toString() == "{10.0.0.0-10.255.255.255, ::1, 2001:db8::-2001:db8::ff}");
+    }
+
+    void testIPv6()
+    {
+        InetAddressRangeSet set;
+        set.add(InetAddress("2001:db8::ffff:ffff:ffff:fff0"), InetAddress("2001:db8:0:1::f"));
+        CPPUNIT_ASSERT(set.contains(InetAddress("2001:db8::ffff:ffff:ffff:ffff")));
+        CPPUNIT_ASSERT(set.contains(InetAddress("2001:db8:0:1::")));
+        CPPUNIT_ASSERT(!set.contains(InetAddress("2001:db8:0:1::10")));
+        CPPUNIT_ASSERT(!set.contains(InetAddress("2001:db8::ffff:ffff:ffff:ffef")));
+
+        std::vector<Subnet> cidrs = set.toCidrs();
+        CPPUNIT_ASSERT(cidrs.size() == 2);
+        CPPUNIT_ASSERT(cidrs[0].toString() == "2001:db8::ffff:ffff:ffff:fff0/124");
+        CPPUNIT_ASSERT(cidrs[1].toString() == "2001:db8:0:1::/124");
+
+        InetAddressRangeSet all;
+        all.add(Subnet("::/0"));
+        CPPUNIT_ASSERT(all.toCidrs().size() == 1);
+        // [::, first - 1] takes one subnet per one bit of first, and
+        // [last + 1, ffff:...] one per zero bit of last.
+        CPPUNIT_ASSERT(all.setDifference(set).toCidrs().size() == 69 + 114);
+    }
+
+    void testMixedRange()
+    {
+        InetAddressRangeSet set;
+        set.add(InetAddress("10.0.0.1"), InetAddress("::1"));
+    }
+#endif
+
+  private:
+    InetAddress address(size_t offset)
+    {
+        struct in_addr in;
+        in.s_addr = htonl(0x0a000000U + static_cast<uint32_t>(offset));
+        return InetAddress(in);
+    }
+
+    void fillRandom(InetAddressRangeSet& set, std::vector<bool>& bits)
+    {
+        for(size_t i = 0; i < 12; ++i)
+        {
+            if(rand() & 1)
+            {
+                size_t first = rand() % bits.size();
+                size_t last = std::min(bits.size() - 1, first + rand() % 300);
+                set.add(address(first), address(last));
+                for(size_t j = first; j <= last; ++j)
+                {
+                    bits[j] = true;
+                }
+            }
+            else
+            {
+                uint32_t prefixLength = 22 + rand() % 11;
+                Subnet subnet(address(rand() % bits.size()), prefixLength);
+                set.add(subnet);
+                for(size_t j = 0; j < bits.size(); ++j)
+                {
+                    bits[j] = bits[j] || subnet.contains(address(j));
+                }
+            }
+        }
+    }
+};
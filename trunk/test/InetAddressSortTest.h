@@ -0,0 +1,217 @@
+// C++ test file ---------------------------------------------------------//
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@gmail.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License as
+//   published by the Free Software Foundation; either version 2 of the
+//   License, or (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+//   This file is part of the Frog Framework.
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/InetAddressSort.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+
+class InetAddressSortTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(InetAddressSortTest);
+
+    CPPUNIT_TEST(testSort);
+    CPPUNIT_TEST(testSortThreads);
+    CPPUNIT_TEST(testSortSmall);
+    CPPUNIT_TEST(testUnique);
+    CPPUNIT_TEST(testMerge);
+    CPPUNIT_TEST(testIntersect);
+    CPPUNIT_TEST(testDifference);
+    CPPUNIT_TEST(testEmpty);
+
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void setUp()
+    {
+    }
+
+    void tearDown()
+    {
+    }
+
+    void testSort()
+    {
+        std::vector<InetAddressValue> values = addresses(100000, 1);
+        std::vector<InetAddressValue> expected(values);
+        std::stable_sort(expected.begin(), expected.end());
+        frog::net::sortAddresses(values, 1);
+        CPPUNIT_ASSERT(values == expected);
+
+        // Only the last byte differs, so only one pass is made.
+        values.clear();
+        for(uint32_t i = 0; i < 1000; ++i)
+        {
+            values.push_back((InetAddress("10.1.2.0") + (i * 37) % 256).getValue());
+        }
+        expected = values;
+        std::stable_sort(expected.begin(), expected.end());
+        frog::net::sortAddresses(values, 1);
+        CPPUNIT_ASSERT(values == expected);
+    }
+
+    void testSortThreads()
+    {
+        std::vector<InetAddressValue> expected = addresses(300000, 2);
+        std::stable_sort(expected.begin(), expected.end());
+        size_t threads[] = { 0, 3, 8 };
+        for(size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); ++i)
+        {
+            std::vector<InetAddressValue> values = addresses(300000, 2);
+            frog::net::sortAddresses(values, threads[i]);
+            CPPUNIT_ASSERT(values == expected);
+        }
+    }
+
+    void testSortSmall()
+    {
+        std::vector<InetAddressValue> values = addresses(100, 3);
+        std::vector<InetAddressValue> expected(values);
+        std::stable_sort(expected.begin(), expected.end());
+        frog::net::sortAddresses(values);
+        CPPUNIT_ASSERT(values == expected);
+    }
+
+    void testUnique()
+    {
+        std::vector<InetAddressValue> values = addresses(20000, 4);
+        frog::net::sortAddresses(values);
+        std::vector<InetAddressValue> expected(values);
+        expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+        CPPUNIT_ASSERT(expected.size() < values.size());
+        values.resize(frog::net::uniqueAddresses(&values[0], values.size()));
+        CPPUNIT_ASSERT(values == expected);
+    }
+
+    void testMerge()
+    {
+        std::vector<InetAddressValue> a = set(20000, 5), b = set(3000, 6), expected;
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        std::vector<InetAddressValue> out(a.size() + b.size());
+        out.resize(frog::net::mergeAddresses(&a[0], a.size(), &b[0], b.size(), &out[0]));
+        CPPUNIT_ASSERT(out == expected);
+    }
+
+    void testIntersect()
+    {
+        // Sizes close together and far apart, in both orders.
+        size_t sizes[][2] = { { 20000, 20000 }, { 20000, 50 }, { 50, 20000 } };
+        for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        {
+            std::vector<InetAddressValue> a = set(sizes[i][0], 7), b = set(sizes[i][1], 8), expected;
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+            CPPUNIT_ASSERT(!expected.empty());
+            size_t n = frog::net::intersectAddresses(&a[0], a.size(), &b[0], b.size(), &a[0]);
+            a.resize(n);
+            CPPUNIT_ASSERT(a == expected);
+        }
+    }
+
+    void testDifference()
+    {
+        size_t sizes[][2] = { { 20000, 20000 }, { 20000, 50 }, { 50, 20000 } };
+        for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        {
+            std::vector<InetAddressValue> a = set(sizes[i][0], 9), b = set(sizes[i][1], 10), expected;
+            std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+            size_t n = frog::net::differenceAddresses(&a[0], a.size(), &b[0], b.size(), &a[0]);
+            a.resize(n);
+            CPPUNIT_ASSERT(a == expected);
+        }
+    }
+
+    void testEmpty()
+    {
+        std::vector<InetAddressValue> empty;
+        frog::net::sortAddresses(empty);
+        CPPUNIT_ASSERT(empty.empty());
+        CPPUNIT_ASSERT(frog::net::uniqueAddresses(NULL, 0) == 0);
+
+        std::vector<InetAddressValue> a = set(10, 11), out(10);
+        CPPUNIT_ASSERT(frog::net::mergeAddresses(&a[0], a.size(), NULL, 0, &out[0]) == 10);
+        CPPUNIT_ASSERT(out == a);
+        CPPUNIT_ASSERT(frog::net::intersectAddresses(&a[0], a.size(), NULL, 0, &out[0]) == 0);
+        CPPUNIT_ASSERT(frog::net::intersectAddresses(NULL, 0, &a[0], a.size(), &out[0]) == 0);
+        CPPUNIT_ASSERT(frog::net::differenceAddresses(NULL, 0, &a[0], a.size(), &out[0]) == 0);
+        CPPUNIT_ASSERT(frog::net::differenceAddresses(&a[0], a.size(), NULL, 0, &out[0]) == 10);
+        CPPUNIT_ASSERT(out == a);
+    }
+
+  private:
+    // Returns IPv4 addresses, IPv6 addresses and IPv6 addresses with
+    // scope ids, including ones above 24 bits, drawn from small ranges
+    // so that some repeat. Without IPv6 support all of them are IPv4.
+    static std::vector<InetAddressValue> addresses(size_t count, uint32_t seed)
+    {
+        std::vector<InetAddressValue> values;
+        values.reserve(count);
+        uint32_t x = seed * 2654435761U + 1;
+        for(size_t i = 0; i < count; ++i)
+        {
+            x = x * 1103515245U + 12345U;
+            uint32_t r = x >> 8;
+            switch(i % 4)
+            {
+                case 0:
+                    values.push_back((InetAddress("10.0.0.0") + (r & 0xFFFFF)).getValue());
+                    break;
+#ifdef HAVE_IPV6_SUPPORT
+                case 1:
+                    values.push_back((InetAddress("2001:db8::") + (r & 0xFFFFF)).getValue());
+                    break;
+                case 2:
+                    values.push_back((InetAddress("fe80::1", (r & 3) ? r & 7 : 0x12345678 + (r & 1)) + ((r >> 4) & 0xF)).getValue());
+                    break;
+#else
+                case 1:
+                    values.push_back((InetAddress("172.16.0.0") + (r & 0xFFFFF)).getValue());
+                    break;
+                case 2:
+                    values.push_back((InetAddress("169.254.0.0") + ((r >> 4) & 0xF)).getValue());
+                    break;
+#endif
+                default:
+                    values.push_back((InetAddress("192.168.0.0") + (r & 0xFF)).getValue());
+                    break;
+            }
+        }
+        return values;
+    }
+
+    // Returns a sorted set of addresses.
+    static std::vector<InetAddressValue> set(size_t count, uint32_t seed)
+    {
+        std::vector<InetAddressValue> values = addresses(count, seed);
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        return values;
+    }
+};
@@ -0,0 +1,391 @@
+// C++ test file ---------------------------------------------------------//
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@gmail.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License as
+//   published by the Free Software Foundation; either version 2 of the
+//   License, or (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+//   This file is part of the Frog Framework.
+
+#include <sys/types.h>
+#include <arpa/inet.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+
+class InetAddressValueTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(InetAddressValueTest);
+
+    CPPUNIT_TEST(testSize);
+    CPPUNIT_TEST(testUnspecified);
+    CPPUNIT_TEST(testRoundTrip);
+    CPPUNIT_TEST(testTryParse);
+    CPPUNIT_TEST(testPredicates);
+    CPPUNIT_TEST(testClassify);
+    CPPUNIT_TEST(testClassifyBatch);
+    CPPUNIT_TEST(testMemcpy);
+    CPPUNIT_TEST(testEquality);
+    CPPUNIT_TEST(testCanonical);
+    CPPUNIT_TEST(testOrdering);
+    CPPUNIT_TEST(testSortKey);
+
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void setUp()
+    {
+        const char* text[] = { "0.0.0.0", "127.0.0.1", "10.1.0.1", "172.16.5.4", "192.168.1.1",
+            "169.254.3.3", "224.0.0.1", "224.0.1.1", "238.255.255.255", "239.255.0.1",
+            "239.192.0.1", "239.195.255.255", "8.8.8.8", "255.255.255.255"
+#ifdef HAVE_IPV6_SUPPORT
+            , "::", "::1", "::2", "::10.9.8.7", "::ffff:10.1.0.1", "fe80::1", "fec0::1",
+            "ff01::1", "ff02::1", "ff05::1", "ff08::1", "ff0e::1", "2001:db8::1"
+#endif
+        };
+        for(size_t i = 0; i < sizeof(text) / sizeof(text[0]); ++i)
+        {
+            addresses_.push_back(InetAddress(text[i]));
+        }
+#ifdef HAVE_IPV6_SUPPORT
+        addresses_.push_back(InetAddress("fe80::1", 7));
+#endif
+    }
+
+    void tearDown()
+    {
+        addresses_.clear();
+    }
+
+    void testSize()
+    {
+        CPPUNIT_ASSERT(sizeof(InetAddressValue) == 24);
+    }
+
+    void testUnspecified()
+    {
+        InetAddressValue value;
+        memset(&value, 0, sizeof(value));
+        InetAddress addr;
+
+        CPPUNIT_ASSERT(addr.getValue() == value);
+        CPPUNIT_ASSERT(InetAddress(value) == addr);
+        CPPUNIT_ASSERT(InetAddress(value).isIPv4Compatible() == addr.isIPv4Compatible());
+    }
+
+    void testRoundTrip()
+    {
+        for(size_t i = 0; i < addresses_.size(); ++i)
+        {
+            InetAddressValue value = addresses_[i].getValue();
+            InetAddress addr(value);
+
+            CPPUNIT_ASSERT(addr == addresses_[i]);
+            CPPUNIT_ASSERT(addr.getValue() == value);
+            CPPUNIT_ASSERT(addr.getAddressFamily() == addresses_[i].getAddressFamily());
+            CPPUNIT_ASSERT(addr.isIPv4Compatible() == addresses_[i].isIPv4Compatible());
+            CPPUNIT_ASSERT(addr.toString() == addresses_[i].toString());
+            CPPUNIT_ASSERT(value.isIPv4Compatible() == addresses_[i].isIPv4Compatible());
+        }
+    }
+
+    void testTryParse()
+    {
+        for(size_t i = 0; i < addresses_.size(); ++i)
+        {
+            std::string text = addresses_[i].getHostAddress();
+            InetAddressValue value;
+            CPPUNIT_ASSERT(InetAddress::tryParse(text.data(), text.size(), value));
+            CPPUNIT_ASSERT(value == addresses_[i].getValue());
+        }
+
+        InetAddressValue value = addresses_[0].getValue();
+        CPPUNIT_ASSERT(!InetAddress::tryParse("10.0.0.256", 10, value));
+        CPPUNIT_ASSERT(!InetAddress::tryParse("", 0, value));
+        CPPUNIT_ASSERT(value == addresses_[0].getValue());
+    }
+
+    void testPredicates()
+    {
+        for(size_t i = 0; i < addresses_.size(); ++i)
+        {
+            InetAddress& addr = addresses_[i];
+            const InetAddressValue& value = addr.getValue();
+
+            CPPUNIT_ASSERT(value.isAnyLocalAddress() == addr.isAnyLocalAddress());
+            CPPUNIT_ASSERT(value.isLoopbackAddress() == addr.isLoopbackAddress());
+            CPPUNIT_ASSERT(value.isMulticastAddress() == addr.isMulticastAddress());
+            CPPUNIT_ASSERT(value.isLinkLocalAddress() == addr.isLinkLocalAddress());
+            CPPUNIT_ASSERT(value.isSiteLocalAddress() == addr.isSiteLocalAddress());
+            CPPUNIT_ASSERT(value.isMulticastGlobal() == addr.isMulticastGlobal());
+            CPPUNIT_ASSERT(value.isMulticastNodeLocal() == addr.isMulticastNodeLocal());
+            CPPUNIT_ASSERT(value.isMulticastLinkLocal() == addr.isMulticastLinkLocal());
+            CPPUNIT_ASSERT(value.isMulticastSiteLocal() == addr.isMulticastSiteLocal());
+            CPPUNIT_ASSERT(value.isMulticastOrgLocal() == addr.isMulticastOrgLocal());
+        }
+
+        CPPUNIT_ASSERT(InetAddress("127.0.0.1").getValue().isLoopbackAddress());
+        CPPUNIT_ASSERT(InetAddress("239.192.0.1").getValue().isMulticastOrgLocal());
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(InetAddress("ff0e::1").getValue().isMulticastGlobal());
+        CPPUNIT_ASSERT(InetAddress("fe80::1").getValue().isLinkLocalAddress());
+#endif
+    }
+
+    void testClassify()
+    {
+        std::vector<InetAddressValue> values = makeValues(5000);
+        for(size_t i = 0; i < addresses_.size(); ++i)
+        {
+            values.push_back(addresses_[i].getValue());
+        }
+
+        for(size_t i = 0; i < values.size(); ++i)
+        {
+            const InetAddressValue& value = values[i];
+            uint32_t flags = value.classify();
+            CPPUNIT_ASSERT(((flags & InetAddressValue::CLASS_IPV4) != 0) == value.isIPv4());
+            CPPUNIT_ASSERT(((flags & InetAddressValue::CLASS_IPV6) != 0) == value.isIPv6());
+            CPPUNIT_ASSERT(((flags & InetAddressValue::CLASS_ANY_LOCAL) != 0) == value.isAnyLocalAddress());
+            CPPUNIT_ASSERT(((flags & InetAddressValue::CLASS_LOOPBACK) != 0) == value.isLoopbackAddress());
+            CPPUNIT_ASSERT(((flags & InetAddressValue::CLASS_LINK_LOCAL) != 0) == value.isLinkLocalAddress());
+            CPPUNIT_ASSERT(((flags & InetAddressValue::CLASS_SITE_LOCAL) != 0) == value.isSiteLocalAddress());
+            CPPUNIT_ASSERT(((flags & InetAddressValue::CLASS_MULTICAST) != 0) == value.isMulticastAddress());
+            CPPUNIT_ASSERT(((flags & InetAddressValue::CLASS_MULTICAST_GLOBAL) != 0) == value.isMulticastGlobal());
+            CPPUNIT_ASSERT(((flags & InetAddressValue::CLASS_MULTICAST_NODE_LOCAL) != 0) ==
+                    value.isMulticastNodeLocal());
+            CPPUNIT_ASSERT(((flags & InetAddressValue::CLASS_MULTICAST_LINK_LOCAL) != 0) ==
+                    value.isMulticastLinkLocal());
+            CPPUNIT_ASSERT(((flags & InetAddressValue::CLASS_MULTICAST_SITE_LOCAL) != 0) ==
+                    value.isMulticastSiteLocal());
+            CPPUNIT_ASSERT(((flags & InetAddressValue::CLASS_MULTICAST_ORG_LOCAL) != 0) ==
+                    value.isMulticastOrgLocal());
+            if(value.family != 0)
+            {
+                CPPUNIT_ASSERT(((flags & InetAddressValue::CLASS_IPV4_COMPATIBLE) != 0) ==
+                        value.isIPv4Compatible());
+            }
+            else
+            {
+                CPPUNIT_ASSERT(flags == 0);
+            }
+        }
+
+        CPPUNIT_ASSERT(InetAddress("127.0.0.1").classify() ==
+                (InetAddressValue::CLASS_IPV4 | InetAddressValue::CLASS_IPV4_COMPATIBLE |
+                 InetAddressValue::CLASS_LOOPBACK));
+    }
+
+    void testClassifyBatch()
+    {
+        std::vector<InetAddressValue> values = makeValues(1000);
+        for(size_t count = 0; count < 40; ++count)
+        {
+            std::vector<uint32_t> out(count + 1, 0xdeadbeefU);
+            InetAddressValue::classifyBatch(&values[count], count, &out[0]);
+            for(size_t i = 0; i < count; ++i)
+            {
+                CPPUNIT_ASSERT(out[i] == values[count + i].classify());
+            }
+            CPPUNIT_ASSERT(out[count] == 0xdeadbeefU);
+        }
+
+        std::vector<uint32_t> out(values.size());
+        InetAddressValue::classifyBatch(&values[0], values.size(), &out[0]);
+        for(size_t i = 0; i < values.size(); ++i)
+        {
+            CPPUNIT_ASSERT(out[i] == values[i].classify());
+        }
+    }
+
+    void testMemcpy()
+    {
+        std::vector<InetAddressValue> values(addresses_.size());
+        for(size_t i = 0; i < addresses_.size(); ++i)
+        {
+            values[i] = addresses_[i].getValue();
+        }
+
+        std::vector<InetAddressValue> copy(values.size());
+        memcpy(&copy[0], &values[0], values.size() * sizeof(InetAddressValue));
+        for(size_t i = 0; i < copy.size(); ++i)
+        {
+            CPPUNIT_ASSERT(InetAddress(copy[i]) == addresses_[i]);
+        }
+    }
+
+    void testEquality()
+    {
+        CPPUNIT_ASSERT(InetAddress("10.1.0.1").getValue() == InetAddress("10.1.0.1").getValue());
+        CPPUNIT_ASSERT(InetAddress("10.1.0.1").getValue() != InetAddress("10.1.0.2").getValue());
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(InetAddress("fe80::1", 1).getValue() != InetAddress("fe80::1", 2).getValue());
+        CPPUNIT_ASSERT(InetAddress("::10.1.0.1").getValue() != InetAddress("10.1.0.1").getValue());
+#endif
+    }
+
+    void testCanonical()
+    {
+        InetAddress ipv4("10.1.0.1");
+        CPPUNIT_ASSERT(!ipv4.isIPv4Mapped());
+        CPPUNIT_ASSERT(ipv4.canonical() == ipv4);
+#ifdef HAVE_IPV6_SUPPORT
+        InetAddress mapped("::ffff:10.1.0.1");
+        CPPUNIT_ASSERT(mapped.isIPv4Mapped());
+        CPPUNIT_ASSERT(mapped != ipv4);
+        CPPUNIT_ASSERT(mapped.canonical() == ipv4);
+        CPPUNIT_ASSERT(mapped.canonical().getAddressFamily() == frog::net::AddressFamily::InterNetwork);
+        CPPUNIT_ASSERT(mapped.canonical().isIPv4Compatible());
+        CPPUNIT_ASSERT(mapped.canonical().toString() == "10.1.0.1");
+        CPPUNIT_ASSERT(InetAddress("::ffff:10.1.0.1", 3).canonical() == ipv4);
+
+        // Only ::ffff:0:0/96 is folded.
+        const char* other[] = { "::10.1.0.1", "::1:ffff:10.1.0.1", "::fffe:10.1.0.1", "64:ff9b::10.1.0.1", "::" };
+        for(size_t i = 0; i < sizeof(other) / sizeof(other[0]); ++i)
+        {
+            InetAddress addr(other[i]);
+            CPPUNIT_ASSERT(!addr.isIPv4Mapped());
+            CPPUNIT_ASSERT(addr.canonical() == addr);
+        }
+
+        frog::net::InetAddressCanonicalHash hash;
+        frog::net::InetAddressCanonicalEqual equal;
+        CPPUNIT_ASSERT(hash(mapped) == hash(ipv4));
+        CPPUNIT_ASSERT(equal(mapped, ipv4));
+        CPPUNIT_ASSERT(!equal(mapped, InetAddress("10.1.0.2")));
+        CPPUNIT_ASSERT(!equal(InetAddress("::10.1.0.1"), ipv4));
+
+        frog::net::InetAddressValueCanonicalHash valueHash;
+        frog::net::InetAddressValueCanonicalEqual valueEqual;
+        CPPUNIT_ASSERT(valueHash(mapped.getValue()) == valueHash(ipv4.getValue()));
+        CPPUNIT_ASSERT(valueEqual(mapped.getValue(), ipv4.getValue()));
+#endif
+
+        // Equality looks at every word: address, scope and family.
+        InetAddressValue a = ipv4.getValue();
+        InetAddressValue b = a;
+        b.scope = 1;
+        CPPUNIT_ASSERT(a != b);
+        b = a;
+        b.family = frog::net::AddressFamily::Unspecified;
+        CPPUNIT_ASSERT(a != b);
+        b = a;
+        b.address[0] = 1;
+        CPPUNIT_ASSERT(a != b);
+        b.address[0] = 0;
+        CPPUNIT_ASSERT(a == b);
+    }
+
+    void testOrdering()
+    {
+        for(size_t i = 0; i < addresses_.size(); ++i)
+        {
+            const InetAddressValue& a = addresses_[i].getValue();
+            CPPUNIT_ASSERT(a.compare(a) == 0);
+            for(size_t j = 0; j < addresses_.size(); ++j)
+            {
+                const InetAddressValue& b = addresses_[j].getValue();
+                int result = a.compare(b);
+                CPPUNIT_ASSERT(result == -b.compare(a));
+                CPPUNIT_ASSERT((result == 0) == (a == b));
+                CPPUNIT_ASSERT((a < b) == (b > a));
+                CPPUNIT_ASSERT((a <= b) == !(a > b));
+                CPPUNIT_ASSERT((a >= b) == !(a < b));
+            }
+        }
+
+        CPPUNIT_ASSERT(InetAddress("10.1.0.1").getValue() < InetAddress("10.1.0.2").getValue());
+        CPPUNIT_ASSERT(InetAddress("9.255.255.255").getValue() < InetAddress("10.0.0.0").getValue());
+        CPPUNIT_ASSERT(InetAddress("127.255.255.255").getValue() < InetAddress("128.0.0.0").getValue());
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(InetAddress("255.255.255.255").getValue() < InetAddress("::").getValue());
+        CPPUNIT_ASSERT(InetAddress("::ffff:ffff:ffff:ffff").getValue() < InetAddress("0:0:0:1::").getValue());
+        CPPUNIT_ASSERT(InetAddress("7fff::").getValue() < InetAddress("8000::").getValue());
+        CPPUNIT_ASSERT(InetAddress("fe80::1", 1).getValue() < InetAddress("fe80::1", 2).getValue());
+        CPPUNIT_ASSERT(InetAddress("fe80::1", 9).getValue() < InetAddress("fe80::2", 1).getValue());
+#endif
+    }
+
+    void testSortKey()
+    {
+        std::vector<InetAddressValue> values;
+        for(size_t i = 0; i < addresses_.size(); ++i)
+        {
+            values.push_back(addresses_[i].getValue());
+        }
+        std::sort(values.begin(), values.end());
+
+        uint8_t key[InetAddressValue::SORT_KEY_SIZE], next[InetAddressValue::SORT_KEY_SIZE];
+        for(size_t i = 1; i < values.size(); ++i)
+        {
+            CPPUNIT_ASSERT(values[i - 1] < values[i]);
+            values[i - 1].sortKey(key);
+            values[i].sortKey(next);
+            CPPUNIT_ASSERT(memcmp(key, next, sizeof(key)) < 0);
+        }
+
+        InetAddressValue a = InetAddress("10.1.0.1").getValue();
+        InetAddressValue b = a;
+        a.scope = 0x1000000U;
+        b.scope = 0xFFFFFFFFU;
+        a.sortKey(key);
+        b.sortKey(next);
+        CPPUNIT_ASSERT(memcmp(key, next, sizeof(key)) == 0);
+    }
+
+  private:
+    /**
+     * Makes values whose bytes are picked from the ones the predicates
+     * look for, so that every flag is hit.
+     */
+    std::vector<InetAddressValue> makeValues(size_t count)
+    {
+        const uint8_t bytes[] = { 0, 0, 0, 1, 2, 5, 8, 10, 14, 16, 127, 168, 169, 172, 192,
+            195, 196, 224, 238, 239, 240, 254, 255, 0x80, 0xc0, 0xfe, 0xff, 0x0e, 0x12, 0x15 };
+        std::vector<InetAddressValue> values(count);
+        srand(3);
+        for(size_t i = 0; i < count; ++i)
+        {
+            InetAddressValue& value = values[i];
+            memset(&value, 0, sizeof(value));
+            int kind = rand() % 4;
+            if(kind == 0)
+            {
+                continue;
+            }
+            value.family = static_cast<frog::net::AddressFamily::TYPE>((kind == 1) ? AF_INET : AF_INET6);
+            size_t first = (kind == 1) ? InetAddressValue::IPV4_OFFSET : ((rand() % 3 == 0) ? 12 : 0);
+            for(size_t j = first; j < sizeof(value.address); ++j)
+            {
+                value.address[j] = bytes[rand() % sizeof(bytes)];
+            }
+        }
+        return values;
+    }
+
+    std::vector<InetAddress> addresses_;
+};
@@ -0,0 +1,407 @@
+// C++ test file ---------------------------------------------------------//
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@gmail.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License as
+//   published by the Free Software Foundation; either version 2 of the
+//   License, or (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+//   This file is part of the Frog Framework.
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/Inet4Address.h>
+#include <frog/Ipv4Set.h>
+#include <frog/Subnet.h>
+#include <frog/IllegalArgumentException.h>
+#include <frog/FormatException.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::Inet4Address;
+using frog::net::Ipv4Set;
+using frog::net::Subnet;
+using frog::sys::IllegalArgumentException;
+using frog::sys::FormatException;
+
+class Ipv4SetTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(Ipv4SetTest);
+
+    CPPUNIT_TEST(testAdd);
+#ifdef HAVE_IPV6_SUPPORT
+    CPPUNIT_TEST_EXCEPTION(testAddIPv6, IllegalArgumentException);
+#endif
+    CPPUNIT_TEST(testRemove);
+    CPPUNIT_TEST(testContainers);
+    CPPUNIT_TEST(testRanges);
+    CPPUNIT_TEST(testSetOperations);
+    CPPUNIT_TEST(testUnionOf);
+    CPPUNIT_TEST(testSelect);
+    CPPUNIT_TEST(testSerialize);
+    CPPUNIT_TEST(testSerializeFormat);
+    CPPUNIT_TEST_EXCEPTION(testDeserializeTruncated, FormatException);
+    CPPUNIT_TEST_EXCEPTION(testDeserializeCookie, FormatException);
+    CPPUNIT_TEST(testToString);
+
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void setUp()
+    {
+    }
+
+    void tearDown()
+    {
+    }
+
+    void testAdd()
+    {
+        Ipv4Set set;
+        CPPUNIT_ASSERT(set.isEmpty());
+        CPPUNIT_ASSERT(set.add(InetAddress("10.0.0.1")));
+        CPPUNIT_ASSERT(!set.add(InetAddress("10.0.0.1")));
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(set.add(InetAddress("::ffff:10.0.0.2")));
+#else
+        CPPUNIT_ASSERT(set.add(InetAddress("10.0.0.2")));
+#endif
+        CPPUNIT_ASSERT(set.add(Inet4Address("192.168.1.1")));
+        CPPUNIT_ASSERT(set.add(0xffffffffU));
+        CPPUNIT_ASSERT(set.getCardinality() == 4);
+
+        CPPUNIT_ASSERT(set.contains(InetAddress("10.0.0.1")));
+        CPPUNIT_ASSERT(set.contains(InetAddress("10.0.0.2")));
+        CPPUNIT_ASSERT(set.contains(Inet4Address("255.255.255.255")));
+        CPPUNIT_ASSERT(!set.contains(InetAddress("10.0.0.3")));
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(set.contains(InetAddress("::ffff:10.0.0.1")));
+        CPPUNIT_ASSERT(!set.contains(InetAddress("::10.0.0.1")));
+        CPPUNIT_ASSERT(!set.contains(InetAddress("2001:db8::1")));
+#endif
+
+        std::vector<InetAddress> addresses = set.getAddresses();
+        CPPUNIT_ASSERT(addresses.size() == 4);
+        CPPUNIT_ASSERT(addresses[0] == InetAddress("10.0.0.1"));
+        CPPUNIT_ASSERT(addresses[3] == InetAddress("255.255.255.255"));
+
+        Ipv4Set copy(set);
+        CPPUNIT_ASSERT(copy == set);
+        copy.clear();
+        CPPUNIT_ASSERT(copy.isEmpty());
+        CPPUNIT_ASSERT(copy != set);
+        copy = set;
+        CPPUNIT_ASSERT(copy == set);
+    }
+
+#ifdef HAVE_IPV6_SUPPORT
+    void testAddIPv6()
+    {
+        Ipv4Set set;
+        set.add(InetAddress("2001:db8::1"));
+    }
+#endif
+
+    void testRemove()
+    {
+        Ipv4Set set;
+        set.add(InetAddress("10.0.0.1"));
+        set.add(InetAddress("10.0.0.2"));
+        CPPUNIT_ASSERT(set.remove(InetAddress("10.0.0.1")));
+        CPPUNIT_ASSERT(!set.remove(InetAddress("10.0.0.1")));
+        CPPUNIT_ASSERT(!set.contains(InetAddress("10.0.0.1")));
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(!set.remove(InetAddress("2001:db8::1")));
+        CPPUNIT_ASSERT(set.remove(InetAddress("::ffff:10.0.0.2")));
+#else
+        CPPUNIT_ASSERT(set.remove(InetAddress("10.0.0.2")));
+#endif
+        CPPUNIT_ASSERT(set.isEmpty());
+    }
+
+    void testContainers()
+    {
+        // One container grows from an array into a bitmap and back.
+        Ipv4Set set;
+        std::set<uint32_t> expected;
+        uint32_t x = 1;
+        for(size_t i = 0; i < 20000; ++i)
+        {
+            x = x * 1103515245U + 12345U;
+            uint32_t address = 0x0a000000U | (x >> 16);
+            CPPUNIT_ASSERT(set.add(address) == expected.insert(address).second);
+        }
+        CPPUNIT_ASSERT(set.getCardinality() == expected.size());
+        check(set, expected);
+
+        size_t bitmapMemory = set.getMemoryUsage();
+        for(std::set<uint32_t>::iterator i = expected.begin(); expected.size() > 1000; )
+        {
+            CPPUNIT_ASSERT(set.remove(*i));
+            expected.erase(i++);
+        }
+        check(set, expected);
+        set.optimize();
+        CPPUNIT_ASSERT(set.getMemoryUsage() < bitmapMemory);
+        check(set, expected);
+    }
+
+    void testRanges()
+    {
+        Ipv4Set set;
+        set.add(Subnet("10.0.0.0/8"));
+        CPPUNIT_ASSERT(set.getCardinality() == 16777216U);
+        CPPUNIT_ASSERT(set.contains(InetAddress("10.255.255.255")));
+        CPPUNIT_ASSERT(!set.contains(InetAddress("11.0.0.0")));
+        CPPUNIT_ASSERT(set.getMemoryUsage() < 64 * 1024);
+
+        // A range over part of an array container.
+        set.add(InetAddress("192.168.0.1"));
+        set.add(InetAddress("192.168.0.200"));
+        set.add(0xc0a80010U, 0xc0a80020U);
+        CPPUNIT_ASSERT(set.getCardinality() == 16777216U + 2 + 17);
+        CPPUNIT_ASSERT(set.contains(InetAddress("192.168.0.16")));
+        CPPUNIT_ASSERT(set.contains(InetAddress("192.168.0.32")));
+        CPPUNIT_ASSERT(!set.contains(InetAddress("192.168.0.33")));
+
+        // Adding to and removing from runs.
+        CPPUNIT_ASSERT(!set.add(InetAddress("10.1.2.3")));
+        CPPUNIT_ASSERT(set.remove(InetAddress("10.1.2.3")));
+        CPPUNIT_ASSERT(!set.contains(InetAddress("10.1.2.3")));
+        CPPUNIT_ASSERT(set.add(InetAddress("10.1.2.3")));
+        set.optimize();
+        CPPUNIT_ASSERT(set.getCardinality() == 16777216U + 2 + 17);
+        CPPUNIT_ASSERT(set.getMemoryUsage() < 64 * 1024);
+
+        Ipv4Set all;
+        all.add(0, 0xffffffffU);
+        CPPUNIT_ASSERT(all.getCardinality() == 0x100000000ULL);
+        CPPUNIT_ASSERT(all.setIntersection(set) == set);
+        CPPUNIT_ASSERT(all.setDifference(set).getCardinality() == 0x100000000ULL - set.getCardinality());
+        CPPUNIT_ASSERT(all.intersectionCardinality(set) == set.getCardinality());
+    }
+
+    void testSetOperations()
+    {
+        // Sets with containers of every form, and containers on only one
+        // side.
+        for(uint32_t seed = 1; seed <= 3; ++seed)
+        {
+            std::set<uint32_t> a, b;
+            Ipv4Set setA = randomSet(seed, a), setB = randomSet(seed + 100, b);
+
+            std::set<uint32_t> expected;
+            std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+            check(setA.setUnion(setB), expected);
+
+            expected.clear();
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+            CPPUNIT_ASSERT(!expected.empty());
+            check(setA.setIntersection(setB), expected);
+            CPPUNIT_ASSERT(setA.intersectionCardinality(setB) == expected.size());
+
+            expected.clear();
+            std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+            check(setA.setDifference(setB), expected);
+
+            expected.clear();
+            std::set_difference(b.begin(), b.end(), a.begin(), a.end(), std::inserter(expected, expected.end()));
+            check(setB.setDifference(setA), expected);
+        }
+    }
+
+    void testUnionOf()
+    {
+        std::vector<Ipv4Set> sets(6);
+        std::vector<const Ipv4Set*> pointers;
+        std::set<uint32_t> expected;
+        Ipv4Set chained;
+        for(size_t i = 0; i < sets.size(); ++i)
+        {
+            std::set<uint32_t> values;
+            sets[i] = randomSet(static_cast<uint32_t>(i + 10), values);
+            expected.insert(values.begin(), values.end());
+            pointers.push_back(&sets[i]);
+            chained = chained.setUnion(sets[i]);
+        }
+        Ipv4Set all = Ipv4Set::unionOf(&pointers[0], pointers.size());
+        check(all, expected);
+        CPPUNIT_ASSERT(all == chained);
+        CPPUNIT_ASSERT(Ipv4Set::unionOf(&pointers[0], 1) == sets[0]);
+        CPPUNIT_ASSERT(Ipv4Set::unionOf(NULL, 0).isEmpty());
+    }
+
+    void testSelect()
+    {
+        Ipv4Set set;
+        const char* addresses[] = { "0.0.0.0", "0.0.0.1", "10.1.2.3", "127.0.0.1", "169.254.1.1",
+            "172.16.5.5", "192.168.1.1", "224.0.0.1", "224.0.1.1", "239.255.0.1", "8.8.8.8" };
+        for(size_t i = 0; i < sizeof(addresses) / sizeof(addresses[0]); ++i)
+        {
+            set.add(InetAddress(addresses[i]));
+        }
+
+        Ipv4Set selected = set.select(InetAddressValue::CLASS_SITE_LOCAL);
+        CPPUNIT_ASSERT(selected.toString() == "{10.1.2.3, 172.16.5.5, 192.168.1.1}");
+        selected = set.select(InetAddressValue::CLASS_ANY_LOCAL | InetAddressValue::CLASS_LOOPBACK);
+        CPPUNIT_ASSERT(selected.toString() == "{0.0.0.0, 127.0.0.1}");
+        selected = set.select(InetAddressValue::CLASS_MULTICAST_LINK_LOCAL);
+        CPPUNIT_ASSERT(selected.toString() == "{224.0.0.1}");
+        selected = set.select(InetAddressValue::CLASS_MULTICAST_GLOBAL);
+        CPPUNIT_ASSERT(selected.toString() == "{224.0.1.1}");
+
+        // Each selection agrees with the InetAddress predicates.
+        std::vector<InetAddress> all = set.getAddresses();
+        Ipv4Set multicast = set.select(InetAddressValue::CLASS_MULTICAST);
+        Ipv4Set linkLocal = set.select(InetAddressValue::CLASS_LINK_LOCAL);
+        for(size_t i = 0; i < all.size(); ++i)
+        {
+            CPPUNIT_ASSERT(multicast.contains(all[i]) == all[i].isMulticastAddress());
+            CPPUNIT_ASSERT(linkLocal.contains(all[i]) == all[i].isLinkLocalAddress());
+        }
+    }
+
+    void testSerialize()
+    {
+        std::set<uint32_t> values;
+        Ipv4Set set = randomSet(7, values);
+        std::vector<uint8_t> bytes;
+        set.serialize(bytes);
+        CPPUNIT_ASSERT(bytes.size() == set.getSerializedSize());
+        Ipv4Set copy = Ipv4Set::deserialize(bytes);
+        CPPUNIT_ASSERT(copy == set);
+        check(copy, values);
+
+        // Without runs.
+        Ipv4Set plain;
+        plain.add(InetAddress("10.0.0.1"));
+        plain.add(InetAddress("10.1.0.1"));
+        plain.serialize(bytes);
+        CPPUNIT_ASSERT(Ipv4Set::deserialize(bytes) == plain);
+
+        Ipv4Set empty;
+        empty.serialize(bytes);
+        CPPUNIT_ASSERT(bytes.size() == 8);
+        CPPUNIT_ASSERT(Ipv4Set::deserialize(bytes).isEmpty());
+    }
+
+    void testSerializeFormat()
+    {
+        // {1, 2, 3} in the portable format: cookie, one container, its
+        // key and cardinality less one, its offset and its values.
+        Ipv4Set set;
+        set.add(1U);
+        set.add(2U);
+        set.add(3U);
+        const uint8_t expected[] = { 0x3a, 0x30, 0, 0, 1, 0, 0, 0, 0, 0, 2, 0, 16, 0, 0, 0, 1, 0, 2, 0, 3, 0 };
+        std::vector<uint8_t> bytes;
+        set.serialize(bytes);
+        CPPUNIT_ASSERT(bytes == std::vector<uint8_t>(expected, expected + sizeof(expected)));
+
+        // A run of 0.1.0.0 to 0.1.0.99: cookie and size, run flags, key
+        // and cardinality less one, then the number of runs and the run.
+        Ipv4Set runs;
+        runs.add(0x10000U, 0x10063U);
+        const uint8_t expectedRuns[] = { 0x3b, 0x30, 0, 0, 1, 1, 0, 99, 0, 1, 0, 0, 0, 99, 0 };
+        runs.serialize(bytes);
+        CPPUNIT_ASSERT(bytes == std::vector<uint8_t>(expectedRuns, expectedRuns + sizeof(expectedRuns)));
+        CPPUNIT_ASSERT(Ipv4Set::deserialize(bytes) == runs);
+    }
+
+    void testDeserializeTruncated()
+    {
+        std::set<uint32_t> values;
+        std::vector<uint8_t> bytes;
+        randomSet(8, values).serialize(bytes);
+        bytes.pop_back();
+        Ipv4Set::deserialize(bytes);
+    }
+
+    void testDeserializeCookie()
+    {
+        const uint8_t bytes[] = { 1, 2, 3, 4, 0, 0, 0, 0 };
+        Ipv4Set::deserialize(bytes, sizeof(bytes));
+    }
+
+    void testToString()
+    {
+        Ipv4Set set;
+        CPPUNIT_ASSERT(set.toString() == "{}");
+        set.add(InetAddress("10.0.0.1"));
+        set.add(0x0a000005U, 0x0a000009U);
+        set.add(InetAddress("10.0.0.10"));
+        CPPUNIT_ASSERT(set.toString() == "{10.0.0.1, 10.0.0.5-10.0.0.10}");
+    }
+
+  private:
+    // Checks that a set holds exactly the expected addresses.
+    static void check(const Ipv4Set& set, const std::set<uint32_t>& expected)
+    {
+        CPPUNIT_ASSERT(set.getCardinality() == expected.size());
+        std::vector<uint32_t> values(expected.size());
+        if(!values.empty())
+        {
+            CPPUNIT_ASSERT(set.toArray(&values[0]) == expected.size());
+        }
+        CPPUNIT_ASSERT(std::equal(values.begin(), values.end(), expected.begin()));
+    }
+
+    // Returns a set with sparse containers, dense containers and ranges,
+    // and the same addresses in values.
+    static Ipv4Set randomSet(uint32_t seed, std::set<uint32_t>& values)
+    {
+        Ipv4Set set;
+        uint32_t x = seed * 2654435761U;
+        for(size_t i = 0; i < 30000; ++i)
+        {
+            x = x * 1103515245U + 12345U;
+            uint32_t r = x >> 8;
+            uint32_t address;
+            switch(i % 3)
+            {
+                case 0:
+                    address = 0x0a000000U | (r & 0x3ffff);
+                    break;
+                case 1:
+                    address = 0xc0a80000U | (r & 0x1fff);
+                    break;
+                default:
+                    address = x;
+                    break;
+            }
+            set.add(address);
+            values.insert(address);
+        }
+        for(uint32_t i = 0; i < 4; ++i)
+        {
+            uint32_t first = 0xac100000U + ((seed * 7 + i * 13) % 16) * 0x8000U;
+            uint32_t last = first + 0x12345U * (i + 1) % 0x30000U;
+            set.add(first, last);
+            for(uint32_t a = first; a <= last; ++a)
+            {
+                values.insert(a);
+            }
+        }
+        return set;
+    }
+};
@@ -19,9 +19,14 @@
 //   This file is part of the Frog Framework.
 //------------------------------------------------------------------------//
 
+#include <algorithm>
 #include <iostream>
 #include <cstdio>
 #include <vector>
+#if __cplusplus >= 201103L
+#include <type_traits>
+#include <utility>
+#endif
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <frog/NetworkInterface.h>
@@ -48,6 +53,11 @@ class NetworkInterfaceTest : public CppUnit::TestFixture
     CPPUNIT_TEST(testInequality2);
     CPPUNIT_TEST(displayOneAndOther);
     CPPUNIT_TEST(displayAll);
+    CPPUNIT_TEST(testCopy);
+#if __cplusplus >= 201103L
+    CPPUNIT_TEST(testMove);
+#endif
+    CPPUNIT_TEST(testAllMatchByName);
 
     CPPUNIT_TEST_SUITE_END();
   public:
@@ -95,7 +105,7 @@ class NetworkInterfaceTest : public CppUnit::TestFixture
         NetworkInterface ni = NetworkInterface::getByName("lo");
         int_addr = ni.getInterfaceAddresses();
         cout << endl;
-        cout << ni.name;
+        cout << ni.getName();
         for(int_addr_iter = int_addr.begin(); int_addr_iter != int_addr.end(); ++int_addr_iter)
         {
             cout << "	inet addr: " << int_addr_iter->unicast.getHostAddress();
@@ -107,7 +117,7 @@ class NetworkInterfaceTest : public CppUnit::TestFixture
         NetworkInterface ni2 = NetworkInterface::getByName("eth0");
         int_addr = ni2.getInterfaceAddresses();
         cout << endl;
-        cout << ni2.name;
+        cout << ni2.getName();
         for(int_addr_iter = int_addr.begin(); int_addr_iter != int_addr.end(); ++int_addr_iter)
         {
             cout << "	inet addr: " << int_addr_iter->unicast.getHostAddress();
@@ -134,7 +144,7 @@ class NetworkInterfaceTest : public CppUnit::TestFixture
         {
             ++count;
             int_addr = if_iter->getInterfaceAddresses();
-            cout << if_iter->name;
+            cout << if_iter->getName();
             for(int_addr_iter = int_addr.begin(); int_addr_iter != int_addr.end(); ++int_addr_iter)
             {
                 cout << "	inet addr: " << int_addr_iter->unicast.getHostAddress();
@@ -149,5 +159,75 @@ class NetworkInterfaceTest : public CppUnit::TestFixture
         CPPUNIT_ASSERT(nis.size() > 0);
     }
 
+    void testCopy()
+    {
+        vector<NetworkInterface> nis = NetworkInterface::getNetworkInterfaces();
+        CPPUNIT_ASSERT(nis.size() > 0);
+
+        // The copy keeps its name after the original is gone.
+        NetworkInterface* original = new NetworkInterface(nis[0]);
+        NetworkInterface copy = *original;
+        delete original;
+
+        CPPUNIT_ASSERT(copy == nis[0]);
+        CPPUNIT_ASSERT(copy.getName() == nis[0].getName());
+        CPPUNIT_ASSERT(copy.getDisplayName() == nis[0].getDisplayName());
+
+        // The address list is handed out, not copied.
+        CPPUNIT_ASSERT(&copy.getInterfaceAddresses() == &copy.getInterfaceAddresses());
+        CPPUNIT_ASSERT(copy.getInterfaceAddresses() == nis[0].getInterfaceAddresses());
+    }
+
+#if __cplusplus >= 201103L
+    void testMove()
+    {
+        static_assert(std::is_nothrow_move_constructible<NetworkInterface>::value,
+                "NetworkInterface must be nothrow movable");
+        static_assert(std::is_nothrow_move_assignable<NetworkInterface>::value,
+                "NetworkInterface must be nothrow movable");
+
+        vector<NetworkInterface> nis = NetworkInterface::getNetworkInterfaces();
+        CPPUNIT_ASSERT(nis.size() > 0);
+
+        // The moved-to interface takes over the address list buffer.
+        NetworkInterface original(nis[0]);
+        const NetworkInterface::InterfaceAddress* addrs = original.getInterfaceAddresses().data();
+        NetworkInterface moved(std::move(original));
+
+        CPPUNIT_ASSERT(moved == nis[0]);
+        CPPUNIT_ASSERT(moved.getName() == nis[0].getName());
+        CPPUNIT_ASSERT(moved.getInterfaceAddresses() == nis[0].getInterfaceAddresses());
+        CPPUNIT_ASSERT(moved.getInterfaceAddresses().data() == addrs);
+
+        NetworkInterface assigned = nis[nis.size() - 1];
+        assigned = std::move(moved);
+        CPPUNIT_ASSERT(assigned == nis[0]);
+        CPPUNIT_ASSERT(assigned.getInterfaceAddresses().data() == addrs);
+    }
+#endif
+
+    void testAllMatchByName()
+    {
+        // getNetworkInterfaces() reads netlink on Linux, getByName()
+        // reads ::getifaddrs(): both must see the same interfaces.
+        vector<NetworkInterface> nis = NetworkInterface::getNetworkInterfaces();
+        CPPUNIT_ASSERT(nis.size() > 0);
+
+        for(size_t i = 0; i < nis.size(); ++i)
+        {
+            NetworkInterface ni = NetworkInterface::getByName(nis[i].getName());
+            CPPUNIT_ASSERT(ni.getName() == nis[i].getName());
+
+            // ::getifaddrs() names the addresses of an alias after the
+            // alias ("eth0:1"), so getByName() may see fewer of them.
+            const NetworkInterface::InterfaceAddrList& expected = ni.getInterfaceAddresses();
+            const NetworkInterface::InterfaceAddrList& actual = nis[i].getInterfaceAddresses();
+            CPPUNIT_ASSERT(expected.size() > 0);
+            for(size_t k = 0; k < expected.size(); ++k)
+            {
+                CPPUNIT_ASSERT(std::find(actual.begin(), actual.end(), expected[k]) != actual.end());
+            }
+        }
+    }
 
 };
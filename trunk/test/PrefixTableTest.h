@@ -0,0 +1,250 @@
+// C++ test file ---------------------------------------------------------//
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@gmail.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License as
+//   published by the Free Software Foundation; either version 2 of the
+//   License, or (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+//   This file is part of the Frog Framework.
+
+#include <sys/types.h>
+#include <arpa/inet.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/Subnet.h>
+#include <frog/PrefixTable.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::Subnet;
+using frog::net::PrefixTable;
+using frog::net::AtomicPrefixTable;
+
+class PrefixTableTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(PrefixTableTest);
+
+    CPPUNIT_TEST(testEmpty);
+    CPPUNIT_TEST(testLongestMatch4);
+    CPPUNIT_TEST(testDuplicate);
+    CPPUNIT_TEST(testRandom4);
+    CPPUNIT_TEST(testLookupMany);
+    CPPUNIT_TEST(testAtomic);
+#ifdef HAVE_IPV6_SUPPORT
+    CPPUNIT_TEST(testLongestMatch6);
+    CPPUNIT_TEST(testRandom6);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    typedef PrefixTable<int>::Route Route;
+
+    void setUp()
+    {
+    }
+
+    void tearDown()
+    {
+    }
+
+    void testEmpty()
+    {
+        PrefixTable<int> table;
+        CPPUNIT_ASSERT(table.size() == 0);
+        CPPUNIT_ASSERT(table.lookup(InetAddress("10.1.0.1")) == NULL);
+        CPPUNIT_ASSERT(table.lookup(InetAddress()) == NULL);
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(table.lookup(InetAddress("2001:db8::1")) == NULL);
+#endif
+    }
+
+    void testLongestMatch4()
+    {
+        std::vector<Route> routes;
+        routes.push_back(Route(Subnet("10.1.2.128/25"), 4));
+        routes.push_back(Route(Subnet("0.0.0.0/0"), 0));
+        routes.push_back(Route(Subnet("10.1.2.3/32"), 5));
+        routes.push_back(Route(Subnet("10.0.0.0/8"), 1));
+        routes.push_back(Route(Subnet("10.1.0.0/16"), 2));
+        routes.push_back(Route(Subnet("10.1.2.0/24"), 3));
+        PrefixTable<int> table(routes);
+
+        CPPUNIT_ASSERT(table.size() == routes.size());
+        CPPUNIT_ASSERT(*table.lookup(InetAddress("192.168.1.1")) == 0);
+        CPPUNIT_ASSERT(*table.lookup(InetAddress("10.2.0.1")) == 1);
+        CPPUNIT_ASSERT(*table.lookup(InetAddress("10.1.3.1")) == 2);
+        CPPUNIT_ASSERT(*table.lookup(InetAddress("10.1.2.1")) == 3);
+        CPPUNIT_ASSERT(*table.lookup(InetAddress("10.1.2.3")) == 5);
+        CPPUNIT_ASSERT(*table.lookup(InetAddress("10.1.2.4")) == 3);
+        CPPUNIT_ASSERT(*table.lookup(InetAddress("10.1.2.200")) == 4);
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(table.lookup(InetAddress("::10.1.2.3")) == NULL);
+#endif
+    }
+
+    void testDuplicate()
+    {
+        std::vector<Route> routes;
+        routes.push_back(Route(Subnet("10.0.0.0/8"), 1));
+        routes.push_back(Route(Subnet("10.0.0.0/8"), 2));
+        PrefixTable<int> table(routes);
+        CPPUNIT_ASSERT(*table.lookup(InetAddress("10.9.9.9")) == 2);
+    }
+
+    void testRandom4()
+    {
+        std::vector<Route> routes;
+        std::vector<InetAddressValue> probes;
+        makeRandom(AF_INET, 32, 2000, routes, probes);
+        PrefixTable<int> table(routes);
+        checkAgainstScan(table, routes, probes);
+    }
+
+    void testLookupMany()
+    {
+        std::vector<Route> routes;
+        std::vector<InetAddressValue> probes;
+        makeRandom(AF_INET, 32, 500, routes, probes);
+#ifdef HAVE_IPV6_SUPPORT
+        std::vector<Route> routes6;
+        std::vector<InetAddressValue> probes6;
+        makeRandom(AF_INET6, 128, 500, routes6, probes6);
+        routes.insert(routes.end(), routes6.begin(), routes6.end());
+        probes.insert(probes.end(), probes6.begin(), probes6.end());
+#endif
+        PrefixTable<int> table(routes);
+
+        std::vector<const int*> result(probes.size());
+        size_t matches = table.lookupMany(&probes[0], probes.size(), &result[0]);
+        size_t expected = 0;
+        for(size_t i = 0; i < probes.size(); ++i)
+        {
+            CPPUNIT_ASSERT(result[i] == table.lookup(probes[i]));
+            expected += (result[i] != NULL);
+        }
+        CPPUNIT_ASSERT(matches == expected);
+    }
+
+    void testAtomic()
+    {
+        std::vector<Route> routes;
+        routes.push_back(Route(Subnet("10.0.0.0/8"), 1));
+        PrefixTable<int>* first = new PrefixTable<int>(routes);
+        AtomicPrefixTable<int> published(first);
+        CPPUNIT_ASSERT(*published.get()->lookup(InetAddress("10.1.0.1")) == 1);
+
+        routes.push_back(Route(Subnet("10.1.0.0/16"), 2));
+        PrefixTable<int>* old = published.exchange(new PrefixTable<int>(routes));
+        CPPUNIT_ASSERT(old == first);
+        CPPUNIT_ASSERT(*published.get()->lookup(InetAddress("10.1.0.1")) == 2);
+        delete old;
+        delete published.exchange(NULL);
+        CPPUNIT_ASSERT(published.get() == NULL);
+    }
+
+#ifdef HAVE_IPV6_SUPPORT
+    void testLongestMatch6()
+    {
+        std::vector<Route> routes;
+        routes.push_back(Route(Subnet("::/0"), 0));
+        routes.push_back(Route(Subnet("2001:db8::/32"), 1));
+        routes.push_back(Route(Subnet("2001:db8:8000::/33"), 2));
+        routes.push_back(Route(Subnet("2001:db8:8000::1/128"), 3));
+        routes.push_back(Route(Subnet("2001:db8::/127"), 4));
+        PrefixTable<int> table(routes);
+
+        CPPUNIT_ASSERT(*table.lookup(InetAddress("fe80::1")) == 0);
+        CPPUNIT_ASSERT(*table.lookup(InetAddress("2001:db8:7fff::1")) == 1);
+        CPPUNIT_ASSERT(*table.lookup(InetAddress("2001:db8:8000::2")) == 2);
+        CPPUNIT_ASSERT(*table.lookup(InetAddress("2001:db8:8000::1")) == 3);
+        CPPUNIT_ASSERT(*table.lookup(InetAddress("2001:db8::1")) == 4);
+        CPPUNIT_ASSERT(*table.lookup(InetAddress("2001:db8::2")) == 1);
+        CPPUNIT_ASSERT(table.lookup(InetAddress("10.1.0.1")) == NULL);
+    }
+
+    void testRandom6()
+    {
+        std::vector<Route> routes;
+        std::vector<InetAddressValue> probes;
+        makeRandom(AF_INET6, 128, 2000, routes, probes);
+        PrefixTable<int> table(routes);
+        checkAgainstScan(table, routes, probes);
+    }
+#endif
+
+  private:
+    /**
+     * Makes random prefixes that share their first bits, so that they
+     * nest, and probes next to each of them.
+     */
+    void makeRandom(int family, uint32_t maxLength, size_t count,
+            std::vector<Route>& routes, std::vector<InetAddressValue>& probes)
+    {
+        srand(7);
+        for(size_t i = 0; i < count; ++i)
+        {
+            InetAddressValue value;
+            memset(&value, 0, sizeof(value));
+            value.family = static_cast<frog::net::AddressFamily::TYPE>(family);
+            size_t first = (family == AF_INET) ? InetAddressValue::IPV4_OFFSET : 0;
+            value.address[first] = 10;
+            for(size_t j = first + 1; j < sizeof(value.address); ++j)
+            {
+                value.address[j] = static_cast<uint8_t>(rand() & 0x3);
+            }
+            uint32_t prefixLength = static_cast<uint32_t>(rand()) % (maxLength + 1);
+            routes.push_back(Route(Subnet(InetAddress(value), prefixLength), static_cast<int>(i)));
+            probes.push_back(value);
+            value.address[sizeof(value.address) - 1] ^= 0x1;
+            probes.push_back(value);
+        }
+    }
+
+    /**
+     * Checks every probe against a linear scan for the longest prefix.
+     */
+    void checkAgainstScan(const PrefixTable<int>& table, const std::vector<Route>& routes,
+            const std::vector<InetAddressValue>& probes)
+    {
+        for(size_t i = 0; i < probes.size(); ++i)
+        {
+            const Route* best = NULL;
+            for(size_t j = 0; j < routes.size(); ++j)
+            {
+                if(routes[j].first.contains(probes[i]) &&
+                        ((best == NULL) || (routes[j].first.getPrefixLength() >= best->first.getPrefixLength())))
+                {
+                    best = &routes[j];
+                }
+            }
+            const int* found = table.lookup(probes[i]);
+            CPPUNIT_ASSERT((found == NULL) == (best == NULL));
+            if(best != NULL)
+            {
+                CPPUNIT_ASSERT(*found == best->second);
+            }
+        }
+    }
+};
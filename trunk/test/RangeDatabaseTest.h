@@ -0,0 +1,364 @@
+// C++ test file ---------------------------------------------------------//
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@gmail.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License as
+//   published by the Free Software Foundation; either version 2 of the
+//   License, or (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+//   This file is part of the Frog Framework.
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <frog/InetAddress.h>
+#include <frog/Subnet.h>
+#include <frog/RangeDatabase.h>
+#include <frog/RangeDatabaseWriter.h>
+#include <frog/IOException.h>
+#include <frog/IllegalArgumentException.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+using frog::net::InetAddress;
+using frog::net::Subnet;
+using frog::net::RangeDatabase;
+using frog::net::RangeDatabaseWriter;
+using frog::sys::IOException;
+using frog::sys::IllegalArgumentException;
+
+class RangeDatabaseTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(RangeDatabaseTest);
+
+    CPPUNIT_TEST(testEmpty);
+    CPPUNIT_TEST(testLookup);
+    CPPUNIT_TEST(testFields);
+    CPPUNIT_TEST(testRandom);
+    CPPUNIT_TEST(testReopen);
+    CPPUNIT_TEST_EXCEPTION(testOverlap, IllegalArgumentException);
+    CPPUNIT_TEST_EXCEPTION(testValueCount, IllegalArgumentException);
+    CPPUNIT_TEST_EXCEPTION(testMissing, IOException);
+    CPPUNIT_TEST_EXCEPTION(testNotDatabase, IOException);
+    CPPUNIT_TEST_EXCEPTION(testTruncated, IOException);
+    CPPUNIT_TEST_EXCEPTION(testDamaged, IOException);
+    CPPUNIT_TEST_EXCEPTION(testRecordCountOverflow, IOException);
+#ifdef HAVE_IPV6_SUPPORT
+    CPPUNIT_TEST(testIPv6);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void setUp()
+    {
+        std::ostringstream name;
+        name << "/tmp/RangeDatabaseTest." << ::getpid() << ".db";
+        path = name.str();
+    }
+
+    void tearDown()
+    {
+        ::unlink(path.c_str());
+    }
+
+    void testEmpty()
+    {
+        RangeDatabase closed;
+        RangeDatabase::Record record;
+        CPPUNIT_ASSERT(!closed.isOpen());
+        CPPUNIT_ASSERT(!closed.lookup(InetAddress("10.0.0.1"), record));
+        CPPUNIT_ASSERT(record.get(0) == NULL);
+
+        RangeDatabaseWriter writer(fields("asn"));
+        writer.write(path);
+        RangeDatabase database(path);
+        CPPUNIT_ASSERT(database.isOpen());
+        CPPUNIT_ASSERT(database.getRangeCount() == 0);
+        CPPUNIT_ASSERT(!database.lookup(InetAddress("10.0.0.1"), record));
+        CPPUNIT_ASSERT(!database.lookup(InetAddress(), record));
+        database.close();
+        CPPUNIT_ASSERT(!database.isOpen());
+    }
+
+    void testLookup()
+    {
+        RangeDatabaseWriter writer(fields("asn", "region"));
+        writer.add(Subnet("10.0.0.0/8"), fields("64500", "eu"));
+        writer.add(Subnet("192.168.1.0/24"), fields("64501", "us"));
+        writer.add(InetAddress("192.168.2.10"), InetAddress("192.168.2.20"), fields("64502", "eu"));
+        writer.add(Subnet("255.255.255.255/32"), fields("64503", ""));
+        CPPUNIT_ASSERT(writer.getRangeCount() == 4);
+        writer.write(path);
+
+        RangeDatabase database(path);
+        RangeDatabase::Record record;
+        CPPUNIT_ASSERT(database.getRangeCount() == 4);
+
+        CPPUNIT_ASSERT(database.lookup(InetAddress("10.0.0.0"), record));
+        CPPUNIT_ASSERT(std::string(record.get(0)) == "64500");
+        CPPUNIT_ASSERT(std::string(record.get(1)) == "eu");
+        CPPUNIT_ASSERT(record.get(2) == NULL);
+        CPPUNIT_ASSERT(database.lookup(InetAddress("10.255.255.255"), record));
+        CPPUNIT_ASSERT(std::string(record.get(0)) == "64500");
+
+        CPPUNIT_ASSERT(database.lookup(InetAddress("192.168.1.77"), record));
+        CPPUNIT_ASSERT(std::string(record.get(0)) == "64501");
+        CPPUNIT_ASSERT(std::string(record.get(1)) == "us");
+        CPPUNIT_ASSERT(database.lookup(InetAddress("192.168.2.10"), record));
+        CPPUNIT_ASSERT(std::string(record.get(0)) == "64502");
+        CPPUNIT_ASSERT(database.lookup(InetAddress("192.168.2.20"), record));
+        CPPUNIT_ASSERT(database.lookup(InetAddress("255.255.255.255"), record));
+        CPPUNIT_ASSERT(std::string(record.get(1)) == "");
+
+        record = RangeDatabase::Record();
+        CPPUNIT_ASSERT(!database.lookup(InetAddress("9.255.255.255"), record));
+        CPPUNIT_ASSERT(!database.lookup(InetAddress("11.0.0.0"), record));
+        CPPUNIT_ASSERT(!database.lookup(InetAddress("192.168.2.9"), record));
+        CPPUNIT_ASSERT(!database.lookup(InetAddress("192.168.2.21"), record));
+        CPPUNIT_ASSERT(!database.lookup(InetAddress("0.0.0.0"), record));
+        CPPUNIT_ASSERT(record.get(0) == NULL);
+    }
+
+    void testFields()
+    {
+        RangeDatabaseWriter writer(fields("asn", "region"));
+        writer.write(path);
+        RangeDatabase database(path);
+        CPPUNIT_ASSERT(database.getFieldCount() == 2);
+        CPPUNIT_ASSERT(std::string(database.getFieldName(0)) == "asn");
+        CPPUNIT_ASSERT(std::string(database.getFieldName(1)) == "region");
+        CPPUNIT_ASSERT(database.getFieldName(2) == NULL);
+        CPPUNIT_ASSERT(database.findField("region") == 1);
+        CPPUNIT_ASSERT(database.findField("tenant") == 2);
+    }
+
+    void testRandom()
+    {
+        // Disjoint ranges with gaps between them, checked against a
+        // linear search.
+        std::vector<uint32_t> firsts;
+        std::vector<uint32_t> lasts;
+        RangeDatabaseWriter writer(fields("index"));
+        uint32_t next = 1000;
+        for(size_t i = 0; i < 1000; ++i)
+        {
+            uint32_t first = next + static_cast<uint32_t>(std::rand() % 3);
+            uint32_t last = first + static_cast<uint32_t>(std::rand() % 100);
+            next = last + 1 + static_cast<uint32_t>(std::rand() % 50);
+            firsts.push_back(first);
+            lasts.push_back(last);
+            std::ostringstream value;
+            value << i;
+            writer.add(toAddress(first), toAddress(last), fields(value.str()));
+        }
+        writer.write(path);
+
+        RangeDatabase database(path);
+        for(uint32_t key = 0; key < next + 10; ++key)
+        {
+            size_t expected = firsts.size();
+            for(size_t i = 0; i < firsts.size(); ++i)
+            {
+                if((firsts[i] <= key) && (key <= lasts[i]))
+                {
+                    expected = i;
+                    break;
+                }
+            }
+            RangeDatabase::Record record;
+            bool found = database.lookup(toAddress(key), record);
+            CPPUNIT_ASSERT(found == (expected != firsts.size()));
+            if(found)
+            {
+                CPPUNIT_ASSERT(static_cast<size_t>(std::atoi(record.get(0))) == expected);
+            }
+        }
+    }
+
+    void testReopen()
+    {
+        RangeDatabaseWriter writer(fields("asn"));
+        writer.add(Subnet("10.0.0.0/8"), fields("64500"));
+        writer.write(path);
+        RangeDatabase database(path);
+
+        // Replacing the file does not disturb a database that is open.
+        RangeDatabaseWriter other(fields("asn"));
+        other.add(Subnet("10.0.0.0/8"), fields("64511"));
+        other.write(path);
+
+        RangeDatabase::Record record;
+        CPPUNIT_ASSERT(database.lookup(InetAddress("10.1.2.3"), record));
+        CPPUNIT_ASSERT(std::string(record.get(0)) == "64500");
+        database.open(path);
+        CPPUNIT_ASSERT(database.lookup(InetAddress("10.1.2.3"), record));
+        CPPUNIT_ASSERT(std::string(record.get(0)) == "64511");
+    }
+
+    void testOverlap()
+    {
+        RangeDatabaseWriter writer(fields("asn"));
+        writer.add(Subnet("10.0.0.0/8"), fields("64500"));
+        writer.add(Subnet("10.1.0.0/16"), fields("64501"));
+        writer.write(path);
+    }
+
+    void testValueCount()
+    {
+        RangeDatabaseWriter writer(fields("asn", "region"));
+        writer.add(Subnet("10.0.0.0/8"), fields("64500"));
+    }
+
+    void testMissing()
+    {
+        RangeDatabase database(path);
+    }
+
+    void testNotDatabase()
+    {
+        writeFile(std::string(200, 'x'));
+        RangeDatabase database(path);
+    }
+
+    void testTruncated()
+    {
+        RangeDatabaseWriter writer(fields("asn"));
+        writer.add(Subnet("10.0.0.0/8"), fields("64500"));
+        writer.write(path);
+        std::string content = readFile();
+        writeFile(content.substr(0, content.size() - 8));
+        RangeDatabase database(path);
+    }
+
+    void testDamaged()
+    {
+        RangeDatabaseWriter writer(fields("asn"));
+        writer.add(Subnet("10.0.0.0/8"), fields("64500"));
+        writer.write(path);
+        std::string content = readFile();
+
+        // Points the record of the only range past the records.
+        RangeDatabase::Header header;
+        ::memcpy(&header, content.data(), sizeof(header));
+        uint32_t record = 7;
+        ::memcpy(&content[header.range4Offset + 8], &record, sizeof(record));
+        writeFile(content);
+        RangeDatabase database(path);
+    }
+
+    void testRecordCountOverflow()
+    {
+        RangeDatabaseWriter writer(fields("asn"));
+        writer.add(Subnet("10.0.0.0/8"), fields("64500"));
+        writer.write(path);
+        std::string content = readFile();
+
+        // 2^31 records of 2^31 fields: their size wraps around to 0.
+        // The records and field names point into a sparse tail of zeros
+        // that is large enough for the field names.
+        RangeDatabase::Header header;
+        ::memcpy(&header, content.data(), sizeof(header));
+        header.recordCount = 0x80000000U;
+        header.fieldCount = 0x80000000U;
+        header.fieldOffset = (content.size() + 7U) & ~static_cast<uint64_t>(7U);
+        header.recordOffset = header.fieldOffset;
+        ::memcpy(&content[0], &header, sizeof(header));
+        writeFile(content);
+        CPPUNIT_ASSERT(::truncate(path.c_str(), static_cast<off_t>(header.fieldOffset + (1ULL << 33))) == 0);
+        RangeDatabase database(path);
+    }
+
+#ifdef HAVE_IPV6_SUPPORT
+    void testIPv6()
+    {
+        RangeDatabaseWriter writer(fields("asn"));
+        writer.add(Subnet("2001:db8::/32"), fields("64500"));
+        writer.add(Subnet("2001:db9::/48"), fields("64501"));
+        writer.add(InetAddress("fe80::1"), InetAddress("fe80::1:0:0:5"), fields("64502"));
+        writer.add(Subnet("10.0.0.0/8"), fields("64503"));
+        writer.write(path);
+
+        RangeDatabase database(path);
+        RangeDatabase::Record record;
+        CPPUNIT_ASSERT(database.getRangeCount() == 4);
+        CPPUNIT_ASSERT(database.lookup(InetAddress("2001:db8::"), record));
+        CPPUNIT_ASSERT(std::string(record.get(0)) == "64500");
+        CPPUNIT_ASSERT(database.lookup(InetAddress("2001:db8:ffff:ffff:ffff:ffff:ffff:ffff"), record));
+        CPPUNIT_ASSERT(std::string(record.get(0)) == "64500");
+        CPPUNIT_ASSERT(database.lookup(InetAddress("2001:db9:0:ffff::1"), record));
+        CPPUNIT_ASSERT(std::string(record.get(0)) == "64501");
+        CPPUNIT_ASSERT(database.lookup(InetAddress("fe80::1:0:0:0"), record));
+        CPPUNIT_ASSERT(std::string(record.get(0)) == "64502");
+        CPPUNIT_ASSERT(!database.lookup(InetAddress("2001:db9:1::"), record));
+        CPPUNIT_ASSERT(!database.lookup(InetAddress("fe80::"), record));
+        CPPUNIT_ASSERT(!database.lookup(InetAddress("fe80::1:0:0:6"), record));
+        CPPUNIT_ASSERT(!database.lookup(InetAddress("::a00:1"), record));
+        CPPUNIT_ASSERT(database.lookup(InetAddress("10.0.0.1"), record));
+        CPPUNIT_ASSERT(std::string(record.get(0)) == "64503");
+    }
+#endif
+
+  private:
+    static std::vector<std::string> fields(const std::string& a)
+    {
+        return std::vector<std::string>(1, a);
+    }
+
+    static std::vector<std::string> fields(const std::string& a, const std::string& b)
+    {
+        std::vector<std::string> result(1, a);
+        result.push_back(b);
+        return result;
+    }
+
+    static InetAddress toAddress(uint32_t key)
+    {
+        char text[16];
+        ::snprintf(text, sizeof(text), "%u.%u.%u.%u", key >> 24, (key >> 16) & 0xFF, (key >> 8) & 0xFF, key & 0xFF);
+        return InetAddress(text);
+    }
+
+    std::string readFile()
+    {
+        std::string content;
+        FILE* file = ::fopen(path.c_str(), "rb");
+        char buf[4096];
+        size_t n;
+        while((n = ::fread(buf, 1, sizeof(buf), file)) > 0)
+        {
+            content.append(buf, n);
+        }
+        ::fclose(file);
+        return content;
+    }
+
+    void writeFile(const std::string& content)
+    {
+        FILE* file = ::fopen(path.c_str(), "wb");
+        ::fwrite(content.data(), 1, content.size(), file);
+        ::fclose(file);
+    }
+
+    std::string path;
+};
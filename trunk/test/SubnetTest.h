@@ -0,0 +1,441 @@
+// C++ test file ---------------------------------------------------------//
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@gmail.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License as
+//   published by the Free Software Foundation; either version 2 of the
+//   License, or (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+//   This file is part of the Frog Framework.
+
+#include <sys/types.h>
+#include <arpa/inet.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <iterator>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <frog/InetAddress.h>
+#include <frog/InetAddressValue.h>
+#include <frog/NetworkInterface.h>
+#include <frog/Subnet.h>
+#include <frog/IllegalArgumentException.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+using frog::net::InetAddress;
+using frog::net::InetAddressValue;
+using frog::net::NetworkInterface;
+using frog::net::Subnet;
+using frog::sys::IllegalArgumentException;
+
+class SubnetTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(SubnetTest);
+
+    CPPUNIT_TEST(testParse4);
+    CPPUNIT_TEST(testParseHostBits);
+    CPPUNIT_TEST(testParseInvalid);
+    CPPUNIT_TEST_EXCEPTION(testConstructorInvalid, IllegalArgumentException);
+    CPPUNIT_TEST_EXCEPTION(testPrefixTooLong, IllegalArgumentException);
+    CPPUNIT_TEST(testContains4);
+    CPPUNIT_TEST(testContainsAll);
+    CPPUNIT_TEST(testNetmask);
+    CPPUNIT_TEST(testInterfaceAddress);
+    CPPUNIT_TEST_EXCEPTION(testInterfaceAddressNotContiguous, IllegalArgumentException);
+    CPPUNIT_TEST(testContainsMany);
+    CPPUNIT_TEST(testEquality);
+    CPPUNIT_TEST(testLastAddress);
+    CPPUNIT_TEST(testIterate4);
+    CPPUNIT_TEST(testIterateEmpty);
+    CPPUNIT_TEST(testStride);
+    CPPUNIT_TEST_EXCEPTION(testStrideZero, IllegalArgumentException);
+    CPPUNIT_TEST(testPermutation4);
+#ifdef HAVE_IPV6_SUPPORT
+    CPPUNIT_TEST(testParse6);
+    CPPUNIT_TEST(testContains6);
+    CPPUNIT_TEST(testIterate6);
+    CPPUNIT_TEST(testPermutation6);
+    CPPUNIT_TEST_EXCEPTION(testPermutationTooLarge, IllegalArgumentException);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void setUp()
+    {
+    }
+
+    void tearDown()
+    {
+    }
+
+    void testParse4()
+    {
+        Subnet subnet("10.0.0.0/8");
+        CPPUNIT_ASSERT(subnet.getNetwork() == InetAddress("10.0.0.0"));
+        CPPUNIT_ASSERT(subnet.getPrefixLength() == 8);
+        CPPUNIT_ASSERT(subnet.toString() == "10.0.0.0/8");
+
+        CPPUNIT_ASSERT(Subnet("0.0.0.0/0").toString() == "0.0.0.0/0");
+        CPPUNIT_ASSERT(Subnet("192.168.1.7").toString() == "192.168.1.7/32");
+        CPPUNIT_ASSERT(Subnet("192.168.1.7").getPrefixLength() == 32);
+    }
+
+    void testParseHostBits()
+    {
+        CPPUNIT_ASSERT(Subnet("10.1.2.3/8").toString() == "10.0.0.0/8");
+        CPPUNIT_ASSERT(Subnet("192.168.255.255/23").toString() == "192.168.254.0/23");
+        CPPUNIT_ASSERT(Subnet(InetAddress("172.31.9.9"), 12).toString() == "172.16.0.0/12");
+    }
+
+    void testParseInvalid()
+    {
+        const char* text[] = { "", "/8", "10.0.0.0/", "10.0.0.0/33", "10.0.0.0/08",
+            "10.0.0.0/1000", "10.0.0.0/8/8", "10.0.0.0/-1", "10.0.0/8", "10.0.0.0 /8",
+            "2001:db8::/129" };
+        Subnet subnet("10.0.0.0/8");
+        for(size_t i = 0; i < sizeof(text) / sizeof(text[0]); ++i)
+        {
+            CPPUNIT_ASSERT(!Subnet::tryParse(text[i], strlen(text[i]), subnet));
+        }
+        CPPUNIT_ASSERT(subnet.toString() == "10.0.0.0/8");
+        CPPUNIT_ASSERT(!Subnet::tryParse(NULL, 0, subnet));
+    }
+
+    void testConstructorInvalid()
+    {
+        Subnet subnet("10.0.0.0/abc");
+    }
+
+    void testPrefixTooLong()
+    {
+        Subnet subnet(InetAddress("10.0.0.0"), 33);
+    }
+
+    void testContains4()
+    {
+        Subnet subnet("10.0.0.0/8");
+        CPPUNIT_ASSERT(subnet.contains(InetAddress("10.0.0.0")));
+        CPPUNIT_ASSERT(subnet.contains(InetAddress("10.255.255.255")));
+        CPPUNIT_ASSERT(!subnet.contains(InetAddress("11.0.0.0")));
+        CPPUNIT_ASSERT(!subnet.contains(InetAddress("9.255.255.255")));
+        CPPUNIT_ASSERT(!subnet.contains(InetAddress()));
+
+        Subnet host("192.168.1.7/32");
+        CPPUNIT_ASSERT(host.contains(InetAddress("192.168.1.7")));
+        CPPUNIT_ASSERT(!host.contains(InetAddress("192.168.1.6")));
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(!subnet.contains(InetAddress("::10.0.0.1")));
+        CPPUNIT_ASSERT(!subnet.contains(InetAddress("::ffff:10.0.0.1")));
+#endif
+    }
+
+    void testContainsAll()
+    {
+        Subnet all("0.0.0.0/0");
+        CPPUNIT_ASSERT(all.contains(InetAddress("0.0.0.0")));
+        CPPUNIT_ASSERT(all.contains(InetAddress("255.255.255.255")));
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(!all.contains(InetAddress("::")));
+
+        Subnet all6("::/0");
+        CPPUNIT_ASSERT(all6.contains(InetAddress("::")));
+        CPPUNIT_ASSERT(all6.contains(InetAddress("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff")));
+        CPPUNIT_ASSERT(!all6.contains(InetAddress("0.0.0.0")));
+#endif
+    }
+
+    void testNetmask()
+    {
+        CPPUNIT_ASSERT(Subnet("10.0.0.0/8").getNetmask().toString() == "255.0.0.0");
+        CPPUNIT_ASSERT(Subnet("192.168.0.0/23").getNetmask().toString() == "255.255.254.0");
+        CPPUNIT_ASSERT(Subnet("0.0.0.0/0").getNetmask().toString() == "0.0.0.0");
+#ifdef HAVE_IPV6_SUPPORT
+        CPPUNIT_ASSERT(Subnet("2001:db8::/32").getNetmask().toString() == "ffff:ffff::");
+        CPPUNIT_ASSERT(Subnet("fe80::/10").getNetmask().toString() == "ffc0::");
+#endif
+    }
+
+    void testInterfaceAddress()
+    {
+        NetworkInterface::InterfaceAddress intfaceAddr;
+        intfaceAddr.unicast = InetAddress("192.168.10.77");
+        intfaceAddr.netmask = InetAddress("255.255.252.0");
+        Subnet subnet(intfaceAddr);
+        CPPUNIT_ASSERT(subnet.toString() == "192.168.8.0/22");
+        CPPUNIT_ASSERT(subnet.contains(intfaceAddr.unicast));
+
+        intfaceAddr.netmask = InetAddress("255.255.255.255");
+        CPPUNIT_ASSERT(Subnet(intfaceAddr).getPrefixLength() == 32);
+        intfaceAddr.netmask = InetAddress("0.0.0.0");
+        CPPUNIT_ASSERT(Subnet(intfaceAddr).getPrefixLength() == 0);
+#ifdef HAVE_IPV6_SUPPORT
+        intfaceAddr.unicast = InetAddress("fe80::21f:5bff:fe33:1", 2);
+        intfaceAddr.netmask = InetAddress("ffff:ffff:ffff:ffff::");
+        CPPUNIT_ASSERT(Subnet(intfaceAddr).getPrefixLength() == 64);
+        CPPUNIT_ASSERT(Subnet(intfaceAddr).contains(InetAddress("fe80::1")));
+#endif
+    }
+
+    void testInterfaceAddressNotContiguous()
+    {
+        NetworkInterface::InterfaceAddress intfaceAddr;
+        intfaceAddr.unicast = InetAddress("192.168.10.77");
+        intfaceAddr.netmask = InetAddress("255.0.255.0");
+        Subnet subnet(intfaceAddr);
+    }
+
+    void testContainsMany()
+    {
+        Subnet subnet("172.16.0.0/12");
+        std::vector<InetAddressValue> values;
+        for(uint32_t i = 0; i < 1000; ++i)
+        {
+            struct in_addr in;
+            in.s_addr = htonl(0xac000000U + i * 0x00012345U);
+            values.push_back(InetAddress(in).getValue());
+        }
+#ifdef HAVE_IPV6_SUPPORT
+        values.push_back(InetAddress("::ffff:172.16.0.1").getValue());
+        values.push_back(InetAddress("2001:db8::1").getValue());
+#endif
+
+        std::vector<uint8_t> result(values.size());
+        size_t matches = subnet.containsMany(&values[0], values.size(), &result[0]);
+        size_t expected = 0;
+        for(size_t i = 0; i < values.size(); ++i)
+        {
+            CPPUNIT_ASSERT((result[i] != 0) == subnet.contains(values[i]));
+            expected += subnet.contains(values[i]);
+        }
+        CPPUNIT_ASSERT(matches == expected);
+        CPPUNIT_ASSERT(matches > 0);
+    }
+
+    void testEquality()
+    {
+        CPPUNIT_ASSERT(Subnet("10.0.0.0/8") == Subnet("10.9.9.9/8"));
+        CPPUNIT_ASSERT(Subnet("10.0.0.0/8") != Subnet("10.0.0.0/9"));
+        CPPUNIT_ASSERT(Subnet("10.0.0.0/8").hashCode() == Subnet("10.9.9.9/8").hashCode());
+
+        Subnet subnet;
+        CPPUNIT_ASSERT(subnet.toString() == "");
+        subnet = Subnet("10.0.0.0/8");
+        Subnet copy(subnet);
+        CPPUNIT_ASSERT(copy == subnet);
+        CPPUNIT_ASSERT(copy.contains(InetAddress("10.1.0.1")));
+    }
+
+    void testLastAddress()
+    {
+        CPPUNIT_ASSERT(Subnet("10.0.0.0/8").getLastAddress().toString() == "10.255.255.255");
+        CPPUNIT_ASSERT(Subnet("192.168.1.7/32").getLastAddress().toString() == "192.168.1.7");
+        CPPUNIT_ASSERT(Subnet("0.0.0.0/0").getLastAddress().toString() == "255.255.255.255");
+    }
+
+    void testIterate4()
+    {
+        Subnet subnet("192.168.1.0/28");
+        std::vector<std::string> seen;
+        for(Subnet::iterator it = subnet.begin(); it != subnet.end(); ++it)
+        {
+            seen.push_back(it->toString());
+        }
+        CPPUNIT_ASSERT(seen.size() == 16);
+        CPPUNIT_ASSERT(seen[0] == "192.168.1.0");
+        CPPUNIT_ASSERT(seen[1] == "192.168.1.1");
+        CPPUNIT_ASSERT(seen[15] == "192.168.1.15");
+
+        Subnet host("10.1.2.3/32");
+        Subnet::iterator it = host.begin();
+        CPPUNIT_ASSERT(*it == InetAddress("10.1.2.3"));
+        CPPUNIT_ASSERT(it++ != host.end());
+        CPPUNIT_ASSERT(it == host.end());
+        ++it;
+        CPPUNIT_ASSERT(it == host.end());
+
+        // The last addresses of the whole space do not wrap around.
+        Subnet top("255.255.255.252/30");
+        CPPUNIT_ASSERT(std::distance(top.begin(), top.end()) == 4);
+    }
+
+    void testIterateEmpty()
+    {
+        Subnet empty;
+        CPPUNIT_ASSERT(empty.begin() == empty.end());
+        CPPUNIT_ASSERT(empty.stride(2).begin() == empty.end());
+    }
+
+    void testStride()
+    {
+        Subnet subnet("10.0.0.0/16");
+        Subnet::Range range = subnet.stride(256);
+        size_t count = 0;
+        for(Subnet::iterator it = range.begin(); it != range.end(); ++it, ++count)
+        {
+            CPPUNIT_ASSERT(*it == InetAddress("10.0.0.0") + static_cast<int64_t>(count * 256));
+        }
+        CPPUNIT_ASSERT(count == 256);
+
+        // A step larger than the subnet yields the network address only.
+        Subnet small("10.0.0.0/24");
+        CPPUNIT_ASSERT(std::distance(small.stride(1000).begin(), small.stride(1000).end()) == 1);
+        CPPUNIT_ASSERT(std::distance(small.stride(~0ULL).begin(), small.stride(~0ULL).end()) == 1);
+        CPPUNIT_ASSERT(std::distance(small.stride(100).begin(), small.stride(100).end()) == 3);
+    }
+
+    void testStrideZero()
+    {
+        Subnet("10.0.0.0/8").stride(0);
+    }
+
+    void testPermutation4()
+    {
+        Subnet subnet("172.16.0.0/20");
+        for(uint64_t seed = 0; seed < 4; ++seed)
+        {
+            std::vector<InetAddress> seen;
+            Subnet::Range range = subnet.permutation(seed);
+            for(Subnet::iterator it = range.begin(); it != range.end(); ++it)
+            {
+                CPPUNIT_ASSERT(subnet.contains(*it));
+                seen.push_back(*it);
+            }
+            CPPUNIT_ASSERT(seen.size() == 4096);
+
+            // Not in order, but every address once.
+            size_t ascending = 0;
+            for(size_t i = 1; i < seen.size(); ++i)
+            {
+                ascending += (seen[i - 1] < seen[i]) ? 1 : 0;
+            }
+            CPPUNIT_ASSERT(ascending < seen.size() * 3 / 4);
+            std::sort(seen.begin(), seen.end());
+            CPPUNIT_ASSERT(std::adjacent_find(seen.begin(), seen.end()) == seen.end());
+        }
+
+        std::vector<InetAddress> first, second;
+        Subnet::Range a = subnet.permutation(1);
+        Subnet::Range b = subnet.permutation(2);
+        std::copy(a.begin(), a.end(), std::back_inserter(first));
+        std::copy(b.begin(), b.end(), std::back_inserter(second));
+        CPPUNIT_ASSERT(first != second);
+
+        for(uint32_t length = 0; length < 4; ++length)
+        {
+            Subnet tiny(InetAddress("10.0.0.0"), 32 - length);
+            Subnet::Range range = tiny.permutation(7);
+            std::set<std::string> unique;
+            for(Subnet::iterator it = range.begin(); it != range.end(); ++it)
+            {
+                unique.insert(it->toString());
+            }
+            CPPUNIT_ASSERT(unique.size() == (1U << length));
+        }
+    }
+#ifdef HAVE_IPV6_SUPPORT
+    void testParse6()
+    {
+        Subnet subnet("2001:db8::/32");
+        CPPUNIT_ASSERT(subnet.getPrefixLength() == 32);
+        CPPUNIT_ASSERT(subnet.toString() == "2001:db8::/32");
+        CPPUNIT_ASSERT(Subnet("2001:db8:ffff::1/48").toString() == "2001:db8:ffff::/48");
+        CPPUNIT_ASSERT(Subnet("2001:db8::1/127").toString() == "2001:db8::/127");
+        CPPUNIT_ASSERT(Subnet("2001:db8::1").toString() == "2001:db8::1/128");
+        CPPUNIT_ASSERT(Subnet("fe80::%1/64").toString() == "fe80::%1/64");
+    }
+
+    void testContains6()
+    {
+        Subnet subnet("2001:db8::/32");
+        CPPUNIT_ASSERT(subnet.contains(InetAddress("2001:db8::1")));
+        CPPUNIT_ASSERT(subnet.contains(InetAddress("2001:db8:ffff:ffff:ffff:ffff:ffff:ffff")));
+        CPPUNIT_ASSERT(!subnet.contains(InetAddress("2001:db9::")));
+        CPPUNIT_ASSERT(!subnet.contains(InetAddress("32.1.13.184")));
+
+        Subnet wide("2001:db8:8000::/33");
+        CPPUNIT_ASSERT(wide.contains(InetAddress("2001:db8:8000::1")));
+        CPPUNIT_ASSERT(!wide.contains(InetAddress("2001:db8:7fff::1")));
+
+        Subnet low("::1:0:0:0/80");
+        CPPUNIT_ASSERT(low.contains(InetAddress("::1:ffff:ffff:ffff")));
+        CPPUNIT_ASSERT(!low.contains(InetAddress("::2:0:0:0")));
+
+        CPPUNIT_ASSERT(Subnet("fe80::/10").contains(InetAddress("fe80::1", 3)));
+    }
+
+    void testIterate6()
+    {
+        Subnet subnet("fe80::ff00/120");
+        Subnet::iterator it = subnet.begin();
+        CPPUNIT_ASSERT(it->toString() == "fe80::ff00");
+        ++it;
+        CPPUNIT_ASSERT(it->toString() == "fe80::ff01");
+        CPPUNIT_ASSERT(std::distance(subnet.begin(), subnet.end()) == 256);
+        CPPUNIT_ASSERT(subnet.getLastAddress().toString() == "fe80::ffff");
+
+        // Carry into the upper 64 bits.
+        Subnet wide("2001:db8:0:0:ffff:ffff:ffff:0/63");
+        Subnet::Range range = wide.stride(~0ULL);
+        it = range.begin();
+        CPPUNIT_ASSERT(it->toString() == "2001:db8::");
+        ++it;
+        CPPUNIT_ASSERT(it->toString() == "2001:db8::ffff:ffff:ffff:ffff");
+        ++it;
+        CPPUNIT_ASSERT(it->toString() == "2001:db8:0:1:ffff:ffff:ffff:fffe");
+        ++it;
+        CPPUNIT_ASSERT(it == range.end());
+
+        Subnet all("::/0");
+        CPPUNIT_ASSERT(all.stride(1ULL << 63).begin()->toString() == "::");
+        CPPUNIT_ASSERT(Subnet("fe80::%3/64").begin()->getValue().scope == 3U);
+    }
+
+    void testPermutation6()
+    {
+        Subnet subnet("2001:db8::/64");
+        Subnet::Range range = subnet.permutation(42);
+        std::vector<InetAddress> seen;
+        Subnet::iterator it = range.begin();
+        for(int i = 0; i < 1000; ++i, ++it)
+        {
+            CPPUNIT_ASSERT(subnet.contains(*it));
+            seen.push_back(*it);
+        }
+        std::sort(seen.begin(), seen.end());
+        CPPUNIT_ASSERT(std::adjacent_find(seen.begin(), seen.end()) == seen.end());
+        // Probes spread over the whole /64, not the first few addresses.
+        CPPUNIT_ASSERT(seen.back() > InetAddress("2001:db8::ffff:ffff:ffff"));
+
+        Subnet small("2001:db8::/116");
+        std::set<std::string> unique;
+        for(Subnet::iterator i = small.permutation(3).begin(); i != small.end(); ++i)
+        {
+            unique.insert(i->toString());
+        }
+        CPPUNIT_ASSERT(unique.size() == 4096);
+    }
+
+    void testPermutationTooLarge()
+    {
+        Subnet("2001:db8::/63").permutation(0);
+    }
+#endif
+};
@@ -0,0 +1,223 @@
+// C++ implementation file -----------------------------------------------//
+//   Frog Framework - A useful framework for C++ applications.
+//   Copyright (C) 2005 by Janvier D. Anonical <janvier@users.berlios.de>
+//
+//   This library is free software; you can redistribute it and/or
+//   modify it under the terms of the GNU Lesser General Public
+//   License as published by the Free Software Foundation; either
+//   version 2.1 of the License, or (at your option) any later version.
+//
+//   This library is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Lesser General Public License for more details.
+//
+//   You should have received a copy of the GNU Lesser General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+//   MA  02110-1301  USA
+//------------------------------------------------------------------------//
+
+
+
+// Builds a RangeDatabase file from a CSV file.
+//
+//   mkrangedb input.csv output.db
+//
+// The first row names the columns. The first column holds the ranges and
+// the other columns are the fields of the database. A range is a subnet
+// (10.0.0.0/8), a single address or two addresses joined by a dash
+// (10.0.0.1-10.0.0.9). Fields may be quoted with double quotes, a quote
+// inside a quoted field being written twice. Empty rows and rows that
+// start with # are skipped.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <frog/InetAddress.h>
+#include <frog/Subnet.h>
+#include <frog/RangeDatabaseWriter.h>
+#include <frog/IOException.h>
+#include <frog/Exception.h>
+#include <frog/IllegalArgumentException.h>
+
+using frog::net::InetAddress;
+using frog::net::Subnet;
+using frog::net::RangeDatabaseWriter;
+
+//--------------------------------------------------------------
+// Splits a CSV row into fields. Returns false if a quote is not closed.
+static bool split(const std::string& line, std::vector<std::string>& fields)
+{
+    fields.clear();
+    std::string field;
+    bool quoted = false;
+    for(size_t i = 0; i < line.size(); ++i)
+    {
+        char c = line[i];
+        if(quoted)
+        {
+            if(c != '"')
+            {
+                field += c;
+            }
+            else if((i + 1 < line.size()) && (line[i + 1] == '"'))
+            {
+                field += '"';
+                ++i;
+            }
+            else
+            {
+                quoted = false;
+            }
+        }
+        else if(c == '"')
+        {
+            quoted = true;
+        }
+        else if(c == ',')
+        {
+            fields.push_back(field);
+            field.clear();
+        }
+        else
+        {
+            field += c;
+        }
+    }
+    fields.push_back(field);
+    return !quoted;
+}
+
+//--------------------------------------------------------------
+// Adds the range of a row. Returns false if the range is not valid.
+static bool addRange(RangeDatabaseWriter& writer, const std::string& range,
+        const std::vector<std::string>& values)
+{
+    if(range.find('/') != std::string::npos)
+    {
+        Subnet subnet;
+        if(!Subnet::tryParse(range.data(), range.size(), subnet))
+        {
+            return false;
+        }
+        writer.add(subnet, values);
+        return true;
+    }
+
+    size_t dash = range.find('-');
+    InetAddress first;
+    InetAddress last;
+    if(dash == std::string::npos)
+    {
+        if(!InetAddress::tryParse(range.data(), range.size(), first))
+        {
+            return false;
+        }
+        last = first;
+    }
+    else if(!InetAddress::tryParse(range.data(), dash, first) ||
+            !InetAddress::tryParse(range.data() + dash + 1, range.size() - dash - 1, last))
+    {
+        return false;
+    }
+    writer.add(first, last, values);
+    return true;
+}
+
+//--------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    if(argc != 3)
+    {
+        ::fprintf(stderr, "usage: %s input.csv output.db\n", argv[0]);
+        return 2;
+    }
+
+    FILE* input = ::fopen(argv[1], "r");
+    if(input == NULL)
+    {
+        ::perror(argv[1]);
+        return 1;
+    }
+
+    RangeDatabaseWriter* writer = NULL;
+    std::vector<std::string> fields;
+    std::string line;
+    size_t lineNo = 0;
+    int status = 0;
+    char buf[4096];
+    while((status == 0) && (::fgets(buf, sizeof(buf), input) != NULL))
+    {
+        line += buf;
+        if((line[line.size() - 1] != '\n') && !::feof(input))
+        {
+            continue;
+        }
+        ++lineNo;
+        while(!line.empty() && ((line[line.size() - 1] == '\n') || (line[line.size() - 1] == '\r')))
+        {
+            line.erase(line.size() - 1);
+        }
+        if(line.empty() || (line[0] == '#'))
+        {
+            line.clear();
+            continue;
+        }
+
+        try
+        {
+            if(!split(line, fields))
+            {
+                ::fprintf(stderr, "%s:%lu: quote is not closed\n", argv[1], static_cast<unsigned long>(lineNo));
+                status = 1;
+            }
+            else if(writer == NULL)
+            {
+                fields.erase(fields.begin());
+                writer = new RangeDatabaseWriter(fields);
+            }
+            else
+            {
+                std::string range = fields[0];
+                fields.erase(fields.begin());
+                if(!addRange(*writer, range, fields))
+                {
+                    ::fprintf(stderr, "%s:%lu: range is not valid: %s\n", argv[1],
+                            static_cast<unsigned long>(lineNo), range.c_str());
+                    status = 1;
+                }
+            }
+        }
+        catch(frog::sys::IllegalArgumentException& e)
+        {
+            ::fprintf(stderr, "%s:%lu: %s\n", argv[1], static_cast<unsigned long>(lineNo), e.getDescription());
+            status = 1;
+        }
+        line.clear();
+    }
+    ::fclose(input);
+
+    if((status == 0) && (writer == NULL))
+    {
+        ::fprintf(stderr, "%s: no header row\n", argv[1]);
+        status = 1;
+    }
+    if(status == 0)
+    {
+        try
+        {
+            writer->write(argv[2]);
+            ::printf("%s: %lu ranges\n", argv[2], static_cast<unsigned long>(writer->getRangeCount()));
+        }
+        catch(frog::sys::Exception& e)
+        {
+            ::fprintf(stderr, "%s\n", e.getDescription());
+            status = 1;
+        }
+    }
+    delete writer;
+    return status;
+}